@@ -0,0 +1,85 @@
+// Interval detection and resampling throughput.
+//
+// Run with: dart run benchmark/log_resampler_benchmark.dart
+//
+// Sessions are 90 minutes long at their native interval with ~2% packet
+// loss; each is resampled to 100 ms (upsampling) and 500 ms (downsampling
+// with IMU anti-aliasing).
+import 'dart:math';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/log_resampler.dart';
+
+const int _sessionMs = 90 * 60 * 1000;
+const int _iterations = 10;
+
+List<SensorLog> _session(int intervalMs, {int seed = 1}) {
+  final rng = Random(seed);
+  final base = DateTime.utc(2026, 3, 14, 10);
+  final logs = <SensorLog>[];
+  for (int t = 0; t < _sessionMs; t += intervalMs) {
+    if (rng.nextDouble() < 0.02) continue;
+    final ax = sin(t / 130.0) + rng.nextDouble() * 0.5;
+    logs.add(
+      SensorLog(
+        packetId: 1000 + t,
+        timestamp: base.add(Duration(milliseconds: t)),
+        latitude: -25.7 + t * 1e-9,
+        longitude: 28.2 + t * 1e-9,
+        speed: 5 + rng.nextDouble() * 10,
+        accelX: ax,
+        accelY: 0.1,
+        accelZ: 9.8,
+        gyroX: rng.nextDouble() - 0.5,
+        gyroY: 0.01,
+        gyroZ: 0.02,
+        filteredAccelX: ax,
+        filteredAccelY: 0.1,
+        filteredAccelZ: 9.8,
+      ),
+    );
+  }
+  return logs;
+}
+
+double _time(void Function() body) {
+  for (int i = 0; i < 2; i++) {
+    body(); // warm-up
+  }
+  final sw = Stopwatch()..start();
+  for (int i = 0; i < _iterations; i++) {
+    body();
+  }
+  return sw.elapsedMicroseconds / _iterations / 1000.0;
+}
+
+void main() {
+  for (final interval in [100, 200, 500]) {
+    final logs = _session(interval);
+    int detected = 0;
+    int up = 0;
+    int down = 0;
+
+    final detect = _time(() => detected = LogInterval.detect(logs));
+    final toFast = _time(() {
+      up = LogResampler.resample(
+        logs,
+        targetIntervalMs: 100,
+        sourceIntervalMs: interval,
+      ).length;
+    });
+    final toSlow = _time(() {
+      down = LogResampler.resample(
+        logs,
+        targetIntervalMs: 500,
+        sourceIntervalMs: interval,
+      ).length;
+    });
+
+    print(
+      '${interval}ms: rows=${logs.length} detected=${detected}ms '
+      'detect=${detect.toStringAsFixed(3)}ms '
+      'to100=${toFast.toStringAsFixed(2)}ms ($up rows) '
+      'to500=${toSlow.toStringAsFixed(2)}ms ($down rows)',
+    );
+  }
+}
@@ -0,0 +1,94 @@
+// Stage -1 sanity check: per-log scalar filter vs. vectorized column kernel.
+//
+// Run with: dart run benchmark/sanity_kernel_benchmark.dart
+//
+// "clean" is a 90-minute session at 10 Hz with valid data; "corrupted" has
+// ~30% of rows damaged (NaN/Inf, null island, out-of-range, zero fill).
+import 'dart:math';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/record_anomalies.dart';
+import 'package:metric_athlete_pod_ble/utils/sanity_kernel.dart';
+
+const int _rows = 54000;
+const int _iterations = 50;
+
+List<SensorLog> _session({required double corruptRatio, int seed = 1}) {
+  final rng = Random(seed);
+  return List.generate(_rows, (i) {
+    double ax = rng.nextDouble() * 4 - 2;
+    double gx = rng.nextDouble() - 0.5;
+    double speed = rng.nextDouble() * 30;
+    double lat = -25.7 + rng.nextDouble() * 1e-3;
+    double lon = 28.2 + rng.nextDouble() * 1e-3;
+    if (rng.nextDouble() < corruptRatio) {
+      switch (rng.nextInt(4)) {
+        case 0:
+          ax = double.nan;
+        case 1:
+          lat = 0;
+          lon = 0;
+        case 2:
+          speed = 500;
+        default:
+          gx = 1e6;
+      }
+    }
+    return SensorLog(
+      packetId: i * 100,
+      timestamp: DateTime(2026, 3, 14),
+      latitude: lat,
+      longitude: lon,
+      speed: speed,
+      accelX: ax,
+      accelY: 0.1,
+      accelZ: 9.8,
+      gyroX: gx,
+      gyroY: 0.01,
+      gyroZ: 0.02,
+      filteredAccelX: ax,
+      filteredAccelY: 0.1,
+      filteredAccelZ: 9.8,
+    );
+  });
+}
+
+double _time(void Function() body) {
+  for (int i = 0; i < 5; i++) {
+    body(); // warm-up
+  }
+  final sw = Stopwatch()..start();
+  for (int i = 0; i < _iterations; i++) {
+    body();
+  }
+  return sw.elapsedMicroseconds / _iterations / 1000.0;
+}
+
+void main() {
+  for (final (name, ratio) in [('clean', 0.0), ('corrupted', 0.3)]) {
+    final logs = _session(corruptRatio: ratio);
+    int kept = 0;
+
+    final scalar = _time(() {
+      kept = logs.where((l) => RecordAnomaly.classify(l) == 0).length;
+    });
+    final columns = SensorColumns.fromLogs(logs);
+    final kernelOnly = _time(() {
+      kept =
+          SanityKernel.compactionIndex(SanityKernel.classify(columns)).length;
+    });
+    final withColumns = _time(() {
+      final flags = SanityKernel.classify(SensorColumns.fromLogs(logs));
+      kept = SanityKernel.compact(
+        logs,
+        SanityKernel.compactionIndex(flags),
+      ).length;
+    });
+
+    print(
+      '$name: rows=$_rows kept=$kept '
+      'scalar=${scalar.toStringAsFixed(2)}ms '
+      'kernel=${kernelOnly.toStringAsFixed(2)}ms '
+      'kernel+columns+compact=${withColumns.toStringAsFixed(2)}ms',
+    );
+  }
+}
@@ -0,0 +1,103 @@
+// Squad metrics on 25 athletes x 90 minutes at 10 Hz (54000 steps).
+//
+// Run with: dart run benchmark/squad_metrics_benchmark.dart
+//
+// Reports alignment once, then the scalar reference (per step, every pair,
+// float64), the Float32x4 kernel on one isolate, and the kernel split over
+// several isolates.
+import 'dart:math';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/squad_alignment.dart';
+import 'package:metric_athlete_pod_ble/utils/squad_metrics.dart';
+
+const int _athletes = 25;
+const int _steps = 90 * 60 * 10;
+const int _iterations = 5;
+
+List<SensorLog> _athlete(int id) {
+  final rng = Random(id);
+  final base = DateTime.utc(2026, 3, 14, 10);
+  final phase = rng.nextDouble() * 2 * pi;
+  final firstTick = rng.nextInt(1 << 20);
+  return List.generate(_steps, (t) {
+    final s = t / 600.0 + phase;
+    return SensorLog(
+      packetId: firstTick + t * 100,
+      timestamp: base.add(Duration(milliseconds: t * 100)),
+      latitude: -25.7 + 3e-4 * sin(s) + id * 1e-5,
+      longitude: 28.2 + 4e-4 * cos(s * 1.3),
+      speed: 12 + 14 * sin(s * 7).abs(),
+      accelX: 0.5,
+      accelY: 0.1,
+      accelZ: 9.8,
+      gyroX: 0.01,
+      gyroY: 0.02,
+      gyroZ: 0.03,
+      filteredAccelX: 0.5,
+      filteredAccelY: 0.1,
+      filteredAccelZ: 9.8,
+    );
+  });
+}
+
+/// Straightforward per-step evaluation for comparison.
+double _scalarMeanPair(SquadTimeline timeline) {
+  final n = timeline.length;
+  final kx = SquadAnalytics.metresPerDegree * cos(-25.7 * pi / 180);
+  double total = 0;
+  for (int t = 0; t < n; t++) {
+    double sum = 0;
+    for (int i = 0; i < _athletes; i++) {
+      for (int j = i + 1; j < _athletes; j++) {
+        final dx =
+            (timeline.longitude[i * n + t] - timeline.longitude[j * n + t]) *
+            kx;
+        final dy =
+            (timeline.latitude[i * n + t] - timeline.latitude[j * n + t]) *
+            SquadAnalytics.metresPerDegree;
+        sum += sqrt(dx * dx + dy * dy);
+      }
+    }
+    total += sum;
+  }
+  return total;
+}
+
+Future<double> _time(Future<void> Function() body) async {
+  await body(); // warm-up
+  final sw = Stopwatch()..start();
+  for (int i = 0; i < _iterations; i++) {
+    await body();
+  }
+  return sw.elapsedMicroseconds / _iterations / 1000.0;
+}
+
+Future<void> main() async {
+  final sessions = {
+    for (int a = 0; a < _athletes; a++) 'athlete$a': _athlete(a),
+  };
+
+  final sw = Stopwatch()..start();
+  final timeline = SquadAligner.align(sessions);
+  print(
+    'align: athletes=$_athletes steps=${timeline.length} '
+    '${sw.elapsedMilliseconds}ms',
+  );
+
+  final scalar = await _time(() async => _scalarMeanPair(timeline));
+  int syncSprints = 0;
+  final kernel = await _time(() async {
+    syncSprints = SquadAnalytics.compute(timeline).synchronisedSprints.length;
+  });
+  print(
+    'scalar pairs=${scalar.toStringAsFixed(1)}ms '
+    'kernel=${kernel.toStringAsFixed(1)}ms syncSprints=$syncSprints',
+  );
+
+  for (final blocks in [2, 4, 8]) {
+    final parallel = await _time(() async {
+      await SquadAnalytics.computeParallel(timeline, blocks: blocks);
+    });
+    print('kernel x$blocks isolates=${parallel.toStringAsFixed(1)}ms');
+  }
+}
@@ -0,0 +1,397 @@
+// Headless batch sync: the multi-file sync pipeline without Flutter or a pod.
+//
+// Each input directory is one sync batch (one pod's files). Every .bin file
+// in it is parsed (BinaryParser) and filtered (FilterPipeline), then the
+// batch is merged, deduplicated and clustered (BatchSync) exactly as
+// PodNotifier.syncAllFiles does, and the raw archive is written as CSV.
+// With --simulate each file first travels through a SimulatedPod link and
+// the BlockReassembler, so the transport path is exercised as well.
+// Throughput is reported per stage.
+//
+// Run with:      dart run bin/pod_batch_sync.dart [options] <dir> [<dir> ...]
+// Native binary: dart compile exe bin/pod_batch_sync.dart -o pod_batch_sync
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/services/batch_sync.dart';
+import 'package:metric_athlete_pod_ble/transport/block_reassembler.dart';
+import 'package:metric_athlete_pod_ble/transport/simulated_pod.dart';
+import 'package:metric_athlete_pod_ble/utils/filter_pipeline.dart';
+import 'package:metric_athlete_pod_ble/utils/logs_binary_parser.dart';
+import 'package:metric_athlete_pod_ble/utils/pod_logger.dart';
+import 'package:metric_athlete_pod_ble/utils/sensor_log_csv.dart';
+
+const _usage = '''
+Usage: pod_batch_sync [options] <dir> [<dir> ...]
+
+Processes every .bin file in each directory as one sync batch and writes
+Player_X_YYYYMMDD_HHMM_Raw.csv per batch.
+
+Options:
+  --out <dir>          Output directory (default: <dir>/export per batch)
+  --player <n>         Player number used in file names (default: unknown)
+  --start <iso8601>    Keep only records at or after this time
+  --end <iso8601>      Keep only records before this time
+  --no-filter          Skip the filter pipeline (raw parsed records)
+  --split              Also write one CSV per detected session
+  --dry-run            Process but write nothing
+  --simulate           Send each file through a simulated BLE link
+  --block-size <n>     Simulated notification size in bytes (default 244)
+  --loss <p>           Simulated block loss rate, 0..1 (default 0)
+  --duplicate <p>      Simulated duplicate rate, 0..1 (default 0)
+  --reorder <p>        Simulated reorder rate, 0..1 (default 0)
+  --seed <n>           Simulation seed (default 1)
+  --verbose            Echo PodLogger diagnostics
+  -h, --help           Show this help
+''';
+
+class _Options {
+  final List<String> inputs = [];
+  String? out;
+  int player = 0;
+  DateTime? start;
+  DateTime? end;
+  bool filter = true;
+  bool split = false;
+  bool dryRun = false;
+  bool simulate = false;
+  int blockSize = 244;
+  double loss = 0;
+  double duplicate = 0;
+  double reorder = 0;
+  int seed = 1;
+  bool verbose = false;
+}
+
+/// Elapsed time and volume for one pipeline stage.
+class _Stage {
+  final String name;
+  final Stopwatch watch = Stopwatch();
+  int bytes = 0;
+  int records = 0;
+
+  _Stage(this.name);
+
+  T time<T>(T Function() body) {
+    watch.start();
+    try {
+      return body();
+    } finally {
+      watch.stop();
+    }
+  }
+}
+
+/// Totals over every batch.
+class _Totals {
+  int batches = 0;
+  int failedBatches = 0;
+  int files = 0;
+  int failedFiles = 0;
+  int bytes = 0;
+  int parsedRecords = 0;
+  int exportedRecords = 0;
+  int duplicates = 0;
+  int sessions = 0;
+  int blocks = 0;
+  int missingBlocks = 0;
+  int duplicateBlocks = 0;
+
+  final read = _Stage('read');
+  final link = _Stage('link');
+  final parse = _Stage('parse');
+  final filter = _Stage('filter');
+  final merge = _Stage('merge');
+  final write = _Stage('write');
+
+  List<_Stage> get stages => [read, link, parse, filter, merge, write];
+}
+
+Future<void> main(List<String> args) async {
+  final _Options options;
+  try {
+    options = _parseArgs(args);
+  } on FormatException catch (e) {
+    stderr.writeln('pod_batch_sync: ${e.message}\n');
+    stderr.write(_usage);
+    exitCode = 64;
+    return;
+  }
+  if (options.inputs.isEmpty) {
+    stdout.write(_usage);
+    return;
+  }
+  PodLogger.printToConsole = options.verbose;
+
+  final totals = _Totals();
+  final wall = Stopwatch()..start();
+  for (final input in options.inputs) {
+    await _runBatch(Directory(input), options, totals);
+  }
+  wall.stop();
+
+  _printSummary(totals, wall.elapsed, options);
+  if (totals.failedBatches > 0) exitCode = 1;
+}
+
+_Options _parseArgs(List<String> args) {
+  final o = _Options();
+  for (int i = 0; i < args.length; i++) {
+    final arg = args[i];
+    String value() {
+      if (i + 1 >= args.length) throw FormatException('$arg needs a value');
+      return args[++i];
+    }
+
+    int intValue() {
+      final v = value();
+      return int.tryParse(v) ?? (throw FormatException('$arg: not an integer: $v'));
+    }
+
+    double rate() {
+      final v = value();
+      final p = double.tryParse(v);
+      if (p == null || p < 0 || p > 1) {
+        throw FormatException('$arg: expected 0..1, got $v');
+      }
+      return p;
+    }
+
+    DateTime time() {
+      final v = value();
+      return DateTime.tryParse(v) ?? (throw FormatException('$arg: not ISO 8601: $v'));
+    }
+
+    switch (arg) {
+      case '--out':
+        o.out = value();
+      case '--player':
+        o.player = intValue();
+      case '--start':
+        o.start = time();
+      case '--end':
+        o.end = time();
+      case '--no-filter':
+        o.filter = false;
+      case '--split':
+        o.split = true;
+      case '--dry-run':
+        o.dryRun = true;
+      case '--simulate':
+        o.simulate = true;
+      case '--block-size':
+        o.blockSize = intValue();
+        if (o.blockSize < 10) throw FormatException('--block-size must be at least 10');
+      case '--loss':
+        o.loss = rate();
+      case '--duplicate':
+        o.duplicate = rate();
+      case '--reorder':
+        o.reorder = rate();
+      case '--seed':
+        o.seed = intValue();
+      case '--verbose':
+        o.verbose = true;
+      case '-h' || '--help':
+        o.inputs.clear();
+        return o;
+      default:
+        if (arg.startsWith('-')) throw FormatException('Unknown option $arg');
+        o.inputs.add(arg);
+    }
+  }
+  return o;
+}
+
+Future<void> _runBatch(Directory dir, _Options options, _Totals totals) async {
+  totals.batches++;
+  if (!dir.existsSync()) {
+    stderr.writeln('${dir.path}: no such directory');
+    totals.failedBatches++;
+    return;
+  }
+
+  final files =
+      dir
+          .listSync()
+          .whereType<File>()
+          .where((f) => f.path.toLowerCase().endsWith('.bin'))
+          .toList()
+        ..sort((a, b) => a.path.compareTo(b.path));
+  stdout.writeln('${dir.path}: ${files.length} files');
+  if (files.isEmpty) {
+    totals.failedBatches++;
+    return;
+  }
+
+  final pod =
+      options.simulate
+          ? SimulatedPod(
+            blockSize: options.blockSize,
+            lossRate: options.loss,
+            duplicateRate: options.duplicate,
+            reorderRate: options.reorder,
+            seed: options.seed,
+          )
+          : null;
+  final reassembler = BlockReassembler();
+
+  final batchLogs = <SensorLog>[];
+  for (final file in files) {
+    totals.files++;
+    try {
+      final logs = _processFile(file, pod, reassembler, options, totals);
+      batchLogs.addAll(logs);
+      stdout.writeln(
+        '  ${_basename(file.path)}: ${logs.length} records',
+      );
+    } catch (e) {
+      totals.failedFiles++;
+      stderr.writeln('  ${_basename(file.path)}: $e');
+    }
+  }
+
+  if (batchLogs.isEmpty) {
+    stderr.writeln('${dir.path}: no records');
+    totals.failedBatches++;
+    return;
+  }
+
+  final batch = totals.merge.time(() => BatchSync.finalize(batchLogs));
+  totals.merge.records += batchLogs.length;
+  totals.duplicates += batch.duplicatesRemoved;
+  totals.sessions += batch.sessions.length;
+  totals.exportedRecords += batch.logs.length;
+
+  final outDir = Directory(options.out ?? '${dir.path}${Platform.pathSeparator}export');
+  final name = BatchSync.rawArchiveName(options.player, batch.logs.first.timestamp);
+  stdout.writeln(
+    '  => $name: ${batch.logs.length} records, '
+    '${batch.duplicatesRemoved} duplicates removed, '
+    '${batch.sessions.length} session(s)',
+  );
+  if (options.dryRun) return;
+
+  outDir.createSync(recursive: true);
+  await _writeCsv(File('${outDir.path}${Platform.pathSeparator}$name'), batch.logs, totals);
+  if (options.split && batch.sessions.length > 1) {
+    final player = options.player > 0 ? 'Player_${options.player}' : 'Player_Unknown';
+    for (int i = 0; i < batch.sessions.length; i++) {
+      final session = batch.sessions[i];
+      final sessionName =
+          '${player}_${BatchSync.timeLabel(session.first.timestamp)}_Session${i + 1}.csv';
+      await _writeCsv(File('${outDir.path}${Platform.pathSeparator}$sessionName'), session, totals);
+    }
+  }
+}
+
+List<SensorLog> _processFile(
+  File file,
+  SimulatedPod? pod,
+  BlockReassembler reassembler,
+  _Options options,
+  _Totals totals,
+) {
+  Uint8List bytes = totals.read.time(() => file.readAsBytesSync());
+  totals.read.bytes += bytes.length;
+  totals.bytes += bytes.length;
+
+  if (pod != null) {
+    bytes = totals.link.time(() {
+      ReassembledMessage? message;
+      for (final block in pod.transmit(bytes)) {
+        message = reassembler.add(block) ?? message;
+      }
+      message ??= reassembler.finish();
+      if (message == null) throw StateError('transfer never started');
+      totals.blocks += message.blocks;
+      totals.missingBlocks += message.missingBlocks;
+      totals.duplicateBlocks += message.duplicateBlocks;
+      return Uint8List.sublistView(message.payload, 1);
+    });
+    totals.link.bytes += bytes.length;
+  }
+
+  final parsed = totals.parse.time(() => BinaryParser.parse(bytes));
+  totals.parse.bytes += bytes.length;
+  totals.parse.records += parsed.logs.length;
+  totals.parsedRecords += parsed.logs.length;
+  if (parsed.logs.isEmpty) throw StateError('no valid sensor data');
+
+  List<SensorLog> logs = parsed.logs;
+  if (options.filter) {
+    logs = totals.filter.time(() {
+      try {
+        return FilterPipeline.processParsed(parsed).logs;
+      } catch (e) {
+        // Same fallback as the app: keep the raw logs rather than lose data
+        PodLogger.error('sync', 'Filter error', detail: '$e');
+        return parsed.logs;
+      }
+    });
+    totals.filter.records += parsed.logs.length;
+  }
+
+  final start = options.start;
+  final end = options.end;
+  if (start != null || end != null) {
+    logs =
+        logs
+            .where(
+              (l) =>
+                  (start == null || !l.timestamp.isBefore(start)) &&
+                  (end == null || l.timestamp.isBefore(end)),
+            )
+            .toList();
+  }
+  return logs;
+}
+
+Future<void> _writeCsv(File file, List<SensorLog> logs, _Totals totals) async {
+  totals.write.watch.start();
+  final sink = file.openWrite();
+  SensorLogCsv.write(sink, logs);
+  await sink.close();
+  totals.write.watch.stop();
+  totals.write.records += logs.length;
+  totals.write.bytes += file.lengthSync();
+}
+
+void _printSummary(_Totals t, Duration wall, _Options options) {
+  final seconds = wall.inMicroseconds / 1e6;
+  stdout.writeln('');
+  stdout.writeln(
+    '${t.batches} batch(es), ${t.files} files (${t.failedFiles} failed), '
+    '${_mb(t.bytes)} MB in ${seconds.toStringAsFixed(2)} s '
+    '= ${_rate(t.bytes / 1e6, seconds)} MB/s',
+  );
+  stdout.writeln(
+    'records: ${t.parsedRecords} parsed, ${t.exportedRecords} exported, '
+    '${t.duplicates} duplicates, ${t.sessions} session(s)',
+  );
+  if (options.simulate) {
+    stdout.writeln(
+      'link: ${t.blocks} blocks, ${t.missingBlocks} missing, '
+      '${t.duplicateBlocks} duplicate',
+    );
+  }
+  stdout.writeln('stage      time (ms)      MB/s   records/s');
+  for (final stage in t.stages) {
+    final s = stage.watch.elapsedMicroseconds / 1e6;
+    if (s == 0) continue;
+    stdout.writeln(
+      '${stage.name.padRight(8)}'
+      '${(s * 1000).toStringAsFixed(1).padLeft(12)}'
+      '${(stage.bytes > 0 ? _rate(stage.bytes / 1e6, s) : '-').padLeft(10)}'
+      '${(stage.records > 0 ? _rate(stage.records.toDouble(), s) : '-').padLeft(12)}',
+    );
+  }
+}
+
+String _mb(int bytes) => (bytes / 1e6).toStringAsFixed(1);
+
+String _rate(double amount, double seconds) =>
+    seconds > 0 ? (amount / seconds).toStringAsFixed(amount / seconds >= 100 ? 0 : 1) : '-';
+
+String _basename(String path) => path.split(RegExp(r'[\\/]')).last;
@@ -12,17 +12,30 @@ export 'providers/pod_notifier.dart';
 
 // Transport
 export 'transport/packet_reassembler.dart';
+export 'transport/transfer_integrity.dart';
+export 'transport/live_metrics.dart';
+export 'transport/block_reassembler.dart';
+export 'transport/simulated_pod.dart';
 
 // Utils
 export 'utils/ble_command_queue.dart';
 export 'utils/logs_binary_parser.dart';
+export 'utils/record_anomalies.dart';
+export 'utils/data_quality_report.dart';
+export 'utils/sanity_kernel.dart';
 export 'utils/usb_file_predictor.dart';
 export 'utils/trajectory_filter.dart';
 export 'utils/butterworth_filter.dart';
+export 'utils/log_resampler.dart';
+export 'utils/squad_alignment.dart';
+export 'utils/squad_metrics.dart';
+export 'utils/event_detector.dart';
 export 'utils/filter_pipeline.dart';
 export 'utils/session_cluster.dart';
 export 'utils/pod_logger.dart';
+export 'utils/sensor_log_csv.dart';
 
 // Services
 export 'services/usb_file_processor.dart';
-export 'services/storage_service.dart';
\ No newline at end of file
+export 'services/storage_service.dart';
+export 'services/batch_sync.dart';
\ No newline at end of file
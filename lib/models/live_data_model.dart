@@ -59,6 +59,11 @@ class LiveTelemetry {
   ///Byte Offset 68            
   final double gpsCourse;           
 
+  // --- NATIVE JITTER BUFFER ---
+  ///Byte Offset 72 (optional). True when the native jitter buffer
+  ///interpolated this sample to cover a lost packet.
+  final bool isConcealed;
+
   LiveTelemetry({
     required this.kernelTickCount,
     required this.batteryVoltage,
@@ -79,6 +84,7 @@ class LiveTelemetry {
     required this.gpsSatellites,
     required this.gpsSpeed,
     required this.gpsCourse,
+    this.isConcealed = false,
   });
   ///Supply a full packet of live data streamed from the pod and transforms it into a LiveTelemetry object.
   ///The function uses little Endian decoding as specified in pod documents.
@@ -123,6 +129,9 @@ class LiveTelemetry {
       gpsSatellites: getUint8(63),
       gpsSpeed: getFloat(64),
       gpsCourse: getFloat(68),
+
+      //Appended by the native jitter buffer
+      isConcealed: bytes.length > 72 && getUint8(72) & 0x01 != 0,
     );
   }
 
@@ -1,5 +1,6 @@
 import 'package:metric_athlete_pod_ble/models/live_data_model.dart';
 import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/transport/live_metrics.dart';
 
 ///Class used to store the different states and data associated with a pod.
 ///Main class used by the provider to determine state and program flow.
@@ -27,6 +28,9 @@ class PodState {
   final List<LiveTelemetry> telemetryHistory;
   ///Flag used to tell the notifier to start or stop recording the live data to a .csv file.
   final bool isRecording;
+  ///Latest native live metrics snapshot (0xDC). Null until the native side
+  ///publishes one; see `setLiveMetrics` on the platform interface.
+  final LiveMetrics? liveMetrics;
 
   // --- Settings ---
   ///Flag to determine if the settings is being retrieved from the pod.
@@ -74,6 +78,7 @@ class PodState {
     this.latestTelemetry,
     this.telemetryHistory = const [],
     this.isRecording = false,
+    this.liveMetrics,
     this.isLoadingSettings = false,
     this.settingsPlayerNumber = 0,
     this.settingsLogInterval = 100, // Default 10Hz
@@ -96,6 +101,7 @@ class PodState {
     LiveTelemetry? latestTelemetry,
     List<LiveTelemetry>? telemetryHistory,
     bool? isRecording,
+    LiveMetrics? liveMetrics,
     bool? isLoadingSettings,
     int? settingsPlayerNumber,
     int? settingsLogInterval,
@@ -115,6 +121,7 @@ class PodState {
       latestTelemetry: latestTelemetry ?? this.latestTelemetry,
       telemetryHistory: telemetryHistory ?? this.telemetryHistory,
       isRecording: isRecording ?? this.isRecording,
+      liveMetrics: liveMetrics ?? this.liveMetrics,
       isLoadingSettings: isLoadingSettings ?? this.isLoadingSettings,
       settingsPlayerNumber: settingsPlayerNumber ?? this.settingsPlayerNumber,
       settingsLogInterval: settingsLogInterval ?? this.settingsLogInterval,
@@ -98,12 +98,212 @@ class MethodChannelPodConnector extends PodConnectorPlatform {
     });
   }
 
+  /// Queues a multi-file download on the native side.
+  @override
+  Future<void> downloadFiles(List<String> filenames, int start, int end, {int window = 2}) async {
+    await methodChannel.invokeMethod<void>('downloadFiles', {
+      'filenames': filenames,
+      'filterStart': start,
+      'filterEnd': end,
+      'window': window,
+    });
+  }
+
+  /// Releases batch files up to [index] so the native queue can continue.
+  @override
+  Future<void> acknowledgeBatchFile(int index) async {
+    await methodChannel.invokeMethod<void>('acknowledgeBatchFile', index);
+  }
+
   /// Cancels an in-progress file download on the native side.
   @override
   Future<void> cancelDownload() async {
     await methodChannel.invokeMethod<void>('cancelDownload');
   }
 
+  /// Reads the native per-pod performance history.
+  /// Omitting [deviceId] returns a summary for every pod seen so far.
+  @override
+  Future<List<Map<String, dynamic>>> getPodHistory({String? deviceId}) async {
+    final result = await methodChannel.invokeMethod<List<dynamic>>('getPodHistory', deviceId);
+    return (result ?? [])
+        .map((e) => Map<String, dynamic>.from(e as Map))
+        .toList();
+  }
+
+  /// Sets the idle connection-parameter downgrade delay on the native side.
+  @override
+  Future<void> setPowerPolicy({required int idleDowngradeMs}) async {
+    await methodChannel.invokeMethod<void>('setPowerPolicy', {
+      'idleDowngradeMs': idleDowngradeMs,
+    });
+  }
+
+  /// Reads active vs idle time for the current connection.
+  @override
+  Future<Map<String, dynamic>> getPowerStats() async {
+    final result = await methodChannel.invokeMethod<Map<dynamic, dynamic>>('getPowerStats');
+    return Map<String, dynamic>.from(result ?? {});
+  }
+
+  /// Enables or disables the native live metrics snapshots.
+  @override
+  Future<void> setLiveMetrics({
+    required bool enabled,
+    int publishIntervalMs = 250,
+    bool forwardPackets = true,
+  }) async {
+    await methodChannel.invokeMethod<void>('setLiveMetrics', {
+      'enabled': enabled,
+      'publishIntervalMs': publishIntervalMs,
+      'forwardPackets': forwardPackets,
+    });
+  }
+
+  /// Zeroes the native live metric totals.
+  @override
+  Future<void> resetLiveMetrics() async {
+    await methodChannel.invokeMethod<void>('resetLiveMetrics');
+  }
+
+  /// Enables or disables the native live-stream jitter buffer.
+  @override
+  Future<void> setLiveJitterBuffer({
+    required bool enabled,
+    int latencyMs = 200,
+    int maxConcealMs = 500,
+    int intervalMs = 0,
+  }) async {
+    await methodChannel.invokeMethod<void>('setLiveJitterBuffer', {
+      'enabled': enabled,
+      'latencyMs': latencyMs,
+      'maxConcealMs': maxConcealMs,
+      'intervalMs': intervalMs,
+    });
+  }
+
+  /// Reads loss and delay statistics of the live jitter buffer.
+  @override
+  Future<Map<String, dynamic>> getLiveJitterStats() async {
+    final result = await methodChannel.invokeMethod<Map<dynamic, dynamic>>(
+      'getLiveJitterStats',
+    );
+    return Map<String, dynamic>.from(result ?? {});
+  }
+
+  /// Starts or stops the shared-memory live telemetry export.
+  @override
+  Future<Map<String, dynamic>> setLiveTelemetryExport({
+    required bool enabled,
+    String? name,
+    int podSlots = 8,
+    int ringRecords = 1024,
+  }) async {
+    final result = await methodChannel.invokeMethod<Map<dynamic, dynamic>>(
+      'setLiveTelemetryExport',
+      {
+        'enabled': enabled,
+        if (name != null) 'name': name,
+        'podSlots': podSlots,
+        'ringRecords': ringRecords,
+      },
+    );
+    return Map<String, dynamic>.from(result ?? {});
+  }
+
+  /// Starts or stops recording the native session for deterministic replay.
+  @override
+  Future<Map<String, dynamic>> setSessionRecording({
+    required bool enabled,
+    String? path,
+  }) async {
+    final result = await methodChannel.invokeMethod<Map<dynamic, dynamic>>(
+      'setSessionRecording',
+      {
+        'enabled': enabled,
+        if (path != null) 'path': path,
+      },
+    );
+    return Map<String, dynamic>.from(result ?? {});
+  }
+
+  /// Reads the native callback queue depth and backpressure counters.
+  @override
+  Future<Map<String, dynamic>> getDispatcherStats() async {
+    final result = await methodChannel.invokeMethod<Map<dynamic, dynamic>>(
+      'getDispatcherStats',
+    );
+    return Map<String, dynamic>.from(result ?? {});
+  }
+
+  /// Applies pod settings natively and waits for the pod to confirm them.
+  @override
+  Future<Map<String, dynamic>> applyPodSettings({
+    int? playerNumber,
+    int? logIntervalMs,
+    Duration timeout = const Duration(seconds: 3),
+  }) async {
+    final result = await methodChannel.invokeMethod<Map<dynamic, dynamic>>(
+      'applyPodSettings',
+      {
+        if (playerNumber != null) 'playerNumber': playerNumber,
+        if (logIntervalMs != null) 'logIntervalMs': logIntervalMs,
+        'timeoutMs': timeout.inMilliseconds,
+      },
+    );
+    return Map<String, dynamic>.from(result ?? {});
+  }
+
+  /// Reads the native per-command round-trip statistics.
+  @override
+  Future<Map<String, dynamic>> getCommandStats() async {
+    final result = await methodChannel.invokeMethod<Map<dynamic, dynamic>>(
+      'getCommandStats',
+    );
+    return Map<String, dynamic>.from(result ?? {});
+  }
+
+  /// Deletes files from the connected pod natively, confirmed by one listing.
+  @override
+  Future<Map<String, dynamic>> deletePodFiles(
+    List<String> filenames, {
+    Duration timeout = const Duration(seconds: 15),
+  }) async {
+    final result = await methodChannel.invokeMethod<Map<dynamic, dynamic>>(
+      'deletePodFiles',
+      {'filenames': filenames, 'timeoutMs': timeout.inMilliseconds},
+    );
+    return Map<String, dynamic>.from(result ?? {});
+  }
+
+  /// Configures a list of pods natively, several connections at a time.
+  @override
+  Future<Map<String, dynamic>> configureFleet(
+    List<Map<String, dynamic>> pods, {
+    int maxConnections = 4,
+    Duration timeout = const Duration(seconds: 3),
+    Duration connectTimeout = const Duration(seconds: 10),
+    Duration deleteTimeout = const Duration(seconds: 15),
+  }) async {
+    final result = await methodChannel.invokeMethod<Map<dynamic, dynamic>>(
+      'configureFleet',
+      {
+        'pods': pods,
+        'maxConnections': maxConnections,
+        'timeoutMs': timeout.inMilliseconds,
+        'connectTimeoutMs': connectTimeout.inMilliseconds,
+        'deleteTimeoutMs': deleteTimeout.inMilliseconds,
+      },
+    );
+    return Map<String, dynamic>.from(result ?? {});
+  }
+
+  /// Cancels the running native fleet configuration.
+  @override
+  Future<void> cancelFleetConfig() async {
+    await methodChannel.invokeMethod<void>('cancelFleetConfig');
+  }
+
   /// Requests the "Unrestricted" battery optimization permission dialog on Android.
   @override
   Future<void> requestBatteryExemption() async {
@@ -62,6 +62,9 @@ abstract class PodConnectorPlatform extends PlatformInterface {
   }
 
   /// connects to a specific device using its ID (MAC Address or UUID).
+  ///
+  /// On Windows the future completes only once the link is ready (services
+  /// discovered and the initial buffer-clear acknowledged by the pod).
   Future<void> connect(String deviceId) {
     throw UnimplementedError('connect() has not been implemented.');
   }
@@ -73,6 +76,8 @@ abstract class PodConnectorPlatform extends PlatformInterface {
 
   /// Sends a raw byte command to the connected Pod.
   /// (e.g. `[0x05, 0x00]` to get file list).
+  ///
+  /// On Windows the future completes when the pod acknowledges the write.
   Future<void> writeCommand(Uint8List bytes) {
     throw UnimplementedError('writeCommand() has not been implemented.');
   }
@@ -86,11 +91,224 @@ abstract class PodConnectorPlatform extends PlatformInterface {
     throw UnimplementedError('downloadFile() has not been implemented.');
   }
 
+  /// Downloads several files back to back, queued on the native side.
+  ///
+  /// The next file is requested as soon as the pod is ready after the previous
+  /// one, without a round trip through Dart. Payloads arrive on [payloadStream]
+  /// in [filenames] order (a skipped file yields a single `0xDA` payload), each
+  /// preceded by a `"Downloading File i/n"` status; `"Batch Complete"` follows
+  /// the last one. Smart Peek applies the [start] / [end] filter to every file.
+  ///
+  /// At most [window] delivered files may be outstanding before the queue
+  /// pauses until [acknowledgeBatchFile] is called. [cancelDownload] aborts
+  /// the whole batch. Windows only.
+  Future<void> downloadFiles(List<String> filenames, int start, int end, {int window = 2}) {
+    throw UnimplementedError('downloadFiles() has not been implemented.');
+  }
+
+  /// Tells the native batch queue that files up to [index] (1-based) have
+  /// been consumed, freeing room in the [downloadFiles] window.
+  Future<void> acknowledgeBatchFile(int index) {
+    throw UnimplementedError('acknowledgeBatchFile() has not been implemented.');
+  }
+
   /// Cancels an in-progress file download on the native side.
   Future<void> cancelDownload() {
     throw UnimplementedError('cancelDownload() has not been implemented.');
   }
 
+  /// Returns the persisted per-pod connection/download performance history.
+  ///
+  /// Each entry summarises one pod: connect latency and throughput percentiles,
+  /// packet loss, retries, watchdog triggers, last negotiated MTU and a
+  /// `degrading` flag when recent downloads are markedly worse than the pod's
+  /// own baseline. Pass [deviceId] to query a single pod.
+  Future<List<Map<String, dynamic>>> getPodHistory({String? deviceId}) {
+    throw UnimplementedError('getPodHistory() has not been implemented.');
+  }
+
+  /// Configures the download-scoped power policy.
+  ///
+  /// The system wake lock is only held while a file transfer is in flight.
+  /// [idleDowngradeMs] is how long the link stays idle after a transfer before
+  /// the native side requests power-optimised connection parameters
+  /// (0 disables the downgrade). Windows only.
+  Future<void> setPowerPolicy({required int idleDowngradeMs}) {
+    throw UnimplementedError('setPowerPolicy() has not been implemented.');
+  }
+
+  /// Returns measured radio duty for the current connection:
+  /// `connectedMs`, `activeMs` (inside transfers), `idleMs`,
+  /// `holdingWakeLock` and `powerOptimized`. Windows only.
+  Future<Map<String, dynamic>> getPowerStats() {
+    throw UnimplementedError('getPowerStats() has not been implemented.');
+  }
+
+  /// Configures native live metrics on the 0x01 stream.
+  ///
+  /// While [enabled], the native side keeps running distance, current/peak
+  /// speed, speed-zone times, player load and impact counts for the pod and
+  /// sends a `LiveMetrics` snapshot (message type 0xDC) at most every
+  /// [publishIntervalMs]. With [forwardPackets] false the raw 0x01 packets
+  /// are no longer delivered to Dart. Enabling resets the totals.
+  /// Windows only.
+  Future<void> setLiveMetrics({
+    required bool enabled,
+    int publishIntervalMs = 250,
+    bool forwardPackets = true,
+  }) {
+    throw UnimplementedError('setLiveMetrics() has not been implemented.');
+  }
+
+  /// Zeroes the native live metric totals. Windows only.
+  Future<void> resetLiveMetrics() {
+    throw UnimplementedError('resetLiveMetrics() has not been implemented.');
+  }
+
+  /// Configures the native live-stream jitter buffer.
+  ///
+  /// While [enabled], live 0x01 packets are reordered by kernel tick and
+  /// released at the pod's own cadence, [latencyMs] behind the fastest
+  /// delivery. Lost packets in gaps up to [maxConcealMs] are interpolated
+  /// (`LiveTelemetry.isConcealed`); longer gaps are skipped. [intervalMs] 0
+  /// learns the sample interval from the stream. Windows only.
+  Future<void> setLiveJitterBuffer({
+    required bool enabled,
+    int latencyMs = 200,
+    int maxConcealMs = 500,
+    int intervalMs = 0,
+  }) {
+    throw UnimplementedError('setLiveJitterBuffer() has not been implemented.');
+  }
+
+  /// Returns jitter buffer statistics: `received`, `duplicates`,
+  /// `reordered`, `late`, `lost`, `concealed`, `underruns`, `jitterMs`,
+  /// `meanDelayMs`, `maxDelayMs`, `intervalMs` and `buffered`. Windows only.
+  Future<Map<String, dynamic>> getLiveJitterStats() {
+    throw UnimplementedError('getLiveJitterStats() has not been implemented.');
+  }
+
+  /// Publishes the live stream into a named shared-memory segment that
+  /// other local processes can poll without going through Flutter.
+  ///
+  /// While [enabled], every in-order live sample (after the jitter buffer)
+  /// is decoded into a per-pod ring of [ringRecords] records, with room for
+  /// [podSlots] pods. [name] defaults to `Local\pod_ble_live`. The layout
+  /// and a reader library are in `windows/live_telemetry_segment.h`.
+  /// Returns the segment's `name` and size in `bytes`; empty when disabling.
+  /// Windows only.
+  Future<Map<String, dynamic>> setLiveTelemetryExport({
+    required bool enabled,
+    String? name,
+    int podSlots = 8,
+    int ringRecords = 1024,
+  }) {
+    throw UnimplementedError('setLiveTelemetryExport() has not been implemented.');
+  }
+
+  /// Records the native session (pod notifications, download requests,
+  /// acks, writes, and the statuses and payloads sent back) to a text script
+  /// that `pod_ble_replay` can replay deterministically on a virtual clock.
+  ///
+  /// Enabling starts a new recording to [path] (default: a new file under
+  /// `%LOCALAPPDATA%\metric_athlete_pod_ble\sessions`) and returns its
+  /// `path`. Disabling writes the recording out and returns its `path` and
+  /// number of `events`; empty if nothing was being recorded. Windows only.
+  Future<Map<String, dynamic>> setSessionRecording({
+    required bool enabled,
+    String? path,
+  }) {
+    throw UnimplementedError('setSessionRecording() has not been implemented.');
+  }
+
+  /// Returns native callback dispatch statistics: `pending`, `highWater`,
+  /// `capacity`, `dispatched`, `waited` and `rejected`. The plugin only
+  /// posts channel drain tasks there, so `waited` stays 0 and `rejected`
+  /// counts refused drain wake-ups, which the next event retries.
+  ///
+  /// `channels` maps each event queue (`live`, `scan`, `status`, `reply`,
+  /// `payload`) to its `policy`, `capacity`, `memoryBudget`, `pending`,
+  /// `highWater`, `accepted`, `delivered`, `dropped`, `coalesced`,
+  /// `spilled`, `spillErrors`, `memoryBytes` and `spillBytes`. Windows only.
+  Future<Map<String, dynamic>> getDispatcherStats() {
+    throw UnimplementedError('getDispatcherStats() has not been implemented.');
+  }
+
+  /// Writes the given settings natively and completes as soon as a Get
+  /// Settings reply shows them, re-asking while replies are stale until
+  /// [timeout]. With neither value given it reads the current settings.
+  ///
+  /// Returns `verified`, `timedOut`, `probes`, `latencyMs` and, once the pod
+  /// has answered, its `playerNumber` and `logIntervalMs`. Each reply also
+  /// arrives on the payload stream as a 0x05 message. Throws a
+  /// `PlatformException` with code `BUSY` during a file transfer. Windows
+  /// only.
+  Future<Map<String, dynamic>> applyPodSettings({
+    int? playerNumber,
+    int? logIntervalMs,
+    Duration timeout = const Duration(seconds: 3),
+  }) {
+    throw UnimplementedError('applyPodSettings() has not been implemented.');
+  }
+
+  /// Returns round-trip statistics per command (`getSettings`,
+  /// `setPlayerNumber`, ...): `sent`, `answered`, `timeouts`, `mismatches`
+  /// (stale replies while verifying a set), `lastMs`, `meanMs` and `maxMs`.
+  /// Set commands and deletes are timed to the reply that verified them.
+  /// Windows only.
+  Future<Map<String, dynamic>> getCommandStats() {
+    throw UnimplementedError('getCommandStats() has not been implemented.');
+  }
+
+  /// Deletes [filenames] (names or file list entries such as
+  /// `"LOG1.BIN (12.0 KB)"`) from the connected pod: every Delete File
+  /// command is written at once, then a single file list read confirms them,
+  /// re-read while it still shows a file until [timeout].
+  ///
+  /// Returns `verified`, `timedOut`, `deleted`, `remaining`, `catalogReads`,
+  /// `latencyMs` and, once the pod has listed its files, `filesLeft` and
+  /// `bytesLeft`. The listing also arrives on the payload stream as a 0x02
+  /// message. Throws a `PlatformException` with code `BUSY` during a file
+  /// transfer. Windows only.
+  Future<Map<String, dynamic>> deletePodFiles(
+    List<String> filenames, {
+    Duration timeout = const Duration(seconds: 15),
+  }) {
+    throw UnimplementedError('deletePodFiles() has not been implemented.');
+  }
+
+  /// Applies settings to and clears files from many pods at once. Each
+  /// entry of [pods] has an `id`, the `playerNumber` and/or `logIntervalMs`
+  /// to set and the `deleteFiles` to remove; an entry with only
+  /// `deleteFiles` skips the settings step. Up to [maxConnections] pods (at
+  /// most 7) are connected at a time, each on its own connection beside the
+  /// main one, verified as in [applyPodSettings] and [deletePodFiles] (with
+  /// [timeout] and [deleteTimeout]) and disconnected again; a failed
+  /// connect is retried once.
+  ///
+  /// Completes when every pod is done with `totalMs`, `verified`, `failed`,
+  /// `peakConnections`, `filesDeleted`, `cancelled` and `pods`: one map per
+  /// entry, in order, with the [applyPodSettings] fields plus `id`,
+  /// `connected`, `connectAttempts`, `connectMs`, `totalMs`, `deletion` (the
+  /// [deletePodFiles] result) and, for a pod that failed, `error`. A pod's
+  /// `verified` covers every step it asked for. Throws a `PlatformException`
+  /// with code `BUSY` while another fleet job runs. Windows only.
+  Future<Map<String, dynamic>> configureFleet(
+    List<Map<String, dynamic>> pods, {
+    int maxConnections = 4,
+    Duration timeout = const Duration(seconds: 3),
+    Duration connectTimeout = const Duration(seconds: 10),
+    Duration deleteTimeout = const Duration(seconds: 15),
+  }) {
+    throw UnimplementedError('configureFleet() has not been implemented.');
+  }
+
+  /// Stops the running [configureFleet] job; it completes with `cancelled`
+  /// set. Windows only.
+  Future<void> cancelFleetConfig() {
+    throw UnimplementedError('cancelFleetConfig() has not been implemented.');
+  }
+
   /// Triggers the system dialog to request "Unrestricted" battery optimization.
   ///
   /// This is crucial for preventing Android Doze mode from throttling Bluetooth
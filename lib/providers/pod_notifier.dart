@@ -1,9 +1,11 @@
 import 'dart:async';
+import 'dart:collection';
 import 'dart:convert';
 import 'dart:io';
 import 'dart:typed_data';
 
 import 'package:flutter/foundation.dart';
+import 'package:flutter/services.dart';
 import 'package:flutter_riverpod/flutter_riverpod.dart';
 import 'package:permission_handler/permission_handler.dart';
 import 'package:metric_athlete_pod_ble/models/session_block_model.dart';
@@ -13,6 +15,7 @@ import 'package:shared_preferences/shared_preferences.dart';
 
 import 'package:metric_athlete_pod_ble/utils/ble_command_queue.dart';
 import 'package:metric_athlete_pod_ble/utils/filter_pipeline.dart';
+import 'package:metric_athlete_pod_ble/utils/pod_handover.dart';
 import 'package:metric_athlete_pod_ble/utils/pod_protocol_decoder.dart';
 
 /// The central State Management class for the Pod Connector application.
@@ -55,10 +58,25 @@ class PodNotifier extends Notifier<PodState> {
   // Buffer to hold live telemetry data during a recording session.
   List<LiveTelemetry> _liveSessionBuffer = [];
 
+  // Firmware-ready handshake and the skip markers owed to our own cancels.
+  // Only the Windows core probes; elsewhere the legacy delay is all there is.
+  final _handover = PodHandover(
+    fallback:
+        Platform.isWindows
+            ? PodHandover.probedFallback
+            : PodHandover.legacyFallback,
+  );
+
   // Completer used to turn the listener-based download flow into a Future-based awaitable.
   // This allows the UI to 'await' a file download even though the data comes in asynchronously via streams.
   Completer<List<SensorLog>>? _syncCompleter;
 
+  // Native multi-file pipeline: one completer per queued file, completed in
+  // request order by the 0x03 / 0xDA handlers. Dart acknowledges each file
+  // after processing; at most [_batchWindow] may be pending natively.
+  static const _batchWindow = 2;
+  final Queue<Completer<List<SensorLog>>> _batchCompleters = Queue();
+
   /// Raw (pre-Kalman) sensor logs from the most recent download.
   ///
   /// Available after [downloadLogFile] completes. Use these for haversine
@@ -168,6 +186,8 @@ class PodNotifier extends Notifier<PodState> {
       case 0x03:
         if (msg.payload is List<SensorLog>) {
           final rawLogs = msg.payload as List<SensorLog>;
+          // Claimed before any await so pipelined files keep their order
+          final completer = _takeDownloadCompleter();
 
           if (rawLogs.isNotEmpty) {
             // Store raw (pre-Kalman) logs for distance calculation.
@@ -181,10 +201,16 @@ class PodNotifier extends Notifier<PodState> {
               // Uses FilterPipeline with Kalman+RTS DISABLED by default.
               // Raw GPS positions give ~10% more accurate haversine distance.
               // Butterworth IMU filter still runs for accurate player load.
-              final FilterPipelineResult result = await compute(
-                FilterPipeline.process,
-                rawLogs,
-              );
+              // Reuses the parser's anomaly flags so the sanity check does
+              // not re-validate every record.
+              final anomalies = msg.anomalies;
+              final FilterPipelineResult result =
+                  anomalies != null && anomalies.length == rawLogs.length
+                      ? await compute(
+                        FilterPipeline.processParsed,
+                        ParsedLogs(logs: rawLogs, anomalies: anomalies),
+                      )
+                      : await compute(FilterPipeline.process, rawLogs);
 
               // --- HEALTH CHECK ---
               if (result.healthScore < 60.0) {
@@ -199,7 +225,8 @@ class PodNotifier extends Notifier<PodState> {
                 'sync',
                 'Filter complete',
                 detail:
-                    'logs=${result.logs.length}, health=${result.healthScore.toInt()}%',
+                    'logs=${result.logs.length}, health=${result.healthScore.toInt()}%, '
+                    'rejected=${result.rejectedCount}',
               );
 
               state = state.copyWith(
@@ -208,14 +235,14 @@ class PodNotifier extends Notifier<PodState> {
               );
 
               // Complete the pending Future waiting in `downloadLogFile` with the SMOOTHED logs
-              if (_syncCompleter != null && !_syncCompleter!.isCompleted) {
-                _syncCompleter!.complete(result.logs);
+              if (completer != null && !completer.isCompleted) {
+                completer.complete(result.logs);
               }
             } catch (e) {
               PodLogger.error('sync', 'Filter error', detail: '$e');
               // Fallback: If filter crashes, return raw logs so user doesn't lose data
-              if (_syncCompleter != null && !_syncCompleter!.isCompleted) {
-                _syncCompleter!.complete(rawLogs);
+              if (completer != null && !completer.isCompleted) {
+                completer.complete(rawLogs);
               }
             }
           } else {
@@ -226,8 +253,8 @@ class PodNotifier extends Notifier<PodState> {
             );
             state = state.copyWith(statusMessage: "Data Corrupt or Empty");
             // Signal failure to the download function
-            if (_syncCompleter != null && !_syncCompleter!.isCompleted) {
-              _syncCompleter!.complete([]);
+            if (completer != null && !completer.isCompleted) {
+              completer.complete([]);
             }
           }
         }
@@ -246,11 +273,21 @@ class PodNotifier extends Notifier<PodState> {
         }
         break;
 
+      // Native live metrics snapshot
+      case 0xdc:
+        if (msg.payload is LiveMetrics) {
+          state = state.copyWith(liveMetrics: msg.payload as LiveMetrics);
+        }
+        break;
+
       // Skipped file during download process
       case 0xda:
+        // The answer to our own cancel, not to the request that followed it
+        if (_handover.takeOwnSkip()) break;
         state = state.copyWith(statusMessage: "Skipped: Out of Range");
-        if (_syncCompleter != null && !_syncCompleter!.isCompleted) {
-          _syncCompleter!.complete([]);
+        final completer = _takeDownloadCompleter();
+        if (completer != null && !completer.isCompleted) {
+          completer.complete([]);
         }
         break;
 
@@ -265,6 +302,12 @@ class PodNotifier extends Notifier<PodState> {
   /// Sets up listeners for the native platform streams.
   void _setupNativeListeners() {
     _statusSub = _native.statusStream.listen((status) {
+      // Internal handshake signal — not shown in the UI
+      if (status == 'Pod Ready') {
+        _handover.markReady();
+        return;
+      }
+
       // Log all native status messages for diagnostics
       if (status.startsWith('Downloading')) {
         // Don't spam logs with progress updates — only log milestones
@@ -443,9 +486,31 @@ class PodNotifier extends Notifier<PodState> {
     _protocolHandler.handleMessage(0x02, Uint8List.fromList(reassembled));
   }
 
+  /// Cancels the native transfer. Its 0xDA answers this cancel and is
+  /// dropped by the 0xDA handler instead of completing the next download.
+  Future<void> _cancelNativeDownload() async {
+    _handover.cancelIssued();
+    await _native.cancelDownload();
+  }
+
+  /// Returns the completer owed the next downloaded (or skipped) file: the
+  /// head of the native batch queue if one is running, else the single-file one.
+  Completer<List<SensorLog>>? _takeDownloadCompleter() {
+    if (_batchCompleters.isNotEmpty) return _batchCompleters.removeFirst();
+    return _syncCompleter;
+  }
+
+  void _failBatch(String reason) {
+    while (_batchCompleters.isNotEmpty) {
+      final completer = _batchCompleters.removeFirst();
+      if (!completer.isCompleted) completer.completeError(reason);
+    }
+  }
+
   /// Resets the connection state when the Pod disconnects.
   void _resetConnectionState() {
     _hasAutoConnected = false;
+    _handover.reset();
     _liveSessionBuffer.clear();
     _commandQueue.clear();
     _fileListReassemblyActive = false;
@@ -460,6 +525,7 @@ class PodNotifier extends Notifier<PodState> {
       );
       _syncCompleter!.completeError("Disconnected during sync");
     }
+    _failBatch("Disconnected during sync");
 
     state = PodState(
       scannedDevices: state.scannedDevices,
@@ -705,6 +771,8 @@ class PodNotifier extends Notifier<PodState> {
   }) async {
     _isCancellingDownload = false;
     List<SensorLog> masterSessionLogs = [];
+    final syncStopwatch = Stopwatch()..start();
+    var handoverTotal = Duration.zero;
 
     PodLogger.info(
       'sync',
@@ -712,16 +780,29 @@ class PodNotifier extends Notifier<PodState> {
       detail: '${filesToSync.length} files',
     );
 
+    // Native pipeline first; anything it could not deliver goes file by file
+    final pipelined = await _downloadFilesPipelined(
+      filesToSync,
+      masterSessionLogs,
+      start: start,
+      end: end,
+    );
+
     // Download loop
-    for (int i = 0; i < filesToSync.length; i++) {
+    for (int i = pipelined; i < filesToSync.length; i++) {
       // Check cancellation flag before starting the next file
       if (_isCancellingDownload) break;
 
-      // --- HANDOVER GAP FIX ---
-      // Give the Pod firmware 500ms to finish closing the previous file pointer
-      if (i > 0) {
-        PodLogger.debug('sync', 'Handover cooldown (500ms)');
-        await Future.delayed(const Duration(milliseconds: 500));
+      // --- HANDOVER GAP ---
+      // Wait until the firmware has closed the previous file pointer
+      if (i > 0 || !_handover.isReady) {
+        final waited = await _handover.waitUntilReady();
+        handoverTotal += waited;
+        PodLogger.debug(
+          'sync',
+          'Handover',
+          detail: '${waited.inMilliseconds}ms',
+        );
       }
 
       String fileName = filesToSync[i];
@@ -750,6 +831,15 @@ class PodNotifier extends Notifier<PodState> {
       }
     }
 
+    syncStopwatch.stop();
+    PodLogger.info(
+      'sync',
+      'Batch transfer finished',
+      detail:
+          '${filesToSync.length} files in ${syncStopwatch.elapsedMilliseconds}ms '
+          '(handover ${handoverTotal.inMilliseconds}ms)',
+    );
+
     // --- 2. VALIDATION ---
     if (masterSessionLogs.isEmpty) {
       state = state.copyWith(statusMessage: "Sync Failed or Empty");
@@ -758,48 +848,32 @@ class PodNotifier extends Notifier<PodState> {
 
     state = state.copyWith(statusMessage: "Finalizing Session...");
 
-    // --- 3. DEDUPLICATION & SORTING ---
-    // Sort by time just in case files were downloaded in random order
-    masterSessionLogs.sort((a, b) => a.timestamp.compareTo(b.timestamp));
-
-    // G4: Deduplicate logs by packetId+timestamp to prevent duplicate sessions
-    // from re-downloaded files
-    final seen = <String>{};
-    final deduped = <SensorLog>[];
-    for (final log in masterSessionLogs) {
-      final key = '${log.packetId}_${log.timestamp.millisecondsSinceEpoch}';
-      if (seen.add(key)) {
-        deduped.add(log);
-      }
-    }
-    if (deduped.length < masterSessionLogs.length) {
+    // --- 3. DEDUPLICATION, SORTING & CLUSTERING ---
+    // Files may arrive in any order; G4: re-downloaded files must not
+    // produce duplicate sessions
+    final batch = BatchSync.finalize(masterSessionLogs);
+    if (batch.duplicatesRemoved > 0) {
       PodLogger.info(
         'sync',
         'Deduplicated logs',
-        detail:
-            'removed ${masterSessionLogs.length - deduped.length} duplicates',
+        detail: 'removed ${batch.duplicatesRemoved} duplicates',
       );
     }
-    masterSessionLogs = deduped;
-
-    final startTime = masterSessionLogs.first.timestamp;
-    // Format: YYYYMMDD_HHMM
-    final formattedTime =
-        "${startTime.year}${startTime.month.toString().padLeft(2, '0')}${startTime.day.toString().padLeft(2, '0')}_${startTime.hour.toString().padLeft(2, '0')}${startTime.minute.toString().padLeft(2, '0')}";
+    masterSessionLogs = batch.logs;
 
     // Naming: Player_X_YYYYMMDD_HHMM_Raw.csv
-    String pNum =
-        state.settingsPlayerNumber > 0
-            ? "Player_${state.settingsPlayerNumber}"
-            : "Player_Unknown";
-    String finalName = "${pNum}_${formattedTime}_Raw.csv";
+    final finalName = BatchSync.rawArchiveName(
+      state.settingsPlayerNumber,
+      masterSessionLogs.first.timestamp,
+    );
 
     // --- 4. SAVE RAW ARCHIVE ---
     await _storage.saveSensorLogsToCsv(masterSessionLogs, finalName);
 
     // --- 5. INTELLIGENT CLUSTERING ---
-    // Analyze the time gaps. If we find gaps > 5 minutes, split them into separate "Sessions".
-    final rawClusters = SessionClusterer.cluster(masterSessionLogs);
+    // Gaps > SessionClusterer.sessionGapThreshold split the batch into
+    // separate "Sessions".
+    final rawClusters = batch.sessions;
 
     if (rawClusters.length > 1) {
       // Multiple sessions found (e.g., Morning Run + Afternoon Run downloaded together)
@@ -867,6 +941,75 @@ class PodNotifier extends Notifier<PodState> {
   // 5. DOWNLOAD HELPER
   // ===========================================================================
 
+  /// Downloads [files] through the native batch queue
+  /// ([PodConnectorPlatform.downloadFiles]), appending their logs to [into].
+  ///
+  /// Returns how many files were handled. Platforms without the queue return 0,
+  /// and a failure mid-batch stops early so the caller can retry the rest
+  /// one file at a time.
+  Future<int> _downloadFilesPipelined(
+    List<String> files,
+    List<SensorLog> into, {
+    DateTime? start,
+    DateTime? end,
+  }) async {
+    if (files.length < 2) return 0;
+
+    final completers = [for (final _ in files) Completer<List<SensorLog>>()];
+    _batchCompleters
+      ..clear()
+      ..addAll(completers);
+    state = state.copyWith(
+      downloadedFileBytes: null,
+      statusMessage: "Requesting Data...",
+    );
+
+    try {
+      await _native.downloadFiles(
+        files,
+        start?.millisecondsSinceEpoch ?? 0,
+        end?.millisecondsSinceEpoch ?? 0,
+        window: _batchWindow,
+      );
+    } on MissingPluginException {
+      _batchCompleters.clear();
+      return 0;
+    } on UnimplementedError {
+      _batchCompleters.clear();
+      return 0;
+    }
+
+    int handled = 0;
+    for (; handled < files.length; handled++) {
+      final stopwatch = Stopwatch()..start();
+      try {
+        final fileLogs = await completers[handled].future.timeout(
+          const Duration(minutes: 45),
+        );
+        into.addAll(fileLogs);
+        PodLogger.info(
+          'sync',
+          'Download complete',
+          detail:
+              '"${files[handled]}" → ${fileLogs.length} records in ${stopwatch.elapsed.inSeconds}s (${handled + 1}/${files.length})',
+        );
+      } catch (e) {
+        PodLogger.warn(
+          'sync',
+          'Pipelined download failed',
+          detail: '"${files[handled]}": $e',
+        );
+        _failBatch("Batch aborted");
+        if (state.connectedDeviceId != null && !_isCancellingDownload) {
+          await _cancelNativeDownload();
+        }
+        break;
+      }
+      await _native.acknowledgeBatchFile(handled + 1);
+    }
+    return handled;
+  }
+
   /// Helper function that wraps the native file download stream in a [Future].
   /// Retries up to [maxRetries] times with exponential backoff on failure.
   Future<List<SensorLog>> downloadLogFile(
@@ -895,8 +1038,8 @@ class PodNotifier extends Notifier<PodState> {
           'Retry attempt',
           detail: '$attempt/$maxRetries for "$fileInfo"',
         );
-        await _native.cancelDownload();
-        await Future.delayed(const Duration(milliseconds: 500));
+        await _cancelNativeDownload();
+        await _handover.waitUntilReady();
       }
 
       _syncCompleter = Completer<List<SensorLog>>();
@@ -909,6 +1052,7 @@ class PodNotifier extends Notifier<PodState> {
       );
 
       try {
+        _handover.requestIssued();
         await _native.downloadFile(
           fileInfo,
           startMillis,
@@ -989,25 +1133,72 @@ class PodNotifier extends Notifier<PodState> {
     PodLogger.info('sync', 'File list command written to BLE');
   }
 
-  Future<void> deleteLogFile(String fileInfo) async {
+  Future<void> deleteLogFile(String fileInfo) => deleteLogFiles([fileInfo]);
+
+  /// Deletes [files] (file list entries) from the connected pod. Natively
+  /// every delete is written at once and one file list confirms them all;
+  /// elsewhere each file is deleted, waited on for 2 s and the list fetched
+  /// again.
+  Future<void> deleteLogFiles(List<String> files) async {
+    if (files.isEmpty) return;
     // 1. Optimistic UI Update
     List<String> currentFiles = List.from(state.podFiles);
-    currentFiles.remove(fileInfo);
+    currentFiles.removeWhere(files.contains);
     state = state.copyWith(podFiles: currentFiles);
 
-    // 2. Prepare Command
-    String cleanName = fileInfo.split('(')[0].trim();
-    List<int> nameBytes = ascii.encode(cleanName);
+    if (await _deleteFilesNatively(files)) return;
 
-    // Ensure 32-byte padding
-    List<int> paddedName = List<int>.filled(32, 0);
-    for (int i = 0; i < nameBytes.length && i < 32; i++) {
-      paddedName[i] = nameBytes[i];
+    for (final fileInfo in files) {
+      // 2. Prepare Command
+      String cleanName = fileInfo.split('(')[0].trim();
+      List<int> nameBytes = ascii.encode(cleanName);
+
+      // Ensure 32-byte padding
+      List<int> paddedName = List<int>.filled(32, 0);
+      for (int i = 0; i < nameBytes.length && i < 32; i++) {
+        paddedName[i] = nameBytes[i];
+      }
+
+      await _write([0x07, 0x20, ...paddedName]);
+      await Future.delayed(const Duration(seconds: 2));
+      await getLogFilesInfo();
+    }
+  }
+
+  /// Batch delete in the native layer. The confirming file list arrives as a
+  /// 0x02 payload and refreshes [PodState.podFiles] like any other. Returns
+  /// false where there is no native command layer.
+  Future<bool> _deleteFilesNatively(List<String> files) async {
+    Map<String, dynamic>? outcome;
+    try {
+      await _commandQueue.enqueue(() async {
+        outcome = await _native.deletePodFiles(files);
+      });
+    } on MissingPluginException {
+      return false;
+    } on UnimplementedError {
+      return false;
+    } catch (e) {
+      state = state.copyWith(statusMessage: "Delete Error: $e");
+      return true;
     }
 
-    await _write([0x07, 0x20, ...paddedName]);
-    await Future.delayed(const Duration(seconds: 2));
-    await getLogFilesInfo();
+    final verified = outcome?['verified'] == true;
+    final deleted = (outcome?['deleted'] as List?)?.length ?? 0;
+    PodLogger.info(
+      'sync',
+      verified ? 'Files deleted' : 'Deletes not confirmed by pod',
+      detail:
+          'deleted=$deleted/${files.length}, '
+          'latency=${(outcome?['latencyMs'] as num?)?.round()}ms, '
+          'catalogReads=${outcome?['catalogReads']}',
+    );
+    state = state.copyWith(
+      statusMessage: verified
+          ? "Deleted $deleted File${deleted == 1 ? '' : 's'}"
+          : "Delete Not Confirmed",
+    );
+    return true;
   }
 
   Future<void> cancelDownload() async {
@@ -1018,6 +1209,11 @@ class PodNotifier extends Notifier<PodState> {
     if (_syncCompleter != null && !_syncCompleter!.isCompleted) {
       _syncCompleter!.completeError("Cancelled");
     }
+    if (_batchCompleters.isNotEmpty) {
+      // Also drops the files still queued natively
+      _failBatch("Cancelled");
+      await _cancelNativeDownload();
+    }
     Future.delayed(
       const Duration(seconds: 1),
       () => _isCancellingDownload = false,
@@ -1043,6 +1239,7 @@ class PodNotifier extends Notifier<PodState> {
 
   Future<void> setPlayerNumber(int number) async {
     if (number < 1 || number > 99) return;
+    if (await _applySettingsNatively(playerNumber: number)) return;
     await _write([0x0A, 0x01, number]);
     await Future.delayed(const Duration(milliseconds: 500));
     await getDeviceSettings();
@@ -1050,6 +1247,7 @@ class PodNotifier extends Notifier<PodState> {
 
   Future<void> setLogInterval(int intervalMs) async {
     if (intervalMs < 100 || intervalMs > 1000) return;
+    if (await _applySettingsNatively(logIntervalMs: intervalMs)) return;
 
     int lsb = intervalMs & 0xFF;
     int msb = (intervalMs >> 8) & 0xFF;
@@ -1058,6 +1256,128 @@ class PodNotifier extends Notifier<PodState> {
     await Future.delayed(const Duration(milliseconds: 500));
     await getDeviceSettings();
   }
+
+  /// Applies player numbers and/or a log interval to a whole squad natively,
+  /// several pods at a time, instead of connecting to each one in turn.
+  /// [pods] entries take the `id`, `playerNumber` and `logIntervalMs` keys of
+  /// [PodConnectorPlatform.configureFleet]. Returns its report, or null where
+  /// there is no native fleet job.
+  Future<Map<String, dynamic>?> configureSquad(
+    List<Map<String, dynamic>> pods, {
+    int maxConnections = 4,
+  }) async {
+    state = state.copyWith(statusMessage: "Configuring ${pods.length} Pods");
+    try {
+      final report = await _native.configureFleet(
+        pods,
+        maxConnections: maxConnections,
+      );
+      PodLogger.info(
+        'sync',
+        'Fleet configured',
+        detail:
+            'verified=${report['verified']}, failed=${report['failed']}, '
+            'total=${(report['totalMs'] as num?)?.round()}ms',
+      );
+      state = state.copyWith(
+        statusMessage:
+            "Squad Configured: ${report['verified']}/${pods.length} Pods",
+      );
+      return report;
+    } on MissingPluginException {
+      return null;
+    } on UnimplementedError {
+      return null;
+    } catch (e) {
+      state = state.copyWith(statusMessage: "Squad Config Error: $e");
+      return null;
+    }
+  }
+
+  /// Clears files off a whole squad natively, several pods at a time, each
+  /// confirmed by one file list read. [files] maps pod ids to the file list
+  /// entries to delete. Returns the [PodConnectorPlatform.configureFleet]
+  /// report, or null where there is no native fleet job.
+  Future<Map<String, dynamic>?> clearSquadFiles(
+    Map<String, List<String>> files, {
+    int maxConnections = 4,
+  }) async {
+    state = state.copyWith(statusMessage: "Clearing ${files.length} Pods");
+    try {
+      final report = await _native.configureFleet(
+        [
+          for (final entry in files.entries)
+            {'id': entry.key, 'deleteFiles': entry.value},
+        ],
+        maxConnections: maxConnections,
+      );
+      PodLogger.info(
+        'sync',
+        'Squad files cleared',
+        detail:
+            'verified=${report['verified']}, failed=${report['failed']}, '
+            'files=${report['filesDeleted']}, '
+            'total=${(report['totalMs'] as num?)?.round()}ms',
+      );
+      state = state.copyWith(
+        statusMessage:
+            "Squad Cleared: ${report['verified']}/${files.length} Pods",
+      );
+      return report;
+    } on MissingPluginException {
+      return null;
+    } on UnimplementedError {
+      return null;
+    } catch (e) {
+      state = state.copyWith(statusMessage: "Squad Clear Error: $e");
+      return null;
+    }
+  }
+
+  /// Set-and-verify in the native layer: returns as soon as the pod reports
+  /// the new value instead of after a fixed delay and a separate read. The
+  /// replies arrive as 0x05 payloads and update the state like any other.
+  /// Returns false where there is no native command layer, so the caller
+  /// falls back to write + delay + [getDeviceSettings].
+  Future<bool> _applySettingsNatively({
+    int? playerNumber,
+    int? logIntervalMs,
+  }) async {
+    state = state.copyWith(isLoadingSettings: true);
+    Map<String, dynamic>? outcome;
+    try {
+      await _commandQueue.enqueue(() async {
+        outcome = await _native.applyPodSettings(
+          playerNumber: playerNumber,
+          logIntervalMs: logIntervalMs,
+        );
+      });
+    } on MissingPluginException {
+      return false;
+    } on UnimplementedError {
+      return false;
+    } catch (e) {
+      state = state.copyWith(
+        isLoadingSettings: false,
+        statusMessage: "Settings Error: $e",
+      );
+      return true;
+    }
+
+    final verified = outcome?['verified'] == true;
+    PodLogger.info(
+      'sync',
+      verified ? 'Settings applied' : 'Settings not confirmed by pod',
+      detail:
+          'latency=${(outcome?['latencyMs'] as num?)?.round()}ms, '
+          'probes=${outcome?['probes']}',
+    );
+    state = state.copyWith(
+      isLoadingSettings: false,
+      statusMessage: verified ? "Settings Saved" : "Settings Not Confirmed",
+    );
+    return true;
+  }
 }
 
 final podNotifierProvider = NotifierProvider<PodNotifier, PodState>(
@@ -0,0 +1,65 @@
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/session_cluster.dart';
+
+/// Outcome of merging every file of a multi-file sync.
+class BatchSyncResult {
+  /// Merged logs in time order, duplicates removed.
+  final List<SensorLog> logs;
+
+  /// Records dropped because another file already contained them.
+  final int duplicatesRemoved;
+
+  /// Sessions found by [SessionClusterer]; more than one means the batch
+  /// spans separate recordings.
+  final List<List<SensorLog>> sessions;
+
+  const BatchSyncResult({
+    required this.logs,
+    required this.duplicatesRemoved,
+    required this.sessions,
+  });
+}
+
+/// Batch-level steps of a multi-file sync: merge, deduplicate, cluster and
+/// name the archive.
+///
+/// Flutter-free so `PodNotifier.syncAllFiles` and the headless
+/// `bin/pod_batch_sync.dart` tool produce identical output.
+class BatchSync {
+  BatchSync._();
+
+  /// Sorts [logs] by time, drops records already seen (same packetId and
+  /// timestamp, e.g. from a re-downloaded file) and clusters the rest.
+  static BatchSyncResult finalize(List<SensorLog> logs) {
+    final sorted = List<SensorLog>.of(logs)
+      ..sort((a, b) => a.timestamp.compareTo(b.timestamp));
+
+    final seen = <String>{};
+    final deduped = <SensorLog>[];
+    for (final log in sorted) {
+      final key = '${log.packetId}_${log.timestamp.millisecondsSinceEpoch}';
+      if (seen.add(key)) {
+        deduped.add(log);
+      }
+    }
+
+    return BatchSyncResult(
+      logs: deduped,
+      duplicatesRemoved: sorted.length - deduped.length,
+      sessions: SessionClusterer.cluster(deduped),
+    );
+  }
+
+  /// `YYYYMMDD_HHMM` label used in export file names.
+  static String timeLabel(DateTime t) =>
+      "${t.year}${t.month.toString().padLeft(2, '0')}${t.day.toString().padLeft(2, '0')}"
+      "_${t.hour.toString().padLeft(2, '0')}${t.minute.toString().padLeft(2, '0')}";
+
+  /// Raw archive name: `Player_X_YYYYMMDD_HHMM_Raw.csv`, with
+  /// `Player_Unknown` when no player number is set.
+  static String rawArchiveName(int playerNumber, DateTime start) {
+    final player =
+        playerNumber > 0 ? "Player_$playerNumber" : "Player_Unknown";
+    return "${player}_${timeLabel(start)}_Raw.csv";
+  }
+}
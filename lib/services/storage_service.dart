@@ -4,6 +4,7 @@ import 'dart:typed_data';
 import 'package:path_provider/path_provider.dart';
 import 'package:metric_athlete_pod_ble/models/live_data_model.dart';
 import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/sensor_log_csv.dart';
 ///Class contains functions used to save .bin files and [SensorLog] lists as .csv files.
 class StorageService {
   
@@ -34,33 +35,7 @@ class StorageService {
 
     final file = File('$path/$csvName');
 
-    // Build CSV String using StringBuffer
-    StringBuffer sb = StringBuffer();
-    
-    // Headers
-    sb.writeln("Timestamp,KernelCount,Lat,Lon,Speed_Kph,AccelX,AccelY,AccelZ,GyroX,GyroY,GyroZ,FiltAccelX,FiltAccelY,FiltAccelZ");
-
-    // Rows
-    for (var log in logs) {
-      sb.writeln(
-        "${log.timestamp.toIso8601String()},"
-        "${log.packetId},"
-        "${log.latitude},"
-        "${log.longitude},"
-        "${log.speed},"
-        "${log.accelX},"
-        "${log.accelY},"
-        "${log.accelZ},"
-        "${log.gyroX},"
-        "${log.gyroY},"
-        "${log.gyroZ},"
-        "${log.filteredAccelX},"
-        "${log.filteredAccelY},"
-        "${log.filteredAccelZ}"
-      );
-    }
-
-    await file.writeAsString(sb.toString());
+    await file.writeAsString(SensorLogCsv.encode(logs));
     return file;
   }
 
@@ -0,0 +1,129 @@
+import 'dart:typed_data';
+
+/// A message rebuilt from BLE blocks, in the form the native layers deliver
+/// on the payload stream: the message type byte followed by the data.
+class ReassembledMessage {
+  final int messageType;
+  final Uint8List payload;
+
+  /// Blocks the message was announced with.
+  final int blocks;
+
+  /// Blocks that arrived more than once (dropped).
+  final int duplicateBlocks;
+
+  /// Blocks that never arrived (zero-filled to keep record alignment).
+  final int missingBlocks;
+
+  const ReassembledMessage({
+    required this.messageType,
+    required this.payload,
+    required this.blocks,
+    required this.duplicateBlocks,
+    required this.missingBlocks,
+  });
+
+  bool get isComplete => missingBlocks == 0;
+}
+
+/// Dart counterpart of the native block reassembly, for headless tools that
+/// talk to a pod (or a simulated one) without the plugin.
+///
+/// Pod framing: the first block of a message is
+/// `[type][sequence u32][total blocks u32][data]`, every later block
+/// `[type][sequence u32][data]`, all little endian. Blocks are placed by
+/// sequence relative to the first, so reordered blocks land in the right
+/// slot and repeats are dropped. A block size is learned from the first
+/// block; when [finish] gives up on missing blocks they are zero-filled at
+/// that size, like the native tracker does.
+///
+/// Not thread-safe; one message at a time.
+class BlockReassembler {
+  /// Same sanity cap as the native reassemblers.
+  static const int maxBlocks = 500000;
+
+  int _messageType = 0;
+  int _firstSequence = 0;
+  int _blockData = 0;
+  int _received = 0;
+  int _duplicates = 0;
+  Uint8List? _firstData;
+  List<Uint8List?> _blocks = const [];
+
+  // Sequence range of the last finished message, so its late repeats are
+  // not mistaken for the header of a new one
+  int _doneFirst = 0;
+  int _doneCount = 0;
+
+  /// Whether a message has started and not yet completed.
+  bool get inProgress => _firstData != null;
+
+  /// Feeds one BLE notification. Returns the message once all of its blocks
+  /// have arrived, otherwise null.
+  ReassembledMessage? add(Uint8List packet) {
+    if (packet.length < 5) return null;
+    final data = ByteData.sublistView(packet);
+    final sequence = data.getUint32(1, Endian.little);
+
+    if (!inProgress) {
+      if (((sequence - _doneFirst) & 0xFFFFFFFF) < _doneCount) {
+        _duplicates++;
+        return null;
+      }
+      if (packet.length < 9) return null;
+      final total = data.getUint32(5, Endian.little);
+      if (total <= 0 || total > maxBlocks) return null;
+      _messageType = packet[0];
+      _firstSequence = sequence;
+      _blockData = packet.length - 5;
+      _received = 1;
+      _firstData = Uint8List.sublistView(packet, 9);
+      _blocks = List<Uint8List?>.filled(total, null);
+    } else {
+      final index = (sequence - _firstSequence) & 0xFFFFFFFF;
+      if (index == 0 || index >= _blocks.length || _blocks[index] != null) {
+        _duplicates++;
+        return null;
+      }
+      _blocks[index] = Uint8List.sublistView(packet, 5);
+      _received++;
+    }
+
+    return _received == _blocks.length ? finish() : null;
+  }
+
+  /// Ends the current message with whatever has arrived, zero-filling the
+  /// missing blocks. Returns null if no message is in progress.
+  ReassembledMessage? finish() {
+    final first = _firstData;
+    if (first == null) return null;
+
+    final builder = BytesBuilder(copy: false)
+      ..addByte(_messageType)
+      ..add(first);
+    int missing = 0;
+    for (int i = 1; i < _blocks.length; i++) {
+      final block = _blocks[i];
+      if (block != null) {
+        builder.add(block);
+      } else {
+        builder.add(Uint8List(_blockData));
+        missing++;
+      }
+    }
+
+    final message = ReassembledMessage(
+      messageType: _messageType,
+      payload: builder.takeBytes(),
+      blocks: _blocks.length,
+      duplicateBlocks: _duplicates,
+      missingBlocks: missing,
+    );
+    _doneFirst = _firstSequence;
+    _doneCount = _blocks.length;
+    _firstData = null;
+    _blocks = const [];
+    _duplicates = 0;
+    return message;
+  }
+}
@@ -0,0 +1,103 @@
+import 'dart:typed_data';
+
+/// Running live-session totals the native side computes from every 0x01
+/// packet and publishes (message type 0xDC) at a UI rate, so the Dart
+/// isolate does not have to touch each live packet.
+///
+/// Speeds are km/h (converted from the pod's knots), times are kernel-tick
+/// milliseconds and distance is integrated GPS speed while the fix is valid.
+///
+/// ### Wire Format (after the 0xDC type byte, little endian)
+/// | Offset | Field | Type | Size |
+/// | :--- | :--- | :--- | :--- |
+/// | 0 | Packets | Uint32 | 4 |
+/// | 4 | Kernel Tick | Uint32 | 4 |
+/// | 8 | Elapsed ms | Uint32 | 4 |
+/// | 12 | Distance (m) | Float32 | 4 |
+/// | 16 | Speed (km/h) | Float32 | 4 |
+/// | 20 | Peak Speed (km/h) | Float32 | 4 |
+/// | 24 | Player Load | Float32 | 4 |
+/// | 28 | Impacts | Uint32 | 4 |
+/// | 32 | Battery (V) | Float32 | 4 |
+/// | 36 | Flags | Uint8 | 1 |
+/// | 37 | Satellites | Uint8 | 1 |
+/// | 38 | Zone ms | Uint32[5] | 20 |
+class LiveMetrics {
+  /// Synthetic message type used on the payload stream.
+  static const int messageType = 0xDC;
+
+  static const int _size = 58;
+
+  static const int flagGpsFix = 0x01;
+  static const int flagInImpact = 0x02;
+
+  /// Lower bounds of speed zones 2-5 in km/h (zone 1 starts at 0).
+  static const List<double> zoneFloorsKmh = [7.2, 14.4, 19.8, 25.2];
+
+  final int packets;
+  final int kernelTick;
+  final int elapsedMs;
+  final double distanceM;
+  final double speedKmh;
+  final double peakSpeedKmh;
+
+  /// Accumulated change in acceleration (g) / 100.
+  final double playerLoad;
+  final int impacts;
+  final double batteryVoltage;
+  final int flags;
+  final int satellites;
+
+  /// Time spent in each of the five speed zones (ms).
+  final List<int> zoneMs;
+
+  const LiveMetrics({
+    required this.packets,
+    required this.kernelTick,
+    required this.elapsedMs,
+    required this.distanceM,
+    required this.speedKmh,
+    required this.peakSpeedKmh,
+    required this.playerLoad,
+    required this.impacts,
+    required this.batteryVoltage,
+    required this.flags,
+    required this.satellites,
+    required this.zoneMs,
+  });
+
+  /// Decodes the message body (without the type byte). Returns null if the
+  /// payload is truncated.
+  static LiveMetrics? fromBytes(Uint8List payload) {
+    if (payload.length < _size) return null;
+    final data = ByteData.sublistView(payload);
+    return LiveMetrics(
+      packets: data.getUint32(0, Endian.little),
+      kernelTick: data.getUint32(4, Endian.little),
+      elapsedMs: data.getUint32(8, Endian.little),
+      distanceM: data.getFloat32(12, Endian.little),
+      speedKmh: data.getFloat32(16, Endian.little),
+      peakSpeedKmh: data.getFloat32(20, Endian.little),
+      playerLoad: data.getFloat32(24, Endian.little),
+      impacts: data.getUint32(28, Endian.little),
+      batteryVoltage: data.getFloat32(32, Endian.little),
+      flags: data.getUint8(36),
+      satellites: data.getUint8(37),
+      zoneMs: List.unmodifiable([
+        for (int i = 0; i < 5; i++) data.getUint32(38 + i * 4, Endian.little),
+      ]),
+    );
+  }
+
+  bool get hasGpsFix => flags & flagGpsFix != 0;
+  bool get inImpact => flags & flagInImpact != 0;
+
+  /// Time at or above the sprint threshold (zone 5), in ms.
+  int get sprintMs => zoneMs[4];
+
+  @override
+  String toString() =>
+      'LiveMetrics(${distanceM.toStringAsFixed(1)}m, '
+      '${speedKmh.toStringAsFixed(1)}/${peakSpeedKmh.toStringAsFixed(1)}km/h, '
+      'load=${playerLoad.toStringAsFixed(2)}, impacts=$impacts)';
+}
@@ -1,4 +1,5 @@
 import 'dart:typed_data';
+import 'package:metric_athlete_pod_ble/utils/record_anomalies.dart';
 
 /// Validation result for a reassembled payload.
 class PayloadValidation {
@@ -22,7 +23,7 @@ class PayloadValidation {
 /// the protocol decoder.
 class PacketReassembler {
   /// Known valid message types from Pod firmware protocol.
-  static const validMessageTypes = {0x01, 0x02, 0x03, 0x05, 0xDA};
+  static const validMessageTypes = {0x01, 0x02, 0x03, 0x05, 0xDA, 0xDB, 0xDC};
 
   /// Maximum reasonable payload sizes by message type.
   static const _maxPayloadSize = {
@@ -31,6 +32,8 @@ class PacketReassembler {
     0x03: 10 * 1024 * 1024, // File data — up to 10 MB
     0x05: 256, // Device settings — small response
     0xDA: 1, // Skip signal — just the type byte
+    0xDB: 64 * 1024, // Integrity summary — 27-byte header + 1 bit per record
+    0xDC: 256, // Live metrics snapshot — 59 bytes
   };
 
   /// Validate a reassembled payload from native code.
@@ -94,20 +97,17 @@ class PacketReassembler {
       );
     }
 
-    // Check header date at offset 5-10 (year at 5-6, month at 7, day at 8)
-    if (payload.length >= 9) {
+    // First record starts after the type byte
+    if (!RecordHeader.isPlausible(payload, 1)) {
       final year = payload[5] | (payload[6] << 8);
       final month = payload[7];
       final day = payload[8];
-
-      if (year < 2022 || year > 2035 || month < 1 || month > 12 || day < 1 || day > 31) {
-        return PayloadValidation(
-          isValid: false,
-          error: 'Invalid header date: $year-$month-$day',
-          messageType: 0x03,
-          payloadSize: payload.length,
-        );
-      }
+      return PayloadValidation(
+        isValid: false,
+        error: 'Invalid header date: $year-$month-$day',
+        messageType: 0x03,
+        payloadSize: payload.length,
+      );
     }
 
     return PayloadValidation(
@@ -155,29 +155,11 @@ class PacketReassembler {
   /// Detect firmware record size from payload buffer (47, 61 or 64 bytes).
   /// Returns 47 for V3.6 (v01), 61 for Proewe, 64 for HTS firmware.
   static int detectRecordSize(Uint8List buffer) {
-    // Check for V3.6 v01 format (47-byte records)
-    // Need at least 1 (type) + 47 (first record) + 8 (header of second) = 56 bytes
-    if (buffer.length >= 56) {
-      // Second record at offset 48; year is 4 bytes into the record header
-      final year = buffer[52] | (buffer[53] << 8);
-      final month = buffer[54];
-      final day = buffer[55];
-      if (year >= 2022 && year <= 2030 && month >= 1 && month <= 12 && day >= 1 && day <= 31) {
-        return 47;
-      }
-    }
+    // Second record header directly after a 47-byte (V3.6 v01) record
+    if (RecordHeader.isPlausible(buffer, 1 + 47)) return 47;
 
-    // Check for Proewe format (61-byte records)
-    // Need at least 1 (type) + 61 (first record) + 8 (header of second) = 70 bytes
-    if (buffer.length >= 70) {
-      // Second record at offset 62; year is 4 bytes into the record header
-      final year = buffer[66] | (buffer[67] << 8);
-      final month = buffer[68];
-      final day = buffer[69];
-      if (year >= 2022 && year <= 2030 && month >= 1 && month <= 12 && day >= 1 && day <= 31) {
-        return 61;
-      }
-    }
+    // ... or after a 61-byte (Proewe) record
+    if (RecordHeader.isPlausible(buffer, 1 + 61)) return 61;
 
     return 64;
   }
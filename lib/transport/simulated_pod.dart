@@ -0,0 +1,78 @@
+import 'dart:math';
+import 'dart:typed_data';
+
+/// Stand-in for the pod end of a BLE link, for headless syncs, tests and
+/// benchmarks that run without a radio (e.g. on Linux servers).
+///
+/// [transmit] frames a message the way the firmware does (see
+/// [BlockReassembler]) in blocks of [blockSize] bytes, and can impair the
+/// link: blocks are dropped with [lossRate], sent twice with
+/// [duplicateRate] and swapped with their successor with [reorderRate].
+/// The header block is never dropped, since a lost header aborts the
+/// transfer on a real pod. Impairments are reproducible for a given [seed].
+class SimulatedPod {
+  /// Bytes per notification, header included (ATT MTU 247 minus 3).
+  final int blockSize;
+  final double lossRate;
+  final double duplicateRate;
+  final double reorderRate;
+
+  final Random _random;
+  int _sequence;
+
+  SimulatedPod({
+    this.blockSize = 244,
+    this.lossRate = 0,
+    this.duplicateRate = 0,
+    this.reorderRate = 0,
+    int seed = 1,
+  }) : assert(blockSize > 9),
+       _random = Random(seed),
+       _sequence = seed & 0xFFFF;
+
+  /// Whether any impairment is configured.
+  bool get isLossless => lossRate <= 0 && duplicateRate <= 0 && reorderRate <= 0;
+
+  /// Blocks needed to send [dataLength] bytes.
+  int blockCount(int dataLength) {
+    final first = blockSize - 9;
+    if (dataLength <= first) return 1;
+    final rest = blockSize - 5;
+    return 1 + (dataLength - first + rest - 1) ~/ rest;
+  }
+
+  /// The notifications for one message of [messageType] carrying [data], in
+  /// the order the link delivers them.
+  List<Uint8List> transmit(Uint8List data, {int messageType = 0x03}) {
+    final total = blockCount(data.length);
+    final blocks = <Uint8List>[];
+    int offset = 0;
+    for (int i = 0; i < total; i++) {
+      final header = i == 0 ? 9 : 5;
+      final len = min(blockSize - header, data.length - offset);
+      final block = Uint8List(header + len);
+      final view = ByteData.sublistView(block);
+      block[0] = messageType;
+      view.setUint32(1, _sequence, Endian.little);
+      if (i == 0) view.setUint32(5, total, Endian.little);
+      block.setRange(header, header + len, data, offset);
+      offset += len;
+      _sequence = (_sequence + 1) & 0xFFFFFFFF;
+      blocks.add(block);
+    }
+    if (isLossless) return blocks;
+
+    final out = <Uint8List>[blocks.first];
+    for (int i = 1; i < blocks.length; i++) {
+      if (i + 1 < blocks.length && _random.nextDouble() < reorderRate) {
+        final swapped = blocks[i];
+        blocks[i] = blocks[i + 1];
+        blocks[i + 1] = swapped;
+      }
+      if (_random.nextDouble() < lossRate) continue;
+      out.add(blocks[i]);
+      if (_random.nextDouble() < duplicateRate) out.add(blocks[i]);
+    }
+    return out;
+  }
+}
@@ -0,0 +1,110 @@
+import 'dart:typed_data';
+
+/// Integrity summary the native reassembler sends (message type 0xDB)
+/// immediately before the 0x03 file payload it describes.
+///
+/// Carries a rolling CRC32C of the received data, block sequence statistics
+/// and a per-record validity bitmap, so the parser can walk records at a fixed
+/// stride without re-validating headers.
+///
+/// ### Wire Format (after the 0xDB type byte, little endian)
+/// | Offset | Field | Type | Size |
+/// | :--- | :--- | :--- | :--- |
+/// | 0 | CRC32C | Uint32 | 4 |
+/// | 4 | Flags | Uint8 | 1 |
+/// | 5 | Record Size | Uint8 | 1 |
+/// | 6 | Records | Uint32 | 4 |
+/// | 10 | Valid Records | Uint32 | 4 |
+/// | 14 | Missing Blocks | Uint32 | 4 |
+/// | 18 | Duplicate Blocks | Uint32 | 4 |
+/// | 22 | Data Bytes | Uint32 | 4 |
+/// | 26 | Validity Bitmap | Uint8[] | ceil(records / 8) |
+class TransferIntegrity {
+  /// Synthetic message type used on the payload stream.
+  static const int messageType = 0xDB;
+
+  static const int _headerSize = 26;
+
+  static const int flagSequenceVerified = 0x01;
+  static const int flagDigestMatched = 0x02;
+  static const int flagDigestMismatch = 0x04;
+  static const int flagGapsPadded = 0x08;
+  static const int flagGapsUnpadded = 0x10;
+
+  final int crc32c;
+  final int flags;
+  final int recordSize;
+  final int records;
+  final int validRecords;
+  final int missingBlocks;
+  final int duplicateBlocks;
+  final int dataBytes;
+
+  /// Bit i (LSB first) set = record i is usable.
+  final Uint8List validity;
+
+  const TransferIntegrity({
+    required this.crc32c,
+    required this.flags,
+    required this.recordSize,
+    required this.records,
+    required this.validRecords,
+    required this.missingBlocks,
+    required this.duplicateBlocks,
+    required this.dataBytes,
+    required this.validity,
+  });
+
+  /// Decodes the message body (without the type byte). Returns null if the
+  /// payload is truncated or the bitmap does not cover every record.
+  static TransferIntegrity? fromBytes(Uint8List payload) {
+    if (payload.length < _headerSize) return null;
+    final data = ByteData.sublistView(payload);
+    final records = data.getUint32(6, Endian.little);
+    final bitmapBytes = (records + 7) ~/ 8;
+    if (payload.length < _headerSize + bitmapBytes) return null;
+
+    return TransferIntegrity(
+      crc32c: data.getUint32(0, Endian.little),
+      flags: data.getUint8(4),
+      recordSize: data.getUint8(5),
+      records: records,
+      validRecords: data.getUint32(10, Endian.little),
+      missingBlocks: data.getUint32(14, Endian.little),
+      duplicateBlocks: data.getUint32(18, Endian.little),
+      dataBytes: data.getUint32(22, Endian.little),
+      validity: Uint8List.sublistView(
+        payload,
+        _headerSize,
+        _headerSize + bitmapBytes,
+      ),
+    );
+  }
+
+  bool get sequenceVerified => flags & flagSequenceVerified != 0;
+  bool get digestMatched => flags & flagDigestMatched != 0;
+  bool get digestMismatch => flags & flagDigestMismatch != 0;
+  bool get gapsPadded => flags & flagGapsPadded != 0;
+
+  /// A gap longer than the native pad limit was left unfilled, so every
+  /// record after it is off the fixed stride.
+  bool get gapsUnpadded => flags & flagGapsUnpadded != 0;
+
+  /// Whether record [index] passed native validation.
+  bool isRecordValid(int index) =>
+      index >= 0 &&
+      index < records &&
+      validity[index >> 3] & (1 << (index & 7)) != 0;
+
+  /// True when the bitmap describes [payload] exactly (same record size and
+  /// record count) and every record sits on the fixed stride, i.e. it can
+  /// replace header scanning for that payload. The stride only holds when
+  /// the block sequence was verified and every gap was zero-filled; after an
+  /// unfilled gap, or a loss the native side could not see, the parser has
+  /// to resync by scanning.
+  bool describes(Uint8List payload) =>
+      recordSize > 0 &&
+      payload.length ~/ recordSize == records &&
+      sequenceVerified &&
+      (missingBlocks == 0 || (gapsPadded && !gapsUnpadded));
+}
@@ -0,0 +1,282 @@
+import 'dart:math';
+import 'dart:typed_data';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/record_anomalies.dart';
+import 'package:metric_athlete_pod_ble/utils/sanity_kernel.dart';
+
+/// Data-quality summary of one parsed file, built in the same pass that
+/// decodes the records (see [BinaryParser.parse]).
+///
+/// Tick gaps are measured between consecutive records in file order and
+/// bucketed in multiples of the nominal kernel step (the most common gap):
+///
+/// | Bucket | Steps | Meaning |
+/// | :--- | :--- | :--- |
+/// | 0 | 1 | Normal |
+/// | 1 | 2 | One record lost |
+/// | 2 | 3-5 | Short burst lost |
+/// | 3 | 6-10 | |
+/// | 4 | 11-499 | Long loss (still repaired by gap repair) |
+/// | 5 | 500+ | Pause / file merge (not counted as loss) |
+class DataQualityReport {
+  /// Channel order of [nonFiniteCounts].
+  static const List<String> channels = [
+    'latitude',
+    'longitude',
+    'speed',
+    'accelX',
+    'accelY',
+    'accelZ',
+    'gyroX',
+    'gyroY',
+    'gyroZ',
+  ];
+
+  /// Labels of [tickGapHistogram] buckets.
+  static const List<String> tickGapBuckets = [
+    '1',
+    '2',
+    '3-5',
+    '6-10',
+    '11-499',
+    '500+',
+  ];
+
+  /// Decoded records.
+  final int records;
+
+  /// Bytes the sync scan stepped over looking for a plausible header.
+  final int syncSkips;
+
+  /// Plausible headers whose record failed to decode.
+  final int parseErrors;
+
+  /// Records the native validity bitmap marked invalid (not decoded).
+  final int rejectedRecords;
+
+  /// Most common positive tick delta (0 if fewer than two records).
+  final int nominalTickStep;
+
+  /// Gap counts per [tickGapBuckets] entry.
+  final Int32List tickGapHistogram;
+
+  /// Consecutive records with the same tick.
+  final int duplicateTicks;
+
+  /// Consecutive records whose tick went backwards.
+  final int backwardTicks;
+
+  /// Records implied missing by tick gaps of 2-499 steps.
+  final int missingTicks;
+
+  /// Records with a GPS fix (not null island).
+  final int gpsFixes;
+
+  /// NaN/Infinity counts per [channels] entry.
+  final Int32List nonFiniteCounts;
+
+  /// Records over the speed limit ([RecordAnomaly.impossibleSpeed]).
+  final int speedOutOfRange;
+
+  /// Records over the accel/gyro limits ([RecordAnomaly.imuOutOfRange]).
+  final int imuOutOfRange;
+
+  /// Records with every IMU channel exactly 0 ([RecordAnomaly.zeroFill]).
+  final int zeroFilled;
+
+  DataQualityReport({
+    required this.records,
+    required this.syncSkips,
+    required this.parseErrors,
+    required this.rejectedRecords,
+    required this.nominalTickStep,
+    required this.tickGapHistogram,
+    required this.duplicateTicks,
+    required this.backwardTicks,
+    required this.missingTicks,
+    required this.gpsFixes,
+    required this.nonFiniteCounts,
+    required this.speedOutOfRange,
+    required this.imuOutOfRange,
+    required this.zeroFilled,
+  });
+
+  /// Share of records with a GPS fix (0-1).
+  double get gpsFixRatio => records == 0 ? 0 : gpsFixes / records;
+
+  /// NaN/Infinity values across all channels.
+  int get nonFiniteTotal => nonFiniteCounts.fold(0, (a, b) => a + b);
+
+  /// Estimated share of records lost in transfer or logging (0-100).
+  ///
+  /// Records the native bitmap rejected normally show up as tick gaps too,
+  /// so they only count when they exceed the gap estimate (e.g. losses at
+  /// the very start or end of the file).
+  double get estimatedLossPercent {
+    final lost = max(missingTicks, rejectedRecords);
+    final expected = records + lost;
+    return expected == 0 ? 0 : lost / expected * 100.0;
+  }
+
+  /// Compact one-line form for logging.
+  String summary() {
+    final parts = <String>[
+      'records=$records',
+      'loss=${estimatedLossPercent.toStringAsFixed(1)}%',
+      'gpsFix=${(gpsFixRatio * 100).toStringAsFixed(0)}%',
+      'step=$nominalTickStep',
+      'gaps=[${tickGapHistogram.join(',')}]',
+    ];
+    void add(String name, int n) {
+      if (n > 0) parts.add('$name=$n');
+    }
+
+    add('missing', missingTicks);
+    add('dupTicks', duplicateTicks);
+    add('backTicks', backwardTicks);
+    add('syncSkips', syncSkips);
+    add('parseErrors', parseErrors);
+    add('rejected', rejectedRecords);
+    for (int c = 0; c < channels.length; c++) {
+      add('nan.${channels[c]}', nonFiniteCounts[c]);
+    }
+    add('speedRange', speedOutOfRange);
+    add('imuRange', imuOutOfRange);
+    add('zeroFill', zeroFilled);
+    return parts.join(', ');
+  }
+}
+
+/// Accumulates a [DataQualityReport] while the parser decodes records.
+///
+/// Per record only the tick gap is tracked (one map update); flag and
+/// channel counts are taken in [finish] from the [SanityKernel] output and
+/// the float32 columns, and bucketing happens once the nominal step is known.
+class DataQualityAccumulator {
+  int _records = 0;
+  int _syncSkips = 0;
+  int _parseErrors = 0;
+  int _rejectedRecords = 0;
+  int _duplicateTicks = 0;
+  int _backwardTicks = 0;
+  int? _lastTick;
+  final Map<int, int> _gapCounts = {};
+
+  void syncSkip() => _syncSkips++;
+  void parseError() => _parseErrors++;
+  void rejectedRecord() => _rejectedRecords++;
+
+  /// Adds one decoded record.
+  void addRecord(SensorLog log) {
+    _records++;
+
+    final last = _lastTick;
+    if (last != null) {
+      final gap = log.packetId - last;
+      if (gap > 0) {
+        _gapCounts[gap] = (_gapCounts[gap] ?? 0) + 1;
+      } else if (gap == 0) {
+        _duplicateTicks++;
+      } else {
+        _backwardTicks++;
+      }
+    }
+    _lastTick = log.packetId;
+  }
+
+  /// Builds the report. [columns] and [anomalies] hold the records passed to
+  /// [addRecord], in the same order.
+  DataQualityReport finish(SensorColumns columns, Uint8List anomalies) {
+    int gpsFixes = 0;
+    int speedOutOfRange = 0;
+    int imuOutOfRange = 0;
+    int zeroFilled = 0;
+    final lat = columns.latitude;
+    final lon = columns.longitude;
+    for (int i = 0; i < anomalies.length; i++) {
+      final flags = anomalies[i];
+      // The kernel reports only nonFinite for non-finite rows, so the null
+      // island bit is only meaningful without it
+      final notNullIsland =
+          flags & RecordAnomaly.nonFinite == 0
+              ? flags & RecordAnomaly.nullIsland == 0
+              : lat[i].abs() >= 0.001 || lon[i].abs() >= 0.001;
+      if (notNullIsland && lat[i].isFinite && lon[i].isFinite) gpsFixes++;
+      if (flags & RecordAnomaly.impossibleSpeed != 0) speedOutOfRange++;
+      if (flags & RecordAnomaly.imuOutOfRange != 0) imuOutOfRange++;
+      if (flags & RecordAnomaly.zeroFill != 0) zeroFilled++;
+    }
+
+    final nonFinite = Int32List(DataQualityReport.channels.length);
+    final channelColumns = [
+      columns.latitude,
+      columns.longitude,
+      columns.speed,
+      columns.accelX,
+      columns.accelY,
+      columns.accelZ,
+      columns.gyroX,
+      columns.gyroY,
+      columns.gyroZ,
+    ];
+    for (int c = 0; c < channelColumns.length; c++) {
+      final column = channelColumns[c];
+      int count = 0;
+      for (int i = 0; i < columns.length; i++) {
+        if (!column[i].isFinite) count++;
+      }
+      nonFinite[c] = count;
+    }
+
+    int step = 0;
+    int stepCount = 0;
+    _gapCounts.forEach((gap, count) {
+      if (count > stepCount || (count == stepCount && gap < step)) {
+        step = gap;
+        stepCount = count;
+      }
+    });
+
+    final histogram = Int32List(DataQualityReport.tickGapBuckets.length);
+    int missing = 0;
+    if (step > 0) {
+      _gapCounts.forEach((gap, count) {
+        final steps = (gap / step).round();
+        final int bucket;
+        if (steps <= 1) {
+          bucket = 0;
+        } else if (steps == 2) {
+          bucket = 1;
+        } else if (steps <= 5) {
+          bucket = 2;
+        } else if (steps <= 10) {
+          bucket = 3;
+        } else if (steps < 500) {
+          bucket = 4;
+        } else {
+          bucket = 5;
+        }
+        histogram[bucket] += count;
+        // Same repairable range as TrajectoryFilter's gap repair
+        if (steps > 1 && steps < 500) missing += (steps - 1) * count;
+      });
+    }
+
+    return DataQualityReport(
+      records: _records,
+      syncSkips: _syncSkips,
+      parseErrors: _parseErrors,
+      rejectedRecords: _rejectedRecords,
+      nominalTickStep: step,
+      tickGapHistogram: histogram,
+      duplicateTicks: _duplicateTicks,
+      backwardTicks: _backwardTicks,
+      missingTicks: missing,
+      gpsFixes: gpsFixes,
+      nonFiniteCounts: nonFinite,
+      speedOutOfRange: speedOutOfRange,
+      imuOutOfRange: imuOutOfRange,
+      zeroFilled: zeroFilled,
+    );
+  }
+}
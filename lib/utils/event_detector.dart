@@ -0,0 +1,305 @@
+import 'dart:collection';
+import 'dart:math';
+import 'package:metric_athlete_pod_ble/models/live_data_model.dart';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+
+enum AthleteEventType { sprint, acceleration, deceleration, impact }
+
+/// One detected effort or impact.
+///
+/// [peak] is in the unit the event was detected on: km/h for sprints, m/s²
+/// for accelerations (negative for decelerations) and impacts.
+class AthleteEvent {
+  final AthleteEventType type;
+
+  /// Time of the first and last sample above the threshold, in ms (epoch
+  /// for logs, kernel ticks for live data).
+  final int startMs;
+  final int endMs;
+
+  final double peak;
+
+  /// Distance covered during the event, from GPS speed (metres).
+  final double distanceM;
+
+  const AthleteEvent({
+    required this.type,
+    required this.startMs,
+    required this.endMs,
+    required this.peak,
+    this.distanceM = 0,
+  });
+
+  int get durationMs => endMs - startMs;
+
+  @override
+  String toString() =>
+      'AthleteEvent(${type.name}, $startMs..$endMs, '
+      'peak=${peak.toStringAsFixed(2)}, ${distanceM.toStringAsFixed(1)}m)';
+}
+
+/// Events of one session, in the order they ended.
+class EventTable {
+  final List<AthleteEvent> events;
+
+  EventTable(this.events);
+
+  Iterable<AthleteEvent> ofType(AthleteEventType type) =>
+      events.where((e) => e.type == type);
+
+  int count(AthleteEventType type) => ofType(type).length;
+
+  String summary() =>
+      'sprints=${count(AthleteEventType.sprint)} '
+      'accels=${count(AthleteEventType.acceleration)} '
+      'decels=${count(AthleteEventType.deceleration)} '
+      'impacts=${count(AthleteEventType.impact)}';
+}
+
+/// Thresholds for [EventDetector]. Each event starts when its signal reaches
+/// the `on` threshold and ends when it drops below the lower `off` threshold,
+/// so noise around a single threshold does not split one effort into many.
+class EventDetectorConfig {
+  /// Sprint: GPS speed (km/h).
+  final double sprintOnKmh;
+  final double sprintOffKmh;
+  final int minSprintMs;
+
+  /// Acceleration / deceleration: rate of change of GPS speed (m/s²),
+  /// measured over [accelWindowMs]. Decelerations use the same magnitudes.
+  final double accelOnMs2;
+  final double accelOffMs2;
+  final int minAccelMs;
+  final int accelWindowMs;
+
+  /// Impact: gravity-compensated acceleration magnitude (m/s²).
+  final double impactOnMs2;
+  final double impactOffMs2;
+
+  /// A new impact is not started within this many ms of the last one.
+  final int impactRefractoryMs;
+
+  /// Open events are closed, and the speed history reset, across sample gaps
+  /// longer than this (ms).
+  final int maxGapMs;
+
+  const EventDetectorConfig({
+    this.sprintOnKmh = 25.2,
+    this.sprintOffKmh = 23.0,
+    this.minSprintMs = 1000,
+    this.accelOnMs2 = 3.0,
+    this.accelOffMs2 = 2.0,
+    this.minAccelMs = 500,
+    this.accelWindowMs = 500,
+    this.impactOnMs2 = 49.0,
+    this.impactOffMs2 = 29.4,
+    this.impactRefractoryMs = 250,
+    this.maxGapMs = 1000,
+  });
+}
+
+/// Streaming detector for sprints, accelerations/decelerations and impacts.
+///
+/// Every sample is handled in O(1) with no lookahead, so the same detector
+/// runs over a downloaded session ([detect]) or packet by packet on the live
+/// stream ([addLive]). Events are returned by the call that completes them;
+/// call [flush] at the end of a session to close open ones.
+class EventDetector {
+  /// Live `gpsSpeed` is in knots (see the example app); logs use km/h.
+  static const double knotsToKmh = 1.852;
+
+  final EventDetectorConfig config;
+
+  final _Episode _sprint;
+  final _Episode _accel;
+  final _Episode _decel;
+  final _Episode _impact;
+
+  /// (time, speed m/s) samples covering the last [accelWindowMs].
+  final ListQueue<(int, double)> _speedHistory = ListQueue();
+  int? _lastMs;
+
+  EventDetector({this.config = const EventDetectorConfig()})
+    : _sprint = _Episode(
+        AthleteEventType.sprint,
+        config.sprintOnKmh,
+        config.sprintOffKmh,
+        config.minSprintMs,
+      ),
+      _accel = _Episode(
+        AthleteEventType.acceleration,
+        config.accelOnMs2,
+        config.accelOffMs2,
+        config.minAccelMs,
+      ),
+      _decel = _Episode(
+        AthleteEventType.deceleration,
+        config.accelOnMs2,
+        config.accelOffMs2,
+        config.minAccelMs,
+        sign: -1,
+      ),
+      _impact = _Episode(
+        AthleteEventType.impact,
+        config.impactOnMs2,
+        config.impactOffMs2,
+        0,
+        refractoryMs: config.impactRefractoryMs,
+      );
+
+  /// Detects every event in [logs] (sorted by time, e.g. pipeline output).
+  static EventTable detect(
+    List<SensorLog> logs, {
+    EventDetectorConfig config = const EventDetectorConfig(),
+  }) {
+    final detector = EventDetector(config: config);
+    final events = <AthleteEvent>[];
+    for (final log in logs) {
+      events.addAll(detector.addLog(log));
+    }
+    events.addAll(detector.flush());
+    return EventTable(events);
+  }
+
+  /// Feeds one downloaded record (speed in km/h, gravity-compensated accel).
+  List<AthleteEvent> addLog(SensorLog log) => add(
+    log.timestamp.millisecondsSinceEpoch,
+    log.speed,
+    log.filteredAccelX,
+    log.filteredAccelY,
+    log.filteredAccelZ,
+  );
+
+  /// Feeds one live packet, timed by its kernel tick. Linear acceleration
+  /// is the raw accelerometer minus the pod's gravity estimate.
+  List<AthleteEvent> addLive(LiveTelemetry t) => add(
+    t.kernelTickCount,
+    t.gpsSpeed * knotsToKmh,
+    t.accelerometer.x - t.filteredGravity.x,
+    t.accelerometer.y - t.filteredGravity.y,
+    t.accelerometer.z - t.filteredGravity.z,
+  );
+
+  /// Feeds one sample at [timeMs] with GPS speed in km/h and linear
+  /// acceleration in m/s². Samples with non-finite values are skipped.
+  List<AthleteEvent> add(
+    int timeMs,
+    double speedKmh,
+    double ax,
+    double ay,
+    double az,
+  ) {
+    final accelMagnitude = sqrt(ax * ax + ay * ay + az * az);
+    if (!speedKmh.isFinite || !accelMagnitude.isFinite) return const [];
+
+    final last = _lastMs;
+    if (timeMs == last) return const [];
+
+    final events = <AthleteEvent>[];
+    if (last != null && (timeMs < last || timeMs - last > config.maxGapMs)) {
+      events.addAll(flush());
+    }
+    final dtMs = _lastMs == null ? 0 : timeMs - _lastMs!;
+    _lastMs = timeMs;
+
+    final speedMs = speedKmh / 3.6;
+    final stepM = speedMs * dtMs / 1000.0;
+
+    // Rate of change of speed against the newest sample at least
+    // accelWindowMs old
+    _speedHistory.addLast((timeMs, speedMs));
+    while (_speedHistory.length > 1 &&
+        timeMs - _speedHistory.elementAt(1).$1 >= config.accelWindowMs) {
+      _speedHistory.removeFirst();
+    }
+    final (t0, v0) = _speedHistory.first;
+    final accel = timeMs > t0 ? (speedMs - v0) * 1000.0 / (timeMs - t0) : 0.0;
+
+    void emit(AthleteEvent? event) {
+      if (event != null) events.add(event);
+    }
+
+    emit(_sprint.update(timeMs, speedKmh, stepM));
+    emit(_accel.update(timeMs, accel, stepM));
+    emit(_decel.update(timeMs, accel, stepM));
+    emit(_impact.update(timeMs, accelMagnitude, stepM));
+    return events;
+  }
+
+  /// Closes any open events (end of session or a gap) and resets the speed
+  /// history.
+  List<AthleteEvent> flush() {
+    _speedHistory.clear();
+    _lastMs = null;
+    return [
+      for (final episode in [_sprint, _accel, _decel, _impact])
+        if (episode.close() case final event?) event,
+    ];
+  }
+}
+
+/// Hysteresis state for one event type. [sign] -1 detects values at or
+/// below -on (decelerations) and reports a negative peak.
+class _Episode {
+  final AthleteEventType type;
+  final double on;
+  final double off;
+  final int minMs;
+  final int refractoryMs;
+  final int sign;
+
+  int? _startMs;
+  int _lastMs = 0;
+  double _peak = 0;
+  double _distanceM = 0;
+  int? _lastEventEndMs;
+
+  _Episode(
+    this.type,
+    this.on,
+    this.off,
+    this.minMs, {
+    this.refractoryMs = 0,
+    this.sign = 1,
+  });
+
+  AthleteEvent? update(int timeMs, double value, double stepM) {
+    final v = value * sign;
+    if (_startMs == null) {
+      final lastEnd = _lastEventEndMs;
+      // Ticks restart when the pod reboots, so a later event can be earlier
+      if (v >= on &&
+          (lastEnd == null ||
+              timeMs < lastEnd ||
+              timeMs - lastEnd >= refractoryMs)) {
+        _startMs = timeMs;
+        _lastMs = timeMs;
+        _peak = v;
+        _distanceM = 0;
+      }
+      return null;
+    }
+    if (v >= off) {
+      _lastMs = timeMs;
+      _peak = max(_peak, v);
+      _distanceM += stepM;
+      return null;
+    }
+    return close();
+  }
+
+  AthleteEvent? close() {
+    final start = _startMs;
+    if (start == null) return null;
+    _startMs = null;
+    if (_lastMs - start < minMs) return null;
+    _lastEventEndMs = _lastMs;
+    return AthleteEvent(
+      type: type,
+      startMs: start,
+      endMs: _lastMs,
+      peak: _peak * sign,
+      distanceM: _distanceM,
+    );
+  }
+}
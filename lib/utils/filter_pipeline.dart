@@ -1,7 +1,10 @@
 import 'dart:math';
+import 'dart:typed_data';
 import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/record_anomalies.dart';
 import 'package:metric_athlete_pod_ble/utils/trajectory_filter.dart';
 import 'package:metric_athlete_pod_ble/utils/butterworth_filter.dart';
+import 'package:metric_athlete_pod_ble/utils/log_resampler.dart';
 
 /// Configuration for the unified filter pipeline.
 ///
@@ -22,13 +25,21 @@ class FilterConfig {
   /// Enable speed-based outlier rejection (from Python pipeline).
   final bool enableOutlierRejection;
 
-  /// Butterworth cutoff frequency in Hz.
+  /// Butterworth cutoff frequency in Hz. Capped at the Nyquist frequency of
+  /// the sampling rate.
   final double butterworthCutoffHz;
 
-  /// Butterworth sampling frequency in Hz.
-  final double butterworthSamplingHz;
+  /// Butterworth sampling frequency in Hz. When null it follows the file's
+  /// log interval (10 Hz at 100 ms).
+  final double? butterworthSamplingHz;
 
-  /// Maximum allowed GPS jump in meters per 100ms interval.
+  /// Resample the repaired session to this interval (ms) so files logged at
+  /// different intervals can be compared sample for sample. Null keeps the
+  /// file's own interval. See [LogResampler].
+  final int? resampleIntervalMs;
+
+  /// Maximum allowed GPS jump in meters per 100ms interval (scaled to the
+  /// actual log interval).
   /// If exceeded, speed-inferred distance is used instead.
   final double maxGpsJumpMeters;
 
@@ -43,7 +54,8 @@ class FilterConfig {
     this.enableKalmanRts = false,
     this.enableOutlierRejection = false,
     this.butterworthCutoffHz = 5.0,
-    this.butterworthSamplingHz = 10.0,
+    this.butterworthSamplingHz,
+    this.resampleIntervalMs,
     this.maxGpsJumpMeters = 1.0,
     this.trajectoryConfig,
   });
@@ -57,12 +69,20 @@ class FilterPipelineResult {
   final int repairedCount;
   final int outliersCorrected;
 
+  /// Logs removed by the sanity check.
+  final int rejectedCount;
+
+  /// Spacing of [logs] in ms (the file's interval, or the resample target).
+  final int logIntervalMs;
+
   FilterPipelineResult({
     required this.logs,
     required this.healthScore,
     required this.originalCount,
     required this.repairedCount,
     required this.outliersCorrected,
+    this.rejectedCount = 0,
+    this.logIntervalMs = LogInterval.defaultMs,
   });
 }
 
@@ -84,11 +104,25 @@ class FilterPipeline {
     return processWithConfig(logs, const FilterConfig());
   }
 
+  /// Process the output of [BinaryParser.parse], reusing its per-record
+  /// anomaly flags for the sanity check. Also suitable for `compute()`.
+  static FilterPipelineResult processParsed(ParsedLogs parsed) {
+    return processWithConfig(
+      parsed.logs,
+      const FilterConfig(),
+      anomalies: parsed.anomalies,
+    );
+  }
+
   /// Process with explicit configuration.
+  ///
+  /// [anomalies] are optional precomputed [RecordAnomaly] flags aligned with
+  /// [logs] (see [processParsed]).
   static FilterPipelineResult processWithConfig(
     List<SensorLog> logs,
-    FilterConfig config,
-  ) {
+    FilterConfig config, {
+    Uint8List? anomalies,
+  }) {
     if (logs.isEmpty) {
       return FilterPipelineResult(
         logs: [],
@@ -111,12 +145,14 @@ class FilterPipeline {
       trajectoryResult = TrajectoryFilter.processWithConfig(
         logs,
         trajectoryConfig,
+        anomalies: anomalies,
       );
     } else {
       // Lightweight: sanity + gap repair only (skip GPS smoothing)
       trajectoryResult = TrajectoryFilter.sanitizeAndRepairOnly(
         logs,
         trajectoryConfig,
+        anomalies: anomalies,
       );
     }
 
@@ -130,17 +166,31 @@ class FilterPipeline {
         originalCount: trajectoryResult.originalCount,
         repairedCount: trajectoryResult.repairedCount,
         outliersCorrected: 0,
+        rejectedCount: trajectoryResult.rejectedCount,
+        logIntervalMs: trajectoryResult.logIntervalMs,
+      );
+    }
+
+    // Optional: resample to a common rate (anti-aliased for IMU)
+    int intervalMs = trajectoryResult.logIntervalMs;
+    final targetMs = config.resampleIntervalMs;
+    if (targetMs != null && targetMs > 0 && targetMs != intervalMs) {
+      processedLogs = LogResampler.resample(
+        processedLogs,
+        targetIntervalMs: targetMs,
+        sourceIntervalMs: intervalMs,
       );
+      intervalMs = targetMs;
     }
 
     // Stage 3: Butterworth low-pass on IMU channels
     if (config.enableButterworth && processedLogs.length >= 6) {
-      processedLogs = _applyButterworth(processedLogs, config);
+      processedLogs = _applyButterworth(processedLogs, config, intervalMs);
     }
 
     // Stage 5: Speed-based outlier rejection
     if (config.enableOutlierRejection && processedLogs.length >= 2) {
-      final result = _applyOutlierRejection(processedLogs, config);
+      final result = _applyOutlierRejection(processedLogs, config, intervalMs);
       processedLogs = result.$1;
       outliersCorrected = result.$2;
     }
@@ -151,6 +201,8 @@ class FilterPipeline {
       originalCount: trajectoryResult.originalCount,
       repairedCount: trajectoryResult.repairedCount,
       outliersCorrected: outliersCorrected,
+      rejectedCount: trajectoryResult.rejectedCount,
+      logIntervalMs: intervalMs,
     );
   }
 
@@ -158,10 +210,12 @@ class FilterPipeline {
   static List<SensorLog> _applyButterworth(
     List<SensorLog> logs,
     FilterConfig config,
+    int intervalMs,
   ) {
+    final samplingHz = config.butterworthSamplingHz ?? 1000.0 / intervalMs;
     final filter = ButterworthFilter(
-      cutoffHz: config.butterworthCutoffHz,
-      samplingHz: config.butterworthSamplingHz,
+      cutoffHz: min(config.butterworthCutoffHz, samplingHz / 2),
+      samplingHz: samplingHz,
     );
 
     // Extract channels
@@ -196,8 +250,8 @@ class FilterPipeline {
   /// Speed-based outlier rejection from the Python pipeline.
   ///
   /// If the Haversine distance between consecutive points exceeds
-  /// [maxGpsJumpMeters] in a single 100ms interval, replace the GPS position
-  /// with the speed-inferred position.
+  /// [maxGpsJumpMeters] (scaled from 100 ms to [intervalMs]) in a single
+  /// interval, replace the GPS position with the speed-inferred position.
   ///
   /// Compares against last *accepted* (non-corrected) position to prevent
   /// correction cascade drift. Limits consecutive corrections to 3 before
@@ -205,7 +259,10 @@ class FilterPipeline {
   static (List<SensorLog>, int) _applyOutlierRejection(
     List<SensorLog> logs,
     FilterConfig config,
+    int intervalMs,
   ) {
+    final maxJumpMeters = config.maxGpsJumpMeters * intervalMs / 100.0;
+    final maxStepSec = 1.5 * intervalMs / 1000.0;
     final List<SensorLog> corrected = [logs[0]];
     int corrections = 0;
     int consecutiveCorrections = 0;
@@ -230,8 +287,8 @@ class FilterPipeline {
 
       if (consecutiveCorrections < 3 &&
           timeDiffSec > 0 &&
-          timeDiffSec <= 0.15 &&
-          distance > config.maxGpsJumpMeters) {
+          timeDiffSec <= maxStepSec &&
+          distance > maxJumpMeters) {
         // Use speed-inferred distance instead of GPS jump
         double avgSpeedMs =
             ((prev.speed + curr.speed) / 2.0) / 3.6; // km/h -> m/s
@@ -0,0 +1,223 @@
+import 'dart:math';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/butterworth_filter.dart';
+
+/// Log interval detection for pod files.
+///
+/// The pod logs every 100-1000 ms in 100 ms steps (`setLogInterval`). The
+/// kernel tick counts milliseconds, so the interval is the typical tick
+/// delta snapped to the nearest standard value, the same way the native
+/// Smart Peek estimates duration (`SnapToStandardInterval`).
+class LogInterval {
+  /// Intervals the firmware accepts, in ms.
+  static const List<int> standardMs = [
+    100,
+    200,
+    300,
+    400,
+    500,
+    600,
+    700,
+    800,
+    900,
+    1000,
+  ];
+
+  /// Used when nothing can be measured (original 10 Hz firmware default).
+  static const int defaultMs = 100;
+
+  /// Nearest entry of [standardMs] to [rawMs].
+  static int snap(int rawMs) {
+    int closest = standardMs.last;
+    int minDiff = 1 << 62;
+    for (final t in standardMs) {
+      final d = (rawMs - t).abs();
+      if (d < minDiff) {
+        minDiff = d;
+        closest = t;
+      }
+    }
+    return closest;
+  }
+
+  /// Typical kernel tick delta of [sorted] (sorted by packetId, deduplicated).
+  ///
+  /// Samples up to 50 consecutive deltas and takes the median after IQR
+  /// outlier rejection, so lost packets and power-on irregularities do not
+  /// skew it. Falls back to [defaultMs] when there is nothing to measure.
+  static int kernelStep(List<SensorLog> sorted) {
+    final sampleSize = min(sorted.length, 51);
+    if (sampleSize < 2) return defaultMs;
+
+    final diffs = <int>[];
+    for (int i = 1; i < sampleSize; i++) {
+      final d = sorted[i].packetId - sorted[i - 1].packetId;
+      if (d > 0 && d < 5000) diffs.add(d);
+    }
+    if (diffs.isEmpty) return defaultMs;
+
+    diffs.sort();
+    if (diffs.length < 3) return diffs[diffs.length ~/ 2];
+
+    final q1 = diffs[diffs.length ~/ 4];
+    final q3 = diffs[(diffs.length * 3) ~/ 4];
+    final iqr = q3 - q1;
+    final lowerBound = q1 - 1.5 * iqr;
+    final upperBound = q3 + 1.5 * iqr;
+    final filtered =
+        diffs.where((d) => d >= lowerBound && d <= upperBound).toList();
+    return filtered.isNotEmpty
+        ? filtered[filtered.length ~/ 2]
+        : diffs[diffs.length ~/ 2];
+  }
+
+  /// Log interval of [sorted] in ms (sorted by packetId, deduplicated).
+  ///
+  /// Uses the kernel tick step when it is a plausible millisecond interval;
+  /// otherwise the median positive RTC timestamp delta. Both are snapped to
+  /// [standardMs].
+  static int detect(List<SensorLog> sorted, {int? kernelStep}) {
+    final step = kernelStep ?? LogInterval.kernelStep(sorted);
+    if (step >= standardMs.first ~/ 2 && step <= standardMs.last * 11 ~/ 10) {
+      return snap(step);
+    }
+
+    final sampleSize = min(sorted.length, 51);
+    final deltas = <int>[];
+    for (int i = 1; i < sampleSize; i++) {
+      final d =
+          sorted[i].timestamp.difference(sorted[i - 1].timestamp).inMilliseconds;
+      if (d > 0) deltas.add(d);
+    }
+    if (deltas.isEmpty) return defaultMs;
+    deltas.sort();
+    return snap(deltas[deltas.length ~/ 2]);
+  }
+}
+
+/// Resamples a repaired, time-ordered session onto a fixed grid so sessions
+/// logged at different intervals can be compared sample for sample.
+///
+/// * Grid points are multiples of the target interval since the epoch, so
+///   two sessions resampled to the same rate share timestamps.
+/// * Every channel is linearly interpolated between the bracketing samples;
+///   grid points inside a gap longer than [maxBridgeIntervals] source
+///   intervals (pauses / file merges) are skipped instead of invented.
+/// * When downsampling, IMU channels are first low-pass filtered (zero-phase
+///   Butterworth at [antiAliasRatio] × the target Nyquist frequency) so
+///   impacts between output samples do not alias into the result. GPS and
+///   speed are not filtered: they are already smooth at pod rates.
+class LogResampler {
+  /// Largest gap (in source intervals) that is interpolated across.
+  static const int maxBridgeIntervals = 2;
+
+  /// Anti-alias cutoff as a fraction of the target Nyquist frequency.
+  static const double antiAliasRatio = 0.8;
+
+  /// Resamples [logs] (sorted by time) to [targetIntervalMs].
+  ///
+  /// [sourceIntervalMs] defaults to [LogInterval.detect]. Returns [logs]
+  /// unchanged when both intervals are equal and every sample is already on
+  /// the grid.
+  static List<SensorLog> resample(
+    List<SensorLog> logs, {
+    required int targetIntervalMs,
+    int? sourceIntervalMs,
+    bool antiAlias = true,
+  }) {
+    if (logs.length < 2 || targetIntervalMs <= 0) return List.of(logs);
+    final sourceMs = sourceIntervalMs ?? LogInterval.detect(logs);
+    if (sourceMs == targetIntervalMs &&
+        logs.every(
+          (l) => l.timestamp.millisecondsSinceEpoch % targetIntervalMs == 0,
+        )) {
+      return List.of(logs);
+    }
+
+    final source =
+        antiAlias && targetIntervalMs > sourceMs
+            ? _lowPassImu(logs, sourceMs, targetIntervalMs)
+            : logs;
+
+    final maxBridgeMs = maxBridgeIntervals * sourceMs;
+    final startMs = source.first.timestamp.millisecondsSinceEpoch;
+    final endMs = source.last.timestamp.millisecondsSinceEpoch;
+    final result = <SensorLog>[];
+
+    int j = 0;
+    // First grid point at or after the first sample
+    int t = (startMs + targetIntervalMs - 1) ~/ targetIntervalMs *
+        targetIntervalMs;
+    for (; t <= endMs; t += targetIntervalMs) {
+      while (j + 1 < source.length &&
+          source[j + 1].timestamp.millisecondsSinceEpoch <= t) {
+        j++;
+      }
+      final a = source[j];
+      final aMs = a.timestamp.millisecondsSinceEpoch;
+      if (aMs == t || j + 1 >= source.length) {
+        if (aMs == t) result.add(_at(a, a, 0, t));
+        continue;
+      }
+
+      final b = source[j + 1];
+      final bMs = b.timestamp.millisecondsSinceEpoch;
+      final span = bMs - aMs;
+      if (span <= 0 || span > maxBridgeMs) continue;
+      result.add(_at(a, b, (t - aMs) / span, t));
+    }
+    return result;
+  }
+
+  static SensorLog _at(SensorLog a, SensorLog b, double r, int epochMs) {
+    double lerp(double x, double y) => x + (y - x) * r;
+    return a.copyWith(
+      packetId: a.packetId + ((b.packetId - a.packetId) * r).round(),
+      timestamp: DateTime.fromMillisecondsSinceEpoch(
+        epochMs,
+        isUtc: a.timestamp.isUtc,
+      ),
+      latitude: lerp(a.latitude, b.latitude),
+      longitude: lerp(a.longitude, b.longitude),
+      speed: lerp(a.speed, b.speed),
+      accelX: lerp(a.accelX, b.accelX),
+      accelY: lerp(a.accelY, b.accelY),
+      accelZ: lerp(a.accelZ, b.accelZ),
+      gyroX: lerp(a.gyroX, b.gyroX),
+      gyroY: lerp(a.gyroY, b.gyroY),
+      gyroZ: lerp(a.gyroZ, b.gyroZ),
+      filteredAccelX: lerp(a.filteredAccelX, b.filteredAccelX),
+      filteredAccelY: lerp(a.filteredAccelY, b.filteredAccelY),
+      filteredAccelZ: lerp(a.filteredAccelZ, b.filteredAccelZ),
+    );
+  }
+
+  static List<SensorLog> _lowPassImu(
+    List<SensorLog> logs,
+    int sourceMs,
+    int targetMs,
+  ) {
+    final samplingHz = 1000.0 / sourceMs;
+    final cutoffHz = antiAliasRatio * 500.0 / targetMs;
+    final filter = ButterworthFilter(cutoffHz: cutoffHz, samplingHz: samplingHz);
+
+    final ax = filter.filtfilt([for (final l in logs) l.accelX]);
+    final ay = filter.filtfilt([for (final l in logs) l.accelY]);
+    final az = filter.filtfilt([for (final l in logs) l.accelZ]);
+    final gx = filter.filtfilt([for (final l in logs) l.gyroX]);
+    final gy = filter.filtfilt([for (final l in logs) l.gyroY]);
+    final gz = filter.filtfilt([for (final l in logs) l.gyroZ]);
+
+    return List.generate(
+      logs.length,
+      (i) => logs[i].copyWith(
+        accelX: ax[i],
+        accelY: ay[i],
+        accelZ: az[i],
+        gyroX: gx[i],
+        gyroY: gy[i],
+        gyroZ: gz[i],
+      ),
+    );
+  }
+}
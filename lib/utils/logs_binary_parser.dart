@@ -1,6 +1,10 @@
 import 'dart:typed_data';
 import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/transport/transfer_integrity.dart';
+import 'package:metric_athlete_pod_ble/utils/data_quality_report.dart';
 import 'package:metric_athlete_pod_ble/utils/pod_logger.dart';
+import 'package:metric_athlete_pod_ble/utils/record_anomalies.dart';
+import 'package:metric_athlete_pod_ble/utils/sanity_kernel.dart';
 
 /// Class used to parse downloaded .bin file [rawBytes] into [SensorLog] objects.
 /// The [rawBytes] are expected to be in Little Endian format.
@@ -73,7 +77,28 @@ class BinaryParser {
   /// | 35 | Gyro X | Float32 | 4 |
   /// | 39 | Gyro Y | Float32 | 4 |
   /// | 43 | Gyro Z | Float32 | 4 |
-  static List<SensorLog> parseBytes(Uint8List rawBytes) {
+  ///
+  /// When the native reassembler supplied an [integrity] summary that
+  /// describes [rawBytes], records are read at its fixed stride and only the
+  /// ones flagged valid are decoded — no size detection or sync scanning.
+  static List<SensorLog> parseBytes(
+    Uint8List rawBytes, {
+    TransferIntegrity? integrity,
+  }) => parse(rawBytes, integrity: integrity).logs;
+
+  /// Same as [parseBytes], but also returns the per-record [RecordAnomaly]
+  /// flags and a [DataQualityReport]. Decoded values are written to float32
+  /// columns as they are read, and [SanityKernel] evaluates the flags over
+  /// those columns once decoding finishes. Pass the flags on to
+  /// [FilterPipeline] / [TrajectoryFilter] so the sanity stage does not
+  /// re-scan the logs.
+  static ParsedLogs parse(Uint8List rawBytes, {TransferIntegrity? integrity}) {
+    if (integrity != null &&
+        _isKnownSize(integrity.recordSize) &&
+        integrity.describes(rawBytes)) {
+      return _parseWithBitmap(rawBytes, integrity);
+    }
+
     final detectedSize = _detectPacketSize(rawBytes);
     PodLogger.info(
       'parser',
@@ -81,10 +106,11 @@ class BinaryParser {
       detail:
           '${detectedSize}B, totalPayload=${rawBytes.length}B, estRecords=${rawBytes.length ~/ detectedSize}',
     );
-    final logs =
+    final parsed =
         detectedSize == v01DataSize
             ? _parseV01(rawBytes, detectedSize)
             : _parse(rawBytes, detectedSize);
+    final logs = parsed.logs;
     if (logs.isNotEmpty) {
       PodLogger.info(
         'parser',
@@ -93,7 +119,66 @@ class BinaryParser {
             '${logs.length} records, first=${logs.first.timestamp.toIso8601String()}, last=${logs.last.timestamp.toIso8601String()}',
       );
     }
-    return logs;
+    return parsed;
+  }
+
+  static bool _isKnownSize(int size) =>
+      size == v01DataSize || size == dataSize || size == packetSize;
+
+  /// Fixed-stride parse driven by the native validity bitmap.
+  static ParsedLogs _parseWithBitmap(
+    Uint8List rawBytes,
+    TransferIntegrity integrity,
+  ) {
+    final data = ByteData.sublistView(rawBytes);
+    final stepSize = integrity.recordSize;
+    final isV01 = stepSize == v01DataSize;
+    final logs = <SensorLog>[];
+    final columns = SensorColumns(integrity.records);
+    final quality = DataQualityAccumulator();
+    int parseErrors = 0;
+
+    for (int i = 0; i < integrity.records; i++) {
+      if (!integrity.isRecordValid(i)) {
+        quality.rejectedRecord();
+        continue;
+      }
+      try {
+        final offset = i * stepSize;
+        final log =
+            isV01 ? _decodeRecordV01(data, offset) : _decodeRecord(data, offset);
+        columns.add(log);
+        quality.addRecord(log);
+        logs.add(log);
+      } catch (e) {
+        parseErrors++;
+        quality.parseError();
+      }
+    }
+
+    PodLogger.info(
+      'parser',
+      'Bitmap parse',
+      detail:
+          '${stepSize}B stride, ${logs.length}/${integrity.records} records'
+          '${parseErrors > 0 ? ', parseErrors=$parseErrors' : ''}',
+    );
+    return _finish(logs, columns, quality);
+  }
+
+  /// Runs the vectorized sanity check over the decoded columns and packages
+  /// the result.
+  static ParsedLogs _finish(
+    List<SensorLog> logs,
+    SensorColumns columns,
+    DataQualityAccumulator quality,
+  ) {
+    final anomalies = SanityKernel.classify(columns);
+    return ParsedLogs(
+      logs: logs,
+      anomalies: anomalies,
+      quality: quality.finish(columns, anomalies),
+    );
   }
 
   /// Detect packet size by finding the first two valid headers and
@@ -101,14 +186,13 @@ class BinaryParser {
   ///
   /// Checks for 47 (v01), 61 (Proewe), and 64 (HTS) byte records.
   static int _detectPacketSize(Uint8List rawBytes) {
-    final data = ByteData.sublistView(rawBytes);
     int? firstOffset;
 
     // Minimum data size needed for header validation is v01DataSize (47)
     final minSize = v01DataSize;
 
     for (var i = 0; i + minSize <= rawBytes.length; i++) {
-      if (!_isValidHeader(data, i)) continue;
+      if (!RecordHeader.isPlausible(rawBytes, i)) continue;
 
       if (firstOffset == null) {
         firstOffset = i;
@@ -143,21 +227,11 @@ class BinaryParser {
     return packetSize; // default
   }
 
-  /// Check whether bytes at [offset] form a plausible packet header.
-  static bool _isValidHeader(ByteData data, int offset) {
-    if (offset + 8 > data.lengthInBytes) return false;
-
-    final year = data.getUint16(offset + 4, Endian.little);
-    if (year < 2022 || year > 2030) return false;
-
-    final month = data.getUint8(offset + 6);
-    final day = data.getUint8(offset + 7);
-    return month >= 1 && month <= 12 && day >= 1 && day <= 31;
-  }
-
   /// Core parse loop using the given [stepSize] per packet.
-  static List<SensorLog> _parse(Uint8List rawBytes, int stepSize) {
+  static ParsedLogs _parse(Uint8List rawBytes, int stepSize) {
     final List<SensorLog> logs = [];
+    final columns = SensorColumns(rawBytes.length ~/ stepSize + 1);
+    final quality = DataQualityAccumulator();
     final ByteData data = ByteData.sublistView(rawBytes);
     int offset = 0;
     int syncSkips = 0;
@@ -165,64 +239,24 @@ class BinaryParser {
 
     while (offset + dataSize <= rawBytes.length) {
       // --- 1. SYNC CHECK ---
-      if (!_isValidHeader(data, offset)) {
+      if (!RecordHeader.isPlausible(rawBytes, offset)) {
         offset++;
         syncSkips++;
+        quality.syncSkip();
         continue;
       }
 
       // --- 2. EXTRACTION ---
       try {
-        final int kernelTick = data.getUint32(offset + 0, Endian.little);
-        final int year = data.getUint16(offset + 4, Endian.little);
-        final int month = data.getUint8(offset + 6);
-        final int day = data.getUint8(offset + 7);
-        final int hour = data.getUint8(offset + 8);
-        final int min = data.getUint8(offset + 9);
-        final int sec = data.getUint8(offset + 10);
-        final int ms = data.getUint16(offset + 11, Endian.little);
-
-        final DateTime dt = DateTime(year, month, day, hour, min, sec, ms);
-
-        final double lat = data.getFloat32(offset + 13, Endian.little);
-        final double lon = data.getFloat32(offset + 17, Endian.little);
-        final double speed = data.getFloat32(offset + 21, Endian.little);
-
-        final double ax = data.getFloat32(offset + 25, Endian.little);
-        final double ay = data.getFloat32(offset + 29, Endian.little);
-        final double az = data.getFloat32(offset + 33, Endian.little);
-
-        final double gx = data.getFloat32(offset + 37, Endian.little);
-        final double gy = data.getFloat32(offset + 41, Endian.little);
-        final double gz = data.getFloat32(offset + 45, Endian.little);
-
-        final double filtAx = data.getFloat32(offset + 49, Endian.little);
-        final double filtAy = data.getFloat32(offset + 53, Endian.little);
-        final double filtAz = data.getFloat32(offset + 57, Endian.little);
-
-        logs.add(
-          SensorLog(
-            packetId: kernelTick,
-            timestamp: dt,
-            latitude: lat,
-            longitude: lon,
-            speed: speed,
-            accelX: ax,
-            accelY: ay,
-            accelZ: az,
-            gyroX: gx,
-            gyroY: gy,
-            gyroZ: gz,
-            filteredAccelX: filtAx,
-            filteredAccelY: filtAy,
-            filteredAccelZ: filtAz,
-          ),
-        );
-
+        final log = _decodeRecord(data, offset);
+        columns.add(log);
+        quality.addRecord(log);
+        logs.add(log);
         offset += stepSize;
       } catch (e) {
         offset++;
         parseErrors++;
+        quality.parseError();
       }
     }
 
@@ -235,7 +269,7 @@ class BinaryParser {
       );
     }
 
-    return logs;
+    return _finish(logs, columns, quality);
   }
 
   /// Parse loop for V3.6 firmware v01 format (47-byte records).
@@ -243,8 +277,10 @@ class BinaryParser {
   /// Key differences from 61/64-byte format:
   /// - Speed is uint16 (km/h × 10) at offset 21 instead of float32
   /// - No filtered accelerometer data (fields set to raw accel as fallback)
-  static List<SensorLog> _parseV01(Uint8List rawBytes, int stepSize) {
+  static ParsedLogs _parseV01(Uint8List rawBytes, int stepSize) {
     final List<SensorLog> logs = [];
+    final columns = SensorColumns(rawBytes.length ~/ stepSize + 1);
+    final quality = DataQualityAccumulator();
     final ByteData data = ByteData.sublistView(rawBytes);
     int offset = 0;
     int syncSkips = 0;
@@ -252,67 +288,24 @@ class BinaryParser {
 
     while (offset + v01DataSize <= rawBytes.length) {
       // --- 1. SYNC CHECK ---
-      if (!_isValidHeader(data, offset)) {
+      if (!RecordHeader.isPlausible(rawBytes, offset)) {
         offset++;
         syncSkips++;
+        quality.syncSkip();
         continue;
       }
 
       // --- 2. EXTRACTION ---
       try {
-        final int kernelTick = data.getUint32(offset + 0, Endian.little);
-        final int year = data.getUint16(offset + 4, Endian.little);
-        final int month = data.getUint8(offset + 6);
-        final int day = data.getUint8(offset + 7);
-        final int hour = data.getUint8(offset + 8);
-        final int min = data.getUint8(offset + 9);
-        final int sec = data.getUint8(offset + 10);
-        final int ms = data.getUint16(offset + 11, Endian.little);
-
-        final DateTime dt = DateTime(year, month, day, hour, min, sec, ms);
-
-        final double lat = data.getFloat32(offset + 13, Endian.little);
-        final double lon = data.getFloat32(offset + 17, Endian.little);
-
-        // V3.6: Speed is uint16 (km/h × 10). Divide by 10 to get km/h.
-        // SensorLog.speed convention is km/h — converted to m/s downstream
-        // in sensor_log_to_gps_points.dart.
-        final double speed = data.getUint16(offset + 21, Endian.little) / 10.0;
-
-        // IMU data starts 2 bytes earlier (offset 23 vs 25) due to smaller speed field
-        final double ax = data.getFloat32(offset + 23, Endian.little);
-        final double ay = data.getFloat32(offset + 27, Endian.little);
-        final double az = data.getFloat32(offset + 31, Endian.little);
-
-        final double gx = data.getFloat32(offset + 35, Endian.little);
-        final double gy = data.getFloat32(offset + 39, Endian.little);
-        final double gz = data.getFloat32(offset + 43, Endian.little);
-
-        logs.add(
-          SensorLog(
-            packetId: kernelTick,
-            timestamp: dt,
-            latitude: lat,
-            longitude: lon,
-            speed: speed,
-            accelX: ax,
-            accelY: ay,
-            accelZ: az,
-            gyroX: gx,
-            gyroY: gy,
-            gyroZ: gz,
-            // V3.6 has no filtered accel — use raw accel as fallback so the
-            // trajectory filter's variance calculator can still detect motion.
-            filteredAccelX: ax,
-            filteredAccelY: ay,
-            filteredAccelZ: az,
-          ),
-        );
-
+        final log = _decodeRecordV01(data, offset);
+        columns.add(log);
+        quality.addRecord(log);
+        logs.add(log);
         offset += stepSize;
       } catch (e) {
         offset++;
         parseErrors++;
+        quality.parseError();
       }
     }
 
@@ -325,6 +318,103 @@ class BinaryParser {
       );
     }
 
-    return logs;
+    return _finish(logs, columns, quality);
+  }
+
+  /// Decodes one 61/64-byte record starting at [offset].
+  static SensorLog _decodeRecord(ByteData data, int offset) {
+    final int kernelTick = data.getUint32(offset + 0, Endian.little);
+    final int year = data.getUint16(offset + 4, Endian.little);
+    final int month = data.getUint8(offset + 6);
+    final int day = data.getUint8(offset + 7);
+    final int hour = data.getUint8(offset + 8);
+    final int min = data.getUint8(offset + 9);
+    final int sec = data.getUint8(offset + 10);
+    final int ms = data.getUint16(offset + 11, Endian.little);
+
+    final DateTime dt = DateTime(year, month, day, hour, min, sec, ms);
+
+    final double lat = data.getFloat32(offset + 13, Endian.little);
+    final double lon = data.getFloat32(offset + 17, Endian.little);
+    final double speed = data.getFloat32(offset + 21, Endian.little);
+
+    final double ax = data.getFloat32(offset + 25, Endian.little);
+    final double ay = data.getFloat32(offset + 29, Endian.little);
+    final double az = data.getFloat32(offset + 33, Endian.little);
+
+    final double gx = data.getFloat32(offset + 37, Endian.little);
+    final double gy = data.getFloat32(offset + 41, Endian.little);
+    final double gz = data.getFloat32(offset + 45, Endian.little);
+
+    final double filtAx = data.getFloat32(offset + 49, Endian.little);
+    final double filtAy = data.getFloat32(offset + 53, Endian.little);
+    final double filtAz = data.getFloat32(offset + 57, Endian.little);
+
+    return SensorLog(
+      packetId: kernelTick,
+      timestamp: dt,
+      latitude: lat,
+      longitude: lon,
+      speed: speed,
+      accelX: ax,
+      accelY: ay,
+      accelZ: az,
+      gyroX: gx,
+      gyroY: gy,
+      gyroZ: gz,
+      filteredAccelX: filtAx,
+      filteredAccelY: filtAy,
+      filteredAccelZ: filtAz,
+    );
+  }
+
+  /// Decodes one 47-byte v01 record starting at [offset].
+  static SensorLog _decodeRecordV01(ByteData data, int offset) {
+    final int kernelTick = data.getUint32(offset + 0, Endian.little);
+    final int year = data.getUint16(offset + 4, Endian.little);
+    final int month = data.getUint8(offset + 6);
+    final int day = data.getUint8(offset + 7);
+    final int hour = data.getUint8(offset + 8);
+    final int min = data.getUint8(offset + 9);
+    final int sec = data.getUint8(offset + 10);
+    final int ms = data.getUint16(offset + 11, Endian.little);
+
+    final DateTime dt = DateTime(year, month, day, hour, min, sec, ms);
+
+    final double lat = data.getFloat32(offset + 13, Endian.little);
+    final double lon = data.getFloat32(offset + 17, Endian.little);
+
+    // V3.6: Speed is uint16 (km/h × 10). Divide by 10 to get km/h.
+    // SensorLog.speed convention is km/h — converted to m/s downstream
+    // in sensor_log_to_gps_points.dart.
+    final double speed = data.getUint16(offset + 21, Endian.little) / 10.0;
+
+    // IMU data starts 2 bytes earlier (offset 23 vs 25) due to smaller speed field
+    final double ax = data.getFloat32(offset + 23, Endian.little);
+    final double ay = data.getFloat32(offset + 27, Endian.little);
+    final double az = data.getFloat32(offset + 31, Endian.little);
+
+    final double gx = data.getFloat32(offset + 35, Endian.little);
+    final double gy = data.getFloat32(offset + 39, Endian.little);
+    final double gz = data.getFloat32(offset + 43, Endian.little);
+
+    return SensorLog(
+      packetId: kernelTick,
+      timestamp: dt,
+      latitude: lat,
+      longitude: lon,
+      speed: speed,
+      accelX: ax,
+      accelY: ay,
+      accelZ: az,
+      gyroX: gx,
+      gyroY: gy,
+      gyroZ: gz,
+      // V3.6 has no filtered accel — use raw accel as fallback so the
+      // trajectory filter's variance calculator can still detect motion.
+      filteredAccelX: ax,
+      filteredAccelY: ay,
+      filteredAccelZ: az,
+    );
   }
 }
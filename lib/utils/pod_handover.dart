@@ -0,0 +1,86 @@
+import 'dart:async';
+
+/// Firmware handover between file requests.
+///
+/// After a transfer ends or is cancelled the firmware still has to close the
+/// file pointer before it accepts the next request. Native cores that probe
+/// for this emit "Pod Ready" on the status stream once the pod answers (or
+/// the probes run out); other platforms fall back to a fixed delay.
+///
+/// Every native cancel is also answered by one skip marker (0xDA) on the
+/// payload stream. Those answer our own cancel, not the request that follows
+/// it, so [takeOwnSkip] lets the caller drop them instead of completing the
+/// next download with nothing.
+class PodHandover {
+  /// Legacy fixed handover for platforms that never report "Pod Ready".
+  static const legacyFallback = Duration(milliseconds: 500);
+
+  /// For cores that do report "Pod Ready", which they send even when the
+  /// probes run out: up to kReadyFallbackMs (500 ms) of learned gap plus
+  /// kReadyProbeAttempts (4) x kReadyProbeIntervalMs (150 ms) in
+  /// PodBLECore, with headroom for the platform thread. Giving up sooner
+  /// would send the next request to a pod that has not settled.
+  static const probedFallback = Duration(milliseconds: 500 + 4 * 150 + 400);
+
+  PodHandover({this.fallback = legacyFallback});
+
+  /// How long [waitUntilReady] waits for "Pod Ready" before giving up.
+  final Duration fallback;
+
+  bool _ready = true;
+  Completer<void>? _readyCompleter;
+  int _ownSkips = 0;
+
+  bool get isReady => _ready;
+
+  /// A file request went out; the pod is busy until it reports ready.
+  void requestIssued() => _ready = false;
+
+  /// A native cancel went out; its 0xDA and "Pod Ready" are still to come.
+  void cancelIssued() {
+    _ready = false;
+    _ownSkips++;
+  }
+
+  /// "Pod Ready" arrived.
+  void markReady() {
+    _ready = true;
+    if (_readyCompleter != null && !_readyCompleter!.isCompleted) {
+      _readyCompleter!.complete();
+    }
+    _readyCompleter = null;
+  }
+
+  /// Returns true if a 0xDA answers one of our own cancels and must be
+  /// dropped rather than handed to a download.
+  bool takeOwnSkip() {
+    if (_ownSkips == 0) return false;
+    _ownSkips--;
+    return true;
+  }
+
+  /// Disconnected: nothing more is owed.
+  void reset() {
+    _ownSkips = 0;
+    markReady();
+  }
+
+  /// Waits until the pod can accept the next file request.
+  ///
+  /// Returns immediately if the pod is already ready, otherwise waits for
+  /// [markReady] up to [fallback]. Returns the time actually spent waiting.
+  Future<Duration> waitUntilReady() async {
+    final stopwatch = Stopwatch()..start();
+    if (!_ready) {
+      _readyCompleter ??= Completer<void>();
+      try {
+        await _readyCompleter!.future.timeout(fallback);
+      } on TimeoutException {
+        _readyCompleter = null;
+        _ready = true;
+      }
+    }
+    stopwatch.stop();
+    return stopwatch.elapsed;
+  }
+}
@@ -1,5 +1,3 @@
-import 'package:flutter/foundation.dart';
-
 /// Severity levels for diagnostic logging.
 enum LogLevel { debug, info, warn, error }
 
@@ -43,6 +41,12 @@ class PodLogger {
   /// Set this to forward logs to Crashlytics, Sentry, or custom analytics.
   static void Function(PodLogEntry entry)? onLog;
 
+  /// Whether entries are echoed to the console. On by default in debug
+  /// builds. Flutter-free so headless tools can use the same code paths.
+  static bool printToConsole =
+      !bool.fromEnvironment('dart.vm.product') &&
+      !bool.fromEnvironment('dart.vm.profile');
+
   static void _log(LogLevel level, String category, String message, {String? detail}) {
     final entry = PodLogEntry(level: level, category: category, message: message, detail: detail);
 
@@ -53,8 +57,9 @@ class PodLogger {
     }
 
     // Debug console output (only in debug mode)
-    if (kDebugMode) {
-      debugPrint(entry.toString());
+    if (printToConsole) {
+      // ignore: avoid_print
+      print(entry.toString());
     }
 
     // External listener
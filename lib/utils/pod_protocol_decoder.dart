@@ -11,7 +11,10 @@ class PodMessage {
   final int type;
   final String description;
   final dynamic payload;
-  PodMessage(this.type, this.description, {this.payload});
+
+  /// Parse-stage [RecordAnomaly] flags aligned with a 0x03 [payload].
+  final Uint8List? anomalies;
+  PodMessage(this.type, this.description, {this.payload, this.anomalies});
 }
 
 ///This class is used to decode and process the different message types that is received from the pod through bluetooth.
@@ -28,6 +31,9 @@ class PodProtocolHandler {
 
   PodProtocolHandler({required this.onMessageDecoded});
 
+  /// Native integrity summary (0xDB) for the file payload that follows it.
+  TransferIntegrity? _pendingIntegrity;
+
   ///This is the start point of the protocol decoder.
   ///This function receives the message [type] and [payload].
   ///It uses a case statement to determine how the [payload] should be processed based on the message [type].
@@ -72,6 +78,30 @@ class PodProtocolHandler {
         _handleSettings(payload);
         break;
 
+      case 0xdb: //transfer integrity summary for the next file download.
+        _pendingIntegrity = TransferIntegrity.fromBytes(payload);
+        if (_pendingIntegrity == null) {
+          PodLogger.warn(
+            'protocol',
+            'Malformed integrity summary',
+            detail: '${payload.length} bytes',
+          );
+        }
+        break;
+
+      case 0xdc: //native live metrics snapshot.
+        final metrics = LiveMetrics.fromBytes(payload);
+        if (metrics != null) {
+          onMessageDecoded(PodMessage(0xdc, "Live Metrics", payload: metrics));
+        } else {
+          PodLogger.warn(
+            'protocol',
+            'Malformed live metrics snapshot',
+            detail: '${payload.length} bytes',
+          );
+        }
+        break;
+
       case 0xda: //file skipped.
         //This is a custom message type used to let the notifier know a file was skipped while trying to download multiple files based on a time range.
         //Is crucial to pass the await call if a file is skipped.
@@ -87,6 +117,8 @@ class PodProtocolHandler {
   ///The payload is in the format described by the [BinaryParser].
   ///Filtering is NOT done here — it is handled by the notifier to avoid double-filtering.
   void _handleFileDownload(Uint8List rawBytes) {
+    final integrity = _pendingIntegrity;
+    _pendingIntegrity = null;
     PodLogger.info(
       'sync',
       'File download payload received',
@@ -94,7 +126,8 @@ class PodProtocolHandler {
     );
     try {
       // Parse binary data into raw SensorLog objects
-      final rawLogs = BinaryParser.parseBytes(rawBytes);
+      final parsed = BinaryParser.parse(rawBytes, integrity: integrity);
+      final rawLogs = parsed.logs;
 
       PodLogger.info(
         'sync',
@@ -112,34 +145,25 @@ class PodProtocolHandler {
       }
 
       // --- INTEGRITY CHECK ---
-      // Verify the parsed record count is consistent with the payload size.
-      // If records were silently lost during BLE reassembly, this catches it.
-      if (rawLogs.isNotEmpty) {
-        final knownSizes = [
-          BinaryParser.v01DataSize, // 47 (V3.6)
-          BinaryParser.dataSize, // 61 (Proewe)
-          BinaryParser.packetSize, // 64 (HTS)
-        ];
-        for (final recordSize in knownSizes) {
-          if (rawBytes.length % recordSize == 0) {
-            final expectedRecords = rawBytes.length ~/ recordSize;
-            final lossPercent =
-                ((expectedRecords - rawLogs.length) / expectedRecords * 100);
-            if (lossPercent > 5.0) {
-              PodLogger.warn(
-                'sync',
-                'Possible data loss during transfer',
-                detail:
-                    'expected ~$expectedRecords records (${recordSize}B each), got ${rawLogs.length} (${lossPercent.toStringAsFixed(1)}% loss)',
-              );
-            }
-            break;
-          }
-        }
+      // Native block-level report (when sent) plus the parse-time quality
+      // report, which estimates loss from kernel tick gaps.
+      if (integrity != null) {
+        _logIntegrity(integrity, parsed);
+      }
+      final quality = parsed.quality;
+      if (quality != null && quality.records > 0) {
+        _logQuality(quality);
       }
 
       // Return raw List<SensorLog> to Notifier (filtering happens there)
-      onMessageDecoded(PodMessage(0x03, "Download Complete", payload: rawLogs));
+      onMessageDecoded(
+        PodMessage(
+          0x03,
+          "Download Complete",
+          payload: rawLogs,
+          anomalies: parsed.anomalies,
+        ),
+      );
     } catch (e) {
       PodLogger.error(
         'protocol',
@@ -153,6 +177,41 @@ class PodProtocolHandler {
     }
   }
 
+  void _logQuality(DataQualityReport quality) {
+    if (quality.estimatedLossPercent > 5.0) {
+      PodLogger.warn(
+        'sync',
+        'Possible data loss during transfer',
+        detail: quality.summary(),
+      );
+    } else {
+      PodLogger.info('sync', 'Data quality', detail: quality.summary());
+    }
+  }
+
+  void _logIntegrity(TransferIntegrity integrity, ParsedLogs parsed) {
+    final detail =
+        'crc32c=0x${integrity.crc32c.toRadixString(16).padLeft(8, '0')}, '
+        'records=${integrity.validRecords}/${integrity.records}, '
+        'missingBlocks=${integrity.missingBlocks}, '
+        'duplicateBlocks=${integrity.duplicateBlocks}, '
+        '${parsed.summary()}'
+        '${integrity.sequenceVerified ? '' : ' (sequence unverified)'}';
+
+    if (integrity.digestMismatch) {
+      PodLogger.error(
+        'sync',
+        'File content differs from previous download of same size',
+        detail: detail,
+      );
+    } else if (integrity.missingBlocks > 0 ||
+        integrity.validRecords < integrity.records) {
+      PodLogger.warn('sync', 'Data loss during transfer', detail: detail);
+    } else {
+      PodLogger.info('sync', 'Transfer verified', detail: detail);
+    }
+  }
+
   /// Decodes the "Settings" response packet (Type 0x05).
   ///
   /// The payload consists of 3 bytes containing the device configuration.
@@ -0,0 +1,161 @@
+import 'dart:typed_data';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/data_quality_report.dart';
+
+/// Record header plausibility check shared by every stage that needs to find
+/// or validate record boundaries (parser, record size detection, USB
+/// predictor, payload validation).
+///
+/// A header is plausible when year is 2022-2030, month 1-12 and day 1-31
+/// (little-endian year at +4, month at +6, day at +7). Matches
+/// `PayloadIntegrityTracker::IsPlausibleHeader` on the native side.
+class RecordHeader {
+  static const int minYear = 2022;
+  static const int maxYear = 2030;
+
+  /// Bytes needed from the record start to evaluate the header.
+  static const int checkedBytes = 8;
+
+  static bool isPlausible(Uint8List bytes, int offset) {
+    if (offset < 0 || offset + checkedBytes > bytes.length) return false;
+    final year = bytes[offset + 4] | (bytes[offset + 5] << 8);
+    final month = bytes[offset + 6];
+    final day = bytes[offset + 7];
+    return year >= minYear &&
+        year <= maxYear &&
+        month >= 1 &&
+        month <= 12 &&
+        day >= 1 &&
+        day <= 31;
+  }
+}
+
+/// Per-record anomaly flags, evaluated once by the parse stage and consumed by
+/// the sanity check, health reporting and integrity logging.
+///
+/// A record with no bits set is usable. Records whose header failed
+/// validation never become [SensorLog]s, so they show up as
+/// [ParsedLogs.syncSkips] / [ParsedLogs.rejectedRecords] rather than here.
+class RecordAnomaly {
+  /// NaN or Infinity in accel X, gyro X or speed (misaligned byte stream).
+  static const int nonFinite = 0x01;
+
+  /// Lat/lon both ~0 — the GPS "no fix" default.
+  static const int nullIsland = 0x02;
+
+  /// Speed above [maxSpeed] km/h (GPS teleport).
+  static const int impossibleSpeed = 0x04;
+
+  /// Accel above [maxAccel] m/s² or gyro above [maxGyro] rad/s on any axis.
+  static const int imuOutOfRange = 0x08;
+
+  /// Header written but every IMU channel exactly 0.
+  static const int zeroFill = 0x10;
+
+  /// A 16G accelerometer tops out at ~157 m/s²; headroom for impact shocks.
+  static const double maxAccel = 200.0;
+
+  /// A 2000 dps gyro tops out at ~35 rad/s; higher means Int16 overflow.
+  static const double maxGyro = 40.0;
+
+  /// World class sprinters hit ~45 km/h; headroom for noisy GPS spikes.
+  static const double maxSpeed = 80.0;
+
+  /// Returns the anomaly bits for [log] (0 = usable).
+  static int classify(SensorLog log) {
+    if (log.accelX.isNaN ||
+        log.gyroX.isNaN ||
+        log.speed.isNaN ||
+        log.accelX.isInfinite ||
+        log.gyroX.isInfinite ||
+        log.speed.isInfinite) {
+      // Remaining checks are meaningless on garbage values
+      return nonFinite;
+    }
+
+    int flags = 0;
+    if (log.latitude.abs() < 0.001 && log.longitude.abs() < 0.001) {
+      flags |= nullIsland;
+    }
+    if (log.speed > maxSpeed) flags |= impossibleSpeed;
+    if (log.accelX.abs() > maxAccel ||
+        log.accelY.abs() > maxAccel ||
+        log.accelZ.abs() > maxAccel ||
+        log.gyroX.abs() > maxGyro ||
+        log.gyroY.abs() > maxGyro ||
+        log.gyroZ.abs() > maxGyro) {
+      flags |= imuOutOfRange;
+    }
+    if (log.accelX == 0 &&
+        log.accelY == 0 &&
+        log.accelZ == 0 &&
+        log.gyroX == 0 &&
+        log.gyroY == 0 &&
+        log.gyroZ == 0) {
+      flags |= zeroFill;
+    }
+    return flags;
+  }
+}
+
+/// Output of the parse stage: decoded records plus one anomaly byte per
+/// record ([RecordAnomaly] bits), aligned index-for-index with [logs].
+class ParsedLogs {
+  final List<SensorLog> logs;
+  final Uint8List anomalies;
+
+  /// Quality report built during the same pass (null when the logs did not
+  /// come from [BinaryParser.parse]).
+  final DataQualityReport? quality;
+
+  ParsedLogs({required this.logs, required this.anomalies, this.quality})
+    : assert(logs.length == anomalies.length);
+
+  /// Bytes the sync scan stepped over looking for a plausible header.
+  int get syncSkips => quality?.syncSkips ?? 0;
+
+  /// Records the native validity bitmap marked invalid (not decoded).
+  int get rejectedRecords => quality?.rejectedRecords ?? 0;
+
+  static final ParsedLogs empty = ParsedLogs(
+    logs: const [],
+    anomalies: Uint8List(0),
+  );
+
+  /// Records with no anomaly bits set.
+  int get usableCount {
+    int n = 0;
+    for (final a in anomalies) {
+      if (a == 0) n++;
+    }
+    return n;
+  }
+
+  /// Records with [flag] set.
+  int count(int flag) {
+    int n = 0;
+    for (final a in anomalies) {
+      if (a & flag != 0) n++;
+    }
+    return n;
+  }
+
+  /// Compact one-line breakdown for logging, e.g.
+  /// `usable=980/1000, nonFinite=2, nullIsland=18`.
+  String summary() {
+    final parts = <String>['usable=$usableCount/${logs.length}'];
+    void add(String name, int flag) {
+      final n = count(flag);
+      if (n > 0) parts.add('$name=$n');
+    }
+
+    add('nonFinite', RecordAnomaly.nonFinite);
+    add('nullIsland', RecordAnomaly.nullIsland);
+    add('impossibleSpeed', RecordAnomaly.impossibleSpeed);
+    add('imuOutOfRange', RecordAnomaly.imuOutOfRange);
+    add('zeroFill', RecordAnomaly.zeroFill);
+    if (syncSkips > 0) parts.add('syncSkips=$syncSkips');
+    if (rejectedRecords > 0) parts.add('rejectedRecords=$rejectedRecords');
+    return parts.join(', ');
+  }
+}
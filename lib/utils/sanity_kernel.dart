@@ -0,0 +1,170 @@
+import 'dart:typed_data';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/record_anomalies.dart';
+
+/// Column-major float32 copy of the channels the sanity check reads.
+///
+/// Columns are padded to a multiple of 4 so [SanityKernel] can view them as
+/// [Float32x4List]s; padding lanes are zero and never reported.
+class SensorColumns {
+  final Float32List latitude;
+  final Float32List longitude;
+  final Float32List speed;
+  final Float32List accelX;
+  final Float32List accelY;
+  final Float32List accelZ;
+  final Float32List gyroX;
+  final Float32List gyroY;
+  final Float32List gyroZ;
+
+  /// Rows written so far.
+  int length = 0;
+
+  SensorColumns._(int padded)
+    : latitude = Float32List(padded),
+      longitude = Float32List(padded),
+      speed = Float32List(padded),
+      accelX = Float32List(padded),
+      accelY = Float32List(padded),
+      accelZ = Float32List(padded),
+      gyroX = Float32List(padded),
+      gyroY = Float32List(padded),
+      gyroZ = Float32List(padded);
+
+  /// Empty columns with room for [capacity] rows.
+  factory SensorColumns(int capacity) =>
+      SensorColumns._((capacity + 3) & ~3);
+
+  /// Columns holding every log in [logs].
+  factory SensorColumns.fromLogs(List<SensorLog> logs) {
+    final columns = SensorColumns(logs.length);
+    for (final log in logs) {
+      columns.add(log);
+    }
+    return columns;
+  }
+
+  int get capacity => latitude.length;
+
+  /// Appends one row. Values are stored at float32 precision, which is how
+  /// the pod records them.
+  void add(SensorLog log) {
+    final i = length++;
+    latitude[i] = log.latitude;
+    longitude[i] = log.longitude;
+    speed[i] = log.speed;
+    accelX[i] = log.accelX;
+    accelY[i] = log.accelY;
+    accelZ[i] = log.accelZ;
+    gyroX[i] = log.gyroX;
+    gyroY[i] = log.gyroY;
+    gyroZ[i] = log.gyroZ;
+  }
+}
+
+/// Vectorized Stage -1 sanity check.
+///
+/// Evaluates every [RecordAnomaly] predicate four rows at a time with
+/// [Float32x4] compares (SSE / NEON on native targets) and produces the same
+/// flags as [RecordAnomaly.classify], followed by a compaction index of the
+/// usable rows.
+class SanityKernel {
+  static final Float32x4 _zero = Float32x4.zero();
+  static final Float32x4 _gpsEpsilon = Float32x4.splat(0.001);
+  static final Float32x4 _maxSpeed = Float32x4.splat(RecordAnomaly.maxSpeed);
+  static final Float32x4 _maxAccel = Float32x4.splat(RecordAnomaly.maxAccel);
+  static final Float32x4 _maxGyro = Float32x4.splat(RecordAnomaly.maxGyro);
+  static final Int32x4 _allSet = Int32x4(-1, -1, -1, -1);
+
+  static Int32x4 _lanes(int bit) => Int32x4(bit, bit, bit, bit);
+
+  static final Int32x4 _nonFiniteBit = _lanes(RecordAnomaly.nonFinite);
+  static final Int32x4 _nullIslandBit = _lanes(RecordAnomaly.nullIsland);
+  static final Int32x4 _speedBit = _lanes(RecordAnomaly.impossibleSpeed);
+  static final Int32x4 _imuBit = _lanes(RecordAnomaly.imuOutOfRange);
+  static final Int32x4 _zeroFillBit = _lanes(RecordAnomaly.zeroFill);
+
+  /// Lane mask set where [v] is finite (x - x is NaN for NaN and ±Inf).
+  static Int32x4 _finite(Float32x4 v) => (v - v).equal(_zero);
+
+  /// Returns one [RecordAnomaly] byte per row of [columns].
+  static Uint8List classify(SensorColumns columns) {
+    final n = columns.length;
+    final lanes = (n + 3) >> 2;
+    final out = Uint8List(lanes << 2);
+
+    Float32x4List view(Float32List column) =>
+        column.buffer.asFloat32x4List(column.offsetInBytes, lanes);
+
+    final lat = view(columns.latitude);
+    final lon = view(columns.longitude);
+    final speed = view(columns.speed);
+    final ax = view(columns.accelX);
+    final ay = view(columns.accelY);
+    final az = view(columns.accelZ);
+    final gx = view(columns.gyroX);
+    final gy = view(columns.gyroY);
+    final gz = view(columns.gyroZ);
+
+    for (int l = 0; l < lanes; l++) {
+      final vSpeed = speed[l];
+      final vAx = ax[l], vAy = ay[l], vAz = az[l];
+      final vGx = gx[l], vGy = gy[l], vGz = gz[l];
+
+      final finite = _finite(vAx) & _finite(vGx) & _finite(vSpeed);
+
+      final nullIsland =
+          lat[l].abs().lessThan(_gpsEpsilon) &
+          lon[l].abs().lessThan(_gpsEpsilon);
+      final badSpeed = vSpeed.greaterThan(_maxSpeed);
+      final badImu =
+          vAx.abs().greaterThan(_maxAccel) |
+          vAy.abs().greaterThan(_maxAccel) |
+          vAz.abs().greaterThan(_maxAccel) |
+          vGx.abs().greaterThan(_maxGyro) |
+          vGy.abs().greaterThan(_maxGyro) |
+          vGz.abs().greaterThan(_maxGyro);
+      final zeroFill =
+          vAx.equal(_zero) &
+          vAy.equal(_zero) &
+          vAz.equal(_zero) &
+          vGx.equal(_zero) &
+          vGy.equal(_zero) &
+          vGz.equal(_zero);
+
+      // Non-finite rows report only nonFinite, like RecordAnomaly.classify
+      final other =
+          (nullIsland & _nullIslandBit) |
+          (badSpeed & _speedBit) |
+          (badImu & _imuBit) |
+          (zeroFill & _zeroFillBit);
+      final flags = (finite & other) | ((finite ^ _allSet) & _nonFiniteBit);
+
+      final base = l << 2;
+      out[base] = flags.x;
+      out[base + 1] = flags.y;
+      out[base + 2] = flags.z;
+      out[base + 3] = flags.w;
+    }
+
+    return Uint8List.sublistView(out, 0, n);
+  }
+
+  /// Indices of the rows with no anomaly flags, in order.
+  static Int32List compactionIndex(Uint8List anomalies) {
+    int usable = 0;
+    for (int i = 0; i < anomalies.length; i++) {
+      if (anomalies[i] == 0) usable++;
+    }
+    final index = Int32List(usable);
+    int j = 0;
+    for (int i = 0; i < anomalies.length; i++) {
+      if (anomalies[i] == 0) index[j++] = i;
+    }
+    return index;
+  }
+
+  /// Gathers [items] at [index] (see [compactionIndex]).
+  static List<T> compact<T>(List<T> items, Int32List index) =>
+      List<T>.generate(index.length, (i) => items[index[i]]);
+}
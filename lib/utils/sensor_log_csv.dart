@@ -0,0 +1,41 @@
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+
+/// CSV layout for [SensorLog] exports, shared by [StorageService] and the
+/// headless batch-sync tool so both write byte-identical files.
+class SensorLogCsv {
+  SensorLogCsv._();
+
+  /// Column headers, one per [SensorLog] field.
+  static const String header =
+      "Timestamp,KernelCount,Lat,Lon,Speed_Kph,AccelX,AccelY,AccelZ,GyroX,GyroY,GyroZ,FiltAccelX,FiltAccelY,FiltAccelZ";
+
+  /// Writes the header and one row per log to [sink].
+  static void write(StringSink sink, Iterable<SensorLog> logs) {
+    sink.writeln(header);
+    for (final log in logs) {
+      sink.writeln(
+        "${log.timestamp.toIso8601String()},"
+        "${log.packetId},"
+        "${log.latitude},"
+        "${log.longitude},"
+        "${log.speed},"
+        "${log.accelX},"
+        "${log.accelY},"
+        "${log.accelZ},"
+        "${log.gyroX},"
+        "${log.gyroY},"
+        "${log.gyroZ},"
+        "${log.filteredAccelX},"
+        "${log.filteredAccelY},"
+        "${log.filteredAccelZ}",
+      );
+    }
+  }
+
+  /// Returns the whole file as a string.
+  static String encode(Iterable<SensorLog> logs) {
+    final sb = StringBuffer();
+    write(sb, logs);
+    return sb.toString();
+  }
+}
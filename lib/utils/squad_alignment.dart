@@ -0,0 +1,287 @@
+import 'dart:math';
+import 'dart:typed_data';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/log_resampler.dart';
+
+/// Linear model of one pod's clock: `gpsMs = offsetMs + msPerTick * tick`.
+///
+/// Kernel ticks come from the pod's free-running crystal, so they drift
+/// against GPS time by a few tens of ppm and start from an arbitrary value.
+/// [driftPpm] is only meaningful when ticks are milliseconds.
+class PodClockModel {
+  /// GPS time (ms since epoch) at tick 0.
+  final double offsetMs;
+
+  /// GPS milliseconds per kernel tick (≈ 1.0 for millisecond ticks).
+  final double msPerTick;
+
+  /// Median absolute residual of the fit, in ms.
+  final double residualMs;
+
+  /// Logs the model was fitted on.
+  final int samples;
+
+  const PodClockModel({
+    required this.offsetMs,
+    required this.msPerTick,
+    this.residualMs = 0,
+    this.samples = 0,
+  });
+
+  /// Clock drift against GPS in parts per million.
+  double get driftPpm => (msPerTick - 1.0) * 1e6;
+
+  /// GPS time (ms since epoch) of [tick].
+  int toGpsMs(int tick) => (offsetMs + msPerTick * tick).round();
+
+  @override
+  String toString() =>
+      'PodClockModel(offset=${offsetMs.toStringAsFixed(0)}ms, '
+      'drift=${driftPpm.toStringAsFixed(1)}ppm, '
+      'residual=${residualMs.toStringAsFixed(1)}ms, n=$samples)';
+}
+
+/// Estimates [PodClockModel]s from tick vs. GPS timestamp pairs.
+///
+/// Uses a Theil-Sen fit (median of pairwise slopes, then median intercept)
+/// so GPS time jumps before a fix, RTC resyncs and corrupted rows do not pull
+/// the line, as long as they are under ~29% of the sample.
+class PodClockEstimator {
+  /// Rows sampled (evenly spaced) for the pairwise slopes.
+  static const int maxSlopeSamples = 256;
+
+  /// Only pairs at least this fraction of the session apart contribute a
+  /// slope, so timestamp quantization and jitter barely move it.
+  static const double minPairSpan = 0.25;
+
+  /// Fits the clock of one pod. Prefers rows with a GPS fix; falls back to
+  /// every row when there are fewer than two. Returns null when nothing can
+  /// be fitted (fewer than two usable rows, or no tick progress).
+  static PodClockModel? fit(List<SensorLog> logs) {
+    var rows = [
+      for (final l in logs)
+        if (l.latitude.abs() >= 0.001 || l.longitude.abs() >= 0.001) l,
+    ];
+    if (rows.length < 2) rows = logs;
+    if (rows.length < 2) return null;
+
+    final n = rows.length;
+    final m = min(n, maxSlopeSamples);
+    final xs = Float64List(m);
+    final ys = Float64List(m);
+    for (int k = 0; k < m; k++) {
+      final l = rows[m == 1 ? 0 : (k * (n - 1)) ~/ (m - 1)];
+      xs[k] = l.packetId.toDouble();
+      ys[k] = l.timestamp.millisecondsSinceEpoch.toDouble();
+    }
+
+    final span = xs.reduce(max) - xs.reduce(min);
+    final minDx = span * minPairSpan;
+    final slopes = <double>[];
+    for (int i = 0; i < m; i++) {
+      for (int j = i + 1; j < m; j++) {
+        final dx = xs[j] - xs[i];
+        if (dx.abs() >= minDx && dx != 0) slopes.add((ys[j] - ys[i]) / dx);
+      }
+    }
+    if (slopes.isEmpty) return null;
+    final slope = _median(slopes);
+    if (!(slope > 0)) return null;
+
+    final intercepts = [
+      for (final l in rows)
+        l.timestamp.millisecondsSinceEpoch - slope * l.packetId,
+    ];
+    final offset = _median(intercepts);
+
+    final residuals = [
+      for (int k = 0; k < m; k++) (ys[k] - (offset + slope * xs[k])).abs(),
+    ];
+
+    return PodClockModel(
+      offsetMs: offset,
+      msPerTick: slope,
+      residualMs: _median(residuals),
+      samples: n,
+    );
+  }
+
+  static double _median(List<double> values) {
+    values.sort();
+    final mid = values.length ~/ 2;
+    return values.length.isOdd
+        ? values[mid]
+        : (values[mid - 1] + values[mid]) / 2;
+  }
+}
+
+/// Squad session on a shared GPS-time grid: one row per athlete, one column
+/// per grid step.
+///
+/// Each channel is a flat athlete-major matrix (`[athlete * length + t]`), so
+/// a squad-wide metric is a straight loop over contiguous memory. Cells with
+/// no data for that athlete are NaN.
+class SquadTimeline {
+  final List<String> athleteIds;
+
+  /// GPS time (ms since epoch) of column 0.
+  final int startMs;
+
+  /// Grid step in ms.
+  final int intervalMs;
+
+  /// Columns per athlete.
+  final int length;
+
+  /// Fitted clock per athlete (null when it could not be fitted and the
+  /// logged timestamps were used as-is).
+  final List<PodClockModel?> clocks;
+
+  final Float64List latitude;
+  final Float64List longitude;
+  final Float64List speed;
+  final Float64List accelX;
+  final Float64List accelY;
+  final Float64List accelZ;
+  final Float64List gyroX;
+  final Float64List gyroY;
+  final Float64List gyroZ;
+
+  /// Whether timestamps are UTC (follows the input logs).
+  final bool isUtc;
+
+  SquadTimeline._({
+    required this.athleteIds,
+    required this.startMs,
+    required this.intervalMs,
+    required this.length,
+    required this.clocks,
+    required this.isUtc,
+  }) : latitude = _nanMatrix(athleteIds.length * length),
+       longitude = _nanMatrix(athleteIds.length * length),
+       speed = _nanMatrix(athleteIds.length * length),
+       accelX = _nanMatrix(athleteIds.length * length),
+       accelY = _nanMatrix(athleteIds.length * length),
+       accelZ = _nanMatrix(athleteIds.length * length),
+       gyroX = _nanMatrix(athleteIds.length * length),
+       gyroY = _nanMatrix(athleteIds.length * length),
+       gyroZ = _nanMatrix(athleteIds.length * length);
+
+  static Float64List _nanMatrix(int size) =>
+      Float64List(size)..fillRange(0, size, double.nan);
+
+  int get athleteCount => athleteIds.length;
+
+  /// The [athlete]'s row of [channel] (a view, not a copy).
+  Float64List row(Float64List channel, int athlete) =>
+      Float64List.sublistView(
+        channel,
+        athlete * length,
+        (athlete + 1) * length,
+      );
+
+  /// Whether [athlete] has data at column [t].
+  bool hasData(int athlete, int t) => !speed[athlete * length + t].isNaN;
+
+  /// GPS time of column [t].
+  DateTime timeAt(int t) => DateTime.fromMillisecondsSinceEpoch(
+    startMs + t * intervalMs,
+    isUtc: isUtc,
+  );
+
+  void _put(int index, SensorLog l) {
+    latitude[index] = l.latitude;
+    longitude[index] = l.longitude;
+    speed[index] = l.speed;
+    accelX[index] = l.accelX;
+    accelY[index] = l.accelY;
+    accelZ[index] = l.accelZ;
+    gyroX[index] = l.gyroX;
+    gyroY[index] = l.gyroY;
+    gyroZ[index] = l.gyroZ;
+  }
+}
+
+/// Puts every athlete's session on one GPS-time timeline.
+///
+/// Per athlete:
+/// 1. Fit the pod clock ([PodClockEstimator]) and re-time each log from its
+///    kernel tick, which is monotonic and jitter-free, instead of the logged
+///    GPS/RTC time.
+/// 2. Resample onto the shared grid ([LogResampler]: epoch-aligned, linear,
+///    IMU anti-aliased when the athlete logged faster than the grid).
+/// 3. Scatter into the [SquadTimeline] matrices.
+///
+/// Input logs should be sanitized and gap-repaired (e.g. the output of
+/// `FilterPipeline`); tick resets within one session are not supported.
+class SquadAligner {
+  /// Aligns [sessions] (athlete id → logs) on a grid of [intervalMs].
+  static SquadTimeline align(
+    Map<String, List<SensorLog>> sessions, {
+    int intervalMs = LogInterval.defaultMs,
+  }) {
+    final ids = <String>[];
+    final clocks = <PodClockModel?>[];
+    final resampled = <List<SensorLog>>[];
+    int? first;
+    int? last;
+    bool isUtc = false;
+
+    for (final MapEntry(key: id, value: logs) in sessions.entries) {
+      final sorted = List<SensorLog>.of(logs)
+        ..sort((a, b) => a.packetId.compareTo(b.packetId));
+      final clock = PodClockEstimator.fit(sorted);
+      if (sorted.isNotEmpty) isUtc = sorted.first.timestamp.isUtc;
+
+      final retimed =
+          clock == null
+              ? sorted
+              : [
+                for (final l in sorted)
+                  l.copyWith(
+                    timestamp: DateTime.fromMillisecondsSinceEpoch(
+                      clock.toGpsMs(l.packetId),
+                      isUtc: l.timestamp.isUtc,
+                    ),
+                  ),
+              ];
+      final grid =
+          retimed.isEmpty
+              ? <SensorLog>[]
+              : LogResampler.resample(
+                retimed,
+                targetIntervalMs: intervalMs,
+                sourceIntervalMs: LogInterval.detect(retimed),
+              );
+
+      ids.add(id);
+      clocks.add(clock);
+      resampled.add(grid);
+      if (grid.isNotEmpty) {
+        final s = grid.first.timestamp.millisecondsSinceEpoch;
+        final e = grid.last.timestamp.millisecondsSinceEpoch;
+        first = first == null ? s : min(first, s);
+        last = last == null ? e : max(last, e);
+      }
+    }
+
+    final startMs = first ?? 0;
+    final length = first == null ? 0 : (last! - startMs) ~/ intervalMs + 1;
+    final timeline = SquadTimeline._(
+      athleteIds: ids,
+      startMs: startMs,
+      intervalMs: intervalMs,
+      length: length,
+      clocks: clocks,
+      isUtc: isUtc,
+    );
+
+    for (int a = 0; a < resampled.length; a++) {
+      for (final l in resampled[a]) {
+        final t = (l.timestamp.millisecondsSinceEpoch - startMs) ~/ intervalMs;
+        timeline._put(a * length + t, l);
+      }
+    }
+    return timeline;
+  }
+}
@@ -0,0 +1,437 @@
+import 'dart:isolate';
+import 'dart:math';
+import 'dart:typed_data';
+import 'package:metric_athlete_pod_ble/utils/squad_alignment.dart';
+
+/// Thresholds for [SquadAnalytics].
+class SquadMetricsConfig {
+  /// Speed (km/h) at or above which an athlete counts as sprinting.
+  final double sprintSpeedKmh;
+
+  /// Athletes that must sprint at the same time for a synchronised sprint.
+  final int minSyncSprinters;
+
+  /// Shortest synchronised sprint reported, in ms.
+  final int minSyncSprintMs;
+
+  const SquadMetricsConfig({
+    this.sprintSpeedKmh = 25.2,
+    this.minSyncSprinters = 3,
+    this.minSyncSprintMs = 1000,
+  });
+}
+
+/// A stretch of time where at least [SquadMetricsConfig.minSyncSprinters]
+/// athletes sprinted together. Indices are [SquadTimeline] columns.
+class SynchronisedSprint {
+  final int startIndex;
+
+  /// Exclusive.
+  final int endIndex;
+
+  /// Most athletes sprinting at once during the window.
+  final int peakSprinters;
+
+  const SynchronisedSprint({
+    required this.startIndex,
+    required this.endIndex,
+    required this.peakSprinters,
+  });
+
+  @override
+  String toString() =>
+      'SynchronisedSprint($startIndex..$endIndex, peak=$peakSprinters)';
+}
+
+/// Per-time-step team metrics of one [SquadTimeline].
+///
+/// Positions are in metres east ([centroidX]) and north ([centroidY]) of
+/// ([originLatitude], [originLongitude]), the squad's mean position. Steps
+/// with too few athletes hold NaN.
+class SquadMetrics {
+  final int startMs;
+  final int intervalMs;
+  final int length;
+  final double originLatitude;
+  final double originLongitude;
+
+  /// Athletes with a position at each step.
+  final Uint8List present;
+
+  /// Athletes at or above the sprint speed at each step.
+  final Uint8List sprinting;
+
+  /// Team centroid (metres).
+  final Float32List centroidX;
+  final Float32List centroidY;
+
+  /// Mean distance of the athletes to the centroid (metres).
+  final Float32List stretchIndex;
+
+  /// Mean and largest distance between any two athletes (metres).
+  final Float32List meanPairDistance;
+  final Float32List maxPairDistance;
+
+  final List<SynchronisedSprint> synchronisedSprints;
+
+  SquadMetrics({
+    required this.startMs,
+    required this.intervalMs,
+    required this.length,
+    required this.originLatitude,
+    required this.originLongitude,
+    required this.present,
+    required this.sprinting,
+    required this.centroidX,
+    required this.centroidY,
+    required this.stretchIndex,
+    required this.meanPairDistance,
+    required this.maxPairDistance,
+    required this.synchronisedSprints,
+  });
+
+  /// Centroid latitude at step [t].
+  double centroidLatitude(int t) =>
+      originLatitude + centroidY[t] / SquadAnalytics.metresPerDegree;
+
+  /// Centroid longitude at step [t].
+  double centroidLongitude(int t) =>
+      originLongitude +
+      centroidX[t] /
+          (SquadAnalytics.metresPerDegree *
+              cos(originLatitude * pi / 180.0));
+}
+
+/// Squad analytics over a [SquadTimeline].
+///
+/// Positions are projected once to local metres (equirectangular around the
+/// squad's mean position, < 1 cm error over a pitch) and transposed to
+/// time-major float32 rows padded to a multiple of 4 athletes. Each step is
+/// then evaluated with [Float32x4] arithmetic: centroid and stretch index in
+/// O(athletes), pair distances as athletes × athletes/4 vector ops.
+/// [computeParallel] splits the timeline into blocks and runs them on
+/// separate isolates.
+class SquadAnalytics {
+  /// Same earth radius as the pipeline's Haversine distance.
+  static const double earthRadius = 6371000.0;
+  static const double metresPerDegree = earthRadius * pi / 180.0;
+
+  /// Metrics of [timeline] on the calling isolate.
+  static SquadMetrics compute(
+    SquadTimeline timeline, {
+    SquadMetricsConfig config = const SquadMetricsConfig(),
+  }) {
+    final projection = _Projection.of(timeline);
+    final input = _blockInput(
+      timeline,
+      projection,
+      config,
+      0,
+      timeline.length,
+    );
+    return _assemble(timeline, projection, config, [_computeBlock(input)]);
+  }
+
+  /// Metrics of [timeline] computed in [blocks] time blocks on separate
+  /// isolates (defaults to 4). Same result as [compute].
+  static Future<SquadMetrics> computeParallel(
+    SquadTimeline timeline, {
+    SquadMetricsConfig config = const SquadMetricsConfig(),
+    int blocks = 4,
+  }) async {
+    final projection = _Projection.of(timeline);
+    final n = timeline.length;
+    final count = max(1, min(blocks, n));
+    final futures = <Future<_BlockOutput>>[];
+    for (int b = 0; b < count; b++) {
+      final from = n * b ~/ count;
+      final to = n * (b + 1) ~/ count;
+      futures.add(_run(_blockInput(timeline, projection, config, from, to)));
+    }
+    return _assemble(timeline, projection, config, await Future.wait(futures));
+  }
+
+  /// Distances (metres) between every pair of athletes at step [t], as a
+  /// row-major athletes × athletes matrix. NaN where either has no position.
+  static Float32List pairwiseDistances(SquadTimeline timeline, int t) {
+    final a = timeline.athleteCount;
+    final projection = _Projection.of(timeline);
+    final xs = Float64List(a);
+    final ys = Float64List(a);
+    for (int i = 0; i < a; i++) {
+      final idx = i * timeline.length + t;
+      xs[i] = projection.x(timeline.longitude[idx]);
+      ys[i] = projection.y(timeline.latitude[idx]);
+    }
+    final out = Float32List(a * a);
+    for (int i = 0; i < a; i++) {
+      for (int j = 0; j < a; j++) {
+        final dx = xs[i] - xs[j];
+        final dy = ys[i] - ys[j];
+        out[i * a + j] = sqrt(dx * dx + dy * dy);
+      }
+    }
+    return out;
+  }
+
+  // Isolate.run copies everything the closure captures, so keep it to the
+  // block input.
+  static Future<_BlockOutput> _run(_BlockInput input) =>
+      Isolate.run(() => _computeBlock(input));
+
+  static _BlockInput _blockInput(
+    SquadTimeline timeline,
+    _Projection projection,
+    SquadMetricsConfig config,
+    int from,
+    int to,
+  ) {
+    final a = timeline.athleteCount;
+    final stride = (a + 3) & ~3;
+    final steps = to - from;
+    final xs = Float32List(steps * stride);
+    final ys = Float32List(steps * stride);
+    final mask = Float32List(steps * stride);
+    final sprinting = Uint8List(steps);
+    final length = timeline.length;
+
+    for (int i = 0; i < a; i++) {
+      final row = i * length;
+      for (int t = from; t < to; t++) {
+        final lat = timeline.latitude[row + t];
+        final lon = timeline.longitude[row + t];
+        if (lat.isNaN || lon.isNaN) continue;
+        final o = (t - from) * stride + i;
+        xs[o] = projection.x(lon);
+        ys[o] = projection.y(lat);
+        mask[o] = 1.0;
+        if (timeline.speed[row + t] >= config.sprintSpeedKmh) {
+          sprinting[t - from]++;
+        }
+      }
+    }
+    return _BlockInput(steps, stride, xs, ys, mask, sprinting);
+  }
+
+  static _BlockOutput _computeBlock(_BlockInput input) {
+    final steps = input.steps;
+    final groups = input.stride >> 2;
+    final xs = input.xs.buffer.asFloat32x4List();
+    final ys = input.ys.buffer.asFloat32x4List();
+    final ms = input.mask.buffer.asFloat32x4List();
+    final xsFlat = input.xs;
+    final ysFlat = input.ys;
+    final msFlat = input.mask;
+
+    final out = _BlockOutput(steps, input.sprinting);
+    final zero = Float32x4.zero();
+
+    for (int t = 0; t < steps; t++) {
+      final base = t * groups;
+
+      var sumX = zero, sumY = zero, count = zero;
+      for (int g = 0; g < groups; g++) {
+        final m = ms[base + g];
+        sumX += xs[base + g] * m;
+        sumY += ys[base + g] * m;
+        count += m;
+      }
+      final n = _sum(count);
+      out.present[t] = n.round();
+      if (n < 1) {
+        out.centroidX[t] = double.nan;
+        out.centroidY[t] = double.nan;
+        out.stretch[t] = double.nan;
+        out.meanPair[t] = double.nan;
+        out.maxPair[t] = double.nan;
+        continue;
+      }
+      final cx = _sum(sumX) / n;
+      final cy = _sum(sumY) / n;
+      out.centroidX[t] = cx;
+      out.centroidY[t] = cy;
+
+      final vcx = Float32x4.splat(cx), vcy = Float32x4.splat(cy);
+      var spread = zero;
+      for (int g = 0; g < groups; g++) {
+        final dx = xs[base + g] - vcx;
+        final dy = ys[base + g] - vcy;
+        spread += (dx * dx + dy * dy).sqrt() * ms[base + g];
+      }
+      out.stretch[t] = _sum(spread) / n;
+
+      if (n < 2) {
+        out.meanPair[t] = double.nan;
+        out.maxPair[t] = double.nan;
+        continue;
+      }
+      // Every ordered pair once; (i, i) contributes 0, so halve the sum
+      var pairSum = zero, pairMax = zero;
+      final rowBase = t * input.stride;
+      for (int i = 0; i < groups * 4; i++) {
+        if (msFlat[rowBase + i] == 0) continue;
+        final xi = Float32x4.splat(xsFlat[rowBase + i]);
+        final yi = Float32x4.splat(ysFlat[rowBase + i]);
+        for (int g = 0; g < groups; g++) {
+          final dx = xs[base + g] - xi;
+          final dy = ys[base + g] - yi;
+          final d = (dx * dx + dy * dy).sqrt() * ms[base + g];
+          pairSum += d;
+          pairMax = pairMax.max(d);
+        }
+      }
+      out.meanPair[t] = _sum(pairSum) / (n * (n - 1));
+      out.maxPair[t] = max(
+        max(pairMax.x, pairMax.y),
+        max(pairMax.z, pairMax.w),
+      );
+    }
+    return out;
+  }
+
+  static double _sum(Float32x4 v) => v.x + v.y + v.z + v.w;
+
+  static SquadMetrics _assemble(
+    SquadTimeline timeline,
+    _Projection projection,
+    SquadMetricsConfig config,
+    List<_BlockOutput> blocks,
+  ) {
+    final n = timeline.length;
+    final present = Uint8List(n);
+    final sprinting = Uint8List(n);
+    final centroidX = Float32List(n);
+    final centroidY = Float32List(n);
+    final stretch = Float32List(n);
+    final meanPair = Float32List(n);
+    final maxPair = Float32List(n);
+
+    int offset = 0;
+    for (final b in blocks) {
+      present.setAll(offset, b.present);
+      sprinting.setAll(offset, b.sprinting);
+      centroidX.setAll(offset, b.centroidX);
+      centroidY.setAll(offset, b.centroidY);
+      stretch.setAll(offset, b.stretch);
+      meanPair.setAll(offset, b.meanPair);
+      maxPair.setAll(offset, b.maxPair);
+      offset += b.present.length;
+    }
+
+    return SquadMetrics(
+      startMs: timeline.startMs,
+      intervalMs: timeline.intervalMs,
+      length: n,
+      originLatitude: projection.lat0,
+      originLongitude: projection.lon0,
+      present: present,
+      sprinting: sprinting,
+      centroidX: centroidX,
+      centroidY: centroidY,
+      stretchIndex: stretch,
+      meanPairDistance: meanPair,
+      maxPairDistance: maxPair,
+      synchronisedSprints: _synchronisedSprints(
+        sprinting,
+        config,
+        timeline.intervalMs,
+      ),
+    );
+  }
+
+  static List<SynchronisedSprint> _synchronisedSprints(
+    Uint8List sprinting,
+    SquadMetricsConfig config,
+    int intervalMs,
+  ) {
+    final minSteps = (config.minSyncSprintMs / intervalMs).ceil();
+    final result = <SynchronisedSprint>[];
+    int start = -1;
+    int peak = 0;
+    for (int t = 0; t <= sprinting.length; t++) {
+      final active =
+          t < sprinting.length && sprinting[t] >= config.minSyncSprinters;
+      if (active) {
+        if (start < 0) start = t;
+        peak = max(peak, sprinting[t]);
+      } else if (start >= 0) {
+        if (t - start >= minSteps) {
+          result.add(
+            SynchronisedSprint(
+              startIndex: start,
+              endIndex: t,
+              peakSprinters: peak,
+            ),
+          );
+        }
+        start = -1;
+        peak = 0;
+      }
+    }
+    return result;
+  }
+}
+
+/// Equirectangular projection around the squad's mean position.
+class _Projection {
+  final double lat0;
+  final double lon0;
+  final double _kx;
+
+  _Projection(this.lat0, this.lon0)
+    : _kx = SquadAnalytics.metresPerDegree * cos(lat0 * pi / 180.0);
+
+  factory _Projection.of(SquadTimeline timeline) {
+    double sumLat = 0, sumLon = 0;
+    int n = 0;
+    for (int i = 0; i < timeline.latitude.length; i++) {
+      final lat = timeline.latitude[i];
+      final lon = timeline.longitude[i];
+      if (lat.isNaN || lon.isNaN) continue;
+      sumLat += lat;
+      sumLon += lon;
+      n++;
+    }
+    return n == 0 ? _Projection(0, 0) : _Projection(sumLat / n, sumLon / n);
+  }
+
+  double x(double lon) => (lon - lon0) * _kx;
+  double y(double lat) => (lat - lat0) * SquadAnalytics.metresPerDegree;
+}
+
+/// Time-major block: `[step * stride + athlete]`, stride a multiple of 4.
+class _BlockInput {
+  final int steps;
+  final int stride;
+  final Float32List xs;
+  final Float32List ys;
+  final Float32List mask;
+  final Uint8List sprinting;
+
+  _BlockInput(
+    this.steps,
+    this.stride,
+    this.xs,
+    this.ys,
+    this.mask,
+    this.sprinting,
+  );
+}
+
+class _BlockOutput {
+  final Uint8List present;
+  final Uint8List sprinting;
+  final Float32List centroidX;
+  final Float32List centroidY;
+  final Float32List stretch;
+  final Float32List meanPair;
+  final Float32List maxPair;
+
+  _BlockOutput(int steps, this.sprinting)
+    : present = Uint8List(steps),
+      centroidX = Float32List(steps),
+      centroidY = Float32List(steps),
+      stretch = Float32List(steps),
+      meanPair = Float32List(steps),
+      maxPair = Float32List(steps);
+}
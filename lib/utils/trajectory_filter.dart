@@ -1,6 +1,10 @@
 import 'dart:math';
 import 'dart:collection';
+import 'dart:typed_data';
 import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/log_resampler.dart';
+import 'package:metric_athlete_pod_ble/utils/record_anomalies.dart';
+import 'package:metric_athlete_pod_ble/utils/sanity_kernel.dart';
 
 /// Configuration for the Kalman+RTS GPS trajectory filter.
 ///
@@ -18,6 +22,7 @@ class TrajectoryConfig {
     this.movingSpeedThreshold = 3.0,
     this.physicsSpeedLimit = 45.0,
     this.requiredSustainedFrames = 20,
+    this.logIntervalMs,
   });
 
   /// Original conservative settings (pre-v2 tuning).
@@ -63,6 +68,10 @@ class TrajectoryConfig {
 
   /// Number of consecutive frames of motion needed to trigger movement start.
   final int requiredSustainedFrames;
+
+  /// Log interval used to space the repaired timeline (ms). When null it is
+  /// detected per file with [LogInterval.detect].
+  final int? logIntervalMs;
 }
 
 /// **TrajectoryResult**
@@ -75,17 +84,23 @@ class TrajectoryConfig {
 ///   (100% = Perfect data, <60% = Heavy interference/packet loss).
 /// * [originalCount] - Number of valid logs before repair.
 /// * [repairedCount] - Number of synthetic logs generated to fill gaps.
+/// * [rejectedCount] - Number of logs the sanity check removed.
+/// * [logIntervalMs] - Spacing of the repaired timeline.
 class TrajectoryResult {
   final List<SensorLog> logs;
   final double healthScore;
   final int originalCount;
   final int repairedCount;
+  final int rejectedCount;
+  final int logIntervalMs;
 
   TrajectoryResult({
     required this.logs,
     required this.healthScore,
     required this.originalCount,
     required this.repairedCount,
+    this.rejectedCount = 0,
+    this.logIntervalMs = LogInterval.defaultMs,
   });
 }
 
@@ -115,10 +130,15 @@ class TrajectoryFilter {
   }
 
   /// Process with explicit configuration for the Kalman+RTS filter.
+  ///
+  /// [anomalies] are the per-record [RecordAnomaly] flags from
+  /// [BinaryParser.parse]; when they line up with [logs] the sanity check
+  /// reads them instead of re-validating every log.
   static TrajectoryResult processWithConfig(
     List<SensorLog> logs,
-    TrajectoryConfig config,
-  ) {
+    TrajectoryConfig config, {
+    Uint8List? anomalies,
+  }) {
     if (logs.isEmpty) {
       return TrajectoryResult(
         logs: [],
@@ -135,8 +155,7 @@ class TrajectoryFilter {
     // Strategy: It is better to have a "Gap" (which Stage 0 can fix) than to
     // have "Bad Data" (which Stage 1 will try to smooth, ruining the track).
 
-    final List<SensorLog> cleanLogs =
-        logs.where((log) => _isLogValid(log)).toList();
+    final List<SensorLog> cleanLogs = _sanitize(logs, anomalies);
 
     if (cleanLogs.isEmpty) {
       return TrajectoryResult(
@@ -154,127 +173,10 @@ class TrajectoryFilter {
     // constant time steps (dt). Packet loss breaks this assumption.
     // We fix this by mathematically regenerating the missing rows.
 
-    // 1. Sort the CLEAN logs by hardware ID
-    // Hardware writes are sometimes buffered out of order; this enforces monotonicity.
-    final List<SensorLog> sortedLogs = List.from(cleanLogs)
-      ..sort((a, b) => a.packetId.compareTo(b.packetId));
-
-    // 1b. Deduplicate by PacketID (keep last occurrence, as later readings
-    // are more likely to be correct after sensor stabilization).
-    // Duplicate IDs produce zero-distance segments that deflate speed calculations.
-    final List<SensorLog> dedupedLogs = [];
-    for (int i = 0; i < sortedLogs.length; i++) {
-      if (i + 1 < sortedLogs.length &&
-          sortedLogs[i].packetId == sortedLogs[i + 1].packetId) {
-        continue; // Skip this one, keep the next
-      }
-      dedupedLogs.add(sortedLogs[i]);
-    }
-
-    // 2. Determine Kernel Step Size (Hardware Median)
-    // The hardware might step by 1, 10, or 100 counts per log.
-    // We sample up to 50 consecutive diffs and apply IQR outlier rejection
-    // to handle corrupted packets or irregular spacing after power-on.
-    int kernelStepSize = 100; // Default fallback
-    final int sampleSize = min(
-      dedupedLogs.length,
-      51,
-    ); // Need at least 2 for 1 diff
-    if (sampleSize >= 2) {
-      List<int> diffs = [];
-      for (int i = 1; i < sampleSize; i++) {
-        int d = dedupedLogs[i].packetId - dedupedLogs[i - 1].packetId;
-        if (d > 0 && d < 5000) diffs.add(d);
-      }
-      if (diffs.length >= 3) {
-        diffs.sort();
-        // IQR outlier rejection
-        final q1 = diffs[diffs.length ~/ 4];
-        final q3 = diffs[(diffs.length * 3) ~/ 4];
-        final iqr = q3 - q1;
-        final lowerBound = q1 - 1.5 * iqr;
-        final upperBound = q3 + 1.5 * iqr;
-        final filtered =
-            diffs.where((d) => d >= lowerBound && d <= upperBound).toList();
-        if (filtered.isNotEmpty) {
-          kernelStepSize = filtered[filtered.length ~/ 2]; // Median of inliers
-        } else {
-          kernelStepSize = diffs[diffs.length ~/ 2]; // Fallback to raw median
-        }
-      } else if (diffs.isNotEmpty) {
-        diffs.sort();
-        kernelStepSize = diffs[diffs.length ~/ 2];
-      }
-    }
-
-    // 3. The Repair Loop
-    // We iterate through the logs. If we see a jump in PacketID, we fill it.
-    final List<SensorLog> repairedLogs = [];
-    int repairedCount = 0; // NEW: Track how many packets we had to fake.
-
-    // Anchor: Start with the first clean log
-    DateTime currentTime = dedupedLogs.first.timestamp;
-    repairedLogs.add(dedupedLogs.first.copyWith(timestamp: currentTime));
-
-    for (int i = 1; i < dedupedLogs.length; i++) {
-      final prev = dedupedLogs[i - 1];
-      final curr = dedupedLogs[i];
-
-      // Calculate how many "steps" the hardware skipped.
-      // E.g., if IDs are 100 and 300, and step is 100, we missed 1 step (ID 200).
-      int idDiff = curr.packetId - prev.packetId;
-      int steps = (idDiff / kernelStepSize).round();
-
-      // LOGIC BRANCH: INTERPOLATE OR RESET?
-      // We only interpolate if the gap is manageable (< 500 steps / 50 seconds).
-      // If the gap is massive, it's likely a user "Pause" or file merge, so we skip filling.
-      if (steps > 1 && steps < 500) {
-        int missingPackets = steps - 1;
-        repairedCount +=
-            missingPackets; // <--- Count the damage for Health Score
-
-        // Generate a synthetic log for EACH missing step
-        for (int s = 1; s < steps; s++) {
-          double ratio = s / steps; // Linear progress (e.g., 0.25, 0.5, 0.75)
-
-          // Calculate exact time for this missing packet (100ms per step)
-          DateTime interpTime = currentTime.add(
-            Duration(milliseconds: s * 100),
-          );
-          int newId = prev.packetId + (s * kernelStepSize);
-
-          // Create the synthetic log with interpolated sensor values
-          repairedLogs.add(
-            _interpolateLog(prev, curr, ratio, interpTime, newId),
-          );
-        }
-
-        // Advance the master clock by the exact duration of the gap
-        currentTime = currentTime.add(Duration(milliseconds: steps * 100));
-      } else {
-        // HUGE GAP or NORMAL STEP (steps == 1)
-        if (steps >= 500) {
-          // Massive Jump: Don't guess. Re-anchor to the new hardware timestamp.
-          currentTime = curr.timestamp;
-        } else {
-          // Normal Operation: Just tick forward 100ms.
-          // (Also handles duplicate IDs by essentially ignoring the zero-step time change)
-          currentTime = currentTime.add(Duration(milliseconds: 100));
-        }
-      }
-
-      // Add the current real log with the corrected/anchored timestamp
-      repairedLogs.add(curr.copyWith(timestamp: currentTime));
-    }
-
-    // --- CALCULATE HEALTH SCORE ---
-    // A perfect session has 0 repaired packets.
-    // If we had to synthesize 50% of the data, confidence is 50%.
-    int totalOutput = repairedLogs.length;
-    double health = 100.0;
-    if (totalOutput > 0) {
-      health = ((totalOutput - repairedCount) / totalOutput) * 100.0;
-    }
+    final repair = _repair(cleanLogs, config);
+    final repairedLogs = repair.logs;
+    final repairedCount = repair.repairedCount;
+    final health = repair.health;
 
     // ========================================================================
     // STAGE 1 & 2: CORE FILTERING
@@ -289,6 +191,8 @@ class TrajectoryFilter {
       healthScore: health,
       originalCount: cleanLogs.length,
       repairedCount: repairedCount,
+      rejectedCount: logs.length - cleanLogs.length,
+      logIntervalMs: repair.intervalMs,
     );
   }
 
@@ -299,8 +203,9 @@ class TrajectoryFilter {
   /// positions because the Kalman filter compresses the GPS trajectory.
   static TrajectoryResult sanitizeAndRepairOnly(
     List<SensorLog> logs,
-    TrajectoryConfig config,
-  ) {
+    TrajectoryConfig config, {
+    Uint8List? anomalies,
+  }) {
     if (logs.isEmpty) {
       return TrajectoryResult(
         logs: [],
@@ -311,7 +216,7 @@ class TrajectoryFilter {
     }
 
     // STAGE -1: Sanity check
-    final cleanLogs = logs.where((log) => _isLogValid(log)).toList();
+    final cleanLogs = _sanitize(logs, anomalies);
     if (cleanLogs.isEmpty) {
       return TrajectoryResult(
         logs: [],
@@ -322,154 +227,151 @@ class TrajectoryFilter {
     }
 
     // STAGE 0: Sort, dedup, repair (same logic as processWithConfig)
-    final sortedLogs = List<SensorLog>.from(cleanLogs)
+    final repair = _repair(cleanLogs, config);
+    final repairedLogs = repair.logs;
+    final repairedCount = repair.repairedCount;
+    final health = repair.health;
+
+    // Skip Stage 1-2 (Kalman+RTS) — return sanitized + gap-repaired logs
+    return TrajectoryResult(
+      logs: repairedLogs,
+      healthScore: health,
+      originalCount: cleanLogs.length,
+      repairedCount: repairedCount,
+      rejectedCount: logs.length - cleanLogs.length,
+      logIntervalMs: repair.intervalMs,
+    );
+  }
+
+  /// STAGE 0: STRICT DATA REPAIR
+  /// Sorts and deduplicates [cleanLogs] by PacketID, then regenerates
+  /// missing rows by linear interpolation on a timeline spaced at the file's
+  /// log interval ([TrajectoryConfig.logIntervalMs], detected when null).
+  static ({
+    List<SensorLog> logs,
+    int repairedCount,
+    double health,
+    int intervalMs,
+  })
+  _repair(List<SensorLog> cleanLogs, TrajectoryConfig config) {
+    // 1. Sort the CLEAN logs by hardware ID
+    // Hardware writes are sometimes buffered out of order; this enforces monotonicity.
+    final List<SensorLog> sortedLogs = List.from(cleanLogs)
       ..sort((a, b) => a.packetId.compareTo(b.packetId));
 
-    final dedupedLogs = <SensorLog>[];
+    // 1b. Deduplicate by PacketID (keep last occurrence, as later readings
+    // are more likely to be correct after sensor stabilization).
+    // Duplicate IDs produce zero-distance segments that deflate speed calculations.
+    final List<SensorLog> dedupedLogs = [];
     for (int i = 0; i < sortedLogs.length; i++) {
       if (i + 1 < sortedLogs.length &&
           sortedLogs[i].packetId == sortedLogs[i + 1].packetId) {
-        continue;
+        continue; // Skip this one, keep the next
       }
       dedupedLogs.add(sortedLogs[i]);
     }
 
-    int kernelStepSize = 100;
-    final sampleSize = min(dedupedLogs.length, 51);
-    if (sampleSize >= 2) {
-      List<int> diffs = [];
-      for (int i = 1; i < sampleSize; i++) {
-        int d = dedupedLogs[i].packetId - dedupedLogs[i - 1].packetId;
-        if (d > 0 && d < 5000) diffs.add(d);
-      }
-      if (diffs.length >= 3) {
-        diffs.sort();
-        final q1 = diffs[diffs.length ~/ 4];
-        final q3 = diffs[(diffs.length * 3) ~/ 4];
-        final iqr = q3 - q1;
-        final lowerBound = q1 - 1.5 * iqr;
-        final upperBound = q3 + 1.5 * iqr;
-        final filtered =
-            diffs.where((d) => d >= lowerBound && d <= upperBound).toList();
-        kernelStepSize =
-            filtered.isNotEmpty
-                ? filtered[filtered.length ~/ 2]
-                : diffs[diffs.length ~/ 2];
-      } else if (diffs.isNotEmpty) {
-        diffs.sort();
-        kernelStepSize = diffs[diffs.length ~/ 2];
-      }
-    }
+    // 2. Determine Kernel Step Size (Hardware Median) and Log Interval
+    // The hardware might step by 1, 10, or 100 counts per log.
+    // We sample up to 50 consecutive diffs and apply IQR outlier rejection
+    // to handle corrupted packets or irregular spacing after power-on.
+    // The interval (100-1000 ms, see setLogInterval) sets the repaired
+    // timeline's spacing.
+    final int kernelStepSize = LogInterval.kernelStep(dedupedLogs);
+    final int intervalMs =
+        config.logIntervalMs ??
+        LogInterval.detect(dedupedLogs, kernelStep: kernelStepSize);
+
+    // 3. The Repair Loop
+    // We iterate through the logs. If we see a jump in PacketID, we fill it.
+    final List<SensorLog> repairedLogs = [];
+    int repairedCount = 0; // NEW: Track how many packets we had to fake.
 
-    final repairedLogs = <SensorLog>[];
-    int repairedCount = 0;
+    // Anchor: Start with the first clean log
     DateTime currentTime = dedupedLogs.first.timestamp;
     repairedLogs.add(dedupedLogs.first.copyWith(timestamp: currentTime));
 
     for (int i = 1; i < dedupedLogs.length; i++) {
       final prev = dedupedLogs[i - 1];
       final curr = dedupedLogs[i];
+
+      // Calculate how many "steps" the hardware skipped.
+      // E.g., if IDs are 100 and 300, and step is 100, we missed 1 step (ID 200).
       int idDiff = curr.packetId - prev.packetId;
       int steps = (idDiff / kernelStepSize).round();
 
+      // LOGIC BRANCH: INTERPOLATE OR RESET?
+      // We only interpolate if the gap is manageable (< 500 steps, 50 s at 10 Hz).
+      // If the gap is massive, it's likely a user "Pause" or file merge, so we skip filling.
       if (steps > 1 && steps < 500) {
         int missingPackets = steps - 1;
-        repairedCount += missingPackets;
+        repairedCount +=
+            missingPackets; // <--- Count the damage for Health Score
+
+        // Generate a synthetic log for EACH missing step
         for (int s = 1; s < steps; s++) {
-          double ratio = s / steps;
+          double ratio = s / steps; // Linear progress (e.g., 0.25, 0.5, 0.75)
+
+          // Calculate exact time for this missing packet (one interval per step)
           DateTime interpTime = currentTime.add(
-            Duration(milliseconds: s * 100),
+            Duration(milliseconds: s * intervalMs),
           );
           int newId = prev.packetId + (s * kernelStepSize);
+
+          // Create the synthetic log with interpolated sensor values
           repairedLogs.add(
             _interpolateLog(prev, curr, ratio, interpTime, newId),
           );
         }
-        currentTime = currentTime.add(Duration(milliseconds: steps * 100));
+
+        // Advance the master clock by the exact duration of the gap
+        currentTime = currentTime.add(
+          Duration(milliseconds: steps * intervalMs),
+        );
       } else {
+        // HUGE GAP or NORMAL STEP (steps == 1)
         if (steps >= 500) {
+          // Massive Jump: Don't guess. Re-anchor to the new hardware timestamp.
           currentTime = curr.timestamp;
         } else {
-          currentTime = currentTime.add(const Duration(milliseconds: 100));
+          // Normal Operation: Just tick forward one interval.
+          // (Also handles duplicate IDs by essentially ignoring the zero-step time change)
+          currentTime = currentTime.add(Duration(milliseconds: intervalMs));
         }
       }
+
+      // Add the current real log with the corrected/anchored timestamp
       repairedLogs.add(curr.copyWith(timestamp: currentTime));
     }
 
+    // --- CALCULATE HEALTH SCORE ---
+    // A perfect session has 0 repaired packets.
+    // If we had to synthesize 50% of the data, confidence is 50%.
     int totalOutput = repairedLogs.length;
-    double health =
-        totalOutput > 0
-            ? ((totalOutput - repairedCount) / totalOutput) * 100.0
-            : 0;
+    double health = 100.0;
+    if (totalOutput > 0) {
+      health = ((totalOutput - repairedCount) / totalOutput) * 100.0;
+    }
 
-    // Skip Stage 1-2 (Kalman+RTS) — return sanitized + gap-repaired logs
-    return TrajectoryResult(
+    return (
       logs: repairedLogs,
-      healthScore: health,
-      originalCount: cleanLogs.length,
       repairedCount: repairedCount,
+      health: health,
+      intervalMs: intervalMs,
     );
   }
 
   /// VALIDATION LOGIC
-  /// Returns 'false' if the packet contains corrupted or physically impossible data.
-  /// Used in Stage -1 to filter out "gibberish" before processing.
-  static bool _isLogValid(SensorLog log) {
-    // 1. Check for Binary Parsing Errors
-    // NaN (Not a Number) or Infinity indicates the byte stream was misaligned.
-    if (log.accelX.isNaN || log.gyroX.isNaN || log.speed.isNaN) return false;
-    if (log.accelX.isInfinite || log.gyroX.isInfinite || log.speed.isInfinite)
-      return false;
-
-    // 2. Check for "Null Island"
-    // Lat/Lon of 0.0 is the default "No Fix" state for GPS.
-    if (log.latitude.abs() < 0.001 && log.longitude.abs() < 0.001) return false;
-
-    // 3. PHYSICAL LIMITS CHECK (Tuned to hardware capabilities)
-
-    // ACCEL: Units are m/s^2.
-    // A standard 16G accelerometer maxes out at ~157 m/s^2.
-    // We allow up to 200.0 to account for impact shocks (e.g., dropping the pod)
-    // but reject massive corrupt values like 10,000.
-    const double maxAccel = 200.0;
-    if (log.accelX.abs() > maxAccel ||
-        log.accelY.abs() > maxAccel ||
-        log.accelZ.abs() > maxAccel) {
-      return false;
-    }
-
-    // GYRO: Units are rad/s.
-    // A 2000 dps (degrees per second) gyro maxes out at ~35 rad/s.
-    // We cap at 40.0. Any higher usually means an Int16 overflow in the binary.
-    const double maxGyro = 40.0;
-    if (log.gyroX.abs() > maxGyro ||
-        log.gyroY.abs() > maxGyro ||
-        log.gyroZ.abs() > maxGyro) {
-      return false;
-    }
-
-    // SPEED: Units are km/h.
-    // World class sprinters hit ~45 km/h.
-    // We cap at 80.0 km/h to allow for noisy GPS spikes but filter out
-    // "teleportation" errors (like getting a fix 500km away).
-    const double maxSpeed = 80.0;
-    if (log.speed > maxSpeed) {
-      return false;
-    }
-
-    // 4. Check for "Zero-Fill" Glitch
-    // Sometimes hardware writes the header but fails to write the payload,
-    // leaving all sensors exactly at 0.0. This is statistically impossible for a moving object.
-    bool isAllZeroes =
-        log.accelX == 0 &&
-        log.accelY == 0 &&
-        log.accelZ == 0 &&
-        log.gyroX == 0 &&
-        log.gyroY == 0 &&
-        log.gyroZ == 0;
-    if (isAllZeroes) return false;
-
-    return true;
+  /// Keeps only logs without [RecordAnomaly] flags (NaN/Inf, null island,
+  /// physically impossible values, zero-filled IMU). Uses the parse stage's
+  /// precomputed [anomalies] when they line up with [logs]; otherwise runs
+  /// the vectorized [SanityKernel] over a column copy of [logs].
+  static List<SensorLog> _sanitize(List<SensorLog> logs, Uint8List? anomalies) {
+    final flags =
+        anomalies != null && anomalies.length == logs.length
+            ? anomalies
+            : SanityKernel.classify(SensorColumns.fromLogs(logs));
+    return SanityKernel.compact(logs, SanityKernel.compactionIndex(flags));
   }
 
   /// LINEAR INTERPOLATION
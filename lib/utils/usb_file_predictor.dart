@@ -1,6 +1,7 @@
 import 'dart:io';
 import 'dart:typed_data';
 import '../models/usb_bounds_model.dart';
+import 'record_anomalies.dart';
 ///Class contains functions to assist in predicting if a file contains the logs within the time interval.
 class UsbFilePredictor {
 
@@ -57,27 +58,8 @@ class UsbFilePredictor {
   /// Detect record size by checking if a valid header starts at byte 47, 61, or 64.
   /// Returns 47 for V3.6 firmware (v01), 61 for Proewe, 64 for original HTS.
   static int _detectRecordSize(Uint8List data) {
-    final bd = ByteData.sublistView(data);
-
-    // Check for V3.6 v01 format (47-byte records)
-    if (data.length >= 55) {
-      final year = bd.getUint16(51, Endian.little); // 47 + 4
-      final month = data[53]; // 47 + 6
-      final day = data[54]; // 47 + 7
-      if (year >= 2022 && year <= 2030 && month >= 1 && month <= 12 && day >= 1 && day <= 31) {
-        return 47;
-      }
-    }
-
-    // Check for Proewe format (61-byte records)
-    if (data.length >= 69) {
-      final year = bd.getUint16(65, Endian.little); // 61 + 4
-      final month = data[67]; // 61 + 6
-      final day = data[68]; // 61 + 7
-      if (year >= 2022 && year <= 2030 && month >= 1 && month <= 12 && day >= 1 && day <= 31) {
-        return 61;
-      }
-    }
+    if (RecordHeader.isPlausible(data, 47)) return 47;
+    if (RecordHeader.isPlausible(data, 61)) return 61;
 
     return 64;
   }
@@ -85,16 +67,13 @@ class UsbFilePredictor {
   /// Extracts the timestamp from a binary record.
   /// Logic mirrors the full [BinaryParser] but strictly for time extraction.
   static DateTime? _parseTimestamp(Uint8List bytes) {
+    // Validation: realistic year, month and day
+    if (!RecordHeader.isPlausible(bytes, 0)) return null;
     try {
       final data = ByteData.sublistView(bytes);
 
-      // Extract the year (Offset 4)
-      int year = data.getUint16(4, Endian.little);
-
-      // Validation: Ensure year is within a realistic range.
-      if (year < 2022 || year > 2030) return null;
-
       // Extract date and time components
+      int year  = data.getUint16(4, Endian.little);
       int month = data.getUint8(6);
       int day   = data.getUint8(7);
       int hour  = data.getUint8(8);
@@ -102,9 +81,6 @@ class UsbFilePredictor {
       int sec   = data.getUint8(10);
       int ms    = data.getUint16(11, Endian.little);
 
-      // Confirm a valid month and day were extracted
-      if (month == 0 || month > 12 || day == 0 || day > 31) return null;
-
       return DateTime(year, month, day, hour, min, sec, ms);
     } catch (e) {
       return null;
@@ -0,0 +1,93 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/services/batch_sync.dart';
+import 'package:metric_athlete_pod_ble/utils/sensor_log_csv.dart';
+
+SensorLog _log(int packetId, DateTime timestamp) {
+  return SensorLog(
+    packetId: packetId,
+    timestamp: timestamp,
+    latitude: -25.8,
+    longitude: 28.2,
+    speed: 10.0,
+    accelX: 0.5,
+    accelY: -0.3,
+    accelZ: 9.8,
+    gyroX: 0.01,
+    gyroY: -0.02,
+    gyroZ: 0.03,
+    filteredAccelX: 0.4,
+    filteredAccelY: -0.2,
+    filteredAccelZ: 9.7,
+  );
+}
+
+/// [minutes] of 1 Hz logs starting at [start].
+List<SensorLog> _file(DateTime start, int minutes, {int firstId = 0}) =>
+    List.generate(
+      minutes * 60,
+      (i) => _log(firstId + i, start.add(Duration(seconds: i))),
+    );
+
+void main() {
+  final base = DateTime(2026, 3, 14, 9, 5);
+
+  group('BatchSync.finalize', () {
+    test('sorts files downloaded out of order', () {
+      final a = _file(base, 6);
+      final b = _file(base.add(const Duration(minutes: 6)), 6, firstId: 360);
+      final result = BatchSync.finalize([...b, ...a]);
+      expect(result.logs.first.timestamp, base);
+      for (int i = 1; i < result.logs.length; i++) {
+        expect(
+          result.logs[i].timestamp.isBefore(result.logs[i - 1].timestamp),
+          isFalse,
+        );
+      }
+      expect(result.sessions.length, 1);
+    });
+
+    test('drops records of a re-downloaded file', () {
+      final a = _file(base, 6);
+      final result = BatchSync.finalize([...a, ...a]);
+      expect(result.logs.length, a.length);
+      expect(result.duplicatesRemoved, a.length);
+    });
+
+    test('clusters separate recordings', () {
+      final morning = _file(base, 6);
+      final evening = _file(
+        base.add(const Duration(hours: 8)),
+        6,
+        firstId: 100000,
+      );
+      final result = BatchSync.finalize([...morning, ...evening]);
+      expect(result.duplicatesRemoved, 0);
+      expect(result.sessions.length, 2);
+    });
+  });
+
+  group('BatchSync names', () {
+    test('raw archive name', () {
+      expect(
+        BatchSync.rawArchiveName(7, base),
+        'Player_7_20260314_0905_Raw.csv',
+      );
+      expect(
+        BatchSync.rawArchiveName(0, base),
+        'Player_Unknown_20260314_0905_Raw.csv',
+      );
+    });
+  });
+
+  group('SensorLogCsv', () {
+    test('writes a header and one row per log', () {
+      final csv = SensorLogCsv.encode(_file(base, 1));
+      final lines = csv.trimRight().split('\n');
+      expect(lines.first, SensorLogCsv.header);
+      expect(lines.length, 61);
+      expect(lines[1].split(',').length, 14);
+      expect(lines[1], startsWith('2026-03-14T09:05:00.000,0,'));
+    });
+  });
+}
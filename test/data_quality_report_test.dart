@@ -0,0 +1,121 @@
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:metric_athlete_pod_ble/transport/transfer_integrity.dart';
+import 'package:metric_athlete_pod_ble/utils/data_quality_report.dart';
+import 'package:metric_athlete_pod_ble/utils/logs_binary_parser.dart';
+
+/// Builds one 61-byte record (Proewe layout).
+Uint8List _buildRecord({
+  required int kernelTick,
+  double lat = -25.8,
+  double lon = 28.2,
+  double speed = 12.0,
+  double accelZ = 9.8,
+}) {
+  final data = ByteData(61);
+  data.setUint32(0, kernelTick, Endian.little);
+  data.setUint16(4, 2026, Endian.little);
+  data.setUint8(6, 3);
+  data.setUint8(7, 14);
+  data.setUint8(8, 10);
+  data.setFloat32(13, lat, Endian.little);
+  data.setFloat32(17, lon, Endian.little);
+  data.setFloat32(21, speed, Endian.little);
+  data.setFloat32(33, accelZ, Endian.little);
+  return data.buffer.asUint8List();
+}
+
+Uint8List _concat(List<Uint8List> records) =>
+    Uint8List.fromList([for (final r in records) ...r]);
+
+void main() {
+  group('DataQualityReport from BinaryParser.parse', () {
+    test('clean file reports no loss', () {
+      final raw = _concat([
+        for (int i = 0; i < 10; i++) _buildRecord(kernelTick: 100 + i * 100),
+      ]);
+
+      final quality = BinaryParser.parse(raw).quality!;
+      expect(quality.records, 10);
+      expect(quality.nominalTickStep, 100);
+      expect(quality.tickGapHistogram, [9, 0, 0, 0, 0, 0]);
+      expect(quality.missingTicks, 0);
+      expect(quality.estimatedLossPercent, 0);
+      expect(quality.gpsFixRatio, 1.0);
+    });
+
+    test('buckets tick gaps and estimates loss', () {
+      final raw = _concat([
+        _buildRecord(kernelTick: 100),
+        _buildRecord(kernelTick: 200),
+        _buildRecord(kernelTick: 300),
+        _buildRecord(kernelTick: 400),
+        _buildRecord(kernelTick: 600), // 1 lost
+        _buildRecord(kernelTick: 1000), // 3 lost
+        _buildRecord(kernelTick: 1000), // duplicate
+        _buildRecord(kernelTick: 900000), // pause, not loss
+        _buildRecord(kernelTick: 900100),
+      ]);
+
+      final quality = BinaryParser.parse(raw).quality!;
+      expect(quality.nominalTickStep, 100);
+      expect(quality.tickGapHistogram, [4, 1, 1, 0, 0, 1]);
+      expect(quality.duplicateTicks, 1);
+      expect(quality.missingTicks, 4);
+      expect(quality.estimatedLossPercent, closeTo(4 / 13 * 100, 1e-9));
+    });
+
+    test('counts non-finite channels, range violations and GPS fixes', () {
+      final raw = _concat([
+        _buildRecord(kernelTick: 100),
+        _buildRecord(kernelTick: 200, speed: double.nan),
+        _buildRecord(kernelTick: 300, lat: 0, lon: 0),
+        _buildRecord(kernelTick: 400, speed: 120),
+        _buildRecord(kernelTick: 500, accelZ: 0),
+      ]);
+
+      final quality = BinaryParser.parse(raw).quality!;
+      final speedChannel = DataQualityReport.channels.indexOf('speed');
+      expect(quality.nonFiniteCounts[speedChannel], 1);
+      expect(quality.nonFiniteTotal, 1);
+      expect(quality.gpsFixes, 4);
+      expect(quality.speedOutOfRange, 1);
+      expect(quality.zeroFilled, 1);
+      expect(quality.summary(), contains('nan.speed=1'));
+    });
+
+    test('counts sync skips', () {
+      final raw = _concat([
+        Uint8List.fromList([0xFF, 0xFF]),
+        _buildRecord(kernelTick: 100),
+        _buildRecord(kernelTick: 200),
+      ]);
+
+      final quality = BinaryParser.parse(raw).quality!;
+      expect(quality.syncSkips, 2);
+      expect(quality.records, 2);
+    });
+
+    test('includes records rejected by the native bitmap in the loss', () {
+      final raw = _concat([
+        for (int i = 0; i < 4; i++) _buildRecord(kernelTick: 100 + i * 100),
+      ]);
+      final header = ByteData(26);
+      header.setUint8(4, TransferIntegrity.flagSequenceVerified);
+      header.setUint8(5, 61);
+      header.setUint32(6, 4, Endian.little);
+      header.setUint32(10, 3, Endian.little);
+      header.setUint32(22, 4 * 61, Endian.little);
+      final integrity = TransferIntegrity.fromBytes(
+        Uint8List.fromList([...header.buffer.asUint8List(), 0x0B]),
+      );
+
+      final quality = BinaryParser.parse(raw, integrity: integrity).quality!;
+      expect(quality.records, 3);
+      expect(quality.rejectedRecords, 1);
+      // Tick gap 200 -> 400 already accounts for the rejected record
+      expect(quality.missingTicks, 1);
+      expect(quality.estimatedLossPercent, closeTo(25.0, 1e-9));
+    });
+  });
+}
@@ -0,0 +1,166 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:metric_athlete_pod_ble/models/live_data_model.dart';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/event_detector.dart';
+
+final _base = DateTime.utc(2026, 3, 14, 10);
+
+SensorLog _log(int i, double speed, {double impact = 0}) {
+  return SensorLog(
+    packetId: 1000 + i * 100,
+    timestamp: _base.add(Duration(milliseconds: i * 100)),
+    latitude: -25.7,
+    longitude: 28.2,
+    speed: speed,
+    accelX: 0.5,
+    accelY: 0.1,
+    accelZ: 9.8,
+    gyroX: 0.01,
+    gyroY: 0.02,
+    gyroZ: 0.03,
+    filteredAccelX: impact > 0 ? impact : 0.2,
+    filteredAccelY: impact > 0 ? impact : 0.1,
+    filteredAccelZ: impact > 0 ? impact : 0.3,
+  );
+}
+
+/// 11 s at 10 Hz: jog, accelerate 8 -> 32 km/h over 2 s, hold 3 s,
+/// decelerate to 8 km/h over 1.5 s, then impacts at 9.0 s, 9.2 s and 10.0 s.
+List<SensorLog> _session() {
+  double speed(int i) {
+    if (i < 10) return 8;
+    if (i < 30) return 8 + (i - 10) * 1.2;
+    if (i < 60) return 32;
+    if (i < 75) return 32 - (i - 60) * 1.6;
+    return 8;
+  }
+
+  return [
+    for (int i = 0; i < 110; i++)
+      _log(i, speed(i), impact: i == 90 || i == 92 || i == 100 ? 30 : 0),
+  ];
+}
+
+LiveTelemetry _live(int tick, double knots) {
+  return LiveTelemetry(
+    kernelTickCount: tick,
+    batteryVoltage: 4.0,
+    accelerometer: Vector3(x: 0.1, y: 0.2, z: 9.9),
+    gyroscope: Vector3(x: 0, y: 0, z: 0),
+    filteredGravity: Vector3(x: 0, y: 0, z: 9.8),
+    isGpsFixValid: true,
+    year: 2026,
+    month: 3,
+    day: 14,
+    hour: 10,
+    minute: 0,
+    second: 0,
+    millisecond: 0,
+    latitude: -25.7,
+    longitude: 28.2,
+    gpsFixQuality: 1,
+    gpsSatellites: 9,
+    gpsSpeed: knots,
+    gpsCourse: 0,
+  );
+}
+
+void main() {
+  group('EventDetector.detect', () {
+    test('finds sprint, acceleration, deceleration and impacts', () {
+      final table = EventDetector.detect(_session());
+      final t0 = _base.millisecondsSinceEpoch;
+
+      expect(table.count(AthleteEventType.sprint), 1);
+      expect(table.count(AthleteEventType.acceleration), 1);
+      expect(table.count(AthleteEventType.deceleration), 1);
+      // 9.0 s and 9.2 s are one impact (refractory period)
+      expect(table.count(AthleteEventType.impact), 2);
+
+      final sprint = table.ofType(AthleteEventType.sprint).single;
+      expect(sprint.startMs - t0, 2500);
+      expect(sprint.endMs - t0, 6500);
+      expect(sprint.peak, 32);
+      // ~4 s between 26 and 32 km/h
+      expect(sprint.distanceM, closeTo(34.5, 1.0));
+
+      final accel = table.ofType(AthleteEventType.acceleration).single;
+      expect(accel.peak, closeTo(12 / 3.6, 1e-6));
+      final decel = table.ofType(AthleteEventType.deceleration).single;
+      expect(decel.peak, closeTo(-16 / 3.6, 1e-6));
+
+      final impacts = table.ofType(AthleteEventType.impact).toList();
+      expect(impacts.map((e) => e.startMs - t0), [9000, 10000]);
+      expect(table.summary(), 'sprints=1 accels=1 decels=1 impacts=2');
+    });
+
+    test('keeps one sprint through dips above the off threshold', () {
+      final logs = [
+        for (int i = 0; i < 40; i++) _log(i, i.isEven ? 26 : 24),
+        for (int i = 40; i < 50; i++) _log(i, 10),
+      ];
+      final sprints = EventDetector.detect(
+        logs,
+      ).ofType(AthleteEventType.sprint);
+      expect(sprints.length, 1);
+      expect(sprints.single.durationMs, 3900);
+    });
+
+    test('ignores efforts shorter than the minimum duration', () {
+      final logs = [
+        for (int i = 0; i < 5; i++) _log(i, 8),
+        for (int i = 5; i < 10; i++) _log(i, 30),
+        for (int i = 10; i < 20; i++) _log(i, 8),
+      ];
+      final table = EventDetector.detect(logs);
+      expect(table.count(AthleteEventType.sprint), 0);
+    });
+
+    test('closes open events across gaps', () {
+      final logs = [
+        for (int i = 0; i < 20; i++) _log(i, 30),
+        for (int i = 100; i < 120; i++) _log(i, 30),
+      ];
+      final sprints =
+          EventDetector.detect(logs).ofType(AthleteEventType.sprint).toList();
+      expect(sprints.length, 2);
+      expect(sprints.first.durationMs, 1900);
+    });
+  });
+
+  group('EventDetector streaming', () {
+    test('matches batch detection', () {
+      final logs = _session();
+      final detector = EventDetector();
+      final streamed = [
+        for (final log in logs) ...detector.addLog(log),
+        ...detector.flush(),
+      ];
+      final batch = EventDetector.detect(logs).events;
+
+      expect(streamed.length, batch.length);
+      for (int i = 0; i < batch.length; i++) {
+        expect(streamed[i].type, batch[i].type);
+        expect(streamed[i].startMs, batch[i].startMs);
+        expect(streamed[i].endMs, batch[i].endMs);
+      }
+    });
+
+    test('reports a sprint on the live stream once it ends', () {
+      final detector = EventDetector();
+      final events = <AthleteEvent>[];
+      for (int i = 0; i < 20; i++) {
+        events.addAll(detector.addLive(_live(5000 + i * 100, 20)));
+      }
+      expect(events, isEmpty);
+
+      events.addAll(detector.addLive(_live(7000, 5)));
+      final sprint = events.singleWhere(
+        (e) => e.type == AthleteEventType.sprint,
+      );
+      expect(sprint.startMs, 5000);
+      expect(sprint.endMs, 6900);
+      expect(sprint.peak, closeTo(20 * EventDetector.knotsToKmh, 1e-9));
+    });
+  });
+}
@@ -137,6 +137,17 @@ void main() {
       final telemetry = LiveTelemetry.fromBytes(packet);
       expect(telemetry, isNotNull);
       expect(telemetry!.kernelTickCount, 1000);
+      expect(telemetry.isConcealed, isFalse);
+    });
+
+    test('reads the jitter buffer concealment flag at byte 72', () {
+      final packet = Uint8List.fromList([..._buildTelemetryPacket(), 0x01]);
+      final telemetry = LiveTelemetry.fromBytes(packet);
+      expect(telemetry!.isConcealed, isTrue);
+      expect(
+        LiveTelemetry.fromBytes(_buildTelemetryPacket())!.isConcealed,
+        isFalse,
+      );
     });
   });
 }
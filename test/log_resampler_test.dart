@@ -0,0 +1,208 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/filter_pipeline.dart';
+import 'package:metric_athlete_pod_ble/utils/log_resampler.dart';
+import 'package:metric_athlete_pod_ble/utils/trajectory_filter.dart';
+
+final _base = DateTime.utc(2026, 3, 14, 10);
+
+SensorLog _log(
+  int packetId,
+  int offsetMs, {
+  double speed = 10.0,
+  double accelX = 0.5,
+}) {
+  return SensorLog(
+    packetId: packetId,
+    timestamp: _base.add(Duration(milliseconds: offsetMs)),
+    latitude: -25.7 + offsetMs * 1e-8,
+    longitude: 28.2,
+    speed: speed,
+    accelX: accelX,
+    accelY: 0.1,
+    accelZ: 9.8,
+    gyroX: 0.01,
+    gyroY: 0.02,
+    gyroZ: 0.03,
+    filteredAccelX: accelX,
+    filteredAccelY: 0.1,
+    filteredAccelZ: 9.8,
+  );
+}
+
+/// [count] logs at [intervalMs], kernel tick in ms.
+List<SensorLog> _session(int count, int intervalMs) => List.generate(
+  count,
+  (i) => _log(1000 + i * intervalMs, i * intervalMs, speed: i.toDouble()),
+);
+
+void main() {
+  group('LogInterval', () {
+    test('snaps to the intervals the pod accepts', () {
+      expect(LogInterval.snap(96), 100);
+      expect(LogInterval.snap(190), 200);
+      expect(LogInterval.snap(520), 500);
+      expect(LogInterval.snap(0), 100);
+      expect(LogInterval.snap(4000), 1000);
+    });
+
+    test('detects the interval from kernel ticks', () {
+      for (final interval in [100, 200, 500, 1000]) {
+        expect(LogInterval.detect(_session(30, interval)), interval);
+      }
+    });
+
+    test('ignores lost packets when detecting', () {
+      final logs = _session(30, 200)..removeAt(10);
+      logs.removeAt(20);
+      expect(LogInterval.detect(logs), 200);
+    });
+
+    test('falls back to timestamps when ticks are not milliseconds', () {
+      final logs = List.generate(20, (i) => _log(i + 1, i * 300));
+      expect(LogInterval.kernelStep(logs), 1);
+      expect(LogInterval.detect(logs), 300);
+    });
+
+    test('defaults to 100 ms with nothing to measure', () {
+      expect(LogInterval.detect([]), LogInterval.defaultMs);
+      expect(LogInterval.detect([_log(100, 0)]), LogInterval.defaultMs);
+    });
+  });
+
+  group('Gap repair at the detected interval', () {
+    test('spaces synthetic rows one interval apart', () {
+      final logs = _session(10, 200)..removeAt(5);
+      final result = TrajectoryFilter.sanitizeAndRepairOnly(
+        logs,
+        const TrajectoryConfig(),
+      );
+
+      expect(result.logIntervalMs, 200);
+      expect(result.repairedCount, 1);
+      expect(result.logs.length, 10);
+      for (int i = 1; i < result.logs.length; i++) {
+        final dt = result.logs[i].timestamp.difference(
+          result.logs[i - 1].timestamp,
+        );
+        expect(dt.inMilliseconds, 200, reason: 'row $i');
+      }
+      expect(result.logs[5].speed, closeTo(5.0, 1e-9));
+    });
+
+    test('uses the configured interval when set', () {
+      final result = TrajectoryFilter.sanitizeAndRepairOnly(
+        _session(5, 200),
+        const TrajectoryConfig(logIntervalMs: 500),
+      );
+      expect(result.logIntervalMs, 500);
+      expect(
+        result.logs.last.timestamp.difference(result.logs.first.timestamp),
+        const Duration(seconds: 2),
+      );
+    });
+  });
+
+  group('LogResampler.resample', () {
+    test('upsamples with linear interpolation', () {
+      final logs = _session(10, 200);
+      final out = LogResampler.resample(logs, targetIntervalMs: 100);
+
+      expect(out.length, 19);
+      for (int k = 0; k < out.length; k++) {
+        expect(out[k].speed, closeTo(k / 2, 1e-9), reason: 'sample $k');
+        expect(
+          out[k].timestamp.difference(_base).inMilliseconds,
+          k * 100,
+        );
+      }
+      expect(out.first.timestamp.isUtc, isTrue);
+    });
+
+    test('aligns the grid to multiples of the target interval', () {
+      final logs = List.generate(
+        20,
+        (i) => _log(1000 + i * 100, 50 + i * 100, speed: i.toDouble()),
+      );
+      final out = LogResampler.resample(logs, targetIntervalMs: 200);
+
+      expect(out, isNotEmpty);
+      for (final l in out) {
+        expect(l.timestamp.millisecondsSinceEpoch % 200, 0);
+      }
+      // 10:00:00.200 lies halfway between the samples at .150 and .250
+      expect(out.first.timestamp.difference(_base).inMilliseconds, 200);
+      expect(out.first.speed, closeTo(1.5, 1e-9));
+    });
+
+    test('does not bridge long gaps', () {
+      final logs = [
+        for (int i = 0; i < 5; i++) _log(1000 + i * 200, i * 200),
+        for (int i = 0; i < 5; i++) _log(4000 + i * 200, 3000 + i * 200),
+      ];
+      final out = LogResampler.resample(logs, targetIntervalMs: 100);
+
+      final inGap = out.where((l) {
+        final ms = l.timestamp.difference(_base).inMilliseconds;
+        return ms > 800 && ms < 3000;
+      });
+      expect(inGap, isEmpty);
+      expect(out.length, 9 + 9);
+    });
+
+    test('anti-aliases IMU channels when downsampling', () {
+      // 5 Hz alternating accelX at 10 Hz: above the 1 Hz Nyquist of 500 ms
+      final logs = List.generate(
+        200,
+        (i) => _log(1000 + i * 100, i * 100, accelX: i.isEven ? 1.0 : -1.0),
+      );
+
+      final aliased = LogResampler.resample(
+        logs,
+        targetIntervalMs: 500,
+        antiAlias: false,
+      );
+      expect(aliased.map((l) => l.accelX.abs()), everyElement(1.0));
+
+      final filtered = LogResampler.resample(logs, targetIntervalMs: 500);
+      expect(filtered.length, aliased.length);
+      // Skip the filter's edge transients
+      for (final l in filtered.sublist(4, filtered.length - 4)) {
+        expect(l.accelX.abs(), lessThan(0.05));
+      }
+      // GPS and speed are not filtered
+      expect(filtered[10].latitude, logs[50].latitude);
+    });
+
+    test('returns a copy when the rates match', () {
+      final logs = _session(5, 100);
+      final out = LogResampler.resample(logs, targetIntervalMs: 100);
+      expect(out, logs);
+      expect(identical(out, logs), isFalse);
+    });
+  });
+
+  group('FilterPipeline resampling', () {
+    test('brings a 200 ms session to 100 ms', () {
+      final result = FilterPipeline.processWithConfig(
+        _session(50, 200),
+        const FilterConfig(
+          enableKalmanRts: false,
+          enableOutlierRejection: false,
+          resampleIntervalMs: 100,
+        ),
+      );
+      expect(result.logIntervalMs, 100);
+      expect(result.logs.length, 99);
+    });
+
+    test('keeps the native interval by default', () {
+      final result = FilterPipeline.processWithConfig(
+        _session(50, 500),
+        const FilterConfig(enableKalmanRts: false),
+      );
+      expect(result.logIntervalMs, 500);
+      expect(result.logs.length, 50);
+    });
+  });
+}
@@ -69,12 +69,168 @@ void main() {
     expect(args['currentIndex'], 1);
   });
 
+  test('downloadFiles sends file list, filter and window', () async {
+    await platform.downloadFiles(['a.bin', 'b.bin'], 1000, 2000, window: 3);
+    expect(methodCalls.single.method, 'downloadFiles');
+    final args = methodCalls.single.arguments as Map;
+    expect(args['filenames'], ['a.bin', 'b.bin']);
+    expect(args['filterStart'], 1000);
+    expect(args['filterEnd'], 2000);
+    expect(args['window'], 3);
+  });
+
+  test('acknowledgeBatchFile sends file index', () async {
+    await platform.acknowledgeBatchFile(2);
+    expect(methodCalls.single.method, 'acknowledgeBatchFile');
+    expect(methodCalls.single.arguments, 2);
+  });
+
   test('cancelDownload invokes native method', () async {
     await platform.cancelDownload();
     expect(methodCalls.length, 1);
     expect(methodCalls.first.method, 'cancelDownload');
   });
 
+  test('getPodHistory passes deviceId and decodes summaries', () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(channel, (MethodCall call) async {
+      methodCalls.add(call);
+      return [
+        {'id': 'AA:BB:CC:DD:EE:FF', 'downloadCount': 12, 'degrading': false},
+      ];
+    });
+
+    final history = await platform.getPodHistory(deviceId: 'AA:BB:CC:DD:EE:FF');
+    expect(methodCalls.single.method, 'getPodHistory');
+    expect(methodCalls.single.arguments, 'AA:BB:CC:DD:EE:FF');
+    expect(history.single['downloadCount'], 12);
+    expect(history.single['degrading'], false);
+  });
+
+  test('setPowerPolicy sends idle downgrade delay', () async {
+    await platform.setPowerPolicy(idleDowngradeMs: 3000);
+    expect(methodCalls.single.method, 'setPowerPolicy');
+    expect((methodCalls.single.arguments as Map)['idleDowngradeMs'], 3000);
+  });
+
+  test('setLiveMetrics sends interval and forwarding flag', () async {
+    await platform.setLiveMetrics(
+      enabled: true,
+      publishIntervalMs: 500,
+      forwardPackets: false,
+    );
+    expect(methodCalls.single.method, 'setLiveMetrics');
+    final args = methodCalls.single.arguments as Map;
+    expect(args['enabled'], true);
+    expect(args['publishIntervalMs'], 500);
+    expect(args['forwardPackets'], false);
+  });
+
+  test('resetLiveMetrics invokes native method', () async {
+    await platform.resetLiveMetrics();
+    expect(methodCalls.single.method, 'resetLiveMetrics');
+  });
+
+  test('setLiveJitterBuffer sends latency and concealment limit', () async {
+    await platform.setLiveJitterBuffer(
+      enabled: true,
+      latencyMs: 300,
+      maxConcealMs: 400,
+    );
+    expect(methodCalls.single.method, 'setLiveJitterBuffer');
+    final args = methodCalls.single.arguments as Map;
+    expect(args['enabled'], true);
+    expect(args['latencyMs'], 300);
+    expect(args['maxConcealMs'], 400);
+    expect(args['intervalMs'], 0);
+  });
+
+  test('setLiveTelemetryExport sends ring size and omits default name', () async {
+    final info = await platform.setLiveTelemetryExport(
+      enabled: true,
+      ringRecords: 4096,
+    );
+    expect(methodCalls.single.method, 'setLiveTelemetryExport');
+    final args = methodCalls.single.arguments as Map;
+    expect(args['enabled'], true);
+    expect(args.containsKey('name'), false);
+    expect(args['podSlots'], 8);
+    expect(args['ringRecords'], 4096);
+    expect(info, isEmpty);
+  });
+
+  test('setSessionRecording sends path only when given', () async {
+    final info = await platform.setSessionRecording(enabled: false);
+    expect(methodCalls.single.method, 'setSessionRecording');
+    final args = methodCalls.single.arguments as Map;
+    expect(args['enabled'], false);
+    expect(args.containsKey('path'), false);
+    expect(info, isEmpty);
+  });
+
+  test('getDispatcherStats invokes native method', () async {
+    final stats = await platform.getDispatcherStats();
+    expect(methodCalls.single.method, 'getDispatcherStats');
+    expect(stats, isEmpty);
+  });
+
+  test('applyPodSettings sends only the values to change', () async {
+    final outcome = await platform.applyPodSettings(
+      logIntervalMs: 250,
+      timeout: const Duration(milliseconds: 1500),
+    );
+    expect(methodCalls.single.method, 'applyPodSettings');
+    final args = methodCalls.single.arguments as Map;
+    expect(args.containsKey('playerNumber'), false);
+    expect(args['logIntervalMs'], 250);
+    expect(args['timeoutMs'], 1500);
+    expect(outcome, isEmpty);
+  });
+
+  test('getCommandStats invokes native method', () async {
+    final stats = await platform.getCommandStats();
+    expect(methodCalls.single.method, 'getCommandStats');
+    expect(stats, isEmpty);
+  });
+
+  test('configureFleet sends the pod list and limits', () async {
+    final report = await platform.configureFleet(
+      [
+        {'id': 'AA:BB', 'playerNumber': 7},
+        {'id': 'CC:DD', 'logIntervalMs': 500},
+      ],
+      maxConnections: 3,
+      timeout: const Duration(seconds: 2),
+    );
+    expect(methodCalls.single.method, 'configureFleet');
+    final args = methodCalls.single.arguments as Map;
+    expect((args['pods'] as List).length, 2);
+    expect((args['pods'] as List).first, {'id': 'AA:BB', 'playerNumber': 7});
+    expect(args['maxConnections'], 3);
+    expect(args['timeoutMs'], 2000);
+    expect(args['connectTimeoutMs'], 10000);
+    expect(args['deleteTimeoutMs'], 15000);
+    expect(report, isEmpty);
+  });
+
+  test('deletePodFiles sends the names and timeout', () async {
+    final outcome = await platform.deletePodFiles(
+      ['LOG1.BIN (1.2 KB)', 'LOG2.BIN'],
+      timeout: const Duration(seconds: 5),
+    );
+    expect(methodCalls.single.method, 'deletePodFiles');
+    expect(methodCalls.single.arguments, {
+      'filenames': ['LOG1.BIN (1.2 KB)', 'LOG2.BIN'],
+      'timeoutMs': 5000,
+    });
+    expect(outcome, isEmpty);
+  });
+
+  test('cancelFleetConfig invokes native method', () async {
+    await platform.cancelFleetConfig();
+    expect(methodCalls.single.method, 'cancelFleetConfig');
+  });
+
   test('requestBatteryExemption invokes native method', () async {
     await platform.requestBatteryExemption();
     expect(methodCalls.length, 1);
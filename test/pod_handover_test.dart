@@ -0,0 +1,74 @@
+import 'dart:async';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:metric_athlete_pod_ble/utils/pod_handover.dart';
+
+/// Mirrors PodNotifier's 0xDA handler: a skip we did not cancel ourselves
+/// completes the pending download with nothing.
+void _onSkip(PodHandover handover, Completer<List<int>>? pending) {
+  if (handover.takeOwnSkip()) return;
+  if (pending != null && !pending.isCompleted) pending.complete([]);
+}
+
+void main() {
+  group('PodHandover', () {
+    test('retry after a cancel ignores the cancel\'s skip', () async {
+      final handover = PodHandover();
+      final failed = Completer<List<int>>()..completeError('Timed out');
+      failed.future.ignore();
+
+      // Retry path: cancel, wait for the pod, then a fresh request
+      handover.cancelIssued();
+      scheduleMicrotask(() {
+        // Native order: the skip marker, then "Pod Ready"
+        _onSkip(handover, failed);
+        handover.markReady();
+      });
+      await handover.waitUntilReady();
+      final retry = Completer<List<int>>();
+      handover.requestIssued();
+
+      expect(retry.isCompleted, isFalse);
+      retry.complete([1, 2, 3]);
+      expect(await retry.future, [1, 2, 3]);
+    });
+
+    test('a skip arriving after the fallback still answers the cancel', () async {
+      final handover = PodHandover(fallback: const Duration(milliseconds: 10));
+      handover.cancelIssued();
+      await handover.waitUntilReady();
+      expect(handover.isReady, isTrue);
+
+      final retry = Completer<List<int>>();
+      handover.requestIssued();
+      _onSkip(handover, retry);
+      expect(retry.isCompleted, isFalse);
+    });
+
+    test('one skip dropped per cancel', () {
+      final handover = PodHandover();
+      handover.cancelIssued();
+      handover.cancelIssued();
+      expect(handover.takeOwnSkip(), isTrue);
+      expect(handover.takeOwnSkip(), isTrue);
+      expect(handover.takeOwnSkip(), isFalse);
+    });
+
+    test('a skip nobody cancelled completes the download empty', () async {
+      final handover = PodHandover();
+      final pending = Completer<List<int>>();
+      handover.requestIssued();
+      _onSkip(handover, pending);
+      expect(await pending.future, isEmpty);
+    });
+
+    test('reset forgets owed skips and releases waiters', () async {
+      final handover = PodHandover(fallback: const Duration(seconds: 5));
+      handover.cancelIssued();
+      final wait = handover.waitUntilReady();
+      handover.reset();
+      expect(await wait, lessThan(const Duration(seconds: 5)));
+      expect(handover.takeOwnSkip(), isFalse);
+    });
+  });
+}
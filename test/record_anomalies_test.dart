@@ -0,0 +1,194 @@
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/filter_pipeline.dart';
+import 'package:metric_athlete_pod_ble/utils/logs_binary_parser.dart';
+import 'package:metric_athlete_pod_ble/utils/record_anomalies.dart';
+import 'package:metric_athlete_pod_ble/utils/trajectory_filter.dart';
+
+/// Helper to create a SensorLog with sensible defaults.
+SensorLog _log({
+  int packetId = 100,
+  double lat = -33.8688,
+  double lon = 151.2093,
+  double speed = 10.0,
+  double accelX = 0.5,
+  double accelY = -0.3,
+  double accelZ = 9.8,
+  double gyroX = 0.01,
+  double gyroY = -0.02,
+  double gyroZ = 0.03,
+}) {
+  return SensorLog(
+    packetId: packetId,
+    timestamp: DateTime(2025, 7, 25, 10, 0, 0),
+    latitude: lat,
+    longitude: lon,
+    speed: speed,
+    accelX: accelX,
+    accelY: accelY,
+    accelZ: accelZ,
+    gyroX: gyroX,
+    gyroY: gyroY,
+    gyroZ: gyroZ,
+    filteredAccelX: accelX,
+    filteredAccelY: accelY,
+    filteredAccelZ: accelZ,
+  );
+}
+
+/// Builds one 61-byte record (Proewe layout).
+Uint8List _buildRecord({
+  int kernelTick = 100,
+  int year = 2026,
+  double lat = -25.8,
+  double lon = 28.2,
+  double speed = 12.0,
+  double accelZ = 9.8,
+}) {
+  final data = ByteData(61);
+  data.setUint32(0, kernelTick, Endian.little);
+  data.setUint16(4, year, Endian.little);
+  data.setUint8(6, 3);
+  data.setUint8(7, 14);
+  data.setUint8(8, 10);
+  data.setFloat32(13, lat, Endian.little);
+  data.setFloat32(17, lon, Endian.little);
+  data.setFloat32(21, speed, Endian.little);
+  data.setFloat32(33, accelZ, Endian.little);
+  return data.buffer.asUint8List();
+}
+
+void main() {
+  group('RecordHeader.isPlausible', () {
+    test('accepts a valid header and rejects out-of-range dates', () {
+      expect(RecordHeader.isPlausible(_buildRecord(), 0), true);
+      expect(RecordHeader.isPlausible(_buildRecord(year: 2021), 0), false);
+      expect(RecordHeader.isPlausible(_buildRecord(year: 2031), 0), false);
+    });
+
+    test('rejects offsets without a full header', () {
+      final record = _buildRecord();
+      expect(RecordHeader.isPlausible(record, 54), false);
+      expect(RecordHeader.isPlausible(record, -1), false);
+    });
+  });
+
+  group('RecordAnomaly.classify', () {
+    test('clean log has no flags', () {
+      expect(RecordAnomaly.classify(_log()), 0);
+    });
+
+    test('flags each anomaly class', () {
+      expect(
+        RecordAnomaly.classify(_log(speed: double.nan)),
+        RecordAnomaly.nonFinite,
+      );
+      expect(
+        RecordAnomaly.classify(_log(lat: 0, lon: 0)),
+        RecordAnomaly.nullIsland,
+      );
+      expect(
+        RecordAnomaly.classify(_log(speed: 120)),
+        RecordAnomaly.impossibleSpeed,
+      );
+      expect(
+        RecordAnomaly.classify(_log(gyroY: 50)),
+        RecordAnomaly.imuOutOfRange,
+      );
+      expect(
+        RecordAnomaly.classify(
+          _log(accelX: 0, accelY: 0, accelZ: 0, gyroX: 0, gyroY: 0, gyroZ: 0),
+        ),
+        RecordAnomaly.zeroFill,
+      );
+    });
+
+    test('combines independent flags', () {
+      expect(
+        RecordAnomaly.classify(_log(lat: 0, lon: 0, speed: 120)),
+        RecordAnomaly.nullIsland | RecordAnomaly.impossibleSpeed,
+      );
+    });
+  });
+
+  group('BinaryParser.parse', () {
+    test('returns anomaly flags aligned with the decoded logs', () {
+      final raw = Uint8List.fromList([
+        ..._buildRecord(kernelTick: 100),
+        ..._buildRecord(kernelTick: 200, lat: 0, lon: 0),
+        ..._buildRecord(kernelTick: 300, speed: 95),
+      ]);
+
+      final parsed = BinaryParser.parse(raw);
+      expect(parsed.logs.map((l) => l.packetId), [100, 200, 300]);
+      expect(parsed.anomalies, [
+        0,
+        RecordAnomaly.nullIsland,
+        RecordAnomaly.impossibleSpeed,
+      ]);
+      expect(parsed.usableCount, 1);
+      expect(parsed.count(RecordAnomaly.nullIsland), 1);
+      expect(parsed.summary(), contains('usable=1/3'));
+    });
+
+    test('counts bytes skipped while resyncing', () {
+      final raw = Uint8List.fromList([
+        0xFF,
+        0xFF,
+        0xFF,
+        ..._buildRecord(kernelTick: 100),
+        ..._buildRecord(kernelTick: 200),
+      ]);
+
+      final parsed = BinaryParser.parse(raw);
+      expect(parsed.logs.length, 2);
+      expect(parsed.syncSkips, 3);
+    });
+  });
+
+  group('Sanity stage with precomputed anomalies', () {
+    final logs = List.generate(
+      20,
+      (i) => _log(packetId: 100 + i * 100, lat: -33.8688 + i * 0.00001),
+    );
+
+    test('uses the flags instead of re-validating', () {
+      // Flag a log that would pass classification; only the flags decide
+      final anomalies = Uint8List(logs.length)..[5] = RecordAnomaly.nullIsland;
+
+      final result = TrajectoryFilter.sanitizeAndRepairOnly(
+        logs,
+        const TrajectoryConfig(),
+        anomalies: anomalies,
+      );
+      expect(result.originalCount, 19);
+      expect(result.rejectedCount, 1);
+      expect(result.repairedCount, 1);
+    });
+
+    test('falls back to classification when flags do not line up', () {
+      final withBad = [...logs, _log(packetId: 5000, speed: double.nan)];
+
+      final result = TrajectoryFilter.sanitizeAndRepairOnly(
+        withBad,
+        const TrajectoryConfig(),
+        anomalies: Uint8List(3),
+      );
+      expect(result.originalCount, 20);
+      expect(result.rejectedCount, 1);
+    });
+
+    test('FilterPipeline.processParsed matches process on clean flags', () {
+      final anomalies = Uint8List(logs.length);
+      final parsed = FilterPipeline.processParsed(
+        ParsedLogs(logs: logs, anomalies: anomalies),
+      );
+      final scanned = FilterPipeline.process(logs);
+
+      expect(parsed.logs.length, scanned.logs.length);
+      expect(parsed.healthScore, scanned.healthScore);
+      expect(parsed.rejectedCount, 0);
+    });
+  });
+}
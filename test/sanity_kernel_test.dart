@@ -0,0 +1,84 @@
+import 'dart:math';
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/record_anomalies.dart';
+import 'package:metric_athlete_pod_ble/utils/sanity_kernel.dart';
+
+/// Float32-representable values covering every predicate and its boundary.
+const _specials = [
+  0.0,
+  -0.0,
+  0.0005,
+  12.5,
+  -39.5,
+  40.0,
+  40.5,
+  80.0,
+  80.5,
+  200.0,
+  -250.0,
+  double.nan,
+  double.infinity,
+  double.negativeInfinity,
+];
+
+SensorLog _randomLog(Random rng, int id) {
+  double pick(double normal) =>
+      rng.nextInt(4) == 0 ? _specials[rng.nextInt(_specials.length)] : normal;
+  return SensorLog(
+    packetId: id,
+    timestamp: DateTime(2026, 3, 14),
+    latitude: pick(-25.5),
+    longitude: pick(28.25),
+    speed: pick(12.5),
+    accelX: pick(0.5),
+    accelY: pick(-0.25),
+    accelZ: pick(9.75),
+    gyroX: pick(0.125),
+    gyroY: pick(-0.0625),
+    gyroZ: pick(0.25),
+    filteredAccelX: 0,
+    filteredAccelY: 0,
+    filteredAccelZ: 0,
+  );
+}
+
+void main() {
+  group('SanityKernel.classify', () {
+    test('matches RecordAnomaly.classify on corrupted data', () {
+      final rng = Random(42);
+      final logs = List.generate(2000, (i) => _randomLog(rng, i));
+
+      final flags = SanityKernel.classify(SensorColumns.fromLogs(logs));
+      expect(flags.length, logs.length);
+      for (int i = 0; i < logs.length; i++) {
+        expect(flags[i], RecordAnomaly.classify(logs[i]), reason: 'row $i');
+      }
+    });
+
+    test('handles lengths that are not a multiple of 4', () {
+      final rng = Random(7);
+      for (int n = 0; n <= 9; n++) {
+        final logs = List.generate(n, (i) => _randomLog(rng, i));
+        final flags = SanityKernel.classify(SensorColumns.fromLogs(logs));
+        expect(flags.length, n);
+        for (int i = 0; i < n; i++) {
+          expect(flags[i], RecordAnomaly.classify(logs[i]));
+        }
+      }
+    });
+  });
+
+  group('SanityKernel.compactionIndex', () {
+    test('lists usable rows in order', () {
+      final anomalies = Uint8List.fromList([0, 1, 0, 0, 4, 0]);
+      expect(SanityKernel.compactionIndex(anomalies), [0, 2, 3, 5]);
+    });
+
+    test('compact gathers the indexed items', () {
+      final index = Int32List.fromList([1, 3]);
+      expect(SanityKernel.compact(['a', 'b', 'c', 'd'], index), ['b', 'd']);
+    });
+  });
+}
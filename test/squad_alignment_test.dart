@@ -0,0 +1,154 @@
+import 'dart:math';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/squad_alignment.dart';
+
+final _base = DateTime.utc(2026, 3, 14, 10);
+
+SensorLog _log(int tick, int gpsOffsetMs, {double speed = 10.0}) {
+  return SensorLog(
+    packetId: tick,
+    timestamp: _base.add(Duration(milliseconds: gpsOffsetMs)),
+    latitude: -25.7,
+    longitude: 28.2,
+    speed: speed,
+    accelX: 0.5,
+    accelY: 0.1,
+    accelZ: 9.8,
+    gyroX: 0.01,
+    gyroY: 0.02,
+    gyroZ: 0.03,
+    filteredAccelX: 0.5,
+    filteredAccelY: 0.1,
+    filteredAccelZ: 9.8,
+  );
+}
+
+/// Pod whose tick 0 is at [startOffsetMs] after [_base] and whose crystal
+/// runs [driftPpm] fast. Logged GPS times are rounded to 10 ms. Speed is the
+/// true GPS time in seconds since [_base], so alignment is easy to check.
+List<SensorLog> _pod({
+  required int count,
+  required int intervalMs,
+  int firstTick = 5000,
+  int startOffsetMs = 0,
+  double driftPpm = 0,
+}) {
+  final msPerTick = 1 / (1 + driftPpm * 1e-6);
+  return List.generate(count, (i) {
+    final tick = firstTick + i * intervalMs;
+    final gpsMs = startOffsetMs + (tick - firstTick) * msPerTick;
+    return _log(tick, (gpsMs / 10).round() * 10, speed: gpsMs / 1000);
+  });
+}
+
+void main() {
+  group('PodClockEstimator.fit', () {
+    test('recovers offset and drift', () {
+      final logs = _pod(
+        count: 6000,
+        intervalMs: 100,
+        startOffsetMs: 2000,
+        driftPpm: 40,
+      );
+      final clock = PodClockEstimator.fit(logs)!;
+
+      expect(clock.driftPpm, closeTo(-40, 3));
+      expect(
+        clock.toGpsMs(5000),
+        closeTo(_base.millisecondsSinceEpoch + 2000, 10),
+      );
+      expect(clock.residualMs, lessThan(10));
+    });
+
+    test('ignores a minority of bad timestamps', () {
+      final rng = Random(3);
+      final logs = [
+        for (final l in _pod(count: 3000, intervalMs: 100))
+          rng.nextDouble() < 0.15
+              ? l.copyWith(
+                timestamp: l.timestamp.add(
+                  Duration(seconds: rng.nextInt(3600) - 1800),
+                ),
+              )
+              : l,
+      ];
+      final clock = PodClockEstimator.fit(logs)!;
+
+      expect(clock.msPerTick, closeTo(1.0, 1e-4));
+      expect(clock.toGpsMs(5000), closeTo(_base.millisecondsSinceEpoch, 10));
+    });
+
+    test('returns null without tick progress', () {
+      expect(PodClockEstimator.fit([]), isNull);
+      expect(PodClockEstimator.fit([_log(100, 0)]), isNull);
+      expect(PodClockEstimator.fit([_log(100, 0), _log(100, 100)]), isNull);
+    });
+  });
+
+  group('SquadAligner.align', () {
+    test('puts athletes on a shared grid', () {
+      final timeline = SquadAligner.align({
+        'a': _pod(count: 100, intervalMs: 100),
+        'b': _pod(
+          count: 50,
+          intervalMs: 200,
+          firstTick: 90000,
+          startOffsetMs: 1000,
+        ),
+      });
+
+      expect(timeline.athleteIds, ['a', 'b']);
+      expect(timeline.startMs, _base.millisecondsSinceEpoch);
+      expect(timeline.intervalMs, 100);
+      // a: 0 .. 9.9 s, b: 1.0 .. 10.8 s
+      expect(timeline.length, 109);
+      expect(timeline.latitude.length, 2 * 109);
+
+      expect(timeline.hasData(0, 0), isTrue);
+      expect(timeline.hasData(1, 9), isFalse);
+      expect(timeline.hasData(1, 10), isTrue);
+      expect(timeline.hasData(0, 100), isFalse);
+
+      // Same column, same GPS time, on both rows
+      final a = timeline.row(timeline.speed, 0);
+      final b = timeline.row(timeline.speed, 1);
+      for (int t = 10; t < 100; t++) {
+        expect(a[t], closeTo(t / 10, 1e-6), reason: 'a@$t');
+        expect(b[t], closeTo(t / 10, 1e-6), reason: 'b@$t');
+      }
+      expect(timeline.timeAt(10), _base.add(const Duration(seconds: 1)));
+    });
+
+    test('re-times logs from ticks, removing drift and jitter', () {
+      final logs = _pod(count: 3000, intervalMs: 100, driftPpm: 100);
+      final jittered = [
+        for (int i = 0; i < logs.length; i++)
+          logs[i].copyWith(
+            timestamp: logs[i].timestamp.add(
+              Duration(milliseconds: i.isEven ? 40 : -40),
+            ),
+          ),
+      ];
+      final timeline = SquadAligner.align({'a': jittered});
+
+      expect(timeline.clocks.single!.driftPpm, closeTo(-100, 10));
+      final speed = timeline.row(timeline.speed, 0);
+      for (int t = 0; t < timeline.length; t += 97) {
+        if (speed[t].isNaN) continue;
+        final gpsMs = timeline.timeAt(t).difference(_base).inMilliseconds;
+        expect(speed[t], closeTo(gpsMs / 1000, 0.02), reason: 'col $t');
+      }
+    });
+
+    test('handles empty sessions', () {
+      final timeline = SquadAligner.align({
+        'a': [],
+        'b': _pod(count: 10, intervalMs: 100),
+      });
+      expect(timeline.length, 10);
+      expect(timeline.clocks.first, isNull);
+      expect(timeline.row(timeline.speed, 0), everyElement(isNaN));
+    });
+  });
+}
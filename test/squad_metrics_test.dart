@@ -0,0 +1,132 @@
+import 'dart:math';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:metric_athlete_pod_ble/models/sensor_log_model.dart';
+import 'package:metric_athlete_pod_ble/utils/squad_alignment.dart';
+import 'package:metric_athlete_pod_ble/utils/squad_metrics.dart';
+
+final _base = DateTime.utc(2026, 3, 14, 10);
+const _lat0 = -25.7;
+const _lon0 = 28.2;
+
+/// Athlete standing [east]/[north] metres from the pitch centre, logged at
+/// 100 ms for steps [from] until [to], sprinting during [sprint].
+List<SensorLog> _athlete({
+  required double east,
+  required double north,
+  int from = 0,
+  int to = 50,
+  (int, int)? sprint,
+}) {
+  final dLat = north / SquadAnalytics.metresPerDegree;
+  final dLon =
+      east / (SquadAnalytics.metresPerDegree * cos(_lat0 * pi / 180.0));
+  return [
+    for (int t = from; t < to; t++)
+      SensorLog(
+        packetId: 10000 + t * 100,
+        timestamp: _base.add(Duration(milliseconds: t * 100)),
+        latitude: _lat0 + dLat,
+        longitude: _lon0 + dLon,
+        speed: sprint != null && t >= sprint.$1 && t < sprint.$2 ? 30 : 8,
+        accelX: 0.5,
+        accelY: 0.1,
+        accelZ: 9.8,
+        gyroX: 0.01,
+        gyroY: 0.02,
+        gyroZ: 0.03,
+        filteredAccelX: 0.5,
+        filteredAccelY: 0.1,
+        filteredAccelZ: 9.8,
+      ),
+  ];
+}
+
+/// Four athletes on the corners of a 20 m square; three sprint for 2 s.
+SquadTimeline _square() => SquadAligner.align({
+  'sw': _athlete(east: -10, north: -10, sprint: (10, 30)),
+  'se': _athlete(east: 10, north: -10, sprint: (10, 30)),
+  'ne': _athlete(east: 10, north: 10, sprint: (10, 30)),
+  'nw': _athlete(east: -10, north: 10),
+});
+
+void main() {
+  group('SquadAnalytics.compute', () {
+    test('centroid, stretch index and pair distances', () {
+      final metrics = SquadAnalytics.compute(_square());
+      final diagonal = 20 * sqrt2;
+
+      expect(metrics.length, 50);
+      expect(metrics.originLatitude, closeTo(_lat0, 1e-9));
+      for (int t = 0; t < metrics.length; t++) {
+        expect(metrics.present[t], 4);
+        expect(metrics.centroidX[t], closeTo(0, 1e-3));
+        expect(metrics.centroidY[t], closeTo(0, 1e-3));
+        expect(metrics.stretchIndex[t], closeTo(diagonal / 2, 1e-3));
+        expect(
+          metrics.meanPairDistance[t],
+          closeTo((4 * 20 + 2 * diagonal) / 6, 1e-3),
+        );
+        expect(metrics.maxPairDistance[t], closeTo(diagonal, 1e-3));
+      }
+      expect(metrics.centroidLatitude(0), closeTo(_lat0, 1e-9));
+      expect(metrics.centroidLongitude(0), closeTo(_lon0, 1e-9));
+    });
+
+    test('finds synchronised sprints', () {
+      final metrics = SquadAnalytics.compute(_square());
+      expect(metrics.sprinting[9], 0);
+      expect(metrics.sprinting[10], 3);
+
+      final sprint = metrics.synchronisedSprints.single;
+      expect(sprint.startIndex, 10);
+      expect(sprint.endIndex, 30);
+      expect(sprint.peakSprinters, 3);
+
+      final strict = SquadAnalytics.compute(
+        _square(),
+        config: const SquadMetricsConfig(minSyncSprinters: 4),
+      );
+      expect(strict.synchronisedSprints, isEmpty);
+    });
+
+    test('uses only athletes with a position', () {
+      final metrics = SquadAnalytics.compute(
+        SquadAligner.align({
+          'a': _athlete(east: 0, north: 0),
+          'b': _athlete(east: 30, north: 40, from: 20),
+        }),
+      );
+
+      expect(metrics.present[10], 1);
+      expect(metrics.stretchIndex[10], closeTo(0, 1e-3));
+      expect(metrics.meanPairDistance[10], isNaN);
+      expect(metrics.present[30], 2);
+      expect(metrics.meanPairDistance[30], closeTo(50, 1e-3));
+      expect(metrics.stretchIndex[30], closeTo(25, 1e-3));
+    });
+  });
+
+  test('computeParallel matches compute', () async {
+    final timeline = _square();
+    final serial = SquadAnalytics.compute(timeline);
+    final parallel = await SquadAnalytics.computeParallel(timeline, blocks: 3);
+
+    expect(parallel.length, serial.length);
+    expect(parallel.present, serial.present);
+    expect(parallel.centroidX, serial.centroidX);
+    expect(parallel.stretchIndex, serial.stretchIndex);
+    expect(parallel.meanPairDistance, serial.meanPairDistance);
+    expect(
+      parallel.synchronisedSprints.single.startIndex,
+      serial.synchronisedSprints.single.startIndex,
+    );
+  });
+
+  test('pairwiseDistances at one step', () {
+    final d = SquadAnalytics.pairwiseDistances(_square(), 0);
+    expect(d.length, 16);
+    expect(d[0 * 4 + 1], closeTo(20, 1e-3));
+    expect(d[0 * 4 + 2], closeTo(20 * sqrt2, 1e-3));
+    expect(d[3 * 4 + 3], 0);
+  });
+}
@@ -0,0 +1,98 @@
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:metric_athlete_pod_ble/transport/block_reassembler.dart';
+import 'package:metric_athlete_pod_ble/transport/simulated_pod.dart';
+
+Uint8List _data(int length) =>
+    Uint8List.fromList(List.generate(length, (i) => (i * 7 + 3) & 0xFF));
+
+ReassembledMessage? _deliver(BlockReassembler r, List<Uint8List> blocks) {
+  ReassembledMessage? message;
+  for (final block in blocks) {
+    message = r.add(block) ?? message;
+  }
+  return message ?? r.finish();
+}
+
+void main() {
+  group('SimulatedPod', () {
+    test('frames the first block with sequence and block count', () {
+      final pod = SimulatedPod(blockSize: 20, seed: 5);
+      final blocks = pod.transmit(_data(40));
+      // 11 bytes in the first block, 15 in each later one
+      expect(blocks.length, pod.blockCount(40));
+      expect(blocks.length, 3);
+      final header = ByteData.sublistView(blocks.first);
+      expect(blocks.first[0], 0x03);
+      expect(header.getUint32(5, Endian.little), 3);
+      final second = ByteData.sublistView(blocks[1]);
+      expect(
+        second.getUint32(1, Endian.little),
+        header.getUint32(1, Endian.little) + 1,
+      );
+      expect(blocks.last.length, 5 + 14);
+    });
+  });
+
+  group('BlockReassembler', () {
+    test('rebuilds a lossless transfer byte for byte', () {
+      final data = _data(5000);
+      final message = _deliver(
+        BlockReassembler(),
+        SimulatedPod().transmit(data),
+      );
+      expect(message, isNotNull);
+      expect(message!.messageType, 0x03);
+      expect(message.isComplete, isTrue);
+      expect(message.payload.sublist(1), data);
+    });
+
+    test('restores order and drops repeats', () {
+      final data = _data(20000);
+      final pod = SimulatedPod(
+        blockSize: 64,
+        duplicateRate: 0.2,
+        reorderRate: 0.2,
+        seed: 9,
+      );
+      final message = _deliver(BlockReassembler(), pod.transmit(data));
+      expect(message!.missingBlocks, 0);
+      expect(message.duplicateBlocks, greaterThan(0));
+      expect(message.payload.sublist(1), data);
+    });
+
+    test('counts lost blocks on a lossy link', () {
+      final data = _data(20000);
+      final pod = SimulatedPod(blockSize: 64, lossRate: 0.05, seed: 3);
+      final message = _deliver(BlockReassembler(), pod.transmit(data));
+      expect(message!.missingBlocks, greaterThan(0));
+      expect(message.blocks, pod.blockCount(data.length));
+    });
+
+    test('keeps block offsets across a lost block', () {
+      final data = _data(59 * 4 + 55);
+      final pod = SimulatedPod(blockSize: 64);
+      final blocks = pod.transmit(data)..removeAt(2);
+      final message = _deliver(BlockReassembler(), blocks);
+      expect(message!.missingBlocks, 1);
+      expect(message.payload.length, data.length + 1);
+      // Block 2 is zeros, blocks 3 and 4 are untouched
+      final lost = message.payload.sublist(1 + 55 + 59, 1 + 55 + 118);
+      expect(lost.every((b) => b == 0), isTrue);
+      expect(message.payload.sublist(1 + 55 + 118), data.sublist(55 + 118));
+    });
+
+    test('late repeat of a finished message does not start a new one', () {
+      final pod = SimulatedPod(blockSize: 32);
+      final r = BlockReassembler();
+      final first = pod.transmit(_data(200));
+      expect(_deliver(r, first), isNotNull);
+      expect(r.add(first.last), isNull);
+      expect(r.inProgress, isFalse);
+
+      final second = pod.transmit(_data(100));
+      final message = _deliver(r, second);
+      expect(message!.payload.sublist(1), _data(100));
+    });
+  });
+}
@@ -0,0 +1,69 @@
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:metric_athlete_pod_ble/transport/live_metrics.dart';
+import 'package:metric_athlete_pod_ble/transport/packet_reassembler.dart';
+
+/// Builds a 0xDC message body (without the type byte) as the native
+/// LiveMetricsSnapshot::Serialize writes it.
+Uint8List _buildSnapshot({int flags = LiveMetrics.flagGpsFix}) {
+  final data = ByteData(58);
+  data.setUint32(0, 1201, Endian.little);
+  data.setUint32(4, 125000, Endian.little);
+  data.setUint32(8, 120000, Endian.little);
+  data.setFloat32(12, 412.5, Endian.little);
+  data.setFloat32(16, 18.5, Endian.little);
+  data.setFloat32(20, 29.75, Endian.little);
+  data.setFloat32(24, 3.25, Endian.little);
+  data.setUint32(28, 2, Endian.little);
+  data.setFloat32(32, 3.5, Endian.little);
+  data.setUint8(36, flags);
+  data.setUint8(37, 11);
+  const zones = [40000, 30000, 25000, 15000, 10000];
+  for (int i = 0; i < zones.length; i++) {
+    data.setUint32(38 + i * 4, zones[i], Endian.little);
+  }
+  return data.buffer.asUint8List();
+}
+
+void main() {
+  group('LiveMetrics.fromBytes', () {
+    test('decodes every field', () {
+      final metrics = LiveMetrics.fromBytes(_buildSnapshot())!;
+
+      expect(metrics.packets, 1201);
+      expect(metrics.kernelTick, 125000);
+      expect(metrics.elapsedMs, 120000);
+      expect(metrics.distanceM, 412.5);
+      expect(metrics.speedKmh, 18.5);
+      expect(metrics.peakSpeedKmh, 29.75);
+      expect(metrics.playerLoad, 3.25);
+      expect(metrics.impacts, 2);
+      expect(metrics.batteryVoltage, 3.5);
+      expect(metrics.satellites, 11);
+      expect(metrics.hasGpsFix, isTrue);
+      expect(metrics.inImpact, isFalse);
+      expect(metrics.zoneMs, [40000, 30000, 25000, 15000, 10000]);
+      expect(metrics.sprintMs, 10000);
+    });
+
+    test('reads flags', () {
+      final metrics = LiveMetrics.fromBytes(
+        _buildSnapshot(flags: LiveMetrics.flagInImpact),
+      )!;
+      expect(metrics.hasGpsFix, isFalse);
+      expect(metrics.inImpact, isTrue);
+    });
+
+    test('rejects truncated payloads', () {
+      expect(LiveMetrics.fromBytes(Uint8List(57)), isNull);
+    });
+  });
+
+  test('PacketReassembler accepts the 0xDC message', () {
+    final message = Uint8List.fromList([
+      LiveMetrics.messageType,
+      ..._buildSnapshot(),
+    ]);
+    expect(PacketReassembler.validate(message).isValid, isTrue);
+  });
+}
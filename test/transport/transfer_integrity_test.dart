@@ -0,0 +1,142 @@
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:metric_athlete_pod_ble/transport/transfer_integrity.dart';
+import 'package:metric_athlete_pod_ble/utils/logs_binary_parser.dart';
+
+/// Builds a 0xDB message body (without the type byte).
+Uint8List _buildSummary({
+  int crc = 0xE3069283,
+  int flags = TransferIntegrity.flagSequenceVerified,
+  int recordSize = 61,
+  required int records,
+  required List<int> validity,
+  int missingBlocks = 0,
+}) {
+  final validCount = List.generate(
+    records,
+    (i) => validity[i >> 3] & (1 << (i & 7)) != 0 ? 1 : 0,
+  ).fold<int>(0, (a, b) => a + b);
+  final header = ByteData(26);
+  header.setUint32(0, crc, Endian.little);
+  header.setUint8(4, flags);
+  header.setUint8(5, recordSize);
+  header.setUint32(6, records, Endian.little);
+  header.setUint32(10, validCount, Endian.little);
+  header.setUint32(14, missingBlocks, Endian.little);
+  header.setUint32(18, 0, Endian.little);
+  header.setUint32(22, records * recordSize, Endian.little);
+  return Uint8List.fromList([...header.buffer.asUint8List(), ...validity]);
+}
+
+/// Builds [count] consecutive 61-byte records (Proewe layout).
+Uint8List _buildRecords(int count) {
+  final data = ByteData(61 * count);
+  for (int i = 0; i < count; i++) {
+    final o = i * 61;
+    data.setUint32(o, 1000 + i, Endian.little);
+    data.setUint16(o + 4, 2026, Endian.little);
+    data.setUint8(o + 6, 3);
+    data.setUint8(o + 7, 14);
+    data.setUint8(o + 8, 10);
+    data.setUint8(o + 9, 0);
+    data.setUint8(o + 10, i);
+    data.setFloat32(o + 13, -25.8, Endian.little);
+    data.setFloat32(o + 17, 28.2, Endian.little);
+    data.setFloat32(o + 21, 12.0, Endian.little);
+  }
+  return data.buffer.asUint8List();
+}
+
+void main() {
+  group('TransferIntegrity.fromBytes', () {
+    test('decodes header fields and validity bits', () {
+      final summary = _buildSummary(
+        records: 10,
+        validity: [0xFD, 0x03],
+        missingBlocks: 1,
+        flags:
+            TransferIntegrity.flagSequenceVerified |
+            TransferIntegrity.flagGapsPadded,
+      );
+      final integrity = TransferIntegrity.fromBytes(summary)!;
+      expect(integrity.crc32c, 0xE3069283);
+      expect(integrity.recordSize, 61);
+      expect(integrity.records, 10);
+      expect(integrity.validRecords, 9);
+      expect(integrity.missingBlocks, 1);
+      expect(integrity.sequenceVerified, true);
+      expect(integrity.gapsPadded, true);
+      expect(integrity.digestMismatch, false);
+      expect(integrity.isRecordValid(0), true);
+      expect(integrity.isRecordValid(1), false);
+      expect(integrity.isRecordValid(9), true);
+      expect(integrity.isRecordValid(10), false);
+    });
+
+    test('rejects truncated header or bitmap', () {
+      expect(TransferIntegrity.fromBytes(Uint8List(10)), isNull);
+      final summary = _buildSummary(records: 20, validity: [0xFF, 0xFF, 0x0F]);
+      expect(
+        TransferIntegrity.fromBytes(Uint8List.sublistView(summary, 0, 27)),
+        isNull,
+      );
+    });
+  });
+
+  group('BinaryParser with integrity bitmap', () {
+    test('skips records flagged invalid without resync', () {
+      final records = _buildRecords(4);
+      // Record 2 was zero-filled by the native side after a lost block
+      records.fillRange(2 * 61, 3 * 61, 0);
+      final integrity = TransferIntegrity.fromBytes(
+        _buildSummary(records: 4, validity: [0x0B]),
+      );
+
+      final logs = BinaryParser.parseBytes(records, integrity: integrity);
+      expect(logs.map((l) => l.packetId), [1000, 1001, 1003]);
+    });
+
+    test('falls back to scanning when the bitmap does not match', () {
+      final records = _buildRecords(3);
+      final integrity = TransferIntegrity.fromBytes(
+        _buildSummary(records: 5, validity: [0x1F]),
+      );
+
+      final logs = BinaryParser.parseBytes(records, integrity: integrity);
+      expect(logs.length, 3);
+    });
+
+    // The bitmap rejects every record after the first; only scanning finds them
+    void expectScanned(int flags, {int missingBlocks = 1}) {
+      final records = _buildRecords(3);
+      final integrity = TransferIntegrity.fromBytes(
+        _buildSummary(
+          records: 3,
+          validity: [0x01],
+          flags: flags,
+          missingBlocks: missingBlocks,
+        ),
+      )!;
+      expect(integrity.describes(records), false);
+      final logs = BinaryParser.parseBytes(records, integrity: integrity);
+      expect(logs.length, 3);
+    }
+
+    test('falls back to scanning when a gap was too long to pad', () {
+      expectScanned(
+        TransferIntegrity.flagSequenceVerified |
+            TransferIntegrity.flagGapsPadded |
+            TransferIntegrity.flagGapsUnpadded,
+        missingBlocks: 70,
+      );
+    });
+
+    test('falls back to scanning when a loss was not padded', () {
+      expectScanned(TransferIntegrity.flagSequenceVerified);
+    });
+
+    test('falls back to scanning when the sequence was not verified', () {
+      expectScanned(0, missingBlocks: 0);
+    });
+  });
+}
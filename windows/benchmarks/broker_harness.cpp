@@ -0,0 +1,382 @@
+// Multi-client harness for PodBroker, backed by the simulated pod.
+//
+// Runs a broker on a Unix domain socket (named pipe on Windows) in front of
+// SimulatedPodBackend and connects five clients concurrently, each on its
+// own thread as separate apps would be:
+//   * dashboard  - scans, connects and turns the live stream on
+//   * archiver   - joins the same connection and runs a windowed batch download
+//   * mirror     - subscribes to file payloads only, issues no commands
+//   * competitor - tries to take the pod and the download away, then drops
+//                  off without disconnecting (a crashed app)
+//   * slow       - wants live data but stops reading (a stalled app)
+// and checks that every file arrives intact over shared memory at both
+// readers, live packets stay in order, conflicting requests are refused,
+// the stalled client loses live packets without holding up the others, and
+// the pod sees exactly one scan, connect, live-on and disconnect. Exits
+// non-zero on any failure.
+//
+// Build with -DPOD_BLE_BUILD_BENCHMARKS=ON and run pod_ble_broker_harness.
+// On Linux, from windows/ (pulls in no WinRT):
+//   g++ -std=c++20 -O2 -pthread -o broker_harness benchmarks/broker_harness.cpp
+//       pod_broker.cpp pod_broker_client.cpp broker_protocol.cpp local_channel.cpp
+//       shared_payload_ring.cpp shared_memory_region.cpp simulated_pod_backend.cpp
+//       payload_integrity.cpp -lrt
+
+#include "../pod_broker.h"
+#include "../pod_broker_client.h"
+#include "../simulated_pod_backend.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace pod_connector;
+
+namespace {
+
+constexpr int kFiles = 8;
+constexpr size_t kFileSize = 256 * 1024;
+constexpr auto kTimeout = std::chrono::seconds(20);
+
+int failures = 0;
+std::mutex check_mtx;
+
+void Check(bool ok, const std::string& what) {
+    std::lock_guard<std::mutex> lock(check_mtx);
+    std::printf("  %-60s %s\n", what.c_str(), ok ? "ok" : "FAILED");
+    if (!ok) failures++;
+}
+
+/// A flag other threads can wait on.
+class Signal {
+public:
+    void Set() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            set_ = true;
+        }
+        cv_.notify_all();
+    }
+    bool Wait() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return cv_.wait_for(lock, kTimeout, [&] { return set_; });
+    }
+    bool IsSet() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return set_;
+    }
+
+private:
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool set_ = false;
+};
+
+/// Waits until [pred] holds, polling.
+bool WaitFor(const std::function<bool()>& pred) {
+    auto deadline = std::chrono::steady_clock::now() + kTimeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return true;
+}
+
+std::string FileName(int index) {
+    return "LOG_" + std::to_string(index) + ".BIN";
+}
+
+bool MatchesFile(const uint8_t* data, size_t length, int index) {
+    static const auto expected = [] {
+        std::vector<std::vector<uint8_t>> files;
+        for (int i = 1; i <= kFiles; i++) files.push_back(SimulatedPodBackend::FileData(FileName(i), kFileSize));
+        return files;
+    }();
+    return length == kFileSize + 1 && data[0] == 0x03 &&
+           std::memcmp(data + 1, expected[index - 1].data(), kFileSize) == 0;
+}
+
+/// Checks that live ticks only move forward.
+struct LiveOrder {
+    std::atomic<uint64_t> packets{0};
+    std::atomic<uint64_t> out_of_order{0};
+    uint32_t last = 0;
+
+    void Add(const uint8_t* data, size_t length) {
+        if (length != 73 || data[0] != 0x01) return;
+        uint32_t tick = data[1] | (data[2] << 8) | (data[3] << 16) | (static_cast<uint32_t>(data[4]) << 24);
+        if (packets > 0 && tick <= last) out_of_order++;
+        last = tick;
+        packets++;
+    }
+};
+
+std::string Endpoint() {
+#ifdef _WIN32
+    return "\\\\.\\pipe\\pod_ble_broker_harness_" + std::to_string(GetCurrentProcessId());
+#else
+    return "/tmp/pod_ble_broker_harness_" + std::to_string(getpid()) + ".sock";
+#endif
+}
+
+} // namespace
+
+int main() {
+    std::printf("Broker harness: %d files x %zu KB, 5 clients\n", kFiles, kFileSize / 1024);
+
+    SimulatedPodConfig pod;
+    pod.file_size = kFileSize;
+    pod.live_interval = std::chrono::milliseconds(1);
+    SimulatedPodBackend backend(pod);
+
+    BrokerConfig config;
+    config.endpoint = Endpoint();
+    config.shared_memory_size = 1024 * 1024;    // Four files per lap: the ring wraps
+    config.client_backlog = 16 * 1024;
+    PodBroker broker(backend, config);
+    std::string error;
+    if (!broker.Start(&error)) {
+        std::printf("Broker failed to start: %s\n", error.c_str());
+        return 1;
+    }
+
+    Signal dashboard_connected;
+    Signal mirror_ready;
+    Signal competitor_go;
+    Signal competitor_done;
+    Signal archiver_done;
+    Signal live_done;
+    Signal slow_stalled;
+    Signal slow_gate;
+
+    LiveOrder dashboard_live;
+    LiveOrder slow_live;
+    std::atomic<int> mirror_files{0};
+    std::atomic<int> mirror_bad{0};
+
+    // MARK: dashboard
+    std::thread dashboard([&] {
+        PodBrokerClient client;
+        std::mutex mtx;
+        std::set<std::string> seen;
+        std::atomic<bool> connected{false};
+        PodBrokerClient::Handlers handlers;
+        handlers.status = [&](const std::string& s) { if (s == "Connected") connected = true; };
+        handlers.scan = [&](const std::string&, const std::string& id, int) {
+            std::lock_guard<std::mutex> lock(mtx);
+            seen.insert(id);
+        };
+        handlers.payload = [&](const uint8_t* data, size_t length) { dashboard_live.Add(data, length); };
+        std::string err;
+        Check(client.Open(config.endpoint, "dashboard", kSubscribeStatus | kSubscribeScan | kSubscribeLive,
+                          handlers, &err), "dashboard: opens " + err);
+        Check(client.StartScan(&err), "dashboard: starts scan");
+        Check(WaitFor([&] { std::lock_guard<std::mutex> lock(mtx); return seen.size() == 3; }),
+              "dashboard: sees all three simulated pods");
+        Check(client.Connect("SIM:1", &err), "dashboard: connects SIM:1");
+        Check(WaitFor([&] { return connected.load(); }), "dashboard: gets \"Connected\"");
+        Check(client.WriteCommand({0x03, 0x01}, &err), "dashboard: turns live stream on");
+        dashboard_connected.Set();
+
+        live_done.Wait();
+        client.WriteCommand({0x03, 0x00});
+        client.StopScan();
+        Check(client.Disconnect(&err), "dashboard: disconnects");
+        client.Close();
+    });
+    Check(dashboard_connected.Wait(), "dashboard ready");
+
+    // MARK: mirror
+    std::thread mirror([&] {
+        PodBrokerClient client;
+        PodBrokerClient::Handlers handlers;
+        int next = 1;
+        handlers.payload = [&](const uint8_t* data, size_t length) {
+            if (length == 0 || data[0] != 0x03) return;
+            if (next <= kFiles && MatchesFile(data, length, next)) mirror_files++;
+            else mirror_bad++;
+            next++;
+        };
+        std::string err;
+        Check(client.Open(config.endpoint, "mirror", kSubscribeFiles, handlers, &err), "mirror: opens");
+        mirror_ready.Set();
+        archiver_done.Wait();
+        WaitFor([&] { return mirror_files + mirror_bad >= kFiles; });
+        auto stats = client.stats();
+        Check(stats.payloads_shared == kFiles && stats.checksum_errors == 0,
+              "mirror: every file read from shared memory, CRC ok");
+        client.Close();
+    });
+    mirror_ready.Wait();
+
+    // MARK: slow
+    std::thread slow([&] {
+        PodBrokerClient client;
+        PodBrokerClient::Handlers handlers;
+        std::atomic<bool> stalled{false};
+        handlers.payload = [&](const uint8_t* data, size_t length) {
+            if (stalled && !slow_gate.IsSet()) slow_gate.Wait();
+            slow_live.Add(data, length);
+        };
+        std::string err;
+        Check(client.Open(config.endpoint, "slow", kSubscribeLive, handlers, &err), "slow: opens");
+        Check(client.Connect("SIM:1", &err), "slow: joins SIM:1");
+        Check(client.WriteCommand({0x03, 0x01}, &err), "slow: asks for live stream (already on)");
+        stalled = true;
+        slow_stalled.Set();
+        slow_gate.Wait();
+        Check(WaitFor([&] { return client.stats().live_dropped > 0; }), "slow: told about dropped live packets");
+        Check(client.Disconnect(&err), "slow: disconnects");
+        client.Close();
+    });
+
+    // MARK: archiver
+    std::thread archiver([&] {
+        PodBrokerClient client;
+        PodBrokerClient::Handlers handlers;
+        std::mutex mtx;
+        std::condition_variable cv;
+        int received = 0;
+        int bad = 0;
+        bool complete = false;
+        handlers.status = [&](const std::string& s) {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (s == "Batch Complete") complete = true;
+            cv.notify_all();
+        };
+        handlers.payload = [&](const uint8_t* data, size_t length) {
+            if (length == 0 || data[0] != 0x03) return;
+            std::lock_guard<std::mutex> lock(mtx);
+            received++;
+            if (!MatchesFile(data, length, received)) bad++;
+            cv.notify_all();
+        };
+        std::string err;
+        Check(client.Open(config.endpoint, "archiver", kSubscribeStatus | kSubscribeFiles, handlers, &err),
+              "archiver: opens");
+        Check(client.Connect("SIM:1", &err), "archiver: shares SIM:1");
+        std::vector<std::string> files;
+        for (int i = 1; i <= kFiles; i++) files.push_back(FileName(i));
+        Check(client.DownloadFiles(files, 0, 0, 2, &err), "archiver: starts batch of 8 (window 2)");
+
+        for (int acked = 1; acked <= kFiles; acked++) {
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                if (!cv.wait_for(lock, kTimeout, [&] { return received >= acked; })) break;
+            }
+            if (acked == 2) {
+                // Window full and unacknowledged: the batch is mid-flight
+                competitor_go.Set();
+                competitor_done.Wait();
+            }
+            client.AcknowledgeBatchFile(acked);
+        }
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait_for(lock, kTimeout, [&] { return complete; });
+        Check(received == kFiles && bad == 0, "archiver: 8 files intact and in order");
+        Check(complete, "archiver: gets \"Batch Complete\"");
+        lock.unlock();
+        auto stats = client.stats();
+        Check(stats.payloads_shared == kFiles && stats.checksum_errors == 0,
+              "archiver: every file read from shared memory, CRC ok");
+        Check(client.Disconnect(&err), "archiver: disconnects");
+        client.Close();
+        archiver_done.Set();
+    });
+
+    // MARK: competitor
+    std::thread competitor([&] {
+        PodBrokerClient client;
+        std::string err;
+        Check(client.Open(config.endpoint, "competitor", kSubscribeStatus | kSubscribeScan, {}, &err),
+              "competitor: opens");
+        Check(client.StartScan(&err), "competitor: joins the scan");
+        Check(!client.Connect("SIM:2", &err) && err.rfind("Busy", 0) == 0,
+              "competitor: connect to another pod refused (busy)");
+        competitor_go.Wait();
+        Check(client.Connect("SIM:1", &err), "competitor: joins SIM:1");
+        Check(!client.DownloadFile("OTHER.BIN", 0, 0, &err) && err.rfind("Busy", 0) == 0,
+              "competitor: second download refused (busy)");
+        Check(!client.AcknowledgeBatchFile(1, &err), "competitor: cannot ack the archiver's batch");
+        Check(!client.CancelDownload(&err), "competitor: cannot cancel the archiver's batch");
+        competitor_done.Set();
+        // Drops off without StopScan / Disconnect
+        client.Close();
+    });
+
+    archiver.join();
+    competitor.join();
+    slow_stalled.Wait();
+    uint64_t pod_before = backend.counters().live_packets;
+    uint64_t dashboard_before = dashboard_live.packets;
+    uint64_t slow_before = slow_live.packets;
+    // The stalled client's socket and backlog fill up while the others carry on
+    Check(WaitFor([&] { return broker.Stats().live_dropped > 0; }),
+          "broker: drops live packets for the stalled client");
+    uint64_t pod_stalled = backend.counters().live_packets - pod_before;
+    uint64_t dashboard_stalled = dashboard_live.packets - dashboard_before;
+    uint64_t slow_stalled_packets = slow_live.packets - slow_before;
+    live_done.Set();
+    slow_gate.Set();
+    dashboard.join();
+    slow.join();
+    mirror.join();
+
+    Check(WaitFor([&] { return broker.Stats().clients == 0; }), "broker: all clients gone");
+    Check(WaitFor([&] { return backend.counters().disconnect == 1; }), "pod: disconnected once, by the last client");
+    auto stats = broker.Stats();
+    auto pod_stats = backend.counters();
+
+    std::printf("\n  broker: accepted=%llu requests=%llu refused=%llu events=%llu shared=%llu inline=%llu live_dropped=%llu\n",
+                static_cast<unsigned long long>(stats.clients_accepted), static_cast<unsigned long long>(stats.requests),
+                static_cast<unsigned long long>(stats.requests_refused), static_cast<unsigned long long>(stats.events),
+                static_cast<unsigned long long>(stats.payloads_shared), static_cast<unsigned long long>(stats.payloads_inline),
+                static_cast<unsigned long long>(stats.live_dropped));
+    std::printf("  ring: capacity=%zu high_water=%zu published=%llu rejected=%llu outstanding=%zu\n",
+                stats.ring.capacity, stats.ring.high_water, static_cast<unsigned long long>(stats.ring.published),
+                static_cast<unsigned long long>(stats.ring.rejected), stats.ring.outstanding);
+    std::printf("  pod: live_on=%llu live_off=%llu\n", static_cast<unsigned long long>(pod_stats.live_on),
+                static_cast<unsigned long long>(pod_stats.live_off));
+    std::printf("  live: pod=%llu dashboard=%llu slow=%llu\n\n",
+                static_cast<unsigned long long>(pod_stats.live_packets),
+                static_cast<unsigned long long>(dashboard_live.packets.load()),
+                static_cast<unsigned long long>(slow_live.packets.load()));
+
+    Check(pod_stats.start_scan == 1 && pod_stats.stop_scan == 1, "pod: one scan for two scanning clients");
+    Check(pod_stats.connect == 1, "pod: one connect for four clients");
+    Check(pod_stats.live_on == 1 && pod_stats.live_off == 1, "pod: live stream switched on and off once");
+    Check(pod_stats.downloads == kFiles && pod_stats.cancels == 0, "pod: only the archiver's batch ran");
+    Check(stats.requests_refused == 4, "broker: refused exactly the four conflicting requests");
+    Check(mirror_files == kFiles && mirror_bad == 0, "mirror: 8 files intact and in order");
+    Check(stats.payloads_shared == kFiles, "broker: files went through shared memory");
+    Check(stats.ring.outstanding == 0, "broker: every shared slot released");
+    Check(dashboard_live.packets > 0 && dashboard_live.out_of_order == 0, "dashboard: live packets in tick order");
+    Check(slow_live.out_of_order == 0, "slow: live packets it did get are in order");
+    Check(slow_stalled_packets <= 1 && dashboard_stalled * 10 >= pod_stalled * 9,
+          "dashboard: kept up while the stalled client was blocked");
+
+    broker.Stop();
+    if (failures != 0) {
+        std::printf("\n%d check(s) FAILED\n", failures);
+        return 1;
+    }
+    std::printf("\nAll checks passed\n");
+    return 0;
+}
@@ -0,0 +1,279 @@
+// Stress harness for ChannelQueues with a stalled UI thread.
+//
+// The consumer (a ThreadDispatcher standing in for the platform thread) is
+// blocked while three synthetic BLE threads flood it: the live stream and a
+// scan storm (drop-oldest), and a file transfer that interleaves keyed
+// progress statuses (coalesced) with large payloads (spilled to disk past a
+// small memory budget), plus a burst of method replies (kept). Once the producers finish, the consumer resumes and
+// the harness checks that memory stayed bounded, no producer blocked, every
+// payload arrived intact and in order, and the drop/coalesce/spill counters
+// add up. Exits non-zero on any failure.
+//
+// Build with -DPOD_BLE_BUILD_BENCHMARKS=ON and run pod_ble_channel_harness.
+
+#include "../callback_dispatcher.h"
+#include "../channel_queues.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using pod_connector::ChannelQueues;
+using pod_connector::ChannelStats;
+using pod_connector::OverflowPolicy;
+using pod_connector::OverflowPolicyName;
+using pod_connector::ThreadDispatcher;
+
+namespace {
+
+constexpr int kLivePackets = 100000;
+constexpr int kScanResults = 20000;
+constexpr int kFiles = 48;
+constexpr int kReplies = 5000;
+constexpr size_t kFileSize = 512 * 1024;
+constexpr size_t kLiveCapacity = 512;
+constexpr size_t kScanCapacity = 256;
+constexpr size_t kStatusCapacity = 64;
+constexpr size_t kMemoryBudget = 4 * 1024 * 1024;
+constexpr double kMaxPushMs = 100;
+
+int failures = 0;
+
+void Check(bool ok, const char* what) {
+    std::printf("  %-52s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) failures++;
+}
+
+void PrintStats(const ChannelStats& s) {
+    std::printf("  %-8s %-12s accepted=%llu delivered=%llu dropped=%llu coalesced=%llu spilled=%llu high_water=%zu\n",
+                s.name.c_str(), OverflowPolicyName(s.policy),
+                static_cast<unsigned long long>(s.accepted), static_cast<unsigned long long>(s.delivered),
+                static_cast<unsigned long long>(s.dropped), static_cast<unsigned long long>(s.coalesced),
+                static_cast<unsigned long long>(s.spilled), s.high_water);
+}
+
+std::vector<uint8_t> FilePayload(int index) {
+    std::vector<uint8_t> data(kFileSize);
+    uint32_t x = 0x9E3779B9u * static_cast<uint32_t>(index + 1);
+    for (auto& b : data) {
+        x = x * 1664525u + 1013904223u;
+        b = static_cast<uint8_t>(x >> 24);
+    }
+    return data;
+}
+
+double MsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Consumer-side bookkeeping. Only touched from the dispatcher thread.
+struct Received {
+    std::vector<int> live;
+    std::vector<int> scan;
+    std::vector<std::string> transfer;     // Statuses and "payload N" in delivery order
+    int corrupt_payloads = 0;
+    int replies = 0;
+};
+
+void StalledUiThread() {
+    std::printf("Stalled consumer: %d live, %d scan, %d x %zu KB payloads, %zu KB memory budget\n",
+                kLivePackets, kScanResults, kFiles, kFileSize / 1024, kMemoryBudget / 1024);
+    auto spill_path = std::filesystem::temp_directory_path() / "pod_ble_channel_harness.spill";
+    Received received;
+    std::atomic<bool> release{false};
+    std::atomic<size_t> peak_memory{0};
+    std::vector<double> worst_push_ms(3, 0);
+    std::vector<ChannelStats> stats;
+    bool spill_file_emptied = false;
+
+    std::unique_ptr<ThreadDispatcher> consumer = std::make_unique<ThreadDispatcher>(16);
+    {
+        ChannelQueues queues([&consumer, &queues]() {
+            return consumer->Post([&queues]() { queues.Drain(); });
+        });
+        size_t live = queues.AddChannel("live", OverflowPolicy::kDropOldest, kLiveCapacity);
+        size_t scan = queues.AddChannel("scan", OverflowPolicy::kDropOldest, kScanCapacity);
+        size_t status = queues.AddChannel("status", OverflowPolicy::kCoalesce, kStatusCapacity);
+        size_t payload = queues.AddSpillChannel("payload", kMemoryBudget, spill_path,
+            [&received](std::vector<uint8_t> data) {
+                int index = data.empty() ? -1 : data[0];
+                // First byte is overwritten with the index; the rest must match
+                auto expected = FilePayload(index);
+                expected[0] = data[0];
+                if (data != expected) received.corrupt_payloads++;
+                received.transfer.push_back("payload " + std::to_string(index));
+            });
+        size_t reply = queues.AddChannel("reply", OverflowPolicy::kKeepAll, 0);
+
+        // The "UI thread" stops draining until every producer is done
+        consumer->Post([&release]() {
+            while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
+
+        auto timed = [](double& worst, auto&& push) {
+            auto start = std::chrono::steady_clock::now();
+            push();
+            worst = std::max(worst, MsSince(start));
+        };
+
+        std::vector<std::thread> producers;
+        producers.emplace_back([&]() {
+            for (int i = 0; i < kLivePackets; i++) {
+                timed(worst_push_ms[0], [&]() {
+                    queues.Push(live, [&received, i]() { received.live.push_back(i); });
+                });
+            }
+        });
+        producers.emplace_back([&]() {
+            for (int i = 0; i < kScanResults; i++) {
+                timed(worst_push_ms[1], [&]() {
+                    queues.Push(scan, [&received, i]() { received.scan.push_back(i); });
+                });
+            }
+        });
+        producers.emplace_back([&]() {
+            auto push_status = [&](const std::string& text, const std::string& key) {
+                queues.Push(status, [&received, text]() { received.transfer.push_back(text); }, key);
+            };
+            push_status("Pod Ready", "");
+            for (int i = 1; i <= kFiles; i++) {
+                auto data = FilePayload(i);
+                data[0] = static_cast<uint8_t>(i);
+                timed(worst_push_ms[2], [&]() {
+                    push_status("Downloading File " + std::to_string(i) + "/" + std::to_string(kFiles), "progress");
+                    queues.PushPayload(payload, std::move(data));
+                });
+                size_t memory = queues.Stats()[payload].memory_bytes;
+                if (memory > peak_memory.load()) peak_memory = memory;
+            }
+            push_status("Batch Complete", "");
+        });
+        producers.emplace_back([&]() {
+            for (int i = 0; i < kReplies; i++) {
+                queues.Push(reply, [&received]() { received.replies++; });
+            }
+        });
+        for (auto& t : producers) t.join();
+
+        auto during = queues.Stats();
+        release = true;
+
+        // Wait for the consumer to catch up
+        auto start = std::chrono::steady_clock::now();
+        while (MsSince(start) < 10000) {
+            stats = queues.Stats();
+            size_t pending = 0;
+            for (const auto& s : stats) pending += s.pending;
+            if (pending == 0) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        consumer.reset();   // Runs any drain still queued, while the queues exist
+        stats = queues.Stats();
+        spill_file_emptied = std::filesystem::exists(spill_path) && std::filesystem::file_size(spill_path) == 0;
+
+        std::printf("  while stalled: live pending=%zu scan pending=%zu status pending=%zu payload spill=%zu KB\n",
+                    during[live].pending, during[scan].pending, during[status].pending,
+                    during[payload].spill_bytes / 1024);
+    }
+    for (const auto& s : stats) PrintStats(s);
+    std::printf("  worst push: live %.2f ms, scan %.2f ms, transfer %.2f ms\n",
+                worst_push_ms[0], worst_push_ms[1], worst_push_ms[2]);
+
+    const auto& live = stats[0];
+    const auto& scan = stats[1];
+    const auto& status = stats[2];
+    const auto& payload = stats[3];
+    const auto& reply = stats[4];
+
+    Check(live.high_water <= kLiveCapacity && scan.high_water <= kScanCapacity, "drop-oldest queues stayed within capacity");
+    Check(live.delivered + live.dropped == kLivePackets, "live: delivered + dropped == pushed");
+    Check(scan.delivered + scan.dropped == kScanResults, "scan: delivered + dropped == pushed");
+    bool live_tail = !received.live.empty() && received.live.back() == kLivePackets - 1 &&
+                     std::is_sorted(received.live.begin(), received.live.end());
+    Check(live_tail, "live: newest kept, order preserved");
+    Check(!received.scan.empty() && received.scan.back() == kScanResults - 1, "scan: newest kept");
+
+    Check(status.coalesced == kFiles - 1, "progress coalesced to the latest");
+    Check(status.dropped == 0, "no status dropped");
+
+    Check(payload.delivered == kFiles && payload.dropped == 0, "every payload delivered");
+    Check(received.corrupt_payloads == 0, "payload bytes intact");
+    Check(payload.spilled > 0 && payload.spill_errors == 0, "overflow spilled to disk");
+    Check(peak_memory.load() <= kMemoryBudget, "payload memory stayed within budget");
+    Check(spill_file_emptied, "spill file truncated once drained");
+    Check(!std::filesystem::exists(spill_path), "spill file removed on destruction");
+
+    Check(reply.capacity == 0 && reply.high_water > kStatusCapacity, "replies queued past every bounded capacity");
+    Check(reply.dropped == 0 && received.replies == kReplies, "every reply delivered");
+
+    std::vector<std::string> expected{"Pod Ready"};
+    for (int i = 1; i < kFiles; i++) expected.push_back("payload " + std::to_string(i));
+    expected.push_back("Downloading File " + std::to_string(kFiles) + "/" + std::to_string(kFiles));
+    expected.push_back("payload " + std::to_string(kFiles));
+    expected.push_back("Batch Complete");
+    Check(received.transfer == expected, "statuses and payloads in push order");
+
+    double worst = std::max({worst_push_ms[0], worst_push_ms[1], worst_push_ms[2]});
+    Check(worst < kMaxPushMs, "no producer blocked");
+}
+
+void Recovery() {
+    std::printf("Live stream after the consumer recovers\n");
+    std::vector<int> received;
+    std::vector<ChannelStats> stats;
+    std::unique_ptr<ThreadDispatcher> consumer = std::make_unique<ThreadDispatcher>(16);
+    {
+        ChannelQueues queues([&consumer, &queues]() {
+            return consumer->Post([&queues]() { queues.Drain(); });
+        });
+        size_t live = queues.AddChannel("live", OverflowPolicy::kDropOldest, kLiveCapacity);
+        // Paced well below what the consumer can take: nothing should drop
+        for (int i = 0; i < 2000; i++) {
+            queues.Push(live, [&received, i]() { received.push_back(i); });
+            if (i % 100 == 99) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        consumer.reset();
+        stats = queues.Stats();
+    }
+    PrintStats(stats[0]);
+    Check(stats[0].dropped == 0 && received.size() == 2000, "no drops at a sustainable rate");
+}
+
+void StatusBacklog() {
+    std::printf("Status backlog past capacity\n");
+    std::vector<std::string> received;
+    std::vector<ChannelStats> stats;
+    {
+        // Never woken: the consumer drains once, after everything is pushed
+        ChannelQueues queues([]() { return false; });
+        size_t status = queues.AddChannel("status", OverflowPolicy::kCoalesce, kStatusCapacity);
+        for (int i = 0; i < 4 * static_cast<int>(kStatusCapacity); i++) {
+            std::string text = "Saved " + std::to_string(i);
+            queues.Push(status, [&received, text]() { received.push_back(text); });
+            if (i == 0) queues.Push(status, [&received]() { received.push_back("stale"); }, "progress");
+        }
+        queues.Drain();
+        stats = queues.Stats();
+    }
+    PrintStats(stats[0]);
+    bool all_unkeyed = received.size() == 4 * kStatusCapacity && received.front() == "Saved 0" &&
+                       received.back() == "Saved " + std::to_string(4 * kStatusCapacity - 1);
+    Check(all_unkeyed, "every unkeyed status delivered in order");
+    Check(stats[0].dropped == 1, "only the keyed status evicted");
+}
+
+}  // namespace
+
+int main() {
+    StalledUiThread();
+    Recovery();
+    StatusBacklog();
+    std::printf(failures == 0 ? "PASS\n" : "FAIL (%d)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+// Stress harness for CallbackDispatcher.
+//
+// Synthetic "BLE callback" threads post sequenced tasks to a ThreadDispatcher
+// (the headless path) and the consumer checks that every producer's tasks
+// arrive complete and in order. Covers blocking backpressure (PostWait into a
+// small queue behind a slow consumer), non-blocking rejection (Post) and
+// Shutdown releasing blocked producers. Exits non-zero on any failure.
+//
+// Build with -DPOD_BLE_BUILD_BENCHMARKS=ON and run pod_ble_dispatcher_harness.
+
+#include "../callback_dispatcher.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using pod_connector::DispatcherStats;
+using pod_connector::ThreadDispatcher;
+
+namespace {
+
+constexpr int kProducers = 8;
+constexpr int kTasksPerProducer = 50000;
+constexpr size_t kSmallCapacity = 256;
+
+int failures = 0;
+
+void Check(bool ok, const char* what) {
+    std::printf("  %-52s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) failures++;
+}
+
+void PrintStats(const DispatcherStats& s) {
+    std::printf("  dispatched=%llu waited=%llu rejected=%llu high_water=%zu\n",
+                static_cast<unsigned long long>(s.dispatched), static_cast<unsigned long long>(s.waited),
+                static_cast<unsigned long long>(s.rejected), s.high_water);
+}
+
+// Consumer-side bookkeeping. Only touched from the dispatcher thread.
+struct OrderCheck {
+    std::vector<int> next = std::vector<int>(kProducers, 0);
+    int out_of_order = 0;
+    int received = 0;
+
+    void Record(int producer, int seq, bool allowGaps) {
+        if (allowGaps ? seq < next[producer] : seq != next[producer]) out_of_order++;
+        next[producer] = seq + 1;
+        received++;
+    }
+};
+
+void BlockingBackpressure() {
+    std::printf("PostWait, %d producers x %d tasks, capacity %zu, slow consumer\n",
+                kProducers, kTasksPerProducer, kSmallCapacity);
+    OrderCheck check;
+    std::atomic<int> refused{0};
+    auto start = std::chrono::steady_clock::now();
+    DispatcherStats stats;
+    {
+        ThreadDispatcher dispatcher(kSmallCapacity);
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; p++) {
+            producers.emplace_back([&, p]() {
+                for (int seq = 0; seq < kTasksPerProducer; seq++) {
+                    bool ok = dispatcher.PostWait([&check, p, seq]() {
+                        check.Record(p, seq, false);
+                        if (seq % 5000 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                    }, std::chrono::seconds(5));
+                    if (!ok) refused++;
+                }
+            });
+        }
+        for (auto& t : producers) t.join();
+        stats = dispatcher.Stats();
+    }  // Destructor drains the remainder
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    PrintStats(stats);
+    std::printf("  %.1f ms, %.0f tasks/s\n", ms, kProducers * kTasksPerProducer / (ms / 1000.0));
+    Check(refused.load() == 0, "no task refused");
+    Check(check.received == kProducers * kTasksPerProducer, "every task delivered");
+    Check(check.out_of_order == 0, "per-producer order preserved");
+    Check(stats.high_water <= kSmallCapacity, "queue stayed within capacity");
+}
+
+void NonBlockingRejection() {
+    std::printf("Post into a full queue\n");
+    OrderCheck check;
+    int accepted = 0;
+    DispatcherStats stats;
+    {
+        ThreadDispatcher dispatcher(16);
+        // Stall the consumer so the queue fills
+        std::atomic<bool> release{false};
+        dispatcher.Post([&release]() {
+            while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        for (int seq = 0; seq < 100; seq++) {
+            if (dispatcher.Post([&check, seq]() { check.Record(0, seq, true); })) accepted++;
+        }
+        release = true;
+        stats = dispatcher.Stats();
+    }
+
+    PrintStats(stats);
+    Check(accepted == 16, "exactly capacity tasks accepted");
+    Check(stats.rejected == 84, "the rest reported as rejected");
+    Check(check.received == accepted && check.out_of_order == 0, "accepted tasks delivered in order");
+}
+
+void ShutdownReleasesProducers() {
+    std::printf("Shutdown while a producer is blocked\n");
+    ThreadDispatcher dispatcher(1);
+    std::atomic<bool> release{false};
+    dispatcher.Post([&release]() {
+        while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    dispatcher.Post([]() {});  // Fills the single slot
+
+    std::atomic<int> result{-1};
+    std::thread producer([&]() {
+        result = dispatcher.PostWait([]() {}, std::chrono::seconds(10)) ? 1 : 0;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto start = std::chrono::steady_clock::now();
+    dispatcher.Shutdown();
+    producer.join();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    release = true;
+
+    Check(result.load() == 0, "blocked PostWait returned false");
+    Check(ms < 1000, "producer released promptly");
+    Check(!dispatcher.Post([]() {}), "Post refused after Shutdown");
+}
+
+}  // namespace
+
+int main() {
+    BlockingBackpressure();
+    NonBlockingRejection();
+    ShutdownReleasesProducers();
+    std::printf(failures == 0 ? "PASS\n" : "FAIL (%d)\n", failures);
+    return failures == 0 ? 0 : 1;
+}
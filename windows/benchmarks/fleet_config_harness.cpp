@@ -0,0 +1,635 @@
+// Harness for bulk fleet configuration.
+//
+//   * Squad         - twelve ScriptedPods configured through FleetConfigJob on
+//                     a virtual clock: every pod verified, never more than
+//                     max_connections linked at once, results in target order;
+//                     total time against one pod at a time and against the
+//                     UI flow it replaces (connect, then write + 500 ms sleep
+//                     + Get Settings per setting)
+//   * Failures      - a pod that refuses its first connect (retried), one
+//                     that never answers (connect timeout), one that keeps
+//                     refusing, one that ignores set commands (not
+//                     confirmed) and an out-of-range request (never
+//                     connected); the rest of the squad is unaffected
+//   * Cancel        - Cancel mid-job and destroying a running job disconnect
+//                     every pod; a second Start while running is refused
+//   * Delete        - one pod, a batch of file list entries through
+//                     FileDeleter: every 0x07 written back to back, one
+//                     catalog read settles them; latency against the UI
+//                     flow (per file: 0x07, 2 s sleep, refetch the list); a
+//                     pod that ignores deletes times out with the files
+//                     still listed, an offline link writes nothing
+//   * Cleanup       - twelve pods cleared through FleetConfigJob (deletes
+//                     only, settings skipped): every pod empty; total time
+//                     against one pod at a time and against the UI flow
+//   * Threaded      - the job on its own strand, the pods on a "radio"
+//                     thread, as on Windows; run it under -fsanitize=thread
+// Prints fleet timings; exits non-zero on any failure. The Windows link is
+// a PodBLECore per pod; it needs WinRT and uses the same SettingsVerifier
+// and FileDeleter.
+//
+// Build with -DPOD_BLE_BUILD_BENCHMARKS=ON and run pod_ble_fleet_harness.
+// On Linux, from windows/:
+//   g++ -std=c++20 -O2 -pthread -o fleet_harness benchmarks/fleet_config_harness.cpp
+//       fleet_config.cpp file_deleter.cpp settings_verifier.cpp pod_commands.cpp
+//       core_scheduler.cpp scripted_pod.cpp session_script.cpp payload_integrity.cpp
+// and again with -fsanitize=thread.
+
+#include "../core_scheduler.h"
+#include "../file_deleter.h"
+#include "../fleet_config.h"
+#include "../scripted_pod.h"
+#include "../settings_verifier.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace pod_connector;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+int failures = 0;
+
+void Check(bool ok, const std::string& what) {
+    std::printf("  [%s] %s\n", ok ? "ok" : "FAIL", what.c_str());
+    if (!ok) failures++;
+}
+
+// MARK: - Simulated pods
+
+struct PodPlan {
+    std::chrono::milliseconds connect_latency{300};
+    int refused_connects = 0;       // Attempts that fail before one succeeds
+    bool unreachable = false;       // Connect never completes
+    bool ignores_settings = false;  // Set commands are dropped
+    bool ignores_deletes = false;   // Delete File commands are dropped
+};
+
+// The pods in range, all on one radio strand. Pods outlive the connections
+// made to them (their settings and files persist across links); a link is
+// one connection with its own reply matcher, SettingsVerifier and
+// FileDeleter, the way each fleet PodBLECore has its own.
+class SimulatedAir {
+public:
+    SimulatedAir(std::shared_ptr<CoreScheduler> radio, ScriptedPodConfig config)
+        : config_(config), radio_(std::move(radio)) {}
+
+    // Stop the radio before the pods its timers point at
+    ~SimulatedAir() { radio_.reset(); }
+
+    void AddPod(const std::string& address, PodPlan plan = {}) {
+        auto pod = std::make_unique<Pod>();
+        pod->plan = plan;
+        // Non-owning: the radio must stop while the pods still exist
+        std::shared_ptr<CoreScheduler> radio(std::shared_ptr<CoreScheduler>{}, radio_.get());
+        pod->firmware = std::make_unique<ScriptedPod>(radio, config_, [this, raw = pod.get()](const Bytes& packet) {
+            OnNotify(*raw, packet);
+        });
+        pods_[address] = std::move(pod);
+    }
+
+    std::unique_ptr<FleetPodLink> Link(const std::string& address) {
+        auto it = pods_.find(address);
+        if (it == pods_.end()) return nullptr;
+        return std::make_unique<SimulatedLink>(this, it->second.get());
+    }
+
+    PodSettings Settings(const std::string& address) {
+        return RunOnStrand(*radio_, [&] { return pods_.at(address)->firmware->settings(); });
+    }
+
+    std::vector<std::string> Files(const std::string& address) {
+        return RunOnStrand(*radio_, [&] { return pods_.at(address)->firmware->files(); });
+    }
+
+    int Connected() { return RunOnStrand(*radio_, [this] { return connected_; }); }
+    int PeakConnected() { return RunOnStrand(*radio_, [this] { return peak_; }); }
+    int ConnectAttempts(const std::string& address) {
+        return RunOnStrand(*radio_, [&] { return pods_.at(address)->attempts; });
+    }
+
+private:
+    struct Session {
+        std::shared_ptr<std::atomic<bool>> alive = std::make_shared<std::atomic<bool>>(true);
+        bool connected = false;
+        ReplyMatcher matcher;
+        std::unique_ptr<SettingsVerifier> verifier;
+        std::unique_ptr<FileDeleter> deleter;
+        Bytes catalog;                  // 0x02 message being reassembled
+        uint32_t catalog_blocks = 0;
+        uint32_t catalog_received = 0;
+    };
+
+    struct Pod {
+        PodPlan plan;
+        std::unique_ptr<ScriptedPod> firmware;
+        std::shared_ptr<Session> session;   // The connected link, if any
+        int attempts = 0;
+    };
+
+    class SimulatedLink : public FleetPodLink {
+    public:
+        SimulatedLink(SimulatedAir* air, Pod* pod)
+            : air_(air), pod_(pod), session_(std::make_shared<Session>()) {
+            auto send = [air, pod, session = session_.get()](const Bytes& command) {
+                session->matcher.Sent(static_cast<PodOpcode>(command[0]), air->radio_->Now());
+                bool isSet = command[0] == static_cast<uint8_t>(PodOpcode::kSetPlayerNumber) ||
+                             command[0] == static_cast<uint8_t>(PodOpcode::kSetLogInterval);
+                if (isSet && pod->plan.ignores_settings) return;
+                if (command[0] == static_cast<uint8_t>(PodOpcode::kDeleteFile) && pod->plan.ignores_deletes) return;
+                Bytes framed;
+                framed.reserve(command.size() + 1);
+                framed.push_back(0xAE);
+                framed.insert(framed.end(), command.begin(), command.end());
+                pod->firmware->OnWrite(framed);
+            };
+            auto gate = [session = session_.get()] {
+                return session->connected ? SettingsVerifier::Gate::kReady : SettingsVerifier::Gate::kOffline;
+            };
+            session_->verifier = std::make_unique<SettingsVerifier>(*air_->radio_, session_->matcher,
+                                                                    session_->alive, send, gate);
+            session_->deleter = std::make_unique<FileDeleter>(*air_->radio_, session_->matcher, session_->alive,
+                                                              send, gate);
+        }
+
+        ~SimulatedLink() override { Disconnect(); }
+
+        void Connect(ConnectCallback done) override {
+            air_->radio_->Post([air = air_, pod = pod_, session = session_, done = std::move(done)]() {
+                if (!session->alive->load()) return;
+                int attempt = ++pod->attempts;
+                if (pod->plan.unreachable) return;
+                air->radio_->After(pod->plan.connect_latency, [air, pod, session, attempt, done]() {
+                    if (!session->alive->load()) return;
+                    if (attempt <= pod->plan.refused_connects) {
+                        done(false);
+                        return;
+                    }
+                    session->connected = true;
+                    pod->session = session;
+                    air->peak_ = std::max(air->peak_, ++air->connected_);
+                    done(true);
+                });
+            });
+        }
+
+        void ApplySettings(const SettingsRequest& request, std::chrono::milliseconds timeout,
+                           SettingsCallback done) override {
+            air_->radio_->Post([session = session_, request, timeout, done = std::move(done)]() {
+                session->verifier->Apply(request, timeout, done);
+            });
+        }
+
+        void DeleteFiles(const std::vector<std::string>& files, std::chrono::milliseconds timeout,
+                         DeleteCallback done) override {
+            air_->radio_->Post([session = session_, files, timeout, done = std::move(done)]() {
+                session->deleter->Delete(files, timeout, done);
+            });
+        }
+
+        void Disconnect() override {
+            air_->radio_->Post([air = air_, pod = pod_, session = session_]() {
+                if (!session->alive->load()) return;
+                if (session->connected) {
+                    session->connected = false;
+                    air->connected_--;
+                }
+                if (pod->session == session) pod->session = nullptr;
+                session->verifier->Abandon();
+                session->deleter->Abandon();
+                session->alive->store(false);
+            });
+        }
+
+    private:
+        SimulatedAir* air_;
+        Pod* pod_;
+        std::shared_ptr<Session> session_;
+    };
+
+    void OnNotify(Pod& pod, const Bytes& packet) {
+        auto session = pod.session;
+        if (!session || !session->alive->load()) return;
+        if (auto match = session->matcher.OnReply(packet, radio_->Now())) {
+            session->verifier->OnReply(*match, packet);
+        }
+        if (packet.empty() || packet[0] != static_cast<uint8_t>(PodReplyType::kFileList)) return;
+
+        // Sequenced blocks, as PodBLECore reassembles them: [type][seq][total] then [type][seq]
+        auto u32 = [&](size_t at) {
+            return packet[at] | (packet[at + 1] << 8) | (packet[at + 2] << 16) |
+                   (static_cast<uint32_t>(packet[at + 3]) << 24);
+        };
+        if (packet.size() >= 9 && u32(1) == 0) {
+            session->catalog_blocks = u32(5);
+            session->catalog_received = 0;
+            session->catalog.assign(1, packet[0]);
+            session->catalog.insert(session->catalog.end(), packet.begin() + 9, packet.end());
+        } else if (packet.size() >= 5 && session->catalog_received > 0) {
+            session->catalog.insert(session->catalog.end(), packet.begin() + 5, packet.end());
+        } else {
+            return;
+        }
+        if (++session->catalog_received == session->catalog_blocks) {
+            session->catalog_received = 0;
+            session->deleter->OnCatalog(session->catalog);
+        }
+    }
+
+    ScriptedPodConfig config_;
+    std::map<std::string, std::unique_ptr<Pod>> pods_;
+    int connected_ = 0;
+    int peak_ = 0;
+    std::shared_ptr<CoreScheduler> radio_;  // Last: destroyed first
+};
+
+std::string Address(int i) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "C0:FF:EE:00:00:%02X", i);
+    return buf;
+}
+
+ScriptedPodConfig SquadPod() {
+    ScriptedPodConfig config;
+    config.reply_latency = 20ms;
+    config.apply_latency = 60ms;
+    return config;
+}
+
+// A pod with [count] logs on its SD card
+ScriptedPodConfig CardPod(int count) {
+    auto config = SquadPod();
+    config.records_per_file = 60;
+    config.records_spread = 40;
+    for (int i = 1; i <= count; i++) {
+        std::string number = std::to_string(i);
+        if (number.size() < 3) number.insert(0, 3 - number.size(), '0');
+        config.files.push_back("LOG" + number + ".BIN");
+    }
+    return config;
+}
+
+std::vector<FleetTarget> Squad(int count) {
+    std::vector<FleetTarget> targets;
+    for (int i = 1; i <= count; i++) targets.push_back({Address(i), {i, 200 + 50 * (i % 4)}});
+    return targets;
+}
+
+FleetReport RunVirtual(SimulatedAir& air, const std::shared_ptr<VirtualScheduler>& clock,
+                       std::vector<FleetTarget> targets, FleetConfigOptions options, int* progressCalls = nullptr) {
+    FleetConfigJob job(clock, [&air](const std::string& address) { return air.Link(address); });
+    FleetReport report;
+    bool done = false;
+    job.Start(std::move(targets), options, [&](const FleetReport& r) {
+        report = r;
+        done = true;
+    }, [progressCalls](const FleetPodResult&, int, int) {
+        if (progressCalls) (*progressCalls)++;
+    });
+    clock->RunUntilIdle();
+    Check(done, "job completed");
+    return report;
+}
+
+// MARK: - Squad
+
+void TestSquad() {
+    std::printf("Squad (12 pods, virtual clock)\n");
+    const int kPods = 12;
+    auto config = SquadPod();
+    PodPlan plan;
+
+    auto clock = std::make_shared<VirtualScheduler>();
+    SimulatedAir air(clock, config);
+    for (int i = 1; i <= kPods; i++) air.AddPod(Address(i), plan);
+
+    FleetConfigOptions options;
+    options.max_connections = 4;
+    int progress = 0;
+    auto targets = Squad(kPods);
+    auto report = RunVirtual(air, clock, targets, options, &progress);
+
+    bool ordered = report.pods.size() == targets.size();
+    bool applied = true;
+    for (size_t i = 0; ordered && i < targets.size(); i++) {
+        ordered = report.pods[i].address == targets[i].address;
+        auto settings = air.Settings(targets[i].address);
+        applied = applied && report.pods[i].ok() && settings.player_number == *targets[i].settings.player_number &&
+                  settings.log_interval_ms == *targets[i].settings.log_interval_ms;
+    }
+    Check(report.verified == kPods && report.failed == 0, "every pod verified");
+    Check(applied, "pods hold the requested settings");
+    Check(ordered, "results in target order");
+    Check(progress == kPods, "one progress call per pod");
+    Check(report.peak_connections == 4 && air.PeakConnected() == 4, "never more than 4 pods linked");
+    Check(air.Connected() == 0, "every pod disconnected at the end");
+
+    // One at a time through the same job, and the UI flow it replaces
+    auto sequentialClock = std::make_shared<VirtualScheduler>();
+    SimulatedAir sequentialAir(sequentialClock, config);
+    for (int i = 1; i <= kPods; i++) sequentialAir.AddPod(Address(i), plan);
+    options.max_connections = 1;
+    auto sequential = RunVirtual(sequentialAir, sequentialClock, targets, options);
+    Check(sequential.verified == kPods && sequential.peak_connections == 1, "one at a time also verifies");
+
+    double perSetting = 500.0 + config.reply_latency.count();
+    double legacy = kPods * (plan.connect_latency.count() + 2 * perSetting);
+    std::printf("  fleet (4 links): %.0f ms, one at a time: %.0f ms, UI flow: %.0f ms\n",
+                report.total_ms, sequential.total_ms, legacy);
+    Check(report.total_ms * 3 < sequential.total_ms, "4 links at least 3x faster than one at a time");
+    Check(report.total_ms * 10 < legacy, "at least 10x faster than the UI flow");
+}
+
+// MARK: - Failures
+
+void TestFailures() {
+    std::printf("Failures\n");
+    auto clock = std::make_shared<VirtualScheduler>();
+    SimulatedAir air(clock, SquadPod());
+    for (int i = 1; i <= 8; i++) air.AddPod(Address(i));
+    PodPlan refusesOnce;
+    refusesOnce.refused_connects = 1;
+    PodPlan unreachable;
+    unreachable.unreachable = true;
+    PodPlan refuses;
+    refuses.refused_connects = 10;
+    PodPlan deaf;
+    deaf.ignores_settings = true;
+    air.AddPod("refuses-once", refusesOnce);
+    air.AddPod("unreachable", unreachable);
+    air.AddPod("refuses", refuses);
+    air.AddPod("deaf", deaf);
+
+    auto targets = Squad(8);
+    targets.push_back({"refuses-once", {42, std::nullopt}});
+    targets.push_back({"unreachable", {43, std::nullopt}});
+    targets.push_back({"refuses", {44, std::nullopt}});
+    targets.push_back({"deaf", {45, std::nullopt}});
+    targets.push_back({Address(1), {std::nullopt, 50}});     // Out of range
+    targets.push_back({"not-in-range", {46, std::nullopt}});
+
+    FleetConfigOptions options;
+    options.max_connections = 4;
+    options.connect_timeout = 2s;
+    options.apply_timeout = 800ms;
+    auto report = RunVirtual(air, clock, targets, options);
+
+    auto pod = [&](size_t i) -> const FleetPodResult& { return report.pods[i]; };
+    Check(report.verified == 9 && report.failed == 5, "9 verified, 5 failed (" + std::to_string(report.verified) +
+                                                      "/" + std::to_string(report.failed) + ")");
+    Check(pod(8).ok() && pod(8).connect_attempts == 2 && air.ConnectAttempts("refuses-once") == 2,
+          "refused connect retried and verified");
+    Check(!pod(9).connected && pod(9).error == "connect timed out" && pod(9).connect_attempts == 2,
+          "unreachable pod times out after both attempts");
+    Check(!pod(10).connected && pod(10).error == "connect failed", "refusing pod fails");
+    Check(pod(11).connected && pod(11).error == "not confirmed" && pod(11).settings.has_settings &&
+          pod(11).settings.settings.player_number == 10, "ignored settings reported with the pod's values");
+    Check(!pod(12).connected && pod(12).error == "invalid settings" && pod(12).connect_attempts == 0,
+          "out-of-range request never connects");
+    Check(pod(13).error == "no link", "unknown pod reported");
+    bool squadOk = true;
+    for (size_t i = 0; i < 8; i++) squadOk = squadOk && pod(i).ok() && pod(i).connect_attempts == 1;
+    Check(squadOk, "the rest of the squad unaffected");
+    Check(air.Connected() == 0 && report.peak_connections <= 4, "cap held and every pod disconnected");
+    std::printf("  14 targets in %.0f ms\n", report.total_ms);
+}
+
+// MARK: - Cancel
+
+void TestCancel() {
+    std::printf("Cancel\n");
+    auto clock = std::make_shared<VirtualScheduler>();
+    SimulatedAir air(clock, SquadPod());
+    for (int i = 1; i <= 8; i++) air.AddPod(Address(i));
+    FleetConfigOptions options;
+    options.max_connections = 2;
+
+    {
+        FleetConfigJob job(clock, [&air](const std::string& address) { return air.Link(address); });
+        FleetReport report;
+        int doneCalls = 0;
+        Check(job.Start(Squad(8), options, [&](const FleetReport& r) {
+            report = r;
+            doneCalls++;
+        }), "job started");
+        Check(!job.Start(Squad(2), options, [](const FleetReport&) {}), "second start refused while running");
+
+        clock->RunUntil(clock->Now() + 500ms);
+        job.Cancel();
+        clock->RunUntilIdle();
+        int cancelled = 0;
+        for (const auto& pod : report.pods) cancelled += pod.error == "cancelled";
+        Check(doneCalls == 1 && report.cancelled, "cancelled report delivered once");
+        Check(report.verified == 2 && cancelled == 6, "pods in flight and pending reported cancelled (" +
+                                                      std::to_string(report.verified) + " verified)");
+        Check(air.Connected() == 0, "cancel disconnected every pod");
+        Check(!job.Running(), "job idle after cancel");
+    }
+
+    bool called = false;
+    {
+        FleetConfigJob job(clock, [&air](const std::string& address) { return air.Link(address); });
+        job.Start(Squad(8), options, [&](const FleetReport&) { called = true; });
+        clock->RunUntil(clock->Now() + 200ms);
+        Check(air.Connected() == 0, "no pod linked before its connect completes");
+        clock->RunUntil(clock->Now() + 105ms);
+        Check(air.Connected() == 2, "two pods linked mid-job");
+    }
+    clock->RunUntilIdle();
+    Check(!called && air.Connected() == 0, "destroying a running job disconnects without reporting");
+}
+
+// MARK: - Delete
+
+void TestDelete() {
+    std::printf("Delete (one pod, virtual clock)\n");
+    std::vector<PodFileEntry> listed{{"LOG001.BIN", 1200}, {"MATCH DAY 2.BIN", 7}};
+    auto message = EncodeFileCatalog(listed);
+    message.insert(message.begin(), static_cast<uint8_t>(PodReplyType::kFileList));
+    auto parsed = ParseFileCatalog(message);
+    Check(parsed && *parsed == listed, "file list encodes and parses back");
+
+    const int kFiles = 20;
+    const int kDelete = 12;
+    auto config = CardPod(kFiles);
+    auto clock = std::make_shared<VirtualScheduler>();
+    SimulatedAir air(clock, config);
+    PodPlan deaf;
+    deaf.ignores_deletes = true;
+    air.AddPod("pod");
+    air.AddPod("deaf", deaf);
+
+    auto connect = [&](const std::string& address) {
+        auto link = air.Link(address);
+        link->Connect([](bool) {});
+        clock->RunUntilIdle();
+        return link;
+    };
+    auto remove = [&](FleetPodLink& link, const std::vector<std::string>& files,
+                      std::chrono::milliseconds timeout) {
+        DeleteResult result;
+        link.DeleteFiles(files, timeout, [&result](const DeleteResult& r) { result = r; });
+        clock->RunUntilIdle();
+        return result;
+    };
+
+    // As the app holds them: file list entries, one repeated, one already gone
+    std::vector<std::string> entries;
+    for (int i = 0; i < kDelete; i++) entries.push_back(config.files[i] + " (4.2 KB)");
+    entries.push_back(config.files[0]);
+    entries.push_back("GONE.BIN");
+
+    auto link = connect("pod");
+    auto result = remove(*link, entries, 15s);
+    Check(result.verified && result.deleted.size() == kDelete + 1 && result.remaining.empty(),
+          "batch verified, a repeated name deleted once");
+    Check(result.catalog_reads == 1, "one catalog read settles the batch");
+    Check(result.files_left == kFiles - kDelete && air.Files("pod").size() == kFiles - kDelete &&
+          result.bytes_left > 0, "the catalog reports what is left");
+
+    // The UI flow: per file, write 0x07, sleep 2 s, refetch the list
+    double legacy = kDelete * (2000.0 + config.reply_latency.count());
+    std::printf("  %d files: batch %.0f ms, UI flow: %.0f ms\n", kDelete, result.latency_ms, legacy);
+    Check(result.latency_ms * 10 < legacy, "at least 10x faster than the UI flow");
+
+    auto deafLink = connect("deaf");
+    auto stuck = remove(*deafLink, {config.files[0], config.files[1]}, 3s);
+    Check(!stuck.verified && stuck.timed_out && stuck.has_catalog && stuck.remaining.size() == 2 &&
+          stuck.catalog_reads >= 2 && air.Files("deaf").size() == kFiles,
+          "ignored deletes time out with the files still listed");
+
+    auto offline = air.Link("pod");
+    auto refused = remove(*offline, {config.files[kFiles - 1]}, 3s);
+    Check(!refused.verified && !refused.busy && refused.remaining.size() == 1 && refused.catalog_reads == 0 &&
+          air.Files("pod").size() == kFiles - kDelete, "an offline link writes nothing");
+}
+
+// MARK: - Cleanup
+
+void TestCleanup() {
+    std::printf("Cleanup (12 pods, virtual clock)\n");
+    const int kPods = 12;
+    const int kFiles = 16;
+    auto config = CardPod(kFiles);
+    PodPlan plan;
+
+    auto clock = std::make_shared<VirtualScheduler>();
+    SimulatedAir air(clock, config);
+    std::vector<FleetTarget> targets;
+    for (int i = 1; i <= kPods; i++) {
+        air.AddPod(Address(i), plan);
+        targets.push_back({Address(i), {}, config.files});
+    }
+
+    FleetConfigOptions options;
+    options.max_connections = 4;
+    auto report = RunVirtual(air, clock, targets, options);
+    bool empty = true;
+    bool skipped = true;
+    for (const auto& pod : report.pods) {
+        empty = empty && pod.ok() && pod.deletion.files_left == 0 && air.Files(pod.address).empty();
+        skipped = skipped && pod.settings.probes == 0;
+    }
+    Check(report.verified == kPods && report.files_deleted == kPods * kFiles, "every file on every pod deleted");
+    Check(empty, "every pod's catalog empty");
+    Check(skipped, "settings step skipped for delete-only targets");
+    Check(report.peak_connections == 4 && air.Connected() == 0, "cap held and every pod disconnected");
+
+    auto sequentialClock = std::make_shared<VirtualScheduler>();
+    SimulatedAir sequentialAir(sequentialClock, config);
+    for (int i = 1; i <= kPods; i++) sequentialAir.AddPod(Address(i), plan);
+    options.max_connections = 1;
+    auto sequential = RunVirtual(sequentialAir, sequentialClock, targets, options);
+    Check(sequential.verified == kPods, "one at a time also clears every pod");
+
+    double legacy = kPods * (plan.connect_latency.count() + kFiles * (2000.0 + config.reply_latency.count()));
+    std::printf("  %d files: fleet (4 links): %.0f ms, one at a time: %.0f ms, UI flow: %.0f ms\n",
+                kPods * kFiles, report.total_ms, sequential.total_ms, legacy);
+    Check(report.total_ms * 3 < sequential.total_ms, "4 links at least 3x faster than one at a time");
+    Check(report.total_ms * 50 < legacy, "at least 50x faster than the UI flow");
+
+    // Settings and deletes on one pod; a pod that keeps its files fails alone
+    auto mixedClock = std::make_shared<VirtualScheduler>();
+    SimulatedAir mixedAir(mixedClock, config);
+    PodPlan hoarder;
+    hoarder.ignores_deletes = true;
+    mixedAir.AddPod(Address(1));
+    mixedAir.AddPod("hoarder", hoarder);
+    options.delete_timeout = 2s;
+    auto mixed = RunVirtual(mixedAir, mixedClock,
+                            {{Address(1), {7, std::nullopt}, {config.files[0]}}, {"hoarder", {}, config.files}},
+                            options);
+    Check(mixed.pods[0].ok() && mixed.pods[0].settings.verified && mixedAir.Settings(Address(1)).player_number == 7 &&
+          mixedAir.Files(Address(1)).size() == kFiles - 1, "settings then deletes on one link");
+    Check(!mixed.pods[1].ok() && mixed.pods[1].error == "files remain" &&
+          mixed.pods[1].deletion.remaining.size() == kFiles, "a pod that keeps its files reported");
+}
+
+// MARK: - Threaded
+
+void TestThreaded() {
+    std::printf("Threaded (job strand + radio thread)\n");
+    const int kPods = 10;
+    auto config = CardPod(6);
+    config.reply_latency = 2ms;
+    config.apply_latency = 5ms;
+    config.delete_latency = 5ms;
+    PodPlan plan;
+    plan.connect_latency = 20ms;
+
+    SimulatedAir air(std::make_shared<ThreadScheduler>(), config);
+    for (int i = 1; i <= kPods; i++) air.AddPod(Address(i), plan);
+    auto targets = Squad(kPods);
+    for (size_t i = 0; i < targets.size(); i += 2) targets[i].delete_files = {config.files[0], config.files[1]};
+
+    std::promise<FleetReport> finished;
+    auto future = finished.get_future();
+    {
+        FleetConfigJob job(std::make_shared<ThreadScheduler>(),
+                           [&air](const std::string& address) { return air.Link(address); });
+        FleetConfigOptions options;
+        options.max_connections = 3;
+        job.Start(targets, options, [&finished](const FleetReport& r) { finished.set_value(r); });
+        if (future.wait_for(20s) != std::future_status::ready) {
+            Check(false, "job finished");
+            return;
+        }
+    }
+    auto report = future.get();
+    bool applied = true;
+    bool cleared = true;
+    for (const auto& target : targets) {
+        applied = applied && air.Settings(target.address).player_number == *target.settings.player_number;
+        cleared = cleared && air.Files(target.address).size() == 6 - target.delete_files.size();
+    }
+    std::printf("  %d pods in %.0f ms\n", kPods, report.total_ms);
+    Check(report.verified == kPods, "every pod verified");
+    Check(applied, "settings landed on every pod");
+    Check(cleared && report.files_deleted == kPods, "files deleted where asked, kept elsewhere");
+    Check(air.PeakConnected() <= 3 && report.peak_connections == 3, "cap held across threads");
+    Check(air.Connected() == 0, "every pod disconnected");
+}
+
+} // namespace
+
+int main() {
+    std::printf("Fleet config harness\n");
+    TestSquad();
+    TestFailures();
+    TestCancel();
+    TestDelete();
+    TestCleanup();
+    TestThreaded();
+    std::printf("%s (%d failure%s)\n", failures ? "FAILED" : "PASSED", failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
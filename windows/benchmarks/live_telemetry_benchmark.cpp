@@ -0,0 +1,350 @@
+// Latency benchmark for the shared-memory live telemetry segment.
+//
+// A writer thread publishes decoded live samples for four pods at 1 kHz each
+// (a hundred times the pod's real rate) while readers poll the segment
+// through their own read-only mappings, as separate processes would:
+//   * spin     - busy-polls every pod
+//   * poll     - polls every 100 us, the way a video tool's frame loop might
+//   * laggard  - stops polling for longer than a ring lap
+//   * process  - a forked reader process (POSIX only) that busy-polls
+// Each reader measures publish-to-read latency on the shared clock and checks
+// every record it gets for torn fields and gaps. Also checks the pod
+// directory through attach, detach and slot reuse. Prints latency
+// percentiles and writer cost; exits non-zero on any correctness failure.
+//
+// Build with -DPOD_BLE_BUILD_BENCHMARKS=ON and run pod_ble_live_telemetry_benchmark.
+// On Linux, from windows/:
+//   g++ -std=c++20 -O2 -pthread -o live_telemetry_benchmark
+//       benchmarks/live_telemetry_benchmark.cpp live_telemetry_segment.cpp
+//       shared_memory_region.cpp -lrt
+
+#include "../live_telemetry_segment.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace pod_connector;
+
+namespace {
+
+constexpr uint32_t kPods = 4;
+constexpr uint32_t kRingRecords = 1024;
+constexpr int kSamplesPerPod = 2000;
+constexpr auto kPublishInterval = std::chrono::milliseconds(1);
+
+int failures = 0;
+
+void Check(bool ok, const std::string& what) {
+    std::printf("  [%s] %s\n", ok ? "ok" : "FAIL", what.c_str());
+    if (!ok) failures++;
+}
+
+uint32_t CurrentPid() {
+#ifdef _WIN32
+    return GetCurrentProcessId();
+#else
+    return static_cast<uint32_t>(::getpid());
+#endif
+}
+
+void PutU32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+void PutF32(uint8_t* p, float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    PutU32(p, bits);
+}
+
+// Every field derives from (pod, n), so a record mixing two writes shows up
+float Field(uint32_t pod, uint32_t n, int field) {
+    return static_cast<float>((n * 7 + pod * 1000 + field * 13) % 65536);
+}
+
+void MakeBody(uint32_t pod, uint32_t n, uint8_t* body) {
+    std::memset(body, 0, 72);
+    PutU32(body, n * 100 + pod);
+    PutF32(body + 4, Field(pod, n, 0));
+    for (int i = 0; i < 9; i++) PutF32(body + 8 + 4 * i, Field(pod, n, 1 + i));
+    body[44] = 1;
+    PutF32(body + 54, Field(pod, n, 10));
+    PutF32(body + 58, Field(pod, n, 11));
+    body[63] = static_cast<uint8_t>(n);
+    PutF32(body + 64, Field(pod, n, 12));
+    PutF32(body + 68, Field(pod, n, 13));
+}
+
+bool Consistent(const LiveTelemetryRecord& r) {
+    uint32_t pod = r.kernel_tick % 100;
+    uint32_t n = r.kernel_tick / 100;
+    if (r.index != n || r.battery_v != Field(pod, n, 0)) return false;
+    for (int i = 0; i < 3; i++) {
+        if (r.accel[i] != Field(pod, n, 1 + i) || r.gyro[i] != Field(pod, n, 4 + i) ||
+            r.gravity[i] != Field(pod, n, 7 + i)) {
+            return false;
+        }
+    }
+    return r.latitude == Field(pod, n, 10) && r.longitude == Field(pod, n, 11) &&
+           r.satellites == static_cast<uint8_t>(n) && r.course_deg == Field(pod, n, 13) &&
+           (r.flags & LiveTelemetryRecord::kFixValid);
+}
+
+struct ReaderResult {
+    std::vector<uint64_t> latencies_ns;
+    uint64_t records = 0;
+    uint64_t missed = 0;
+    uint64_t torn = 0;          // Records that passed the seqlock but not the field check
+    uint64_t out_of_order = 0;
+    uint64_t retries = 0;
+    bool opened = false;
+};
+
+// Polls every pod until [stop] and a final drain. [pause] stops polling once
+// for that long, halfway through.
+ReaderResult RunReader(const std::string& name, const std::atomic<bool>& stop,
+                       std::chrono::microseconds interval, std::chrono::milliseconds pause) {
+    ReaderResult result;
+    LiveTelemetryReader reader;
+    std::string error;
+    if (!reader.Open(name, &error)) {
+        std::printf("  reader: %s\n", error.c_str());
+        return result;
+    }
+    result.opened = true;
+
+    std::vector<LiveTelemetryCursor> cursors(kPods);
+    for (uint32_t p = 0; p < kPods; p++) {
+        cursors[p].slot = p;
+        cursors[p].next = 0;
+    }
+    std::vector<uint64_t> expected(kPods, 0);
+    LiveTelemetryRecord batch[64];
+    bool paused = pause.count() == 0;
+    auto started = std::chrono::steady_clock::now();
+
+    auto poll = [&] {
+        for (uint32_t p = 0; p < kPods; p++) {
+            uint64_t missed = 0;
+            size_t n = reader.Poll(cursors[p], batch, 64, &missed);
+            uint64_t now = LiveTelemetryClockNs();
+            result.missed += missed;
+            for (size_t i = 0; i < n; i++) {
+                const auto& r = batch[i];
+                result.records++;
+                result.latencies_ns.push_back(now - r.publish_ns);
+                if (!Consistent(r) || r.kernel_tick % 100 != p) result.torn++;
+                if (r.index < expected[p] || (missed == 0 && r.index != expected[p])) result.out_of_order++;
+                expected[p] = r.index + 1;
+            }
+        }
+    };
+
+    while (!stop.load(std::memory_order_relaxed)) {
+        poll();
+        if (!paused && std::chrono::steady_clock::now() - started > std::chrono::milliseconds(500)) {
+            paused = true;
+            std::this_thread::sleep_for(pause);
+        }
+        if (interval.count() > 0) std::this_thread::sleep_for(interval);
+    }
+    poll();
+    result.retries = reader.retries();
+    return result;
+}
+
+uint64_t Percentile(std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t at = std::min(sorted.size() - 1, static_cast<size_t>(p * (sorted.size() - 1)));
+    return sorted[at];
+}
+
+void Report(const char* label, ReaderResult& r) {
+    std::sort(r.latencies_ns.begin(), r.latencies_ns.end());
+    std::printf("%-8s %7llu records  p50 %6.1f us  p99 %7.1f us  p99.9 %7.1f us  max %8.1f us"
+                "  missed %llu  retries %llu\n",
+                label, static_cast<unsigned long long>(r.records),
+                Percentile(r.latencies_ns, 0.50) / 1000.0, Percentile(r.latencies_ns, 0.99) / 1000.0,
+                Percentile(r.latencies_ns, 0.999) / 1000.0,
+                r.latencies_ns.empty() ? 0.0 : r.latencies_ns.back() / 1000.0,
+                static_cast<unsigned long long>(r.missed), static_cast<unsigned long long>(r.retries));
+}
+
+void CheckReader(const char* label, const ReaderResult& r, bool expectComplete) {
+    std::string name(label);
+    Check(r.opened, name + " opened the segment");
+    Check(r.torn == 0, name + " saw no torn records (" + std::to_string(r.torn) + ")");
+    Check(r.out_of_order == 0, name + " saw every pod's records in order");
+    if (expectComplete) {
+        Check(r.records == uint64_t{kPods} * kSamplesPerPod && r.missed == 0,
+              name + " received every record (" + std::to_string(r.records) + ")");
+    } else {
+        Check(r.missed > 0 && r.records + r.missed == uint64_t{kPods} * kSamplesPerPod,
+              name + " was told about every record it lost (" + std::to_string(r.missed) + " missed)");
+    }
+}
+
+} // namespace
+
+int main() {
+    const std::string name = DefaultLiveTelemetrySegmentName() + "_bench_" + std::to_string(CurrentPid());
+    LiveTelemetrySegment segment;
+    std::string error;
+    if (!segment.Create(name, kPods + 1, kRingRecords, &error)) {
+        std::printf("Create failed: %s\n", error.c_str());
+        return 1;
+    }
+    std::printf("Segment %s: %zu bytes, %u pods x %u records\n\n", name.c_str(), segment.size(),
+                kPods + 1, kRingRecords);
+
+    std::vector<int> slots;
+    for (uint32_t p = 0; p < kPods; p++) slots.push_back(segment.AttachPod("POD-" + std::to_string(p)));
+
+    std::atomic<bool> stop{false};
+
+#ifndef _WIN32
+    // The child reads through its own mapping; it reports and exits on its own
+    std::fflush(stdout);
+    pid_t child = ::fork();
+    if (child == 0) {
+        std::atomic<bool> childStop{false};
+        std::thread watcher([&] {
+            // Stops once the writer has published everything
+            LiveTelemetryReader reader;
+            std::string childError;
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+            if (reader.Open(name, &childError)) {
+                while (std::chrono::steady_clock::now() < deadline) {
+                    bool done = true;
+                    for (uint32_t p = 0; p < kPods; p++) {
+                        auto pod = reader.Pod(p);
+                        if (!pod || pod->published < kSamplesPerPod) done = false;
+                    }
+                    if (done) break;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                }
+            }
+            childStop = true;
+        });
+        ReaderResult r = RunReader(name, childStop, std::chrono::microseconds(0), std::chrono::milliseconds(0));
+        watcher.join();
+        bool ok = r.opened && r.torn == 0 && r.out_of_order == 0 &&
+                  r.records == uint64_t{kPods} * kSamplesPerPod;
+        Report("process", r);
+        std::fflush(stdout);
+        ::_exit(ok ? 0 : 1);
+    }
+#endif
+
+    ReaderResult spin, poll, laggard;
+    std::thread spinThread([&] {
+        spin = RunReader(name, stop, std::chrono::microseconds(0), std::chrono::milliseconds(0));
+    });
+    std::thread pollThread([&] {
+        poll = RunReader(name, stop, std::chrono::microseconds(100), std::chrono::milliseconds(0));
+    });
+    std::thread laggardThread([&] {
+        laggard = RunReader(name, stop, std::chrono::microseconds(100), std::chrono::milliseconds(1500));
+    });
+
+    // Let the readers map the segment before the first sample
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    uint8_t body[72];
+    std::vector<uint64_t> publishNs;
+    publishNs.reserve(size_t{kPods} * kSamplesPerPod);
+    auto next = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < kSamplesPerPod; n++) {
+        for (uint32_t p = 0; p < kPods; p++) {
+            MakeBody(p, n, body);
+            uint64_t before = LiveTelemetryClockNs();
+            if (!segment.Publish(slots[p], body, sizeof(body), false)) failures++;
+            publishNs.push_back(LiveTelemetryClockNs() - before);
+        }
+        next += kPublishInterval;
+        std::this_thread::sleep_until(next);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    stop = true;
+    spinThread.join();
+    pollThread.join();
+    laggardThread.join();
+
+    std::sort(publishNs.begin(), publishNs.end());
+    std::printf("writer   %7zu records  p50 %6.1f us  p99 %7.1f us  per Publish()\n", publishNs.size(),
+                Percentile(publishNs, 0.50) / 1000.0, Percentile(publishNs, 0.99) / 1000.0);
+    Report("spin", spin);
+    Report("poll", poll);
+    Report("laggard", laggard);
+
+#ifndef _WIN32
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    bool childOk = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#endif
+
+    std::printf("\n");
+    CheckReader("spin", spin, true);
+    CheckReader("poll", poll, true);
+    CheckReader("laggard", laggard, false);
+#ifndef _WIN32
+    Check(childOk, "process reader received every record intact");
+#endif
+    {
+        std::vector<uint64_t> sorted = spin.latencies_ns;
+        std::sort(sorted.begin(), sorted.end());
+        uint64_t p99 = Percentile(sorted, 0.99);
+        if (p99 >= 1000000) {
+            std::printf("  [warn] spin p99 %.1f us is above 1 ms; busy readers need a core each (%u here)\n",
+                        p99 / 1000.0, std::thread::hardware_concurrency());
+        }
+    }
+
+    // Directory: detach, reattach the same pod, reuse the oldest slot
+    LiveTelemetryReader reader;
+    Check(reader.Open(name, &error), "directory reader opened the segment");
+    auto before = reader.Pod(static_cast<uint32_t>(slots[0]));
+    segment.DetachPod(slots[0]);
+    auto detached = reader.Pod(static_cast<uint32_t>(slots[0]));
+    Check(detached && detached->state == LivePodState::kDisconnected && detached->device_id == "POD-0" &&
+              detached->published == kSamplesPerPod,
+          "detached pod stays listed with its records");
+    LiveTelemetryRecord latest;
+    Check(reader.Latest(static_cast<uint32_t>(slots[0]), latest) && latest.index == kSamplesPerPod - 1 &&
+              Consistent(latest),
+          "latest record of a detached pod is still readable");
+    Check(segment.AttachPod("POD-0") == slots[0], "a returning pod gets its old slot back");
+    auto reattached = reader.Pod(static_cast<uint32_t>(slots[0]));
+    Check(before && reattached && reattached->state == LivePodState::kConnected &&
+              reattached->session == before->session + 1,
+          "reattaching starts a new session");
+    Check(segment.AttachPod("POD-NEW") == static_cast<int>(kPods), "a new pod takes the free slot");
+    segment.DetachPod(slots[2]);
+    segment.DetachPod(slots[1]);
+    Check(segment.AttachPod("POD-OTHER") == slots[1], "with no free slot the oldest disconnected one is reused");
+    Check(segment.AttachPod("POD-LAST") == slots[2], "then the next oldest");
+    Check(segment.AttachPod("POD-FULL") == -1, "attach fails while every slot is connected");
+    Check(reader.Pods().size() == kPods + 1, "directory lists every slot in use");
+
+    LiveTelemetryReader stale;
+    Check(!stale.Open(name + "_missing", &error), "opening a missing segment fails");
+
+    std::printf("\n%s\n", failures == 0 ? "PASS" : "FAIL");
+    return failures == 0 ? 0 : 1;
+}
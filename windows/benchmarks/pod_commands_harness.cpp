@@ -0,0 +1,308 @@
+// Harness for the typed command layer.
+//
+//   * Encodings     - every ICD V3.6 builder against the byte lists the Dart
+//                     layer writes by hand, filename cleaning and padding
+//   * Settings      - 0x05 replies in block and short form, 0xAE prefix,
+//                     truncated and foreign packets rejected
+//   * ReplyMatcher  - FIFO correlation per reply type, expiry as timeouts,
+//                     tagged requests and their withdrawal, latency
+//                     statistics
+//   * Set-and-verify- SettingsVerifier, as PodBLECore::ApplySettings drives
+//                     it, against ScriptedPod (set, then 0x09 until a reply
+//                     shows the change), compared with the fixed 500 ms
+//                     sleep + Get Settings it replaces
+// Prints set-and-verify latency; exits non-zero on any failure. PodBLECore
+// itself needs WinRT; it uses the same builders, parser and matcher.
+//
+// Build with -DPOD_BLE_BUILD_BENCHMARKS=ON and run pod_ble_commands_harness.
+// On Linux, from windows/:
+//   g++ -std=c++20 -O2 -pthread -o commands_harness benchmarks/pod_commands_harness.cpp
+//       pod_commands.cpp settings_verifier.cpp core_scheduler.cpp scripted_pod.cpp
+//       session_script.cpp payload_integrity.cpp
+
+#include "../core_scheduler.h"
+#include "../pod_commands.h"
+#include "../scripted_pod.h"
+#include "../settings_verifier.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace pod_connector;
+using namespace std::chrono_literals;
+
+namespace {
+
+int failures = 0;
+
+void Check(bool ok, const std::string& what) {
+    std::printf("  [%s] %s\n", ok ? "ok" : "FAIL", what.c_str());
+    if (!ok) failures++;
+}
+
+using Bytes = std::vector<uint8_t>;
+
+// MARK: - Encodings
+
+void TestEncodings() {
+    std::printf("Encodings\n");
+    // The lists pod_notifier.dart builds by hand
+    Check(pod_command::SetLiveStream(true).ToVector() == Bytes{0x03, 0x01, 0x01} &&
+          pod_command::SetLiveStream(false).ToVector() == Bytes{0x03, 0x01, 0x00}, "0x03 live stream");
+    Check(pod_command::SetInternalLogging(true).ToVector() == Bytes{0x04, 0x01, 0x01}, "0x04 internal logging");
+    Check(pod_command::GetLogFilesInfo().ToVector() == Bytes{0x05, 0x00}, "0x05 file list");
+    Check(pod_command::CancelTransfer().ToVector() == Bytes{0x08, 0x00}, "0x08 cancel");
+    Check(pod_command::GetSettings().ToVector() == Bytes{0x09, 0x00}, "0x09 get settings");
+    Check(pod_command::SetPlayerNumber(42).ToVector() == Bytes{0x0A, 0x01, 42}, "0x0A player number");
+    Check(pod_command::SetLogInterval(250).ToVector() == Bytes{0x0B, 0x02, 0xFA, 0x00} &&
+          pod_command::SetLogInterval(1000).ToVector() == Bytes{0x0B, 0x02, 0xE8, 0x03},
+          "0x0B log interval, little endian");
+
+    constexpr auto download = pod_command::DownloadFile("20250725.BIN   (48213 bytes)");
+    Bytes expected(34, 0);
+    expected[0] = 0x06;
+    expected[1] = 0x20;
+    std::string name = "20250725.BIN";
+    std::copy(name.begin(), name.end(), expected.begin() + 2);
+    Check(download.ToVector() == expected, "0x06 name cut at '(', trimmed, NUL-padded to 32");
+    auto remove = pod_command::DeleteFile("20250725.BIN").ToVector();
+    expected[0] = 0x07;
+    Check(remove == expected, "0x07 uses the same name field");
+    auto longName = pod_command::DownloadFile(std::string(40, 'A')).ToVector();
+    Check(longName.size() == 34 && longName[33] == 'A', "names over 32 bytes are truncated");
+
+    Check(OpcodeName(0x09) == "getSettings" && OpcodeName(0x0B) == "setLogInterval" && OpcodeName(0x2F) == "0x2F",
+          "opcode names for statistics");
+    Check(pod_command::IsValidPlayerNumber(1) && pod_command::IsValidPlayerNumber(99) &&
+          !pod_command::IsValidPlayerNumber(0) && !pod_command::IsValidPlayerNumber(100),
+          "player number range 1-99");
+    Check(pod_command::IsValidLogInterval(100) && pod_command::IsValidLogInterval(1000) &&
+          !pod_command::IsValidLogInterval(99) && !pod_command::IsValidLogInterval(1001),
+          "log interval range 100-1000");
+}
+
+// MARK: - Settings replies
+
+void TestSettingsReplies() {
+    std::printf("Settings replies\n");
+    Bytes block{0x05, 0, 0, 0, 0, 1, 0, 0, 0, 0x03, 23, 0xF4, 0x01};
+    auto parsed = ParseSettingsReply(block);
+    Check(parsed && parsed->player_number == 23 && parsed->log_interval_ms == 500, "sequenced block");
+    Bytes framed{0xAE};
+    framed.insert(framed.end(), block.begin(), block.end());
+    Check(ParseSettingsReply(framed) == parsed, "0xAE header skipped");
+    auto payload = EncodeSettingsPayload({23, 500});
+    Check(payload == Bytes{0x05, 0x03, 23, 0xF4, 0x01}, "payload form matches the reassembled message");
+    Check(ParseSettingsReply(payload) == parsed, "payload form parses back");
+    Check(!ParseSettingsReply({0x05, 0x03, 23}) && !ParseSettingsReply({}) && !ParseSettingsReply({0xAE}),
+          "truncated replies rejected");
+    Check(!ParseSettingsReply({0x02, 0, 0, 0, 0, 1, 0, 0, 0, 0x03, 23, 0xF4, 0x01}),
+          "other message types rejected");
+    Check(ReplyTypeOf(framed) == 0x05 && ReplyTypeOf(block) == 0x05 && !ReplyTypeOf({0xAE}),
+          "reply type read past the header");
+}
+
+// MARK: - ReplyMatcher
+
+void TestReplyMatcher() {
+    std::printf("ReplyMatcher\n");
+    ReplyMatcher matcher(1s);
+    auto t0 = ReplyMatcher::Clock::time_point{} + 1h;
+    Bytes settings{0x05, 0, 0, 0, 0, 1, 0, 0, 0, 0x03, 1, 100, 0};
+    Bytes files{0x02, 0, 0, 0, 0, 1, 0, 0, 0, 0x00};
+
+    matcher.Sent(PodOpcode::kGetSettings, t0);
+    matcher.Sent(PodOpcode::kGetLogFilesInfo, t0 + 5ms);
+    matcher.Sent(PodOpcode::kGetSettings, t0 + 10ms);
+    matcher.Sent(PodOpcode::kSetPlayerNumber, t0 + 10ms);
+    Check(matcher.Outstanding() == 3, "set commands are counted, not awaited");
+
+    auto first = matcher.OnReply(files, t0 + 30ms);
+    Check(first && first->request == PodOpcode::kGetLogFilesInfo && first->latency_ms == 25.0,
+          "reply goes to the request of its type");
+    auto second = matcher.OnReply(settings, t0 + 40ms);
+    Check(second && second->request == PodOpcode::kGetSettings && second->latency_ms == 40.0,
+          "oldest request of a type answered first");
+    Check(!matcher.OnReply({0x01, 0, 0, 0, 0, 1, 0, 0, 0}, t0 + 41ms), "unsolicited live data unmatched");
+
+    matcher.Expire(t0 + 2s);
+    const auto& get = matcher.Stats().at(static_cast<uint8_t>(PodOpcode::kGetSettings));
+    Check(get.sent == 2 && get.answered == 1 && get.timeouts == 1 && matcher.Outstanding() == 0,
+          "unanswered request expires as a timeout");
+    Check(!matcher.OnReply(settings, t0 + 2s), "a late reply matches nothing");
+    Check(matcher.Stats().at(static_cast<uint8_t>(PodOpcode::kSetPlayerNumber)).sent == 1,
+          "set command sent count");
+
+    // The host's own probes: an ignored one is withdrawn, so the app's
+    // request behind it gets the next reply
+    auto t1 = t0 + 5s;
+    matcher.Sent(PodOpcode::kGetSettings, t1, 7);
+    matcher.Sent(PodOpcode::kGetSettings, t1 + 10ms);
+    matcher.Withdraw(7);
+    auto app = matcher.OnReply(settings, t1 + 30ms);
+    Check(app && app->tag == 0 && app->latency_ms == 20.0, "withdrawn probe leaves the reply to the app");
+    matcher.Sent(PodOpcode::kGetSettings, t1 + 40ms, 7);
+    auto probe = matcher.OnReply(settings, t1 + 60ms);
+    Check(probe && probe->tag == 7, "a tagged request's reply carries its tag");
+    Check(matcher.Stats().at(static_cast<uint8_t>(PodOpcode::kGetSettings)).timeouts == 2,
+          "a withdrawn request counts as a timeout");
+
+    CommandLatency latency;
+    for (double ms : {10.0, 20.0, 60.0}) latency.Add(ms);
+    Check(latency.answered == 3 && latency.mean_ms == 30.0 && latency.max_ms == 60.0 && latency.last_ms == 60.0,
+          "latency mean / max / last");
+}
+
+// MARK: - Set-and-verify
+
+// The host side of PodBLECore::ApplySettings: the same SettingsVerifier and
+// reply correlation, writing to a ScriptedPod instead of GATT.
+class VerifyHost {
+public:
+    VerifyHost(std::shared_ptr<VirtualScheduler> scheduler, ScriptedPodConfig config)
+        : scheduler_(std::move(scheduler)),
+          pod_(scheduler_, config, [this](const Bytes& packet) { OnNotify(packet); }),
+          verifier_(*scheduler_, matcher_, alive_, [this](const Bytes& command) { Send(command); }, nullptr) {}
+
+    ~VerifyHost() { alive_->store(false); }
+
+    SettingsResult Apply(std::optional<int> player, std::optional<int> interval, std::chrono::milliseconds timeout) {
+        SettingsResult outcome;
+        verifier_.Apply({player, interval}, timeout, [&outcome](const SettingsResult& r) { outcome = r; });
+        scheduler_->RunUntilIdle();
+        return outcome;
+    }
+
+    // What pod_notifier.dart did: write, sleep 500 ms, Get Settings, wait for
+    // the reply (or its 3 s timeout)
+    SettingsResult Legacy(std::optional<int> player, std::optional<int> interval) {
+        legacy_ = {};
+        legacy_player_ = player;
+        legacy_active_ = true;
+        started_ = scheduler_->Now();
+        if (player) Send(pod_command::SetPlayerNumber(static_cast<uint8_t>(*player)).ToVector());
+        if (interval) Send(pod_command::SetLogInterval(static_cast<uint16_t>(*interval)).ToVector());
+        scheduler_->After(500ms, [this] {
+            Send(pod_command::GetSettings().ToVector());
+            legacy_.probes++;
+        });
+        scheduler_->RunUntilIdle();
+        legacy_active_ = false;
+        return legacy_;
+    }
+
+    ScriptedPod& pod() { return pod_; }
+    ReplyMatcher& matcher() { return matcher_; }
+
+private:
+    void Send(const Bytes& command) {
+        matcher_.Sent(static_cast<PodOpcode>(command[0]), scheduler_->Now());
+        Bytes framed;
+        framed.reserve(command.size() + 1);
+        framed.push_back(0xAE);
+        framed.insert(framed.end(), command.begin(), command.end());
+        pod_.OnWrite(framed);
+    }
+
+    void OnNotify(const Bytes& packet) {
+        auto match = matcher_.OnReply(packet, scheduler_->Now());
+        if (!match) return;
+        if (!legacy_active_) {
+            verifier_.OnReply(*match, packet);
+            return;
+        }
+        auto settings = ParseSettingsReply(packet);
+        if (match->request != PodOpcode::kGetSettings || !settings) return;
+        legacy_.has_settings = true;
+        legacy_.settings = *settings;
+        legacy_.verified = !legacy_player_ || *legacy_player_ == settings->player_number;
+        legacy_.latency_ms = std::chrono::duration<double, std::milli>(scheduler_->Now() - started_).count();
+    }
+
+    std::shared_ptr<VirtualScheduler> scheduler_;
+    std::shared_ptr<std::atomic<bool>> alive_ = std::make_shared<std::atomic<bool>>(true);
+    ScriptedPod pod_;
+    ReplyMatcher matcher_;
+    SettingsVerifier verifier_;
+    SettingsResult legacy_;
+    std::optional<int> legacy_player_;
+    bool legacy_active_ = false;
+    CoreScheduler::Clock::time_point started_;
+};
+
+void TestSetAndVerify() {
+    std::printf("Set-and-verify\n");
+    ScriptedPodConfig config;
+    config.reply_latency = 20ms;
+    config.apply_latency = 60ms;
+
+    auto scheduler = std::make_shared<VirtualScheduler>();
+    VerifyHost host(scheduler, config);
+    auto read = host.Apply(std::nullopt, std::nullopt, 1s);
+    Check(read.verified && read.probes == 1 && read.latency_ms == 20.0 && read.has_settings &&
+          read.settings.player_number == 10, "get-only completes on the first reply");
+
+    auto player = host.Apply(23, std::nullopt, 1500ms);
+    Check(player.verified && host.pod().settings().player_number == 23, "player number applied and verified");
+    Check(player.probes == 2, "stale first reply re-asked once (" + std::to_string(player.probes) + " probes)");
+    auto both = host.Apply(7, 800, 1500ms);
+    Check(both.verified && both.has_settings && both.settings.player_number == 7 &&
+          both.settings.log_interval_ms == 800, "both settings in one transaction");
+
+    auto sched2 = std::make_shared<VirtualScheduler>();
+    VerifyHost legacy(sched2, config);
+    auto old = legacy.Legacy(23, std::nullopt);
+    Check(old.verified && old.latency_ms == 520.0, "legacy flow verifies after its fixed sleep");
+    std::printf("  set player number: %.0f ms (was %.0f ms), %d probes\n",
+                player.latency_ms, old.latency_ms, player.probes);
+    Check(player.latency_ms * 4 < old.latency_ms, "set-and-verify at least 4x faster than sleep + read");
+
+    // Slow flash: the change shows up late, the host keeps asking until it does
+    ScriptedPodConfig slow = config;
+    slow.apply_latency = 700ms;
+    auto sched3 = std::make_shared<VirtualScheduler>();
+    VerifyHost slowHost(sched3, slow);
+    auto late = slowHost.Apply(std::nullopt, 400, 1500ms);
+    Check(late.verified && late.latency_ms >= 700.0 && late.latency_ms < 800.0,
+          "late commit verified within one retry (" + std::to_string(static_cast<int>(late.latency_ms)) + " ms)");
+    const auto& stats = slowHost.matcher().Stats().at(static_cast<uint8_t>(PodOpcode::kGetSettings));
+    Check(stats.answered == static_cast<uint64_t>(late.probes) && stats.timeouts == 0,
+          "every probe correlated to its reply");
+
+    // Never applied: the pod ignores the out-of-range value
+    auto sched4 = std::make_shared<VirtualScheduler>();
+    VerifyHost stubborn(sched4, config);
+    auto never = stubborn.Apply(std::nullopt, 50, 600ms);
+    Check(never.timed_out && !never.verified && never.latency_ms == 600.0 && never.has_settings &&
+          never.settings.log_interval_ms == 100, "unapplied change times out with the pod's values");
+
+    // Silent pod (mid-transfer, probes ignored): re-probed every 250 ms until the deadline
+    auto sched5 = std::make_shared<VirtualScheduler>();
+    VerifyHost silent(sched5, config);
+    silent.pod().OnWrite([] {
+        auto frame = pod_command::DownloadFile("LOG1.BIN").ToVector();
+        Bytes framed{0xAE};
+        framed.insert(framed.end(), frame.begin(), frame.end());
+        return framed;
+    }());
+    auto mute = silent.Apply(5, std::nullopt, 600ms);
+    Check(mute.timed_out && !mute.has_settings && mute.probes == 3,
+          "no reply: re-probed until the deadline (" + std::to_string(mute.probes) + " probes)");
+}
+
+} // namespace
+
+int main() {
+    std::printf("Pod commands harness\n");
+    TestEncodings();
+    TestSettingsReplies();
+    TestReplyMatcher();
+    TestSetAndVerify();
+    std::printf("%s (%d failure%s)\n", failures ? "FAILED" : "PASSED", failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
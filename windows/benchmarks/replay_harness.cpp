@@ -0,0 +1,525 @@
+// Harness for the deterministic replay building blocks.
+//
+//   * VirtualScheduler  - deadline / FIFO order, nested scheduling, clock jumps
+//   * ThreadScheduler   - the same order on real time, pending tasks dropped on
+//                         destruction, RunOnStrand released when its task is
+//                         dropped
+//   * Session scripts   - format / parse round trip, error lines, output
+//                         comparison, SessionRecorder from several threads
+//   * ScriptedPod       - a minimal host runs a multi-file sync against it the
+//                         way PodBLECore does (request, reassemble, 50 ms
+//                         finish, 0x09 probes until ready, next file) and
+//                         checks every file byte for byte, with and without
+//                         block loss, then runs it again and requires an
+//                         identical trace
+// Prints virtual vs wall time for the sync; exits non-zero on any failure.
+// PodBLECore itself needs WinRT; pod_ble_replay drives it the same way.
+//
+// Build with -DPOD_BLE_BUILD_BENCHMARKS=ON and run pod_ble_replay_harness.
+// On Linux, from windows/:
+//   g++ -std=c++20 -O2 -pthread -o replay_harness benchmarks/replay_harness.cpp
+//       core_scheduler.cpp session_script.cpp scripted_pod.cpp payload_integrity.cpp
+//       pod_commands.cpp
+
+#include "../core_scheduler.h"
+#include "../payload_integrity.h"
+#include "../scripted_pod.h"
+#include "../session_script.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pod_connector;
+using namespace std::chrono_literals;
+
+namespace {
+
+int failures = 0;
+
+void Check(bool ok, const std::string& what) {
+    std::printf("  [%s] %s\n", ok ? "ok" : "FAIL", what.c_str());
+    if (!ok) failures++;
+}
+
+int64_t Ms(CoreScheduler::Clock::duration d) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+}
+
+// MARK: - Schedulers
+
+void TestVirtualScheduler() {
+    std::printf("VirtualScheduler\n");
+    auto scheduler = std::make_shared<VirtualScheduler>();
+    const auto origin = scheduler->Now();
+    std::vector<std::string> order;
+
+    scheduler->After(20ms, [&] { order.push_back("b"); });
+    scheduler->After(10ms, [&] {
+        order.push_back("a");
+        // Due at 20 ms as well, but scheduled later than "b"
+        scheduler->After(10ms, [&] { order.push_back("c"); });
+        scheduler->After(0ms, [&] { order.push_back("a0"); });
+    });
+    scheduler->After(20ms, [&] { order.push_back("b2"); });
+    Check(scheduler->Pending() == 3 && order.empty(), "nothing runs until driven");
+
+    size_t ran = scheduler->RunUntil(origin + 15ms);
+    Check(ran == 2 && order == std::vector<std::string>{"a", "a0"}, "RunUntil runs due tasks and their follow-ups");
+    Check(scheduler->Now() == origin + 15ms, "clock left at the RunUntil deadline");
+
+    scheduler->RunUntilIdle();
+    Check(order == std::vector<std::string>{"a", "a0", "b", "b2", "c"}, "same deadline runs in scheduling order");
+    Check(scheduler->Now() == origin + 20ms, "clock jumps to the last deadline");
+
+    // A watchdog-style 1 s tick for ten virtual minutes
+    int ticks = 0;
+    std::function<void()> tick = [&] {
+        if (++ticks < 600) scheduler->After(1s, tick);
+    };
+    scheduler->After(1s, tick);
+    auto wall = std::chrono::steady_clock::now();
+    scheduler->RunUntilIdle();
+    auto wallMs = Ms(std::chrono::steady_clock::now() - wall);
+    Check(ticks == 600 && scheduler->Now() == origin + 20ms + 600s, "600 one-second ticks land on virtual time");
+    Check(wallMs < 1000, "ten virtual minutes in " + std::to_string(wallMs) + " ms");
+
+    scheduler->After(-5ms, [&] { order.push_back("late"); });
+    auto before = scheduler->Now();
+    scheduler->RunUntilIdle();
+    Check(order.back() == "late" && scheduler->Now() == before, "negative delays run now, clock never goes back");
+}
+
+void TestThreadScheduler() {
+    std::printf("ThreadScheduler\n");
+    std::mutex mtx;
+    std::vector<int> order;
+    std::atomic<int> done{0};
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<int64_t> lastMs{0};
+    {
+        ThreadScheduler scheduler;
+        scheduler.After(60ms, [&] {
+            std::lock_guard<std::mutex> lock(mtx);
+            order.push_back(3);
+            lastMs = Ms(std::chrono::steady_clock::now() - start);
+            done++;
+        });
+        scheduler.After(20ms, [&] {
+            std::lock_guard<std::mutex> lock(mtx);
+            order.push_back(1);
+            done++;
+        });
+        scheduler.After(20ms, [&] {
+            std::lock_guard<std::mutex> lock(mtx);
+            order.push_back(2);
+            done++;
+        });
+        scheduler.After(10s, [&] { done += 100; });
+        while (done.load() < 3) std::this_thread::sleep_for(5ms);
+    }
+    Check(order == std::vector<int>{1, 2, 3}, "deadline order, FIFO on ties");
+    Check(lastMs.load() >= 60, "tasks wait for their deadline (" + std::to_string(lastMs.load()) + " ms)");
+    Check(done.load() == 3, "pending tasks dropped when the scheduler goes away");
+
+    // A caller waiting in RunOnStrand behind a busy strand must not hang when
+    // the scheduler stops and drops its task
+    struct Stopping : ThreadScheduler {
+        std::atomic<int> posts{0};
+        void Post(Task task) override {
+            ThreadScheduler::Post(std::move(task));
+            posts++;
+        }
+    };
+    auto stopping = std::make_unique<Stopping>();
+    std::atomic<bool> release{false};
+    stopping->Post([&] {
+        while (!release.load()) std::this_thread::sleep_for(1ms);
+    });
+    std::this_thread::sleep_for(20ms);
+    std::atomic<int> outcome{0};   // 0 waiting, 1 ran, -1 broken promise
+    std::thread caller([&outcome, &strand = *stopping] {
+        try {
+            outcome = RunOnStrand(strand, [] { return 1; });
+        } catch (const std::future_error&) {
+            outcome = -1;
+        }
+    });
+    // Stop only once the caller is waiting, not while it is still posting
+    while (stopping->posts.load() < 2) std::this_thread::sleep_for(1ms);
+    std::thread releaser([&] {
+        std::this_thread::sleep_for(50ms);
+        release = true;
+    });
+    auto stopStart = std::chrono::steady_clock::now();
+    stopping.reset();
+    caller.join();
+    releaser.join();
+    Check(outcome.load() == -1, "RunOnStrand fails when its task is dropped");
+    Check(std::chrono::steady_clock::now() - stopStart < 1s, "RunOnStrand caller released on shutdown");
+}
+
+// MARK: - Scripts
+
+void TestScripts() {
+    std::printf("Session scripts\n");
+    std::vector<SessionEvent> events;
+    events.push_back(SessionEvent::Of(SessionEvent::Kind::kNotify, {0x03, 0x00, 0xFF}));
+    events.push_back(SessionEvent::Of(SessionEvent::Kind::kWrite, {0x09, 0x00}));
+    auto file = SessionEvent::Of(SessionEvent::Kind::kDownloadFile);
+    file.text = "LOG 0001.BIN (12 KB)";
+    file.start = 1700000000000;
+    file.end = 1700000600000;
+    file.total = 3;
+    file.index = 2;
+    events.push_back(file);
+    auto batch = SessionEvent::Of(SessionEvent::Kind::kDownloadFiles);
+    batch.files = {"A.BIN", "B C.BIN", "D.BIN"};
+    batch.window = 2;
+    events.push_back(batch);
+    auto ack = SessionEvent::Of(SessionEvent::Kind::kAck);
+    ack.index = 2;
+    events.push_back(ack);
+    events.push_back(SessionEvent::Of(SessionEvent::Kind::kCancel));
+    events.push_back(SessionEvent::Of(SessionEvent::Kind::kDisconnect));
+    auto settings = SessionEvent::Of(SessionEvent::Kind::kApplySettings);
+    settings.player_number = 23;
+    settings.timeout_ms = 1500;
+    events.push_back(settings);
+    auto erase = SessionEvent::Of(SessionEvent::Kind::kDeleteFiles);
+    erase.files = {"LOG1.BIN", "MATCH DAY.BIN"};
+    erase.timeout_ms = 15000;
+    events.push_back(erase);
+    events.push_back(SessionEvent::Of(SessionEvent::Kind::kOutWrite, {0xAE, 0x08}));
+    auto status = SessionEvent::Of(SessionEvent::Kind::kOutStatus);
+    status.text = "Downloading File 2/3";
+    events.push_back(status);
+    events.push_back(SessionEvent::Payload({0x03, 1, 2, 3, 4}));
+    for (size_t i = 0; i < events.size(); i++) events[i].at_us = static_cast<int64_t>(i) * 1250;
+
+    std::string text = FormatSessionScript(events);
+    std::string error;
+    auto parsed = ParseSessionScript(text, &error);
+    Check(parsed && parsed->size() == events.size(),
+          "every event kind parses back" + (error.empty() ? "" : " (" + error + ")"));
+    Check(parsed && FormatSessionScript(*parsed) == text, "format / parse round trip is exact");
+    Check(parsed && (*parsed)[2].text == file.text && (*parsed)[3].files.size() == 3 &&
+          (*parsed)[3].files[1] == "B C.BIN", "filenames keep their spaces");
+    Check(parsed && (*parsed)[7].player_number == 23 && (*parsed)[7].log_interval_ms == 0 &&
+          (*parsed)[7].timeout_ms == 1500, "apply_settings keeps its values");
+    Check(parsed && (*parsed)[8].files == erase.files && (*parsed)[8].timeout_ms == 15000,
+          "delete_files keeps its names and timeout");
+    Check(parsed && SessionDigest(*parsed) == SessionDigest(events), "digest survives the round trip");
+    Check(parsed && FirstOutputMismatch(events, *parsed) == -1, "identical outputs compare equal");
+
+    auto shifted = events;
+    for (auto& e : shifted) e.at_us += 7;
+    Check(FirstOutputMismatch(events, shifted) == -1 && SessionDigest(events) != SessionDigest(shifted),
+          "output comparison ignores timing, the digest does not");
+    auto changed = events;
+    changed.back().crc ^= 1;
+    Check(FirstOutputMismatch(events, changed) == 2, "first differing output is reported");
+    changed.pop_back();
+    Check(FirstOutputMismatch(events, changed) == 2, "a missing output is a mismatch");
+
+    auto bad = ParseSessionScript("# header\n0 ack 1\n\n5 notify 0x\n", &error);
+    Check(!bad && error.rfind("line 4:", 0) == 0, "bad hex reported with its line (" + error + ")");
+    bad = ParseSessionScript("10 reboot\n", &error);
+    Check(!bad && error.find("unknown event") != std::string::npos, "unknown events rejected");
+    auto crlf = ParseSessionScript("0 out_status Pod Ready\r\n", &error);
+    Check(crlf && crlf->size() == 1 && (*crlf)[0].text == "Pod Ready", "CRLF line endings accepted");
+
+    SessionRecorder recorder;
+    auto base = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&recorder, base, t] {
+            for (int i = 0; i < 500; i++) {
+                recorder.Add(base + std::chrono::microseconds(1000 + t),
+                             SessionEvent::Of(SessionEvent::Kind::kNotify, {static_cast<uint8_t>(t)}));
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    auto recorded = recorder.Events();
+    bool relative = true;
+    for (const auto& e : recorded) relative = relative && e.at_us >= -3 && e.at_us <= 3;
+    Check(recorded.size() == 2000 && relative, "recorder takes events from several threads, times relative");
+}
+
+// MARK: - ScriptedPod
+
+struct TraceEntry {
+    int64_t at_us;
+    std::vector<uint8_t> packet;
+};
+
+struct SyncResult {
+    std::vector<TraceEntry> trace;          // Everything the pod sent, in order
+    std::vector<std::vector<uint8_t>> files;
+    int probes = 0;
+    int watchdog_finishes = 0;
+    int64_t virtual_ms = 0;
+    double wall_ms = 0;
+    uint64_t dropped = 0;
+};
+
+// The host half of PodBLECore's batch pipeline, cut down to what drives the
+// pod: one request at a time, 50 ms to finish, then 0x09 probes until ready.
+class MiniHost {
+public:
+    MiniHost(std::shared_ptr<VirtualScheduler> scheduler, const ScriptedPodConfig& config,
+             std::vector<std::string> files)
+        : scheduler_(scheduler), files_(std::move(files)),
+          pod_(scheduler, config, [this](const std::vector<uint8_t>& p) { OnNotify(p); }) {}
+
+    SyncResult Run() {
+        auto wall = std::chrono::steady_clock::now();
+        origin_ = scheduler_->Now();
+        RequestNext();
+        scheduler_->RunUntil(origin_ + 600s);
+        result_.virtual_ms = Ms(last_ - origin_);
+        result_.wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wall).count();
+        result_.dropped = pod_.blocks_dropped();
+        return std::move(result_);
+    }
+
+    ScriptedPod& pod() { return pod_; }
+
+private:
+    void Write(std::vector<uint8_t> command) {
+        command.insert(command.begin(), 0xAE);
+        pod_.OnWrite(command);
+    }
+
+    void RequestNext() {
+        if (next_ == files_.size()) return;
+        std::vector<uint8_t> command(34, 0);
+        command[0] = 0x06;
+        command[1] = 0x20;
+        std::memcpy(command.data() + 2, files_[next_].data(), std::min<size_t>(files_[next_].size(), 32));
+        next_++;
+        buffer_.clear();
+        total_ = received_ = 0;
+        block_payload_ = 0;
+        last_seq_ = 0;
+        generation_++;
+        Write(command);
+        Watchdog(generation_);
+    }
+
+    void OnNotify(const std::vector<uint8_t>& packet) {
+        last_ = scheduler_->Now();
+        result_.trace.push_back({Ms(last_ - origin_) * 1000, packet});
+        if (!packet.empty() && packet[0] == 0x05) {
+            if (awaiting_ready_) {
+                awaiting_ready_ = false;
+                RequestNext();
+            }
+            return;
+        }
+        if (packet.size() < 5 || packet[0] != 0x03) return;
+        uint32_t seq;
+        std::memcpy(&seq, packet.data() + 1, 4);
+        if (received_ == 0) {
+            std::memcpy(&total_, packet.data() + 5, 4);
+            block_payload_ = packet.size() - 5;
+            buffer_.assign(packet.begin() + 9, packet.end());
+        } else {
+            // Lost blocks are zero-filled, like the integrity tracker does
+            for (uint32_t s = last_seq_ + 1; s < seq; s++) {
+                buffer_.insert(buffer_.end(), block_payload_, 0);
+                missing_++;
+            }
+            buffer_.insert(buffer_.end(), packet.begin() + 5, packet.end());
+        }
+        last_seq_ = seq;
+        received_++;
+        if (received_ + missing_ >= static_cast<int>(total_)) ScheduleFinish();
+    }
+
+    void ScheduleFinish() {
+        uint64_t generation = generation_;
+        scheduler_->After(50ms, [this, generation] { if (generation == generation_) Finish(); });
+    }
+
+    void Finish() {
+        generation_++;
+        result_.files.push_back(std::move(buffer_));
+        buffer_.clear();
+        received_ = missing_ = 0;
+        total_ = 0;
+        awaiting_ready_ = true;
+        scheduler_->After(280ms, [this] { Probe(0); });
+    }
+
+    void Probe(int attempt) {
+        if (!awaiting_ready_) return;
+        if (attempt == 4) {
+            awaiting_ready_ = false;
+            RequestNext();
+            return;
+        }
+        result_.probes++;
+        Write({0x09, 0x00});
+        scheduler_->After(150ms, [this, attempt] { Probe(attempt + 1); });
+    }
+
+    // Stuck-at-99% rule: blocks lost at the tail never arrive
+    void Watchdog(uint64_t generation) {
+        scheduler_->After(1s, [this, generation] {
+            if (generation != generation_) return;
+            if (total_ > 0 && scheduler_->Now() - last_ > 2500ms) {
+                result_.watchdog_finishes++;
+                Finish();
+                return;
+            }
+            Watchdog(generation);
+        });
+    }
+
+    std::shared_ptr<VirtualScheduler> scheduler_;
+    std::vector<std::string> files_;
+    ScriptedPod pod_;
+    SyncResult result_;
+    CoreScheduler::Clock::time_point origin_, last_;
+    size_t next_ = 0;
+    std::vector<uint8_t> buffer_;
+    uint32_t total_ = 0;
+    int received_ = 0;
+    int missing_ = 0;
+    size_t block_payload_ = 0;
+    uint32_t last_seq_ = 0;
+    uint64_t generation_ = 0;
+    bool awaiting_ready_ = false;
+};
+
+std::vector<std::string> FileNames(int n) {
+    std::vector<std::string> names;
+    for (int i = 1; i <= n; i++) names.push_back("LOG" + std::to_string(1000 + i) + ".BIN");
+    return names;
+}
+
+bool SameTrace(const SyncResult& a, const SyncResult& b) {
+    if (a.trace.size() != b.trace.size()) return false;
+    for (size_t i = 0; i < a.trace.size(); i++) {
+        if (a.trace[i].at_us != b.trace[i].at_us || a.trace[i].packet != b.trace[i].packet) return false;
+    }
+    return true;
+}
+
+void TestScriptedPod() {
+    std::printf("ScriptedPod\n");
+    ScriptedPodConfig config;
+    const auto names = FileNames(8);
+
+    // File contents look like real 61-byte records
+    {
+        auto scheduler = std::make_shared<VirtualScheduler>();
+        ScriptedPod pod(scheduler, config, [](const std::vector<uint8_t>&) {});
+        auto file = pod.FileContents(names[0]);
+        auto again = pod.FileContents(names[0]);
+        auto other = pod.FileContents(names[1]);
+        Check(file == again && file != other, "contents are a function of the filename");
+        Check(file.size() % 61 == 0 && file.size() / 61 >= 600, "whole 61-byte records");
+        bool plausible = true;
+        for (size_t r = 0; r + 61 <= file.size(); r += 61) {
+            uint16_t year = static_cast<uint16_t>(file[r + 4] | (file[r + 5] << 8));
+            plausible = plausible && year == 2024 && file[r + 6] == 5 && file[r + 7] >= 1 && file[r + 7] <= 28;
+        }
+        // DetectRecordSize's 47-byte probe must not fire on a 61-byte file
+        uint16_t at47 = static_cast<uint16_t>(file[51] | (file[52] << 8));
+        Check(plausible && !(at47 >= 2022 && at47 <= 2030), "record headers valid, no false 47-byte match");
+    }
+
+    auto scheduler = std::make_shared<VirtualScheduler>();
+    MiniHost host(scheduler, config, names);
+    SyncResult clean = host.Run();
+    bool exact = clean.files.size() == names.size();
+    for (size_t i = 0; exact && i < names.size(); i++) {
+        auto expected = host.pod().FileContents(names[i]);
+        exact = clean.files[i].size() >= expected.size() &&
+                std::equal(expected.begin(), expected.end(), clean.files[i].begin());
+    }
+    Check(exact, "8-file sync reassembles every file byte for byte");
+    Check(clean.probes >= 8, "each file ended with readiness probes (" + std::to_string(clean.probes) + ")");
+    Check(clean.watchdog_finishes == 0 && clean.dropped == 0, "no loss, no watchdog");
+
+    auto scheduler2 = std::make_shared<VirtualScheduler>();
+    MiniHost host2(scheduler2, config, names);
+    SyncResult clean2 = host2.Run();
+    Check(SameTrace(clean, clean2), "second run gives the identical trace (" +
+          std::to_string(clean.trace.size()) + " notifications)");
+    double speedup = clean.wall_ms > 0 ? static_cast<double>(clean.virtual_ms) / clean.wall_ms : 0;
+    std::printf("  sync: %.1f s virtual in %.1f ms wall (%.0fx)\n",
+                static_cast<double>(clean.virtual_ms) / 1000.0, clean.wall_ms, speedup);
+    Check(clean.virtual_ms > 1000 && clean.wall_ms < static_cast<double>(clean.virtual_ms),
+          "faster than real time");
+
+    // Lossy link: tail losses end on the watchdog, contents still line up
+    ScriptedPodConfig lossy = config;
+    lossy.loss = 0.02;
+    lossy.seed = 7;
+    auto scheduler3 = std::make_shared<VirtualScheduler>();
+    MiniHost host3(scheduler3, lossy, names);
+    SyncResult lost = host3.Run();
+    auto scheduler4 = std::make_shared<VirtualScheduler>();
+    MiniHost host4(scheduler4, lossy, names);
+    SyncResult lost2 = host4.Run();
+    Check(lost.dropped > 0 && lost.files.size() == names.size(), "lossy sync completes (" +
+          std::to_string(lost.dropped) + " blocks dropped, " + std::to_string(lost.watchdog_finishes) +
+          " watchdog finishes)");
+    Check(SameTrace(lost, lost2) && lost.dropped == lost2.dropped, "loss pattern is reproducible");
+    lossy.seed = 8;
+    auto scheduler5 = std::make_shared<VirtualScheduler>();
+    MiniHost host5(scheduler5, lossy, names);
+    Check(!SameTrace(lost, host5.Run()), "a different seed gives a different session");
+
+    // Cancel mid-transfer; probes are ignored until the file is closed
+    {
+        auto sched = std::make_shared<VirtualScheduler>();
+        const auto origin = sched->Now();
+        std::vector<int64_t> blocks, replies;
+        ScriptedPod pod(sched, config, [&](const std::vector<uint8_t>& p) {
+            (p[0] == 0x05 ? replies : blocks).push_back(Ms(sched->Now() - origin));
+        });
+        std::vector<uint8_t> request(35, 0);
+        request[0] = 0xAE;
+        request[1] = 0x06;
+        request[2] = 0x20;
+        std::memcpy(request.data() + 3, "LOG1001.BIN", 11);
+        pod.OnWrite(request);
+        sched->RunUntil(origin + 100ms);
+        size_t before = blocks.size();
+        pod.OnWrite({0xAE, 0x08});
+        pod.OnWrite({0xAE, 0x09, 0x00});
+        sched->RunUntil(origin + 300ms);
+        Check(before > 0 && blocks.size() == before && replies.empty(),
+              "0x08 stops the stream, early probe unanswered");
+        sched->RunUntil(origin + 500ms);
+        pod.OnWrite({0xAE, 0x09, 0x00});
+        sched->RunUntilIdle();
+        Check(replies.size() == 1 && replies[0] == 520, "probe answered once the file is closed");
+    }
+}
+
+} // namespace
+
+int main() {
+    std::printf("Replay harness (CRC32C %s)\n", Crc32cIsHardwareAccelerated() ? "hardware" : "portable");
+    TestVirtualScheduler();
+    TestThreadScheduler();
+    TestScripts();
+    TestScriptedPod();
+    std::printf("%s (%d failure%s)\n", failures ? "FAILED" : "PASSED", failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+#include "broker_protocol.h"
+
+#include "local_channel.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pod_connector {
+
+namespace {
+
+template <typename T>
+void AppendLE(std::vector<uint8_t>& out, T v) {
+    for (size_t i = 0; i < sizeof(T); i++) {
+        out.push_back(static_cast<uint8_t>(static_cast<uint64_t>(v) >> (8 * i)));
+    }
+}
+
+template <typename T>
+T LoadLE(const uint8_t* p) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < sizeof(T); i++) v |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return static_cast<T>(v);
+}
+
+} // namespace
+
+BrokerSubscription PayloadSubscription(const uint8_t* payload, size_t length) {
+    if (length > 0 && (payload[0] == 0x01 || payload[0] == 0xDC)) return kSubscribeLive;
+    return kSubscribeFiles;
+}
+
+// MARK: - FrameWriter
+
+FrameWriter::FrameWriter(BrokerMessage type) {
+    buffer_.reserve(64);
+    buffer_.resize(4);
+    buffer_.push_back(static_cast<uint8_t>(type));
+}
+
+FrameWriter& FrameWriter::U8(uint8_t v) { buffer_.push_back(v); return *this; }
+FrameWriter& FrameWriter::U16(uint16_t v) { AppendLE(buffer_, v); return *this; }
+FrameWriter& FrameWriter::U32(uint32_t v) { AppendLE(buffer_, v); return *this; }
+FrameWriter& FrameWriter::I32(int32_t v) { AppendLE(buffer_, static_cast<uint32_t>(v)); return *this; }
+FrameWriter& FrameWriter::U64(uint64_t v) { AppendLE(buffer_, v); return *this; }
+FrameWriter& FrameWriter::I64(int64_t v) { AppendLE(buffer_, static_cast<uint64_t>(v)); return *this; }
+
+FrameWriter& FrameWriter::Str(const std::string& v) {
+    size_t n = std::min<size_t>(v.size(), 0xFFFF);
+    U16(static_cast<uint16_t>(n));
+    buffer_.insert(buffer_.end(), v.begin(), v.begin() + n);
+    return *this;
+}
+
+FrameWriter& FrameWriter::Bytes(const uint8_t* data, size_t length) {
+    U32(static_cast<uint32_t>(length));
+    buffer_.insert(buffer_.end(), data, data + length);
+    return *this;
+}
+
+std::vector<uint8_t> FrameWriter::Finish() {
+    uint32_t length = static_cast<uint32_t>(buffer_.size() - 4);
+    for (size_t i = 0; i < 4; i++) buffer_[i] = static_cast<uint8_t>(length >> (8 * i));
+    return std::move(buffer_);
+}
+
+// MARK: - FrameReader
+
+bool FrameReader::Take(void* out, size_t n) {
+    if (!ok_ || length_ - pos_ < n) {
+        ok_ = false;
+        return false;
+    }
+    std::memcpy(out, data_ + pos_, n);
+    pos_ += n;
+    return true;
+}
+
+bool FrameReader::U8(uint8_t& v) { return Take(&v, 1); }
+
+bool FrameReader::U16(uint16_t& v) {
+    uint8_t b[2];
+    if (!Take(b, 2)) return false;
+    v = LoadLE<uint16_t>(b);
+    return true;
+}
+
+bool FrameReader::U32(uint32_t& v) {
+    uint8_t b[4];
+    if (!Take(b, 4)) return false;
+    v = LoadLE<uint32_t>(b);
+    return true;
+}
+
+bool FrameReader::I32(int32_t& v) {
+    uint32_t u;
+    if (!U32(u)) return false;
+    v = static_cast<int32_t>(u);
+    return true;
+}
+
+bool FrameReader::U64(uint64_t& v) {
+    uint8_t b[8];
+    if (!Take(b, 8)) return false;
+    v = LoadLE<uint64_t>(b);
+    return true;
+}
+
+bool FrameReader::I64(int64_t& v) {
+    uint64_t u;
+    if (!U64(u)) return false;
+    v = static_cast<int64_t>(u);
+    return true;
+}
+
+bool FrameReader::Str(std::string& v) {
+    uint16_t n;
+    if (!U16(n)) return false;
+    if (length_ - pos_ < n) {
+        ok_ = false;
+        return false;
+    }
+    v.assign(reinterpret_cast<const char*>(data_ + pos_), n);
+    pos_ += n;
+    return true;
+}
+
+bool FrameReader::Bytes(std::vector<uint8_t>& v) {
+    uint32_t n;
+    if (!U32(n)) return false;
+    if (length_ - pos_ < n) {
+        ok_ = false;
+        return false;
+    }
+    v.assign(data_ + pos_, data_ + pos_ + n);
+    pos_ += n;
+    return true;
+}
+
+// MARK: - Stream
+
+bool ReadFrame(LocalStream& stream, BrokerMessage& type, std::vector<uint8_t>& body) {
+    uint8_t header[5];
+    if (!stream.ReadAll(header, sizeof(header))) return false;
+    uint32_t length = LoadLE<uint32_t>(header);
+    if (length < 1 || length > kBrokerMaxFrame) return false;
+    type = static_cast<BrokerMessage>(header[4]);
+    body.resize(length - 1);
+    return body.empty() || stream.ReadAll(body.data(), body.size());
+}
+
+} // namespace pod_connector
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pod_connector {
+
+class LocalStream;
+
+/// Version exchanged in kHello / kWelcome; a mismatch closes the connection.
+constexpr uint32_t kBrokerProtocolVersion = 1;
+
+/// Largest frame either side accepts (an inline file payload plus headers).
+constexpr size_t kBrokerMaxFrame = 64 * 1024 * 1024;
+
+/// Frame types of the broker protocol. Every frame on the socket / pipe is
+/// `[u32 length][u8 type][body]`, where length counts the type byte and the
+/// body. Integers are little endian; strings are `[u16 length][bytes]` and
+/// byte arrays `[u32 length][bytes]`.
+enum class BrokerMessage : uint8_t {
+    // Client -> broker
+    kHello = 0x01,          // [u32 version][u32 subscriptions][str clientName]
+    kRequest = 0x02,        // [u32 requestId][u8 BrokerCommand][arguments]
+    kSubscribe = 0x03,      // [u32 subscriptions]
+    kRelease = 0x04,        // [u32 slot][u32 generation] shared payload consumed
+
+    // Broker -> client
+    kWelcome = 0x81,        // [u32 version][u32 clientId][str sharedMemoryName][u64 sharedMemorySize]
+    kReply = 0x82,          // [u32 requestId][u8 ok][str error]
+    kStatus = 0x83,         // [str status]
+    kScanResult = 0x84,     // [str name][str id][i32 rssi]
+    kPayload = 0x85,        // [bytes payload] sent inline
+    kPayloadRef = 0x86,     // [u32 slot][u32 generation][u64 offset][u32 length][u32 crc32c]
+    kDropped = 0x87,        // [u32 count] live events dropped for this client since the last notice
+};
+
+/// Requests a client can make, mirroring the method-channel commands.
+/// Arguments follow the command byte in the kRequest body.
+enum class BrokerCommand : uint8_t {
+    kStartScan = 1,             // -
+    kStopScan = 2,              // -
+    kConnect = 3,               // [str deviceId]
+    kDisconnect = 4,            // -
+    kWriteCommand = 5,          // [bytes command]
+    kDownloadFile = 6,          // [str filename][i64 start][i64 end]
+    kDownloadFiles = 7,         // [u32 count][str filename]...[i64 start][i64 end][u32 window]
+    kAcknowledgeBatchFile = 8,  // [u32 index]
+    kCancelDownload = 9,        // -
+};
+
+/// Event streams a client receives (kHello / kSubscribe bit mask).
+enum BrokerSubscription : uint32_t {
+    kSubscribeStatus = 0x01,
+    kSubscribeScan = 0x02,
+    kSubscribeLive = 0x04,      // Payloads of type 0x01 and 0xDC
+    kSubscribeFiles = 0x08,     // Every other payload (file list, 0x03 data, 0xDA / 0xDB, settings)
+    kSubscribeAll = 0x0F,
+};
+
+/// Stream a payload belongs to, from its message type byte.
+BrokerSubscription PayloadSubscription(const uint8_t* payload, size_t length);
+
+/// Builds one frame. Finish() fills in the length prefix.
+class FrameWriter {
+public:
+    explicit FrameWriter(BrokerMessage type);
+
+    FrameWriter& U8(uint8_t v);
+    FrameWriter& U16(uint16_t v);
+    FrameWriter& U32(uint32_t v);
+    FrameWriter& I32(int32_t v);
+    FrameWriter& U64(uint64_t v);
+    FrameWriter& I64(int64_t v);
+    FrameWriter& Str(const std::string& v);     // Truncated to 65535 bytes
+    FrameWriter& Bytes(const uint8_t* data, size_t length);
+    FrameWriter& Bytes(const std::vector<uint8_t>& v) { return Bytes(v.data(), v.size()); }
+
+    std::vector<uint8_t> Finish();
+
+private:
+    std::vector<uint8_t> buffer_;
+};
+
+/// Reads a frame body. Every accessor returns false (and keeps failing) once
+/// the body is exhausted, so a sequence of reads can be checked once.
+class FrameReader {
+public:
+    FrameReader(const uint8_t* data, size_t length) : data_(data), length_(length) {}
+    explicit FrameReader(const std::vector<uint8_t>& body) : FrameReader(body.data(), body.size()) {}
+
+    bool U8(uint8_t& v);
+    bool U16(uint16_t& v);
+    bool U32(uint32_t& v);
+    bool I32(int32_t& v);
+    bool U64(uint64_t& v);
+    bool I64(int64_t& v);
+    bool Str(std::string& v);
+    bool Bytes(std::vector<uint8_t>& v);
+
+    bool ok() const { return ok_; }
+
+private:
+    bool Take(void* out, size_t n);
+
+    const uint8_t* data_;
+    size_t length_;
+    size_t pos_ = 0;
+    bool ok_ = true;
+};
+
+/// Reads one frame. Returns false on end of stream, a read error or a frame
+/// larger than kBrokerMaxFrame.
+bool ReadFrame(LocalStream& stream, BrokerMessage& type, std::vector<uint8_t>& body);
+
+} // namespace pod_connector
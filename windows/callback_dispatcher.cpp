@@ -0,0 +1,182 @@
+#include "callback_dispatcher.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace pod_connector {
+
+// MARK: - CallbackDispatcher
+
+CallbackDispatcher::CallbackDispatcher(size_t capacity)
+    : capacity_(std::max<size_t>(capacity, 1)) {}
+
+bool CallbackDispatcher::Post(Task task) {
+    return Enqueue(std::move(task), std::chrono::milliseconds(0));
+}
+
+bool CallbackDispatcher::PostWait(Task task, std::chrono::milliseconds timeout) {
+    return Enqueue(std::move(task), timeout);
+}
+
+bool CallbackDispatcher::Enqueue(Task task, std::chrono::milliseconds timeout) {
+    bool wake = false;
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (!shut_down_ && queue_.size() >= capacity_ && timeout.count() > 0 &&
+            std::this_thread::get_id() != consumer_thread_) {
+            stats_.waited++;
+            space_cv_.wait_for(lock, timeout, [this] { return shut_down_ || queue_.size() < capacity_; });
+        }
+        if (shut_down_ || queue_.size() >= capacity_) {
+            stats_.rejected++;
+            return false;
+        }
+        queue_.push_back(std::move(task));
+        stats_.high_water = std::max(stats_.high_water, queue_.size());
+        if (!wake_pending_) {
+            wake_pending_ = true;
+            wake = true;
+        }
+    }
+    if (wake) Wake();
+    return true;
+}
+
+size_t CallbackDispatcher::Drain() {
+    // Swap-under-lock: the mutex is not held while callbacks run
+    std::deque<Task> batch;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        wake_pending_ = false;
+        std::swap(queue_, batch);
+    }
+    space_cv_.notify_all();
+
+    for (auto& fn : batch) {
+        try { fn(); } catch (...) {}
+    }
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    stats_.dispatched += batch.size();
+    return batch.size();
+}
+
+void CallbackDispatcher::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        shut_down_ = true;
+    }
+    space_cv_.notify_all();
+}
+
+DispatcherStats CallbackDispatcher::Stats() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    DispatcherStats stats = stats_;
+    stats.pending = queue_.size();
+    return stats;
+}
+
+void CallbackDispatcher::SetConsumerThread(std::thread::id id) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    consumer_thread_ = id;
+}
+
+// MARK: - ThreadDispatcher
+
+ThreadDispatcher::ThreadDispatcher(size_t capacity) : CallbackDispatcher(capacity) {
+    thread_ = std::thread([this]() {
+        while (true) {
+            bool stop;
+            {
+                std::unique_lock<std::mutex> lock(wake_mtx_);
+                wake_cv_.wait(lock, [this] { return signalled_ || stopping_; });
+                signalled_ = false;
+                stop = stopping_;
+            }
+            Drain();
+            if (stop) return;
+        }
+    });
+    SetConsumerThread(thread_.get_id());
+}
+
+ThreadDispatcher::~ThreadDispatcher() {
+    Shutdown();
+    {
+        std::lock_guard<std::mutex> lock(wake_mtx_);
+        stopping_ = true;
+    }
+    wake_cv_.notify_one();
+    if (thread_.joinable()) thread_.join();
+}
+
+void ThreadDispatcher::Wake() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mtx_);
+        signalled_ = true;
+    }
+    wake_cv_.notify_one();
+}
+
+// MARK: - MessageWindowDispatcher
+
+#ifdef _WIN32
+
+namespace {
+
+constexpr wchar_t kWindowClass[] = L"PodConnectorCallbackDispatcher";
+
+// The plugin is a DLL: register the window class against its own module
+HINSTANCE ModuleInstance() {
+    HMODULE module = nullptr;
+    GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                       reinterpret_cast<LPCWSTR>(&ModuleInstance), &module);
+    return module;
+}
+
+}  // namespace
+
+MessageWindowDispatcher::MessageWindowDispatcher(size_t capacity) : CallbackDispatcher(capacity) {
+    static std::once_flag registered;
+    HINSTANCE instance = ModuleInstance();
+    std::call_once(registered, [instance]() {
+        WNDCLASSEXW wc{};
+        wc.cbSize = sizeof(wc);
+        wc.lpfnWndProc = &MessageWindowDispatcher::WindowProc;
+        wc.hInstance = instance;
+        wc.lpszClassName = kWindowClass;
+        RegisterClassExW(&wc);
+    });
+
+    hwnd_ = CreateWindowExW(0, kWindowClass, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, instance, nullptr);
+    if (hwnd_ != nullptr) {
+        SetWindowLongPtrW(hwnd_, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
+        SetConsumerThread(std::this_thread::get_id());
+    }
+}
+
+MessageWindowDispatcher::~MessageWindowDispatcher() {
+    Shutdown();
+    if (hwnd_ != nullptr) {
+        SetWindowLongPtrW(hwnd_, GWLP_USERDATA, 0);
+        DestroyWindow(hwnd_);
+        hwnd_ = nullptr;
+    }
+}
+
+void MessageWindowDispatcher::Wake() {
+    if (hwnd_ != nullptr) PostMessageW(hwnd_, kDrainMessage, 0, 0);
+}
+
+LRESULT CALLBACK MessageWindowDispatcher::WindowProc(HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam) {
+    if (message == kDrainMessage) {
+        auto* self = reinterpret_cast<MessageWindowDispatcher*>(GetWindowLongPtrW(hwnd, GWLP_USERDATA));
+        if (self != nullptr) self->Drain();
+        return 0;
+    }
+    return DefWindowProcW(hwnd, message, wparam, lparam);
+}
+
+#endif
+
+} // namespace pod_connector
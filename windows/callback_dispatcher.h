@@ -0,0 +1,136 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace pod_connector {
+
+struct DispatcherStats {
+    size_t pending = 0;
+    size_t high_water = 0;      // Deepest the queue has been
+    uint64_t dispatched = 0;
+    uint64_t waited = 0;        // Posts that blocked for space
+    uint64_t rejected = 0;      // Posts refused (queue full past the timeout, or shut down)
+};
+
+/// Ordered hand-off of callbacks from BLE threads to one consumer thread.
+///
+/// Tasks run one at a time, in the order they were accepted, on whichever
+/// thread calls Drain(); subclasses decide which thread that is and how it is
+/// woken. Wake-ups are coalesced: one per batch, not one per task.
+///
+/// The queue is bounded. Post() refuses a task when it is full; PostWait()
+/// blocks the producer until space frees up, which pushes back on the BLE
+/// thread instead of growing without limit. PostWait() never blocks on the
+/// consumer thread itself, where waiting would deadlock.
+///
+/// The plugin only Post()s ChannelQueues drain tasks, at most one pending at
+/// a time; the per-channel policies decide what is kept. PostWait() and the
+/// waited counter serve other embedders and the dispatcher harness.
+class CallbackDispatcher {
+public:
+    using Task = std::function<void()>;
+
+    static constexpr size_t kDefaultCapacity = 4096;
+
+    explicit CallbackDispatcher(size_t capacity = kDefaultCapacity);
+    virtual ~CallbackDispatcher() = default;
+
+    CallbackDispatcher(const CallbackDispatcher&) = delete;
+    CallbackDispatcher& operator=(const CallbackDispatcher&) = delete;
+
+    /// Queues [task] without blocking. Returns false if the queue is full or
+    /// the dispatcher has shut down.
+    bool Post(Task task);
+
+    /// Queues [task], waiting up to [timeout] for space.
+    bool PostWait(Task task, std::chrono::milliseconds timeout);
+
+    /// Runs every queued task on the calling thread. Returns how many ran.
+    size_t Drain();
+
+    /// Refuses further tasks and releases blocked producers. Already queued
+    /// tasks still run on the next Drain().
+    void Shutdown();
+
+    DispatcherStats Stats() const;
+    size_t Capacity() const { return capacity_; }
+
+protected:
+    /// Asks the consumer thread to call Drain().
+    virtual void Wake() = 0;
+
+    /// Thread that drains the queue (PostWait does not block there).
+    void SetConsumerThread(std::thread::id id);
+
+private:
+    bool Enqueue(Task task, std::chrono::milliseconds timeout);
+
+    mutable std::mutex mtx_;
+    std::condition_variable space_cv_;
+    std::deque<Task> queue_;
+    size_t capacity_;
+    bool shut_down_ = false;
+    bool wake_pending_ = false;
+    std::thread::id consumer_thread_;
+    DispatcherStats stats_;
+};
+
+/// Drains on a dedicated thread. Works without any window or message loop,
+/// e.g. for headless runners; callbacks then run on that thread instead of
+/// the platform thread.
+class ThreadDispatcher : public CallbackDispatcher {
+public:
+    explicit ThreadDispatcher(size_t capacity = kDefaultCapacity);
+
+    /// Runs whatever is still queued, then joins the thread.
+    ~ThreadDispatcher() override;
+
+protected:
+    void Wake() override;
+
+private:
+    std::mutex wake_mtx_;
+    std::condition_variable wake_cv_;
+    bool signalled_ = false;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+#ifdef _WIN32
+/// Drains on the thread that created it (the Flutter platform thread) via a
+/// message-only window. Needs that thread's message loop, but no Flutter view
+/// or top-level window, so it serves any number of views or none.
+class MessageWindowDispatcher : public CallbackDispatcher {
+public:
+    explicit MessageWindowDispatcher(size_t capacity = kDefaultCapacity);
+    ~MessageWindowDispatcher() override;
+
+    /// False if the window could not be created.
+    bool IsValid() const { return hwnd_ != nullptr; }
+
+protected:
+    void Wake() override;
+
+private:
+    static constexpr UINT kDrainMessage = WM_APP + 0x504F;  // "PO" for Pod
+    HWND hwnd_ = nullptr;
+
+    static LRESULT CALLBACK WindowProc(HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam);
+};
+#endif
+
+} // namespace pod_connector
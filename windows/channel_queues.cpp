@@ -0,0 +1,266 @@
+#include "channel_queues.h"
+
+#include <algorithm>
+#include <system_error>
+#include <utility>
+
+namespace pod_connector {
+
+const char* OverflowPolicyName(OverflowPolicy policy) {
+    switch (policy) {
+        case OverflowPolicy::kDropOldest: return "dropOldest";
+        case OverflowPolicy::kCoalesce: return "coalesce";
+        case OverflowPolicy::kSpillToDisk: return "spillToDisk";
+        case OverflowPolicy::kKeepAll: return "keepAll";
+    }
+    return "unknown";
+}
+
+// MARK: - Setup
+
+ChannelQueues::ChannelQueues(WakeFn wake) : wake_(std::move(wake)) {}
+
+ChannelQueues::~ChannelQueues() {
+    for (auto& channel : channels_) {
+        if (channel->spill_path.empty()) continue;
+        channel->spill_out.close();
+        channel->spill_in.close();
+        std::error_code ec;
+        std::filesystem::remove(channel->spill_path, ec);
+    }
+}
+
+size_t ChannelQueues::AddChannel(std::string name, OverflowPolicy policy, size_t capacity) {
+    auto channel = std::make_unique<Channel>();
+    channel->stats.name = std::move(name);
+    channel->stats.policy = policy;
+    channel->stats.capacity = policy == OverflowPolicy::kKeepAll ? 0 : std::max<size_t>(capacity, 1);
+    std::lock_guard<std::mutex> lock(mtx_);
+    channels_.push_back(std::move(channel));
+    return channels_.size() - 1;
+}
+
+size_t ChannelQueues::AddSpillChannel(std::string name, size_t memoryBudget,
+                                      std::filesystem::path spillPath, PayloadSink sink) {
+    auto channel = std::make_unique<Channel>();
+    channel->stats.name = std::move(name);
+    channel->stats.policy = OverflowPolicy::kSpillToDisk;
+    channel->stats.memory_budget = memoryBudget;
+    channel->spill_path = std::move(spillPath);
+    channel->sink = std::move(sink);
+    std::lock_guard<std::mutex> lock(mtx_);
+    channels_.push_back(std::move(channel));
+    return channels_.size() - 1;
+}
+
+// MARK: - Producers
+
+void ChannelQueues::Push(size_t channel, Task task, const std::string& key) {
+    Entry entry;
+    entry.key = key;
+    entry.task = std::move(task);
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (channel >= channels_.size()) return;
+    Enqueue(*channels_[channel], std::move(entry));
+    WakeIfNeeded(lock);
+}
+
+void ChannelQueues::PushPayload(size_t channel, std::vector<uint8_t> payload) {
+    Entry entry;
+    entry.payload = std::move(payload);
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (channel >= channels_.size()) return;
+    Enqueue(*channels_[channel], std::move(entry));
+    WakeIfNeeded(lock);
+}
+
+void ChannelQueues::Enqueue(Channel& channel, Entry entry) {
+    auto& stats = channel.stats;
+    auto& entries = channel.entries;
+    entry.seq = next_seq_++;
+    stats.accepted++;
+
+    switch (stats.policy) {
+        case OverflowPolicy::kCoalesce:
+            if (!entry.key.empty()) {
+                auto it = std::find_if(entries.begin(), entries.end(),
+                                       [&](const Entry& e) { return e.key == entry.key; });
+                if (it != entries.end()) {
+                    entries.erase(it);
+                    stats.coalesced++;
+                    pending_--;
+                }
+            }
+            if (entries.size() >= stats.capacity) {
+                // Only keyed entries are evictable; unkeyed ones are never dropped
+                auto it = std::find_if(entries.begin(), entries.end(),
+                                       [](const Entry& e) { return !e.key.empty(); });
+                if (it != entries.end()) {
+                    entries.erase(it);
+                    stats.dropped++;
+                    pending_--;
+                }
+            }
+            break;
+        case OverflowPolicy::kDropOldest:
+            if (entries.size() >= stats.capacity) {
+                entries.pop_front();
+                stats.dropped++;
+                pending_--;
+            }
+            break;
+        case OverflowPolicy::kSpillToDisk:
+            if (stats.memory_bytes + entry.payload.size() > stats.memory_budget && Spill(channel, entry)) break;
+            stats.memory_bytes += entry.payload.size();
+            break;
+        case OverflowPolicy::kKeepAll:
+            break;
+    }
+
+    entries.push_back(std::move(entry));
+    pending_++;
+    stats.high_water = std::max(stats.high_water, entries.size());
+}
+
+bool ChannelQueues::Spill(Channel& channel, Entry& entry) {
+    // The stream is only closed while nothing spilled is pending, so
+    // reopening it truncated never loses data
+    if (!channel.spill_out.is_open()) {
+        channel.spill_out.open(channel.spill_path, std::ios::binary | std::ios::trunc);
+        channel.spill_end = 0;
+        if (!channel.spill_out) {
+            channel.spill_out.close();
+            channel.stats.spill_errors++;
+            return false;
+        }
+    }
+
+    // Flushed before the entry is visible, so the consumer's read handle sees it
+    channel.spill_out.write(reinterpret_cast<const char*>(entry.payload.data()),
+                            static_cast<std::streamsize>(entry.payload.size()));
+    channel.spill_out.flush();
+    if (!channel.spill_out) {
+        // Overwrite the partial write next time; keep this payload in memory
+        channel.spill_out.clear();
+        channel.spill_out.seekp(static_cast<std::streamoff>(channel.spill_end));
+        channel.stats.spill_errors++;
+        return false;
+    }
+
+    entry.spilled = true;
+    entry.offset = channel.spill_end;
+    entry.length = entry.payload.size();
+    std::vector<uint8_t>().swap(entry.payload);
+    channel.spill_end += entry.length;
+    channel.spilled_pending++;
+    channel.stats.spilled++;
+    channel.stats.spill_bytes += entry.length;
+    return true;
+}
+
+void ChannelQueues::WakeIfNeeded(std::unique_lock<std::mutex>& lock) {
+    if (pending_ == 0 || wake_pending_) return;
+    wake_pending_ = true;
+    lock.unlock();
+    if (wake_ && wake_()) return;
+    // Not scheduled: let the next push try again
+    lock.lock();
+    wake_pending_ = false;
+    lock.unlock();
+}
+
+// MARK: - Consumer
+
+size_t ChannelQueues::Drain() {
+    size_t budget;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        wake_pending_ = false;
+        budget = pending_;
+    }
+
+    size_t ran = 0;
+    while (ran < budget) {
+        Entry entry;
+        Channel* from = nullptr;
+        {
+            // Oldest entry across all channels; the lock is not held while it runs
+            std::lock_guard<std::mutex> lock(mtx_);
+            for (auto& channel : channels_) {
+                ResetSpillIfIdle(*channel);
+                if (channel->entries.empty()) continue;
+                if (from == nullptr || channel->entries.front().seq < from->entries.front().seq) {
+                    from = channel.get();
+                }
+            }
+            if (from == nullptr) break;
+            entry = std::move(from->entries.front());
+            from->entries.pop_front();
+            pending_--;
+            if (entry.spilled) {
+                from->stats.spill_bytes -= entry.length;
+                from->spilled_pending--;
+            } else {
+                from->stats.memory_bytes -= entry.payload.size();
+            }
+        }
+
+        bool readable = !entry.spilled || ReadSpilled(*from, entry);
+        if (readable) {
+            try {
+                if (entry.task) {
+                    entry.task();
+                } else if (from->sink) {
+                    from->sink(std::move(entry.payload));
+                }
+            } catch (...) {}
+        }
+        ran++;
+
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (readable) {
+            from->stats.delivered++;
+        } else {
+            from->stats.spill_errors++;
+            from->stats.dropped++;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    for (auto& channel : channels_) ResetSpillIfIdle(*channel);
+    WakeIfNeeded(lock);
+    return ran;
+}
+
+bool ChannelQueues::ReadSpilled(Channel& channel, Entry& entry) {
+    auto& in = channel.spill_in;
+    if (!in.is_open()) in.open(channel.spill_path, std::ios::binary);
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(entry.offset));
+    entry.payload.resize(entry.length);
+    in.read(reinterpret_cast<char*>(entry.payload.data()), static_cast<std::streamsize>(entry.length));
+    return static_cast<bool>(in);
+}
+
+void ChannelQueues::ResetSpillIfIdle(Channel& channel) {
+    // Consumer thread only, under mtx_: the read handle is not in use
+    if (channel.spilled_pending != 0 || channel.spill_end == 0) return;
+    channel.spill_in.close();
+    channel.spill_out.close();
+    channel.spill_out.open(channel.spill_path, std::ios::binary | std::ios::trunc);
+    channel.spill_out.close();
+    channel.spill_end = 0;
+}
+
+std::vector<ChannelStats> ChannelQueues::Stats() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::vector<ChannelStats> out;
+    out.reserve(channels_.size());
+    for (const auto& channel : channels_) {
+        out.push_back(channel->stats);
+        out.back().pending = channel->entries.size();
+    }
+    return out;
+}
+
+} // namespace pod_connector
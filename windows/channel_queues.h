@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pod_connector {
+
+enum class OverflowPolicy {
+    kDropOldest,    // A full queue discards its oldest entry (live telemetry, scan results)
+    kCoalesce,      // A keyed entry replaces the pending one with the same key; unkeyed ones never drop (status)
+    kSpillToDisk,   // Never drops or blocks: entries past the memory budget go to a file (payloads)
+    kKeepAll,       // Never drops or blocks, unbounded (method replies)
+};
+
+const char* OverflowPolicyName(OverflowPolicy policy);
+
+struct ChannelStats {
+    std::string name;
+    OverflowPolicy policy = OverflowPolicy::kDropOldest;
+    size_t capacity = 0;        // Entries (0 = unbounded: kSpillToDisk, kKeepAll)
+    size_t memory_budget = 0;   // Payload bytes kept in memory (kSpillToDisk only)
+    size_t pending = 0;
+    size_t high_water = 0;      // Deepest the queue has been
+    uint64_t accepted = 0;
+    uint64_t delivered = 0;
+    uint64_t dropped = 0;       // Discarded to make room, or unreadable from the spill file
+    uint64_t coalesced = 0;     // Replaced by a newer entry with the same key
+    uint64_t spilled = 0;       // Written to the spill file
+    uint64_t spill_errors = 0;  // Spill writes or reads that failed
+    size_t memory_bytes = 0;    // Payload bytes pending in memory
+    size_t spill_bytes = 0;     // Payload bytes pending in the spill file
+};
+
+/// Bounded per-channel queues in front of one consumer thread.
+///
+/// Each event channel gets its own queue and overflow policy, so a burst on
+/// one of them (a scan storm, the live stream while the UI thread is stalled)
+/// can neither grow memory without limit nor push the others out. Producers
+/// never block. Drain() delivers the entries of all channels in the order
+/// they were pushed; a coalesced entry moves to the position of the newer
+/// push, so a progress update never overtakes what was queued before it.
+///
+/// Channels are added before the first Push and live as long as the queues.
+class ChannelQueues {
+public:
+    using Task = std::function<void()>;
+    using PayloadSink = std::function<void(std::vector<uint8_t>)>;
+
+    /// Asks the consumer thread to call Drain(). Returns false if the request
+    /// could not be queued; the next Push asks again.
+    using WakeFn = std::function<bool()>;
+
+    explicit ChannelQueues(WakeFn wake);
+
+    /// Deletes the spill files.
+    ~ChannelQueues();
+
+    ChannelQueues(const ChannelQueues&) = delete;
+    ChannelQueues& operator=(const ChannelQueues&) = delete;
+
+    /// Adds a kDropOldest or kCoalesce channel holding up to [capacity]
+    /// entries, or a kKeepAll channel, which ignores [capacity].
+    size_t AddChannel(std::string name, OverflowPolicy policy, size_t capacity);
+
+    /// Adds a kSpillToDisk channel. Payloads beyond [memoryBudget] pending
+    /// bytes are appended to [spillPath] and read back when delivered to
+    /// [sink]. The file is truncated whenever nothing spilled is pending.
+    size_t AddSpillChannel(std::string name, size_t memoryBudget,
+                           std::filesystem::path spillPath, PayloadSink sink);
+
+    /// Queues [task]. On a kCoalesce channel a non-empty [key] replaces the
+    /// pending entry with the same key. A full kCoalesce channel drops its
+    /// oldest keyed entry; with none pending it grows past [capacity], so
+    /// unkeyed entries are never dropped.
+    void Push(size_t channel, Task task, const std::string& key = {});
+
+    /// Queues [payload] on a kSpillToDisk channel.
+    void PushPayload(size_t channel, std::vector<uint8_t> payload);
+
+    /// Delivers the entries pending when called, oldest first, on the calling
+    /// thread. Anything pushed meanwhile waits for the next wake, so a fast
+    /// producer cannot hold the consumer here. Returns how many ran.
+    size_t Drain();
+
+    std::vector<ChannelStats> Stats() const;
+
+private:
+    struct Entry {
+        uint64_t seq = 0;
+        std::string key;
+        Task task;
+        std::vector<uint8_t> payload;
+        bool spilled = false;
+        uint64_t offset = 0;    // Position in the spill file
+        size_t length = 0;
+    };
+
+    struct Channel {
+        ChannelStats stats;
+        std::deque<Entry> entries;
+        PayloadSink sink;
+        std::filesystem::path spill_path;
+        std::ofstream spill_out;    // Appended under mtx_
+        std::ifstream spill_in;     // Read by the consumer only
+        uint64_t spill_end = 0;
+        size_t spilled_pending = 0;
+    };
+
+    void Enqueue(Channel& channel, Entry entry);
+    bool Spill(Channel& channel, Entry& entry);
+    bool ReadSpilled(Channel& channel, Entry& entry);
+    void ResetSpillIfIdle(Channel& channel);
+    void WakeIfNeeded(std::unique_lock<std::mutex>& lock);
+
+    mutable std::mutex mtx_;
+    std::vector<std::unique_ptr<Channel>> channels_;
+    WakeFn wake_;
+    uint64_t next_seq_ = 0;
+    size_t pending_ = 0;
+    bool wake_pending_ = false;
+};
+
+} // namespace pod_connector
@@ -0,0 +1,157 @@
+#include "core_scheduler.h"
+
+#include <utility>
+
+namespace pod_connector {
+
+// MARK: - ThreadScheduler
+
+ThreadScheduler::ThreadScheduler()
+    : thread_(&ThreadScheduler::Run, state_), thread_id_(thread_.get_id()) {}
+
+ThreadScheduler::~ThreadScheduler() {
+    detail::TaskQueue tasks;
+    std::vector<Task> posted;
+    {
+        std::lock_guard<std::mutex> lock(state_->mtx);
+        state_->stopping = true;
+        std::swap(tasks, state_->tasks);
+        std::swap(posted, state_->posted);
+    }
+    // Dropped outside the lock: a capture's destructor may post again
+    tasks = {};
+    posted.clear();
+    state_->cv.notify_all();
+    if (thread_.get_id() == std::this_thread::get_id()) {
+        thread_.detach();
+    } else if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ThreadScheduler::After(Clock::duration delay, Task task) {
+    if (delay <= Clock::duration::zero()) {
+        Post(std::move(task));
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(state_->mtx);
+        if (state_->stopping) return;   // [task] is dropped once the lock is released
+        state_->tasks.push({Clock::now() + delay, state_->next_order++, std::move(task)});
+    }
+    state_->cv.notify_all();
+}
+
+void ThreadScheduler::Post(Task task) {
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(state_->mtx);
+        if (state_->stopping) return;   // [task] is dropped once the lock is released
+        // The thread only sleeps with nothing posted, so only the first post wakes it
+        wake = state_->posted.empty();
+        state_->posted.push_back(std::move(task));
+    }
+    if (wake) state_->cv.notify_all();
+}
+
+void ThreadScheduler::Run(std::shared_ptr<State> state) {
+    // Swapped with state->posted, so both vectors keep their capacity
+    std::vector<Task> batch;
+    std::unique_lock<std::mutex> lock(state->mtx);
+    while (!state->stopping) {
+        bool timerDue = !state->tasks.empty() && state->tasks.top().due <= Clock::now();
+        if (timerDue) {
+            auto task = std::move(const_cast<detail::ScheduledTask&>(state->tasks.top()).task);
+            state->tasks.pop();
+            lock.unlock();
+            task();
+            // Captures are released before the next wait, not when the queue goes
+            task = nullptr;
+            lock.lock();
+            continue;
+        }
+        if (!state->posted.empty()) {
+            batch.swap(state->posted);
+            lock.unlock();
+            for (auto& task : batch) {
+                if (state->stopping.load()) break;
+                task();
+                task = nullptr;
+            }
+            batch.clear();
+            lock.lock();
+            continue;
+        }
+        if (state->tasks.empty()) {
+            state->cv.wait(lock);
+        } else {
+            // By value: the heap may be cleared while we wait
+            auto due = state->tasks.top().due;
+            state->cv.wait_until(lock, due);
+        }
+    }
+}
+
+// MARK: - VirtualScheduler
+
+VirtualScheduler::VirtualScheduler(Clock::time_point start) : now_(start) {}
+
+CoreScheduler::Clock::time_point VirtualScheduler::Now() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return now_;
+}
+
+void VirtualScheduler::After(Clock::duration delay, Task task) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (delay < Clock::duration::zero()) delay = Clock::duration::zero();
+    tasks_.push({now_ + delay, next_order_++, std::move(task)});
+}
+
+bool VirtualScheduler::IsCurrent() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return running_on_ == std::thread::id{} || running_on_ == std::this_thread::get_id();
+}
+
+bool VirtualScheduler::RunNext(Clock::time_point until) {
+    Task task;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (tasks_.empty() || tasks_.top().due > until) return false;
+        const auto& next = tasks_.top();
+        if (next.due > now_) now_ = next.due;
+        task = std::move(const_cast<detail::ScheduledTask&>(next).task);
+        tasks_.pop();
+        executed_++;
+        running_on_ = std::this_thread::get_id();
+    }
+    task();
+    std::lock_guard<std::mutex> lock(mtx_);
+    running_on_ = {};
+    return true;
+}
+
+size_t VirtualScheduler::RunUntil(Clock::time_point until) {
+    size_t ran = 0;
+    while (RunNext(until)) ran++;
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (until > now_) now_ = until;
+    return ran;
+}
+
+size_t VirtualScheduler::RunUntilIdle(size_t limit) {
+    size_t ran = 0;
+    while (ran < limit && RunNext(Clock::time_point::max())) ran++;
+    return ran;
+}
+
+size_t VirtualScheduler::Pending() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return tasks_.size();
+}
+
+uint64_t VirtualScheduler::Executed() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return executed_;
+}
+
+} // namespace pod_connector
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace pod_connector {
+
+/// Clock, timers and strand for the native core. Everything in PodBLECore
+/// that sleeps, polls or reads the time goes through one of these, so the
+/// same code runs on real time (ThreadScheduler) or on a virtual clock
+/// (VirtualScheduler) for deterministic replay.
+///
+/// A scheduler runs one task at a time, so it doubles as the core's strand:
+/// state that is only touched from its tasks needs no locks.
+class CoreScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Task = std::function<void()>;
+
+    virtual ~CoreScheduler() = default;
+
+    virtual Clock::time_point Now() = 0;
+
+    /// Runs [task] once, [delay] from now. Never runs it inline. Tasks that
+    /// are due at the same time run in the order they were scheduled.
+    virtual void After(Clock::duration delay, Task task) = 0;
+
+    /// Runs [task] as soon as the strand is free, after everything posted
+    /// (or scheduled with no delay) before it. Never runs it inline.
+    virtual void Post(Task task) { After(Clock::duration::zero(), std::move(task)); }
+
+    /// True on the thread that is running this scheduler's tasks.
+    virtual bool IsCurrent() = 0;
+};
+
+/// Runs [fn] on [scheduler]'s strand and returns its result: inline when
+/// already there, otherwise posted and waited for. Must not be called from a
+/// thread the strand itself is blocked on. Throws std::future_error
+/// (broken_promise) if the scheduler stops and drops [fn] before running it.
+template <typename Fn>
+auto RunOnStrand(CoreScheduler& scheduler, Fn fn) -> decltype(fn()) {
+    if (scheduler.IsCurrent()) return fn();
+    // Owned by the posted task, so dropping it unrun breaks the promise
+    auto task = std::make_shared<std::packaged_task<decltype(fn())()>>(std::move(fn));
+    auto result = task->get_future();
+    scheduler.Post([task = std::move(task)] { (*task)(); });
+    return result.get();
+}
+
+namespace detail {
+
+struct ScheduledTask {
+    CoreScheduler::Clock::time_point due;
+    uint64_t order = 0;
+    CoreScheduler::Task task;
+};
+
+struct LaterFirst {
+    bool operator()(const ScheduledTask& a, const ScheduledTask& b) const {
+        return a.due != b.due ? a.due > b.due : a.order > b.order;
+    }
+};
+
+using TaskQueue = std::priority_queue<ScheduledTask, std::vector<ScheduledTask>, LaterFirst>;
+
+} // namespace detail
+
+/// Real time on the steady clock. One thread runs due timers and posted
+/// tasks in order; a task that blocks holds back the ones due after it.
+/// Posted tasks (and zero-delay timers) skip the timer heap and are taken
+/// off the queue a whole batch per lock, so the strand's side of a
+/// notification flood costs one lock per batch rather than per task.
+/// Timers that fall due go ahead of the next batch, so a flood cannot
+/// starve the watchdog. Destroying the scheduler drops pending tasks (and
+/// any posted while it stops) and waits for a running one, unless it is
+/// destroyed from that task, in which case the thread finishes on its own.
+class ThreadScheduler : public CoreScheduler {
+public:
+    ThreadScheduler();
+    ~ThreadScheduler() override;
+
+    ThreadScheduler(const ThreadScheduler&) = delete;
+    ThreadScheduler& operator=(const ThreadScheduler&) = delete;
+
+    Clock::time_point Now() override { return Clock::now(); }
+    void After(Clock::duration delay, Task task) override;
+    void Post(Task task) override;
+    bool IsCurrent() override { return std::this_thread::get_id() == thread_id_; }
+
+private:
+    // Shared with the timer thread so it can outlive the scheduler
+    struct State {
+        std::mutex mtx;
+        std::condition_variable cv;
+        detail::TaskQueue tasks;
+        std::vector<Task> posted;
+        uint64_t next_order = 0;
+        std::atomic<bool> stopping{false};
+    };
+
+    static void Run(std::shared_ptr<State> state);
+
+    std::shared_ptr<State> state_ = std::make_shared<State>();
+    std::thread thread_;
+    std::thread::id thread_id_;
+};
+
+/// Virtual time for deterministic replay. Nothing runs until the owner
+/// drives it: tasks run on the driving thread in (due, scheduling order)
+/// and the clock jumps straight to the next deadline, so a given input
+/// always produces the same execution, however long it spans. Between runs
+/// the owner's thread is the strand: nothing else can be executing.
+class VirtualScheduler : public CoreScheduler {
+public:
+    explicit VirtualScheduler(Clock::time_point start = Clock::time_point{});
+
+    Clock::time_point Now() override;
+    void After(Clock::duration delay, Task task) override;
+    bool IsCurrent() override;
+
+    /// Runs every task due up to [until] (including ones they schedule),
+    /// then leaves the clock at [until]. Returns how many ran.
+    size_t RunUntil(Clock::time_point until);
+
+    /// Runs until nothing is pending or [limit] tasks ran. Returns how many ran.
+    size_t RunUntilIdle(size_t limit = SIZE_MAX);
+
+    size_t Pending();
+    uint64_t Executed();
+
+private:
+    bool RunNext(Clock::time_point until);
+
+    std::mutex mtx_;
+    Clock::time_point now_;
+    detail::TaskQueue tasks_;
+    uint64_t next_order_ = 0;
+    uint64_t executed_ = 0;
+    std::thread::id running_on_;    // Driving thread while a task runs
+};
+
+} // namespace pod_connector
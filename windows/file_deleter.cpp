@@ -0,0 +1,134 @@
+#include "file_deleter.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace pod_connector {
+
+FileDeleter::FileDeleter(CoreScheduler& scheduler, ReplyMatcher& matcher, std::shared_ptr<std::atomic<bool>> alive,
+                         SendFn send, GateFn gate)
+    : scheduler_(scheduler), matcher_(matcher), alive_(std::move(alive)), send_(std::move(send)),
+      gate_(std::move(gate)) {}
+
+void FileDeleter::Delete(const std::vector<std::string>& files, std::chrono::milliseconds timeout,
+                         DeleteCallback done) {
+    Transaction transaction{{}, timeout, std::move(done)};
+    for (const auto& entry : files) {
+        std::string name(pod_command::FileNameOf(entry));
+        if (!name.empty() && std::find(transaction.names.begin(), transaction.names.end(), name) ==
+                                 transaction.names.end()) {
+            transaction.names.push_back(std::move(name));
+        }
+    }
+    queue_.push_back(std::move(transaction));
+    StartNext();
+}
+
+void FileDeleter::StartNext() {
+    if (active_ || queue_.empty()) return;
+    current_ = std::move(queue_.front());
+    queue_.pop_front();
+    result_ = {};
+
+    Gate gate = gate_ ? gate_() : Gate::kReady;
+    if (gate != Gate::kReady) {
+        result_.busy = gate == Gate::kBusy;
+        result_.remaining = current_.names;
+        auto done = std::move(current_.done);
+        current_ = {};
+        if (done) done(result_);
+        StartNext();
+        return;
+    }
+
+    active_ = true;
+    started_ = scheduler_.Now();
+    deadline_ = started_ + current_.timeout;
+    // Pipelined: the firmware queues the erases, no need to wait between them
+    for (const auto& name : current_.names) send_(pod_command::DeleteFile(name).ToVector());
+    RequestCatalog(generation_);
+}
+
+void FileDeleter::RequestCatalog(uint64_t generation) {
+    if (!active_ || generation != generation_) return;
+    auto now = scheduler_.Now();
+    if (now >= deadline_) {
+        Finish(true);
+        return;
+    }
+    send_(pod_command::GetLogFilesInfo().ToVector());
+    result_.catalog_reads++;
+
+    uint64_t next = ++generation_;
+    auto wait = std::min<CoreScheduler::Clock::duration>(std::chrono::milliseconds(kReaskMs), deadline_ - now);
+    scheduler_.After(wait, [this, alive = alive_, next]() {
+        if (alive->load()) RequestCatalog(next);
+    });
+}
+
+void FileDeleter::OnCatalog(const std::vector<uint8_t>& message) {
+    if (!active_) return;
+    auto catalog = ParseFileCatalog(message);
+    if (!catalog) return;
+
+    result_.has_catalog = true;
+    result_.files_left = static_cast<int>(catalog->size());
+    result_.bytes_left = 0;
+    for (const auto& file : *catalog) result_.bytes_left += file.size;
+    result_.deleted.clear();
+    result_.remaining.clear();
+    for (const auto& name : current_.names) {
+        bool listed = std::any_of(catalog->begin(), catalog->end(),
+                                  [&](const PodFileEntry& file) { return file.name == name; });
+        (listed ? result_.remaining : result_.deleted).push_back(name);
+    }
+    if (result_.remaining.empty()) {
+        Finish(false);
+        return;
+    }
+
+    // Listed before the erases finished: ask again shortly
+    uint64_t next = ++generation_;
+    scheduler_.After(std::chrono::milliseconds(kStaleRetryMs), [this, alive = alive_, next]() {
+        if (alive->load()) RequestCatalog(next);
+    });
+}
+
+void FileDeleter::Finish(bool timedOut) {
+    active_ = false;
+    generation_++;
+
+    result_.timed_out = timedOut;
+    result_.verified = !timedOut;
+    if (!result_.has_catalog) result_.remaining = current_.names;
+    result_.latency_ms = std::chrono::duration<double, std::milli>(scheduler_.Now() - started_).count();
+    // Deletes have no reply of their own; each is timed to the catalog that verified it
+    auto& stats = matcher_.StatsFor(PodOpcode::kDeleteFile);
+    for (size_t i = 0; i < result_.deleted.size(); i++) stats.Add(result_.latency_ms);
+    stats.timeouts += result_.remaining.size();
+
+    auto done = std::move(current_.done);
+    current_ = {};
+    if (done) done(result_);
+    StartNext();
+}
+
+void FileDeleter::Abandon() {
+    if (active_) {
+        active_ = false;
+        generation_++;
+        if (!result_.has_catalog) result_.remaining = current_.names;
+        auto done = std::move(current_.done);
+        current_ = {};
+        if (done) done(result_);
+    }
+    auto queued = std::move(queue_);
+    queue_.clear();
+    for (auto& transaction : queued) {
+        DeleteResult result;
+        result.remaining = transaction.names;
+        if (transaction.done) transaction.done(result);
+    }
+}
+
+} // namespace pod_connector
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "core_scheduler.h"
+#include "pod_commands.h"
+#include "settings_verifier.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pod_connector {
+
+/// Outcome of a batch delete.
+struct DeleteResult {
+    bool verified = false;              // The final catalog lists none of the files
+    bool timed_out = false;
+    bool busy = false;                  // A transfer held the link; nothing was written
+    bool has_catalog = false;           // The fields below come from the pod's last listing
+    std::vector<std::string> deleted;   // Requested and no longer listed
+    std::vector<std::string> remaining; // Requested and still listed
+    int files_left = 0;                 // Everything still on the pod
+    uint64_t bytes_left = 0;
+    int catalog_reads = 0;              // Get Log Files Info requests written
+    double latency_ms = 0;              // First delete → verifying catalog
+};
+using DeleteCallback = std::function<void(const DeleteResult&)>;
+
+/// Batch delete against one pod: writes every Delete File (0x07) back to
+/// back, then one Get Log Files Info (0x05), and checks the listing for the
+/// names. The firmware erases in order and answers the listing after the
+/// erases ahead of it, so one catalog usually settles the whole batch. A
+/// listing that still shows a file is asked again after kStaleRetryMs,
+/// silence after kReaskMs, until the transaction's timeout.
+///
+/// Transactions run one at a time in arrival order. Not thread-safe, like
+/// SettingsVerifier: everything runs on the owner's strand.
+class FileDeleter {
+public:
+    static constexpr int kReaskMs = 1500;
+    static constexpr int kStaleRetryMs = 200;
+
+    using Gate = SettingsVerifier::Gate;
+    using SendFn = SettingsVerifier::SendFn;
+    using GateFn = SettingsVerifier::GateFn;
+
+    /// [send] writes a command (without the 0xAE header) and reports it to
+    /// [matcher].
+    FileDeleter(CoreScheduler& scheduler, ReplyMatcher& matcher, std::shared_ptr<std::atomic<bool>> alive,
+                SendFn send, GateFn gate);
+
+    /// [files] are names or file list entries ("NAME.BIN (12.0 KB)").
+    void Delete(const std::vector<std::string>& files, std::chrono::milliseconds timeout, DeleteCallback done);
+
+    /// Offers a reassembled file list message ([0x02][len][count][entries]).
+    void OnCatalog(const std::vector<uint8_t>& message);
+
+    /// Link gone: the active transaction and everything queued complete
+    /// unverified.
+    void Abandon();
+
+    bool Active() const { return active_; }
+
+private:
+    struct Transaction {
+        std::vector<std::string> names;
+        std::chrono::milliseconds timeout{0};
+        DeleteCallback done;
+    };
+
+    void StartNext();
+    void RequestCatalog(uint64_t generation);
+    void Finish(bool timedOut);
+
+    CoreScheduler& scheduler_;
+    ReplyMatcher& matcher_;
+    std::shared_ptr<std::atomic<bool>> alive_;
+    SendFn send_;
+    GateFn gate_;
+
+    std::deque<Transaction> queue_;
+    Transaction current_;
+    DeleteResult result_;
+    bool active_ = false;
+    uint64_t generation_ = 0;       // Retires the pending re-ask timer
+    CoreScheduler::Clock::time_point started_;
+    CoreScheduler::Clock::time_point deadline_;
+};
+
+} // namespace pod_connector
@@ -0,0 +1,253 @@
+#include "fleet_config.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace pod_connector {
+
+namespace {
+
+double MsBetween(CoreScheduler::Clock::time_point from, CoreScheduler::Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace
+
+FleetConfigJob::FleetConfigJob(std::shared_ptr<CoreScheduler> strand, FleetLinkFactory factory)
+    : strand_(std::move(strand)), factory_(std::move(factory)) {}
+
+FleetConfigJob::~FleetConfigJob() {
+    RunOnStrand(*strand_, [this] {
+        DropConnections();
+        running_ = false;
+    });
+    alive_->store(false);
+}
+
+void FleetConfigJob::Post(std::function<void()> fn) {
+    strand_->Post([alive = alive_, fn = std::move(fn)]() {
+        if (alive->load()) fn();
+    });
+}
+
+bool FleetConfigJob::Start(std::vector<FleetTarget> targets, FleetConfigOptions options, DoneCallback done,
+                           ProgressCallback progress) {
+    return RunOnStrand(*strand_, [&] {
+        if (running_) return false;
+        running_ = true;
+        options_ = options;
+        options_.max_connections =
+            std::clamp(options_.max_connections, 1, FleetConfigOptions::kAdapterConnectionLimit);
+        options_.connect_attempts = std::max(options_.connect_attempts, 1);
+        targets_ = std::move(targets);
+        done_ = std::move(done);
+        progress_ = std::move(progress);
+        report_ = {};
+        report_.pods.resize(targets_.size());
+        for (size_t i = 0; i < targets_.size(); i++) report_.pods[i].address = targets_[i].address;
+        next_ = 0;
+        finished_ = 0;
+        started_ = strand_->Now();
+        // Started from the strand so Start() never runs callbacks inline
+        Post([this] { Pump(); });
+        return true;
+    });
+}
+
+void FleetConfigJob::Cancel() {
+    Post([this] {
+        if (!running_) return;
+        report_.cancelled = true;
+        for (auto& [index, connection] : connections_) {
+            if (report_.pods[index].error.empty()) report_.pods[index].error = "cancelled";
+        }
+        for (; next_ < targets_.size(); next_++) report_.pods[next_].error = "cancelled";
+        DropConnections();
+        Complete();
+    });
+}
+
+bool FleetConfigJob::Running() {
+    return RunOnStrand(*strand_, [this] { return running_; });
+}
+
+// MARK: - Scheduling
+
+void FleetConfigJob::Pump() {
+    if (!running_) return;
+    while (connections_.size() < static_cast<size_t>(options_.max_connections) && next_ < targets_.size()) {
+        Launch(next_++);
+    }
+    if (connections_.empty() && next_ >= targets_.size()) Complete();
+}
+
+void FleetConfigJob::Launch(size_t index) {
+    if (!targets_[index].settings.Valid()) {
+        report_.pods[index].error = "invalid settings";
+        report_.failed++;
+        finished_++;
+        if (progress_) progress_(report_.pods[index], finished_, static_cast<int>(targets_.size()));
+        return;
+    }
+    auto& connection = connections_[index];
+    connection.started = strand_->Now();
+    ConnectAttempt(index);
+    report_.peak_connections = std::max(report_.peak_connections, static_cast<int>(connections_.size()));
+}
+
+void FleetConfigJob::ConnectAttempt(size_t index) {
+    auto& connection = connections_.at(index);
+    auto& pod = report_.pods[index];
+    connection.phase = Phase::kConnecting;
+    connection.step = ++steps_;
+    connection.link = factory_ ? factory_(pod.address) : nullptr;
+    pod.connect_attempts++;
+    if (!connection.link) {
+        Finish(index, "no link");
+        return;
+    }
+
+    uint64_t step = connection.step;
+    strand_->After(options_.connect_timeout, [this, alive = alive_, index, step]() {
+        if (alive->load()) OnConnected(index, step, false, true);
+    });
+    // A link can call back from its own thread after the job is gone, so
+    // the callback holds the strand and checks alive_
+    connection.link->Connect([this, strand = strand_, alive = alive_, index, step](bool connected) {
+        strand->Post([this, alive, index, step, connected] {
+            if (alive->load()) OnConnected(index, step, connected, false);
+        });
+    });
+}
+
+void FleetConfigJob::OnConnected(size_t index, uint64_t step, bool connected, bool timedOut) {
+    auto it = connections_.find(index);
+    if (it == connections_.end() || it->second.step != step || it->second.phase != Phase::kConnecting) return;
+    auto& connection = it->second;
+    auto& pod = report_.pods[index];
+
+    if (!connected) {
+        connection.link->Disconnect();
+        connection.link.reset();
+        if (pod.connect_attempts >= options_.connect_attempts) {
+            Finish(index, timedOut ? "connect timed out" : "connect failed");
+            return;
+        }
+        connection.phase = Phase::kRetryWait;
+        uint64_t retry = connection.step = ++steps_;
+        strand_->After(options_.retry_delay, [this, alive = alive_, index, retry]() {
+            if (!alive->load()) return;
+            auto it = connections_.find(index);
+            if (it != connections_.end() && it->second.step == retry) ConnectAttempt(index);
+        });
+        return;
+    }
+
+    pod.connected = true;
+    pod.connect_ms = MsBetween(connection.started, strand_->Now());
+    const auto& target = targets_[index];
+    if (target.settings.Empty() && !target.delete_files.empty()) {
+        StartDeleting(index);
+        return;
+    }
+    connection.phase = Phase::kApplying;
+    uint64_t applying = connection.step = ++steps_;
+    connection.link->ApplySettings(targets_[index].settings, options_.apply_timeout,
+                                   [this, strand = strand_, alive = alive_, index, applying](
+                                       const SettingsResult& result) {
+        strand->Post([this, alive, index, applying, result] {
+            if (alive->load()) OnApplied(index, applying, result);
+        });
+    });
+}
+
+void FleetConfigJob::OnApplied(size_t index, uint64_t step, const SettingsResult& result) {
+    auto it = connections_.find(index);
+    if (it == connections_.end() || it->second.step != step || it->second.phase != Phase::kApplying) return;
+    report_.pods[index].settings = result;
+    if (result.verified) {
+        if (targets_[index].delete_files.empty()) {
+            Finish(index, {});
+        } else {
+            StartDeleting(index);
+        }
+    } else if (result.busy) {
+        Finish(index, "busy");
+    } else if (result.timed_out) {
+        Finish(index, "not confirmed");
+    } else {
+        Finish(index, "disconnected");
+    }
+}
+
+void FleetConfigJob::StartDeleting(size_t index) {
+    auto& connection = connections_.at(index);
+    connection.phase = Phase::kDeleting;
+    uint64_t deleting = connection.step = ++steps_;
+    connection.link->DeleteFiles(targets_[index].delete_files, options_.delete_timeout,
+                                 [this, strand = strand_, alive = alive_, index, deleting](
+                                     const DeleteResult& result) {
+        strand->Post([this, alive, index, deleting, result] {
+            if (alive->load()) OnDeleted(index, deleting, result);
+        });
+    });
+}
+
+void FleetConfigJob::OnDeleted(size_t index, uint64_t step, const DeleteResult& result) {
+    auto it = connections_.find(index);
+    if (it == connections_.end() || it->second.step != step || it->second.phase != Phase::kDeleting) return;
+    report_.pods[index].deletion = result;
+    report_.files_deleted += static_cast<int>(result.deleted.size());
+    if (result.verified) {
+        Finish(index, {});
+    } else if (result.busy) {
+        Finish(index, "busy");
+    } else if (result.timed_out) {
+        Finish(index, result.has_catalog ? "files remain" : "not confirmed");
+    } else {
+        Finish(index, "disconnected");
+    }
+}
+
+void FleetConfigJob::Finish(size_t index, std::string error) {
+    auto it = connections_.find(index);
+    if (it == connections_.end()) return;
+    auto link = std::move(it->second.link);
+    auto started = it->second.started;
+    connections_.erase(it);
+    if (link) link->Disconnect();
+    link.reset();
+
+    auto& pod = report_.pods[index];
+    pod.total_ms = MsBetween(started, strand_->Now());
+    pod.verified = error.empty();
+    pod.error = std::move(error);
+    if (pod.ok()) {
+        report_.verified++;
+    } else {
+        report_.failed++;
+    }
+    finished_++;
+    if (progress_) progress_(pod, finished_, static_cast<int>(targets_.size()));
+    Pump();
+}
+
+void FleetConfigJob::Complete() {
+    if (!running_) return;
+    running_ = false;
+    report_.total_ms = MsBetween(started_, strand_->Now());
+    if (report_.cancelled) report_.failed = static_cast<int>(targets_.size()) - report_.verified;
+    auto done = std::move(done_);
+    progress_ = nullptr;
+    if (done) done(report_);
+}
+
+void FleetConfigJob::DropConnections() {
+    auto connections = std::move(connections_);
+    connections_.clear();
+    for (auto& [index, connection] : connections) {
+        if (connection.link) connection.link->Disconnect();
+    }
+}
+
+} // namespace pod_connector
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "core_scheduler.h"
+#include "file_deleter.h"
+#include "settings_verifier.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pod_connector {
+
+/// One pod of a fleet job: the settings it should end up with and the
+/// files to clear off it. Settings left empty are only read back, unless
+/// there are files to delete, in which case the settings step is skipped.
+struct FleetTarget {
+    std::string address;
+    SettingsRequest settings;
+    std::vector<std::string> delete_files = {};
+};
+
+/// What happened to one pod.
+struct FleetPodResult {
+    std::string address;
+    bool connected = false;
+    int connect_attempts = 0;
+    SettingsResult settings;        // Set-and-verify outcome, once connected
+    DeleteResult deletion;          // Batch delete outcome, when files were given
+    double connect_ms = 0;          // First attempt → connected
+    double total_ms = 0;            // First attempt → disconnected
+    bool verified = false;          // Every step the target asked for
+    std::string error;              // Empty when verified
+
+    bool ok() const { return verified; }
+};
+
+struct FleetReport {
+    std::vector<FleetPodResult> pods;   // In target order
+    double total_ms = 0;
+    int verified = 0;
+    int failed = 0;
+    int peak_connections = 0;
+    int files_deleted = 0;
+    bool cancelled = false;
+};
+
+/// A connection to one pod, as the fleet job drives it: PodBLECore on
+/// Windows, a ScriptedPod in tests. The job makes a fresh link for every
+/// connect attempt, calls Disconnect before it destroys one, and destroys
+/// links on its strand. Callbacks may fire on any thread.
+class FleetPodLink {
+public:
+    using ConnectCallback = std::function<void(bool connected)>;
+
+    virtual ~FleetPodLink() = default;
+
+    virtual void Connect(ConnectCallback done) = 0;
+    virtual void ApplySettings(const SettingsRequest& request, std::chrono::milliseconds timeout,
+                               SettingsCallback done) = 0;
+    virtual void DeleteFiles(const std::vector<std::string>& files, std::chrono::milliseconds timeout,
+                             DeleteCallback done) = 0;
+    virtual void Disconnect() = 0;
+};
+
+using FleetLinkFactory = std::function<std::unique_ptr<FleetPodLink>(const std::string& address)>;
+
+struct FleetConfigOptions {
+    /// Concurrent LE connections a typical Windows adapter sustains.
+    static constexpr int kAdapterConnectionLimit = 7;
+
+    int max_connections = 4;                        // Clamped to 1..kAdapterConnectionLimit
+    int connect_attempts = 2;
+    std::chrono::milliseconds connect_timeout{10000};
+    std::chrono::milliseconds retry_delay{500};
+    std::chrono::milliseconds apply_timeout{3000};  // Per pod, set-and-verify
+    std::chrono::milliseconds delete_timeout{15000}; // Per pod, the whole batch
+};
+
+/// Applies settings to and clears files from many pods: connects to up to
+/// max_connections at a time, runs set-and-verify and then a batch delete on
+/// each, disconnects, and moves on to the next pod as soon as a connection
+/// frees up. A failed pod does not stop the job.
+///
+/// All state belongs to [strand]; public methods may be called from any
+/// thread. Callbacks run on the strand.
+class FleetConfigJob {
+public:
+    using ProgressCallback = std::function<void(const FleetPodResult& pod, int finished, int total)>;
+    using DoneCallback = std::function<void(const FleetReport& report)>;
+
+    FleetConfigJob(std::shared_ptr<CoreScheduler> strand, FleetLinkFactory factory);
+
+    /// Disconnects every pod in flight. [done] is not called.
+    ~FleetConfigJob();
+
+    /// Starts a job. Returns false (and calls nothing) while one is running.
+    bool Start(std::vector<FleetTarget> targets, FleetConfigOptions options, DoneCallback done,
+               ProgressCallback progress = nullptr);
+
+    /// Ends the running job: pods in flight are disconnected, pods not yet
+    /// started are skipped, and [done] gets a cancelled report.
+    void Cancel();
+
+    bool Running();
+
+private:
+    enum class Phase { kConnecting, kRetryWait, kApplying, kDeleting };
+
+    struct Connection {
+        std::unique_ptr<FleetPodLink> link;
+        Phase phase = Phase::kConnecting;
+        uint64_t step = 0;      // Retires callbacks and timers of earlier steps
+        CoreScheduler::Clock::time_point started;
+    };
+
+    void Pump();
+    void Launch(size_t index);
+    void ConnectAttempt(size_t index);
+    void OnConnected(size_t index, uint64_t step, bool connected, bool timedOut);
+    void OnApplied(size_t index, uint64_t step, const SettingsResult& result);
+    void StartDeleting(size_t index);
+    void OnDeleted(size_t index, uint64_t step, const DeleteResult& result);
+    void Finish(size_t index, std::string error);
+    void Complete();
+    void DropConnections();
+
+    // Runs [fn] on the strand with the job still alive
+    void Post(std::function<void()> fn);
+
+    std::shared_ptr<CoreScheduler> strand_;
+    FleetLinkFactory factory_;
+    FleetConfigOptions options_;
+    std::shared_ptr<std::atomic<bool>> alive_ = std::make_shared<std::atomic<bool>>(true);
+
+    bool running_ = false;
+    std::vector<FleetTarget> targets_;
+    FleetReport report_;
+    DoneCallback done_;
+    ProgressCallback progress_;
+    size_t next_ = 0;
+    int finished_ = 0;
+    uint64_t steps_ = 0;
+    std::map<size_t, Connection> connections_;
+    CoreScheduler::Clock::time_point started_;
+};
+
+} // namespace pod_connector
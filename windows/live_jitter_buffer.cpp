@@ -0,0 +1,255 @@
+#include "live_jitter_buffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace pod_connector {
+
+namespace {
+
+// Float fields of the LiveTelemetry body that are interpolated linearly:
+// battery, accelerometer, gyroscope, filtered gravity, latitude, longitude, speed
+constexpr size_t kLinearFloatOffsets[] = {4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 54, 58, 64};
+constexpr size_t kCourseOffset = 68;
+
+// Smoothing factor for the jitter and mean-delay estimates (RFC 3550 uses 1/16)
+constexpr double kEwmaGain = 1.0 / 16.0;
+
+uint32_t ReadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void WriteU32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+float ReadF32(const uint8_t* p) {
+    uint32_t bits = ReadU32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void WriteF32(uint8_t* p, float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    WriteU32(p, bits);
+}
+
+double ToMs(LiveJitterBuffer::Clock::time_point t) {
+    return std::chrono::duration<double, std::milli>(t.time_since_epoch()).count();
+}
+
+}  // namespace
+
+LiveJitterBuffer::LiveJitterBuffer(LiveJitterConfig config) : config_(config) {}
+
+void LiveJitterBuffer::Configure(const LiveJitterConfig& config) {
+    config_ = config;
+    config_.latency_ms = std::max(config_.latency_ms, 0);
+    config_.max_conceal_ms = std::max(config_.max_conceal_ms, 0);
+    config_.interval_ms = std::max(config_.interval_ms, 0);
+}
+
+bool LiveJitterBuffer::Push(const uint8_t* telemetry, size_t len, Clock::time_point arrival) {
+    if (telemetry == nullptr || len < kTelemetrySize) return false;
+    uint32_t tick = ReadU32(telemetry);
+
+    if (has_released_ && tick + kRestartThresholdMs < last_tick_) RestartStream();
+    if (has_released_ && tick <= last_tick_) {
+        if (tick == last_tick_ && !last_concealed_) {
+            stats_.duplicates++;
+        } else {
+            stats_.late++;
+        }
+        return false;
+    }
+    if (pending_.count(tick) != 0) {
+        stats_.duplicates++;
+        return false;
+    }
+
+    // Sliding minimum of (arrival - tick): the fastest recent delivery
+    double arrivalMs = ToMs(arrival);
+    double offset = arrivalMs - static_cast<double>(tick);
+    uint64_t sequence = arrival_sequence_++;
+    while (!offset_window_.empty() && offset_window_.back().second >= offset) {
+        offset_window_.pop_back();
+    }
+    offset_window_.emplace_back(sequence, offset);
+    while (offset_window_.front().first + kOffsetWindow <= sequence) {
+        offset_window_.pop_front();
+    }
+
+    double delay = offset - BaseOffsetMs();
+    stats_.mean_delay_ms = stats_.received == 0
+        ? delay
+        : stats_.mean_delay_ms + kEwmaGain * (delay - stats_.mean_delay_ms);
+    stats_.max_delay_ms = std::max(stats_.max_delay_ms, delay);
+
+    if (has_arrival_) {
+        if (tick < max_tick_) stats_.reordered++;
+        double transit = (arrivalMs - last_arrival_ms_) -
+                         (static_cast<double>(tick) - static_cast<double>(last_arrival_tick_));
+        stats_.jitter_ms += kEwmaGain * (std::abs(transit) - stats_.jitter_ms);
+
+        // Interval: smallest recent step between consecutive arrivals
+        if (tick > last_arrival_tick_ && tick - last_arrival_tick_ >= kMinIntervalMs) {
+            recent_steps_[step_index_++ % recent_steps_.size()] = tick - last_arrival_tick_;
+            learned_interval_ = 0;
+            for (uint32_t step : recent_steps_) {
+                if (step != 0 && (learned_interval_ == 0 || step < learned_interval_)) {
+                    learned_interval_ = step;
+                }
+            }
+        }
+    }
+    has_arrival_ = true;
+    max_tick_ = std::max(max_tick_, tick);
+    last_arrival_tick_ = tick;
+    last_arrival_ms_ = arrivalMs;
+
+    auto& slot = pending_[tick];
+    std::copy(telemetry, telemetry + kTelemetrySize, slot.begin());
+    stats_.received++;
+
+    // Nobody is draining the buffer: give up on the oldest packet
+    if (pending_.size() > kMaxBuffered) {
+        pending_.erase(pending_.begin());
+        stats_.lost++;
+    }
+    return true;
+}
+
+std::vector<LiveSample> LiveJitterBuffer::Pop(Clock::time_point now) {
+    std::vector<LiveSample> out;
+    if (!has_released_) {
+        if (pending_.empty()) return out;
+        auto first = pending_.begin();
+        if (PlayoutAt(first->first) > now) return out;
+        Release(first->first, first->second, false, out);
+        pending_.erase(first);
+    }
+
+    uint32_t interval = IntervalMs();
+    while (true) {
+        if (pending_.empty()) {
+            if (interval > 0 && !in_underrun_ && PlayoutAt(last_tick_ + interval) <= now) {
+                in_underrun_ = true;
+                stats_.underruns++;
+            }
+            break;
+        }
+
+        auto next = pending_.begin();
+        uint32_t tick = next->first;
+        uint32_t gap = tick - last_tick_;
+        bool onSlot = interval == 0 || gap <= interval + interval / 2;
+
+        // Next packet is in its slot, or the gap before it is too long to
+        // conceal: play it when due
+        if (onSlot || gap > static_cast<uint32_t>(config_.max_conceal_ms)) {
+            if (PlayoutAt(tick) > now) break;
+            if (!onSlot) stats_.lost += (gap + interval / 2) / interval - 1;
+            Release(tick, next->second, false, out);
+            pending_.erase(next);
+            continue;
+        }
+
+        // Short gap: fill the next missing slot once it is due
+        uint32_t expected = last_tick_ + interval;
+        if (PlayoutAt(expected) > now) break;
+
+        std::array<uint8_t, kTelemetrySize> filled = last_sample_;
+        float f = static_cast<float>(interval) / static_cast<float>(gap);
+        for (size_t offset : kLinearFloatOffsets) {
+            float a = ReadF32(last_sample_.data() + offset);
+            float b = ReadF32(next->second.data() + offset);
+            WriteF32(filled.data() + offset, a + (b - a) * f);
+        }
+        float courseA = ReadF32(last_sample_.data() + kCourseOffset);
+        float courseB = ReadF32(next->second.data() + kCourseOffset);
+        float turn = std::remainder(courseB - courseA, 360.0f);   // Shortest way round
+        float course = std::fmod(courseA + turn * f + 360.0f, 360.0f);
+        WriteF32(filled.data() + kCourseOffset, course);
+
+        stats_.lost++;
+        stats_.concealed++;
+        Release(expected, filled, true, out);
+    }
+    return out;
+}
+
+std::optional<LiveJitterBuffer::Clock::time_point> LiveJitterBuffer::NextRelease() const {
+    uint32_t interval = IntervalMs();
+    if (!has_released_) {
+        if (pending_.empty()) return std::nullopt;
+        return PlayoutAt(pending_.begin()->first);
+    }
+    if (interval == 0) {
+        if (pending_.empty()) return std::nullopt;
+        return PlayoutAt(pending_.begin()->first);
+    }
+    // Earliest event: the next real packet or the next slot's deadline
+    uint32_t tick = last_tick_ + interval;
+    if (!pending_.empty()) tick = std::min(tick, pending_.begin()->first);
+    return PlayoutAt(tick);
+}
+
+LiveJitterStats LiveJitterBuffer::Stats() const {
+    LiveJitterStats stats = stats_;
+    stats.interval_ms = static_cast<int>(IntervalMs());
+    stats.buffered = pending_.size();
+    return stats;
+}
+
+void LiveJitterBuffer::Reset() {
+    *this = LiveJitterBuffer(config_);
+}
+
+uint32_t LiveJitterBuffer::IntervalMs() const {
+    return config_.interval_ms > 0 ? static_cast<uint32_t>(config_.interval_ms) : learned_interval_;
+}
+
+double LiveJitterBuffer::BaseOffsetMs() const {
+    return offset_window_.empty() ? 0.0 : offset_window_.front().second;
+}
+
+LiveJitterBuffer::Clock::time_point LiveJitterBuffer::PlayoutAt(uint32_t tick) const {
+    double ms = static_cast<double>(tick) + BaseOffsetMs() + config_.latency_ms;
+    return Clock::time_point(std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(ms)));
+}
+
+void LiveJitterBuffer::Release(uint32_t tick, const std::array<uint8_t, kTelemetrySize>& data,
+                               bool concealed, std::vector<LiveSample>& out) {
+    LiveSample sample;
+    sample.data = data;
+    WriteU32(sample.data.data(), tick);
+    sample.tick = tick;
+    sample.concealed = concealed;
+    out.push_back(sample);
+
+    last_sample_ = sample.data;
+    last_tick_ = tick;
+    last_concealed_ = concealed;
+    has_released_ = true;
+    in_underrun_ = false;
+}
+
+void LiveJitterBuffer::RestartStream() {
+    // Tick base changed (pod reboot): arrival offsets no longer apply
+    pending_.clear();
+    offset_window_.clear();
+    has_released_ = false;
+    has_arrival_ = false;
+    in_underrun_ = false;
+    max_tick_ = 0;
+}
+
+} // namespace pod_connector
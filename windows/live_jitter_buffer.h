@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace pod_connector {
+
+struct LiveJitterConfig {
+    int latency_ms = 200;       // Release delay behind the earliest-arriving packets
+    int max_conceal_ms = 500;   // Gaps up to this long are interpolated, longer ones skipped
+    int interval_ms = 0;        // Sample interval; 0 learns it from the kernel ticks
+};
+
+/// Loss and delay counters since the last Reset.
+struct LiveJitterStats {
+    uint64_t received = 0;      // Packets accepted into the buffer
+    uint64_t duplicates = 0;
+    uint64_t reordered = 0;     // Arrived after a packet with a later tick
+    uint64_t late = 0;          // Arrived after their slot was released (dropped)
+    uint64_t lost = 0;          // Slots released without the real packet
+    uint64_t concealed = 0;     // Lost slots filled by interpolation
+    uint64_t underruns = 0;     // Times the buffer ran dry with a slot due
+    double jitter_ms = 0;       // RFC 3550 interarrival jitter
+    double mean_delay_ms = 0;   // Arrival delay above the fastest recent packet (EWMA)
+    double max_delay_ms = 0;
+    int interval_ms = 0;
+    size_t buffered = 0;
+};
+
+/// One released 0x01 telemetry body.
+struct LiveSample {
+    std::array<uint8_t, 72> data{};
+    uint32_t tick = 0;
+    bool concealed = false;     // Interpolated, not received
+};
+
+/// Playout buffer for the live 0x01 stream, keyed on kernel tick.
+///
+/// BLE delivers live packets in bursts and occasionally drops or reorders
+/// them. Packets are held in tick order and released on the pod's own
+/// cadence: tick T plays out at T + base offset + latency, where the base
+/// offset is the smallest (arrival - tick) over the recent window, i.e. the
+/// fastest delivery seen. A slot whose packet has not arrived when it is due
+/// is interpolated from its neighbours if the gap is at most max_conceal_ms,
+/// otherwise playout jumps to the next packet. Packets arriving after their
+/// slot are dropped and counted as late.
+///
+/// Interpolated samples take floats (IMU, battery, position, speed, course)
+/// linearly from both neighbours and everything else from the earlier one.
+///
+/// Not thread-safe: the owner serialises all calls.
+class LiveJitterBuffer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kTelemetrySize = 72;
+    static constexpr size_t kMaxBuffered = 256;
+    static constexpr size_t kOffsetWindow = 128;
+    static constexpr uint32_t kMinIntervalMs = 5;
+
+    /// A tick this far behind the last release means the pod rebooted.
+    static constexpr uint32_t kRestartThresholdMs = 10000;
+
+    explicit LiveJitterBuffer(LiveJitterConfig config = {});
+
+    /// Applies new settings; buffered packets and counters are kept.
+    void Configure(const LiveJitterConfig& config);
+    const LiveJitterConfig& Config() const { return config_; }
+
+    /// Buffers one telemetry body received at [arrival]. Returns false if it
+    /// was truncated, a duplicate or late.
+    bool Push(const uint8_t* telemetry, size_t len, Clock::time_point arrival);
+
+    /// Releases every sample due at [now], in tick order.
+    std::vector<LiveSample> Pop(Clock::time_point now);
+
+    /// When the next buffered sample (or concealment decision) is due.
+    std::optional<Clock::time_point> NextRelease() const;
+
+    LiveJitterStats Stats() const;
+
+    /// Drops buffered packets and clears counters.
+    void Reset();
+
+private:
+    LiveJitterConfig config_;
+    LiveJitterStats stats_;
+    std::map<uint32_t, std::array<uint8_t, kTelemetrySize>> pending_;
+
+    // Playout position
+    bool has_released_ = false;
+    uint32_t last_tick_ = 0;
+    std::array<uint8_t, kTelemetrySize> last_sample_{};
+    bool last_concealed_ = false;
+    bool in_underrun_ = false;
+
+    // Arrival timing
+    std::deque<std::pair<uint64_t, double>> offset_window_;   // (sequence, arrival - tick), increasing
+    uint64_t arrival_sequence_ = 0;
+    bool has_arrival_ = false;
+    uint32_t max_tick_ = 0;
+    uint32_t last_arrival_tick_ = 0;
+    double last_arrival_ms_ = 0;
+    std::array<uint32_t, 32> recent_steps_{};   // Recent tick steps between arrivals
+    size_t step_index_ = 0;
+    uint32_t learned_interval_ = 0;
+
+    uint32_t IntervalMs() const;
+    double BaseOffsetMs() const;
+    Clock::time_point PlayoutAt(uint32_t tick) const;
+    void Release(uint32_t tick, const std::array<uint8_t, kTelemetrySize>& data,
+                 bool concealed, std::vector<LiveSample>& out);
+    void RestartStream();
+};
+
+} // namespace pod_connector
@@ -0,0 +1,162 @@
+#include "live_metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace pod_connector {
+
+namespace {
+
+constexpr float kStandardGravity = 9.80665f;
+
+// LiveTelemetry body offsets (see LiveTelemetry.fromBytes on the Dart side)
+constexpr size_t kTickOffset = 0;
+constexpr size_t kBatteryOffset = 4;
+constexpr size_t kAccelOffset = 8;
+constexpr size_t kGravityOffset = 32;
+constexpr size_t kFixValidOffset = 44;
+constexpr size_t kSatellitesOffset = 63;
+constexpr size_t kSpeedOffset = 64;
+
+uint32_t ReadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+float ReadF32(const uint8_t* p) {
+    uint32_t bits = ReadU32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void PutU32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v >> 16));
+    out.push_back(static_cast<uint8_t>(v >> 24));
+}
+
+void PutF32(std::vector<uint8_t>& out, float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    PutU32(out, bits);
+}
+
+}  // namespace
+
+// MARK: - LiveMetricsSnapshot
+
+std::vector<uint8_t> LiveMetricsSnapshot::Serialize() const {
+    std::vector<uint8_t> out;
+    out.reserve(39 + 4 * kSpeedZones);
+    out.push_back(kMessageType);
+    PutU32(out, packets);
+    PutU32(out, kernel_tick);
+    PutU32(out, elapsed_ms);
+    PutF32(out, distance_m);
+    PutF32(out, speed_kmh);
+    PutF32(out, peak_speed_kmh);
+    PutF32(out, player_load);
+    PutU32(out, impacts);
+    PutF32(out, battery_v);
+    out.push_back(flags);
+    out.push_back(satellites);
+    for (uint32_t ms : zone_ms) PutU32(out, ms);
+    return out;
+}
+
+// MARK: - LiveMetricsTracker
+
+int LiveMetricsTracker::ZoneFor(float speedKmh) {
+    int zone = 0;
+    while (zone < static_cast<int>(kZoneFloorsKmh.size()) && speedKmh >= kZoneFloorsKmh[zone]) {
+        zone++;
+    }
+    return zone;
+}
+
+bool LiveMetricsTracker::Add(const uint8_t* telemetry, size_t len) {
+    if (telemetry == nullptr || len < kTelemetrySize) return false;
+
+    LiveMetricsSnapshot& s = snapshot_;
+    uint32_t tick = ReadU32(telemetry + kTickOffset);
+    s.packets++;
+    if (has_previous_ && tick == s.kernel_tick) return true;  // Duplicate notification
+
+    // Only a short forward step is integrated; anything else is a gap
+    uint32_t dt = 0;
+    if (has_previous_ && tick > s.kernel_tick && tick - s.kernel_tick <= kMaxStepMs) {
+        dt = tick - s.kernel_tick;
+    } else {
+        in_impact_ = false;
+    }
+
+    float accel[3];
+    float linear[3];
+    for (int i = 0; i < 3; i++) {
+        accel[i] = ReadF32(telemetry + kAccelOffset + 4 * i);
+        linear[i] = accel[i] - ReadF32(telemetry + kGravityOffset + 4 * i);
+    }
+    bool accelFinite = std::isfinite(accel[0]) && std::isfinite(accel[1]) && std::isfinite(accel[2]);
+
+    bool fix = telemetry[kFixValidOffset] != 0;
+    float speedKmh = ReadF32(telemetry + kSpeedOffset) * kKnotsToKmh;
+    bool speedValid = fix && std::isfinite(speedKmh) && speedKmh >= 0 && speedKmh <= kMaxSpeedKmh;
+
+    if (dt > 0) {
+        s.elapsed_ms += dt;
+        if (speedValid) {
+            distance_m_ += speedKmh / 3.6 * dt / 1000.0;
+            s.zone_ms[ZoneFor(speedKmh)] += dt;
+        }
+        if (accelFinite && has_accel_) {
+            double dx = accel[0] - last_accel_[0];
+            double dy = accel[1] - last_accel_[1];
+            double dz = accel[2] - last_accel_[2];
+            player_load_ += std::sqrt(dx * dx + dy * dy + dz * dz) / kStandardGravity / 100.0;
+        }
+    }
+    if (accelFinite) {
+        std::copy(accel, accel + 3, last_accel_.begin());
+        has_accel_ = true;
+    }
+
+    // Impacts: same hysteresis and refractory period as EventDetector
+    float magnitude = std::sqrt(linear[0] * linear[0] + linear[1] * linear[1] + linear[2] * linear[2]);
+    if (std::isfinite(magnitude)) {
+        if (in_impact_) {
+            if (magnitude >= kImpactOffMs2) {
+                impact_end_tick_ = tick;
+            } else {
+                in_impact_ = false;
+            }
+        } else if (magnitude >= kImpactOnMs2 &&
+                   (!has_impact_ || tick < impact_end_tick_ ||
+                    tick - impact_end_tick_ >= kImpactRefractoryMs)) {
+            in_impact_ = true;
+            has_impact_ = true;
+            impact_end_tick_ = tick;
+            s.impacts++;
+        }
+    }
+
+    s.kernel_tick = tick;
+    s.distance_m = static_cast<float>(distance_m_);
+    s.player_load = static_cast<float>(player_load_);
+    s.speed_kmh = speedValid ? speedKmh : 0.0f;
+    if (speedValid) s.peak_speed_kmh = std::max(s.peak_speed_kmh, speedKmh);
+    s.battery_v = ReadF32(telemetry + kBatteryOffset);
+    s.satellites = telemetry[kSatellitesOffset];
+    s.flags = static_cast<uint8_t>((fix ? LiveMetricsSnapshot::kGpsFix : 0) |
+                                   (in_impact_ ? LiveMetricsSnapshot::kInImpact : 0));
+    has_previous_ = true;
+    return true;
+}
+
+void LiveMetricsTracker::Reset() {
+    *this = LiveMetricsTracker{};
+}
+
+} // namespace pod_connector
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pod_connector {
+
+/// Running live-session totals for one pod, published to Dart at UI rate.
+struct LiveMetricsSnapshot {
+    /// Synthetic message type on the payload stream (alongside 0xDA / 0xDB).
+    static constexpr uint8_t kMessageType = 0xDC;
+    static constexpr int kSpeedZones = 5;
+
+    enum Flags : uint8_t {
+        kGpsFix = 0x01,             // Newest packet had a valid GPS fix
+        kInImpact = 0x02,           // Newest packet is inside an impact
+    };
+
+    uint32_t packets = 0;           // 0x01 packets consumed since the last reset
+    uint32_t kernel_tick = 0;       // Tick of the newest packet (ms)
+    uint32_t elapsed_ms = 0;        // Tick time covered, gaps excluded
+    float distance_m = 0;           // Integrated GPS speed while the fix is valid
+    float speed_kmh = 0;            // Newest GPS speed
+    float peak_speed_kmh = 0;
+    float player_load = 0;          // Sum of |change in acceleration| in g, / 100
+    uint32_t impacts = 0;
+    float battery_v = 0;
+    uint8_t flags = 0;
+    uint8_t satellites = 0;
+    std::array<uint32_t, kSpeedZones> zone_ms{};   // Time spent in each speed zone
+
+    /// Wire format (little endian):
+    ///   [0xDC][packets u32][kernel_tick u32][elapsed_ms u32][distance_m f32]
+    ///   [speed_kmh f32][peak_speed_kmh f32][player_load f32][impacts u32]
+    ///   [battery_v f32][flags u8][satellites u8][zone_ms u32 x 5]
+    std::vector<uint8_t> Serialize() const;
+};
+
+/// Per-pod live metrics, updated in O(1) from each 0x01 telemetry packet so
+/// the Dart isolate only has to handle periodic snapshots.
+///
+/// Samples are timed by the pod's kernel tick. A step that goes backwards
+/// (pod reboot) or is longer than kMaxStepMs is treated as a gap: nothing is
+/// integrated across it and an open impact is closed.
+///
+/// Not thread-safe: the owner serialises Add / Reset / Snapshot.
+class LiveMetricsTracker {
+public:
+    /// LiveTelemetry body size (after the 0x01 type byte).
+    static constexpr size_t kTelemetrySize = 72;
+
+    /// Live gpsSpeed is reported in knots.
+    static constexpr float kKnotsToKmh = 1.852f;
+
+    /// Lower bounds of zones 2-5 (km/h); zone 1 starts at 0.
+    static constexpr std::array<float, LiveMetricsSnapshot::kSpeedZones - 1> kZoneFloorsKmh = {
+        7.2f, 14.4f, 19.8f, 25.2f};
+
+    /// GPS speeds above this are glitches and are not integrated (km/h),
+    /// matching RecordAnomaly.maxSpeed on the Dart side.
+    static constexpr float kMaxSpeedKmh = 80.0f;
+
+    static constexpr uint32_t kMaxStepMs = 1000;
+
+    /// Impact hysteresis on linear acceleration (m/s²), matching the Dart
+    /// EventDetector defaults.
+    static constexpr float kImpactOnMs2 = 49.0f;
+    static constexpr float kImpactOffMs2 = 29.4f;
+    static constexpr uint32_t kImpactRefractoryMs = 250;
+
+    /// Consumes one telemetry body. Returns false (and changes nothing) if
+    /// [len] is shorter than kTelemetrySize.
+    bool Add(const uint8_t* telemetry, size_t len);
+
+    void Reset();
+
+    const LiveMetricsSnapshot& Snapshot() const { return snapshot_; }
+
+    /// Zone index (0-4) for a speed in km/h.
+    static int ZoneFor(float speedKmh);
+
+private:
+    LiveMetricsSnapshot snapshot_;
+    bool has_previous_ = false;
+    double distance_m_ = 0;         // Accumulated in double, published as float
+    double player_load_ = 0;
+    bool has_accel_ = false;
+    std::array<float, 3> last_accel_{};
+    bool in_impact_ = false;
+    bool has_impact_ = false;
+    uint32_t impact_end_tick_ = 0;  // Last tick above the off threshold
+};
+
+} // namespace pod_connector
@@ -0,0 +1,363 @@
+#include "live_telemetry_segment.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace pod_connector {
+
+namespace {
+
+static_assert(std::atomic_ref<uint64_t>::is_always_lock_free, "seqlock needs lock-free 64-bit atomics");
+static_assert(std::atomic_ref<uint32_t>::is_always_lock_free);
+
+constexpr size_t kLiveBodySize = 72;
+constexpr float kKnotsToKmh = 1.852f;
+
+// Seqlocked bytes of a pod entry: everything after seq and write_index
+constexpr size_t kPodEntryBodyOffset = offsetof(LiveSegmentPodEntry, session);
+constexpr size_t kPodEntryBodySize = sizeof(LiveSegmentPodEntry) - kPodEntryBodyOffset;
+
+// Gives up on a slot whose writer died mid-update
+constexpr int kMaxReadAttempts = 1000;
+
+uint16_t ReadU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+float ReadF32(const uint8_t* p) {
+    uint32_t bits = ReadU32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Mapped words are only ever touched through atomic_ref. Readers map the
+// segment read-only and only load, so the const_cast never leads to a store.
+std::atomic_ref<uint64_t> Word(const uint8_t* p) {
+    return std::atomic_ref<uint64_t>(*reinterpret_cast<uint64_t*>(const_cast<uint8_t*>(p)));
+}
+
+void SeqlockWrite(uint8_t* seq, uint8_t* body, const void* src, size_t size) {
+    auto counter = Word(seq);
+    uint64_t s = counter.load(std::memory_order_relaxed);
+    counter.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, static_cast<const uint8_t*>(src) + i, sizeof(word));
+        Word(body + i).store(word, std::memory_order_relaxed);
+    }
+    counter.store(s + 2, std::memory_order_release);
+}
+
+bool SeqlockRead(const uint8_t* seq, const uint8_t* body, void* dst, size_t size) {
+    uint64_t before = Word(seq).load(std::memory_order_acquire);
+    if (before & 1) return false;
+    for (size_t i = 0; i < size; i += sizeof(uint64_t)) {
+        uint64_t word = Word(body + i).load(std::memory_order_relaxed);
+        std::memcpy(static_cast<uint8_t*>(dst) + i, &word, sizeof(word));
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return Word(seq).load(std::memory_order_relaxed) == before;
+}
+
+// Offsets follow the layout in the header: pod entries right after the
+// header, then the rings
+uint8_t* PodEntryAt(uint8_t* base, uint32_t slot) {
+    return base + sizeof(LiveSegmentHeader) + size_t{slot} * sizeof(LiveSegmentPodEntry);
+}
+
+uint8_t* RecordAt(uint8_t* base, uint32_t podSlots, uint32_t ringRecords, uint32_t slot, uint64_t index) {
+    size_t rings = sizeof(LiveSegmentHeader) + size_t{podSlots} * sizeof(LiveSegmentPodEntry);
+    return base + rings + (uint64_t{slot} * ringRecords + (index & (ringRecords - 1))) * kLiveSegmentRecordSize;
+}
+
+uint32_t CurrentPid() {
+#ifdef _WIN32
+    return GetCurrentProcessId();
+#else
+    return static_cast<uint32_t>(::getpid());
+#endif
+}
+
+} // namespace
+
+// MARK: - Common
+
+std::string DefaultLiveTelemetrySegmentName() {
+#ifdef _WIN32
+    return "Local\\pod_ble_live";
+#else
+    return "/pod_ble_live";
+#endif
+}
+
+uint64_t LiveTelemetryClockNs() {
+#ifdef _WIN32
+    static const uint64_t frequency = [] {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return static_cast<uint64_t>(f.QuadPart);
+    }();
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    uint64_t ticks = static_cast<uint64_t>(counter.QuadPart);
+    return ticks / frequency * 1000000000ull + ticks % frequency * 1000000000ull / frequency;
+#else
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+}
+
+bool DecodeLiveTelemetry(const uint8_t* telemetry, size_t len, LiveTelemetryRecord& out) {
+    if (len < kLiveBodySize) return false;
+    out.kernel_tick = ReadU32(telemetry);
+    out.battery_v = ReadF32(telemetry + 4);
+    for (int i = 0; i < 3; i++) {
+        out.accel[i] = ReadF32(telemetry + 8 + 4 * i);
+        out.gyro[i] = ReadF32(telemetry + 20 + 4 * i);
+        out.gravity[i] = ReadF32(telemetry + 32 + 4 * i);
+    }
+    out.flags = telemetry[44] != 0 ? LiveTelemetryRecord::kFixValid : 0;
+    out.year = ReadU16(telemetry + 45);
+    out.month = telemetry[47];
+    out.day = telemetry[48];
+    out.hour = telemetry[49];
+    out.minute = telemetry[50];
+    out.second = telemetry[51];
+    out.millisecond = ReadU16(telemetry + 52);
+    out.latitude = ReadF32(telemetry + 54);
+    out.longitude = ReadF32(telemetry + 58);
+    out.fix_quality = telemetry[62];
+    out.satellites = telemetry[63];
+    out.speed_kmh = ReadF32(telemetry + 64) * kKnotsToKmh;
+    out.course_deg = ReadF32(telemetry + 68);
+    return true;
+}
+
+// MARK: - LiveTelemetrySegment
+
+bool LiveTelemetrySegment::Create(const std::string& name, uint32_t podSlots, uint32_t ringRecords,
+                                  std::string* error) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    uint32_t ring = 2;
+    while (ring < ringRecords && ring < (1u << 24)) ring <<= 1;
+    podSlots = std::clamp(podSlots, 1u, 256u);
+
+    LiveSegmentHeader header;
+    header.version = kLiveSegmentVersion;
+    header.header_size = sizeof(LiveSegmentHeader);
+    header.pod_slots = podSlots;
+    header.ring_records = ring;
+    header.record_size = static_cast<uint32_t>(kLiveSegmentRecordSize);
+    header.pod_entry_size = sizeof(LiveSegmentPodEntry);
+    header.pods_offset = sizeof(LiveSegmentHeader);
+    header.rings_offset = header.pods_offset + uint64_t{podSlots} * sizeof(LiveSegmentPodEntry);
+    header.total_size = header.rings_offset + uint64_t{podSlots} * ring * kLiveSegmentRecordSize;
+    header.writer_pid = CurrentPid();
+    header.created_ns = LiveTelemetryClockNs();
+
+    // The new mapping is zero-filled, so every pod entry starts out free
+    if (!region_.Create(name, static_cast<size_t>(header.total_size), error)) return false;
+    std::memcpy(region_.data(), &header, sizeof(header));
+    std::atomic_ref<uint32_t>(*reinterpret_cast<uint32_t*>(region_.data()))
+        .store(kLiveSegmentMagic, std::memory_order_release);
+
+    name_ = name;
+    pod_slots_ = podSlots;
+    ring_records_ = ring;
+    pods_.assign(podSlots, LiveSegmentPodEntry{});
+    return true;
+}
+
+int LiveTelemetrySegment::AttachPod(const std::string& deviceId) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!region_.data()) return -1;
+
+    int previous = -1, unused = -1, oldest = -1;
+    for (uint32_t i = 0; i < pod_slots_; i++) {
+        const LiveSegmentPodEntry& pod = pods_[i];
+        if (pod.state == LivePodState::kFree) {
+            if (unused < 0) unused = static_cast<int>(i);
+        } else if (std::strncmp(pod.device_id, deviceId.c_str(), sizeof(pod.device_id) - 1) == 0) {
+            previous = static_cast<int>(i);
+        } else if (pod.state == LivePodState::kDisconnected &&
+                   (oldest < 0 || pod.attached_ns < pods_[oldest].attached_ns)) {
+            oldest = static_cast<int>(i);
+        }
+    }
+    int chosen = previous >= 0 ? previous : unused >= 0 ? unused : oldest;
+    if (chosen < 0) return -1;
+
+    LiveSegmentPodEntry& pod = pods_[chosen];
+    pod.session++;
+    pod.state = LivePodState::kConnected;
+    std::memset(pod.device_id, 0, sizeof(pod.device_id));
+    std::memcpy(pod.device_id, deviceId.data(), std::min(deviceId.size(), sizeof(pod.device_id) - 1));
+    pod.attached_ns = LiveTelemetryClockNs();
+    WritePodEntry(static_cast<uint32_t>(chosen), pod);
+    return chosen;
+}
+
+void LiveTelemetrySegment::DetachPod(int slot) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!region_.data() || slot < 0 || static_cast<uint32_t>(slot) >= pod_slots_) return;
+    LiveSegmentPodEntry& pod = pods_[slot];
+    if (pod.state != LivePodState::kConnected) return;
+    pod.state = LivePodState::kDisconnected;
+    WritePodEntry(static_cast<uint32_t>(slot), pod);
+}
+
+bool LiveTelemetrySegment::Publish(int slot, const uint8_t* telemetry, size_t len, bool concealed) {
+    LiveTelemetryRecord record;
+    if (!DecodeLiveTelemetry(telemetry, len, record)) return false;
+    if (concealed) record.flags |= LiveTelemetryRecord::kConcealed;
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!region_.data() || slot < 0 || static_cast<uint32_t>(slot) >= pod_slots_) return false;
+    LiveSegmentPodEntry& pod = pods_[slot];
+    if (pod.state != LivePodState::kConnected) return false;
+
+    record.index = pod.write_index;
+    record.session = static_cast<uint32_t>(pod.session);
+    record.publish_ns = LiveTelemetryClockNs();
+    uint8_t* at = RecordAt(region_.data(), pod_slots_, ring_records_, static_cast<uint32_t>(slot), record.index);
+    SeqlockWrite(at, at + sizeof(uint64_t), &record, sizeof(record));
+
+    pod.write_index++;
+    uint8_t* entry = PodEntryAt(region_.data(), static_cast<uint32_t>(slot));
+    Word(entry + offsetof(LiveSegmentPodEntry, write_index)).store(pod.write_index, std::memory_order_release);
+    return true;
+}
+
+void LiveTelemetrySegment::WritePodEntry(uint32_t slot, const LiveSegmentPodEntry& entry) {
+    uint8_t* at = PodEntryAt(region_.data(), slot);
+    SeqlockWrite(at, at + kPodEntryBodyOffset,
+                 reinterpret_cast<const uint8_t*>(&entry) + kPodEntryBodyOffset, kPodEntryBodySize);
+}
+
+// MARK: - LiveTelemetryReader
+
+bool LiveTelemetryReader::Open(const std::string& name, std::string* error) {
+    // Map the header alone first to learn the full size
+    SharedMemoryRegion probe;
+    if (!probe.Open(name, sizeof(LiveSegmentHeader), error)) return false;
+    uint32_t magic = std::atomic_ref<uint32_t>(*reinterpret_cast<uint32_t*>(probe.data()))
+                         .load(std::memory_order_acquire);
+    if (magic != kLiveSegmentMagic) {
+        if (error) *error = name + " is not a live telemetry segment (yet)";
+        return false;
+    }
+    LiveSegmentHeader header;
+    std::memcpy(&header, probe.data(), sizeof(header));
+    const uint32_t ring = header.ring_records;
+    if (header.version != kLiveSegmentVersion || header.record_size != kLiveSegmentRecordSize ||
+        header.pod_entry_size != sizeof(LiveSegmentPodEntry) || ring == 0 || (ring & (ring - 1)) != 0) {
+        if (error) *error = "Unsupported live telemetry segment version " + std::to_string(header.version);
+        return false;
+    }
+    if (!region_.Open(name, static_cast<size_t>(header.total_size), error)) return false;
+    header_ = header;
+    retries_ = 0;
+    return true;
+}
+
+uint64_t LiveTelemetryReader::WriteIndex(uint32_t slot) const {
+    const uint8_t* entry = PodEntryAt(region_.data(), slot);
+    return Word(entry + offsetof(LiveSegmentPodEntry, write_index)).load(std::memory_order_acquire);
+}
+
+std::optional<LiveTelemetryPod> LiveTelemetryReader::Pod(uint32_t slot) {
+    if (!region_.data() || slot >= header_.pod_slots) return std::nullopt;
+    const uint8_t* at = PodEntryAt(region_.data(), slot);
+    LiveSegmentPodEntry entry;
+    uint8_t* body = reinterpret_cast<uint8_t*>(&entry) + kPodEntryBodyOffset;
+    int attempts = 0;
+    while (!SeqlockRead(at, at + kPodEntryBodyOffset, body, kPodEntryBodySize)) {
+        retries_++;
+        if (++attempts >= kMaxReadAttempts) return std::nullopt;
+        std::this_thread::yield();
+    }
+    if (entry.state == LivePodState::kFree) return std::nullopt;
+
+    LiveTelemetryPod pod;
+    pod.slot = slot;
+    pod.state = entry.state;
+    pod.session = entry.session;
+    pod.device_id.assign(entry.device_id, strnlen(entry.device_id, sizeof(entry.device_id)));
+    pod.attached_ns = entry.attached_ns;
+    pod.published = WriteIndex(slot);
+    return pod;
+}
+
+std::vector<LiveTelemetryPod> LiveTelemetryReader::Pods() {
+    std::vector<LiveTelemetryPod> pods;
+    for (uint32_t slot = 0; slot < header_.pod_slots; slot++) {
+        if (auto pod = Pod(slot)) pods.push_back(std::move(*pod));
+    }
+    return pods;
+}
+
+// Copies the record stored where [index] lives. The caller compares the
+// copy's index with the one it wanted.
+bool LiveTelemetryReader::ReadRecord(uint32_t slot, uint64_t index, LiveTelemetryRecord& out) {
+    const uint8_t* at = RecordAt(region_.data(), header_.pod_slots, header_.ring_records, slot, index);
+    for (int attempt = 0; attempt < kMaxReadAttempts; attempt++) {
+        if (SeqlockRead(at, at + sizeof(uint64_t), &out, sizeof(out))) return true;
+        retries_++;
+        // The writer holds a record for well under a microsecond; spin first
+        if (attempt >= 16) std::this_thread::yield();
+    }
+    return false;
+}
+
+size_t LiveTelemetryReader::Poll(LiveTelemetryCursor& cursor, LiveTelemetryRecord* out, size_t max,
+                                 uint64_t* missed) {
+    if (!region_.data() || cursor.slot >= header_.pod_slots) return 0;
+    const uint64_t written = WriteIndex(cursor.slot);
+    if (cursor.next == LiveTelemetryCursor::kLatest || cursor.next > written) cursor.next = written;
+
+    const uint64_t ring = header_.ring_records;
+    if (written - cursor.next > ring) {
+        if (missed) *missed += written - ring - cursor.next;
+        cursor.next = written - ring;
+    }
+
+    size_t count = 0;
+    while (count < max && cursor.next < written) {
+        if (ReadRecord(cursor.slot, cursor.next, out[count]) && out[count].index == cursor.next) {
+            count++;
+        } else if (missed) {
+            (*missed)++;        // Overwritten while we were catching up
+        }
+        cursor.next++;
+    }
+    return count;
+}
+
+bool LiveTelemetryReader::Latest(uint32_t slot, LiveTelemetryRecord& out) {
+    if (!region_.data() || slot >= header_.pod_slots) return false;
+    const uint64_t written = WriteIndex(slot);
+    if (written == 0) return false;
+    // A newer record may have replaced it meanwhile, which is just as good
+    return ReadRecord(slot, written - 1, out) && out.index + 1 >= written;
+}
+
+} // namespace pod_connector
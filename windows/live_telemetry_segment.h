@@ -0,0 +1,238 @@
+#pragma once
+
+#include "shared_memory_region.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace pod_connector {
+
+// Shared-memory live telemetry segment.
+//
+// The plugin decodes every in-order 0x01 sample of each connected pod into a
+// fixed-size record and writes it into that pod's ring in a named shared
+// memory segment. Other processes map the segment read-only and poll it
+// without any IPC or locks: each record and each pod entry is guarded by a
+// sequence counter (seqlock), so a reader that races the writer simply
+// retries. Readers never block the writer; a reader that falls more than a
+// ring behind loses the oldest records and is told how many.
+//
+// Layout (little endian, offsets in bytes):
+//
+//   0                  LiveSegmentHeader (64)
+//   pods_offset        LiveSegmentPodEntry[pod_slots]          (128 each)
+//   rings_offset       pod_slots rings of ring_records records (128 each)
+//
+//   Record i of pod p lives at
+//     rings_offset + (p * ring_records + (i & (ring_records - 1))) * 128
+//   and holds [u64 seq][LiveTelemetryRecord].
+//
+// Seqlock protocol: the writer makes seq odd, writes the body, then makes it
+// even again (release). A reader loads seq (acquire), skips if odd, copies
+// the body, fences (acquire) and reloads seq; the copy is valid when both
+// loads match. Record bodies also carry their stream index, so a record that
+// was overwritten a lap later is told apart from the one the reader wanted.
+// The header is fully written before magic is stored (release), so a reader
+// that sees kLiveSegmentMagic sees the rest of it.
+//
+// Timestamps come from LiveTelemetryClockNs(), a system-wide monotonic clock
+// (CLOCK_MONOTONIC / QueryPerformanceCounter), so a reader in another process
+// can compute publish-to-read latency directly.
+//
+// Reader library: LiveTelemetryReader below. It only needs this header,
+// live_telemetry_segment.cpp and shared_memory_region.cpp.
+
+constexpr uint32_t kLiveSegmentMagic = 0x4C444F50;     // "PODL"
+constexpr uint16_t kLiveSegmentVersion = 1;
+
+/// Name the plugin uses unless told otherwise.
+std::string DefaultLiveTelemetrySegmentName();
+
+/// Nanoseconds on the clock used for LiveTelemetryRecord::publish_ns.
+uint64_t LiveTelemetryClockNs();
+
+/// Decoded 0x01 sample. Sensor values are as the pod reports them, except
+/// speed, which is converted from knots to km/h.
+struct LiveTelemetryRecord {
+    static constexpr uint32_t kFixValid = 1u << 0;
+    static constexpr uint32_t kConcealed = 1u << 1;    // Interpolated by the jitter buffer
+
+    uint64_t index = 0;             // Position in this pod's stream, from 0
+    uint64_t publish_ns = 0;
+    uint32_t kernel_tick = 0;       // Pod clock, ms
+    uint32_t flags = 0;
+    float battery_v = 0;
+    float accel[3] = {};
+    float gyro[3] = {};
+    float gravity[3] = {};
+    float latitude = 0;
+    float longitude = 0;
+    float speed_kmh = 0;
+    float course_deg = 0;
+    uint16_t year = 0;
+    uint8_t month = 0;
+    uint8_t day = 0;
+    uint8_t hour = 0;
+    uint8_t minute = 0;
+    uint8_t second = 0;
+    uint8_t fix_quality = 0;
+    uint16_t millisecond = 0;
+    uint8_t satellites = 0;
+    uint8_t reserved0 = 0;
+    uint32_t session = 0;           // Low bits of the pod entry's session when written
+    uint32_t reserved[6] = {};
+};
+
+static_assert(sizeof(LiveTelemetryRecord) == 120);
+static_assert(offsetof(LiveTelemetryRecord, kernel_tick) == 16);
+static_assert(offsetof(LiveTelemetryRecord, battery_v) == 24);
+static_assert(offsetof(LiveTelemetryRecord, latitude) == 64);
+static_assert(offsetof(LiveTelemetryRecord, year) == 80);
+static_assert(offsetof(LiveTelemetryRecord, millisecond) == 88);
+static_assert(offsetof(LiveTelemetryRecord, session) == 92);
+
+/// Decodes a 72-byte live telemetry body. False if [len] is too short.
+bool DecodeLiveTelemetry(const uint8_t* telemetry, size_t len, LiveTelemetryRecord& out);
+
+struct LiveSegmentHeader {
+    uint32_t magic = 0;             // Written last
+    uint16_t version = 0;
+    uint16_t header_size = 0;
+    uint32_t pod_slots = 0;
+    uint32_t ring_records = 0;      // Power of two
+    uint32_t record_size = 0;
+    uint32_t pod_entry_size = 0;
+    uint64_t pods_offset = 0;
+    uint64_t rings_offset = 0;
+    uint64_t total_size = 0;
+    uint32_t writer_pid = 0;
+    uint32_t reserved = 0;
+    uint64_t created_ns = 0;
+};
+
+static_assert(sizeof(LiveSegmentHeader) == 64);
+
+enum class LivePodState : uint32_t {
+    kFree = 0,
+    kConnected = 1,
+    kDisconnected = 2,              // Records stay readable until the slot is reused
+};
+
+/// Directory entry for one pod. write_index (records published so far) is
+/// stored with release after each record; the rest is seqlocked by seq.
+struct LiveSegmentPodEntry {
+    uint64_t seq = 0;
+    uint64_t write_index = 0;
+    uint64_t session = 0;           // Bumped each time a pod (re)attaches
+    LivePodState state = LivePodState::kFree;
+    uint32_t reserved0 = 0;
+    char device_id[64] = {};        // NUL-terminated
+    uint64_t attached_ns = 0;
+    uint64_t reserved[3] = {};
+};
+
+static_assert(sizeof(LiveSegmentPodEntry) == 128);
+static_assert(offsetof(LiveSegmentPodEntry, device_id) == 32);
+
+constexpr size_t kLiveSegmentRecordSize = sizeof(uint64_t) + sizeof(LiveTelemetryRecord);
+static_assert(kLiveSegmentRecordSize == 128);
+
+// MARK: - Writer
+
+/// Writer side, owned by the plugin. Publishing copies one record and bumps
+/// two counters; writers in this process serialize on a mutex that readers
+/// never see.
+class LiveTelemetrySegment {
+public:
+    static constexpr uint32_t kDefaultPodSlots = 8;
+    static constexpr uint32_t kDefaultRingRecords = 1024;  // ~100 s at 10 Hz
+
+    /// Creates the segment. [ringRecords] is rounded up to a power of two.
+    bool Create(const std::string& name, uint32_t podSlots, uint32_t ringRecords,
+                std::string* error);
+
+    const std::string& name() const { return name_; }
+    size_t size() const { return region_.size(); }
+
+    /// Claims a slot for [deviceId]: its previous slot if it had one, else a
+    /// free one, else the one disconnected longest ago. -1 when all are live.
+    int AttachPod(const std::string& deviceId);
+    void DetachPod(int slot);
+
+    /// Decodes [telemetry] and appends it to [slot]'s ring.
+    bool Publish(int slot, const uint8_t* telemetry, size_t len, bool concealed);
+
+private:
+    void WritePodEntry(uint32_t slot, const LiveSegmentPodEntry& entry);
+
+    std::mutex mtx_;
+    SharedMemoryRegion region_;
+    std::string name_;
+    uint32_t pod_slots_ = 0;
+    uint32_t ring_records_ = 0;
+    std::vector<LiveSegmentPodEntry> pods_;     // Writer's copy of the directory
+};
+
+// MARK: - Reader
+
+struct LiveTelemetryPod {
+    uint32_t slot = 0;
+    LivePodState state = LivePodState::kFree;
+    uint64_t session = 0;
+    std::string device_id;
+    uint64_t attached_ns = 0;
+    uint64_t published = 0;
+};
+
+/// Where a reader is in one pod's stream. A fresh cursor returns records
+/// published after its first poll; set [next] to 0 to start with whatever
+/// the ring still holds.
+struct LiveTelemetryCursor {
+    static constexpr uint64_t kLatest = ~0ull;
+
+    uint32_t slot = 0;
+    uint64_t next = kLatest;
+};
+
+/// Lock-free reader for another process. Not thread-safe itself; give each
+/// polling thread its own reader (mapping the segment twice is cheap).
+/// Busy-polling is only worth it with a core to spare; otherwise sleeping
+/// ~100 us between polls keeps latency well under a millisecond.
+class LiveTelemetryReader {
+public:
+    bool Open(const std::string& name, std::string* error);
+
+    uint32_t pod_slots() const { return header_.pod_slots; }
+    uint32_t ring_records() const { return header_.ring_records; }
+
+    /// The slot's directory entry; nullopt for a free slot.
+    std::optional<LiveTelemetryPod> Pod(uint32_t slot);
+    std::vector<LiveTelemetryPod> Pods();
+
+    /// Copies up to [max] records published since [cursor] into [out] and
+    /// advances it. Records overwritten before they were read are skipped
+    /// and added to [missed].
+    size_t Poll(LiveTelemetryCursor& cursor, LiveTelemetryRecord* out, size_t max,
+                uint64_t* missed = nullptr);
+
+    /// Newest record of [slot]; false if it has none.
+    bool Latest(uint32_t slot, LiveTelemetryRecord& out);
+
+    /// Reads that raced the writer and were retried.
+    uint64_t retries() const { return retries_; }
+
+private:
+    uint64_t WriteIndex(uint32_t slot) const;
+    bool ReadRecord(uint32_t slot, uint64_t index, LiveTelemetryRecord& out);
+
+    SharedMemoryRegion region_;
+    LiveSegmentHeader header_;
+    uint64_t retries_ = 0;
+};
+
+} // namespace pod_connector
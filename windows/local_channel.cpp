@@ -0,0 +1,362 @@
+#include "local_channel.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace pod_connector {
+
+#ifdef _WIN32
+
+namespace {
+
+std::wstring Widen(const std::string& s) {
+    int n = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), static_cast<int>(s.size()), nullptr, 0);
+    std::wstring w(n, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), static_cast<int>(s.size()), w.data(), n);
+    return w;
+}
+
+HANDLE CreatePipeInstance(const std::string& endpoint, bool first) {
+    DWORD open_mode = PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED;
+    if (first) open_mode |= FILE_FLAG_FIRST_PIPE_INSTANCE;
+    return CreateNamedPipeW(Widen(endpoint).c_str(), open_mode,
+                            PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                            PIPE_UNLIMITED_INSTANCES, 64 * 1024, 64 * 1024, 0, nullptr);
+}
+
+} // namespace
+
+std::string DefaultBrokerEndpoint() {
+    return "\\\\.\\pipe\\pod_ble_broker";
+}
+
+// MARK: - LocalStream (named pipe)
+
+LocalStream::LocalStream(void* handle)
+    : handle_(handle),
+      shutdown_event_(CreateEventW(nullptr, TRUE, FALSE, nullptr)),
+      read_event_(CreateEventW(nullptr, TRUE, FALSE, nullptr)),
+      write_event_(CreateEventW(nullptr, TRUE, FALSE, nullptr)) {}
+
+LocalStream::~LocalStream() {
+    CloseHandle(handle_);
+    CloseHandle(shutdown_event_);
+    CloseHandle(read_event_);
+    CloseHandle(write_event_);
+}
+
+bool LocalStream::Transfer(bool write, void* data, size_t length) {
+    HANDLE event = write ? write_event_ : read_event_;
+    auto* p = static_cast<uint8_t*>(data);
+    while (length > 0) {
+        if (WaitForSingleObject(shutdown_event_, 0) == WAIT_OBJECT_0) return false;
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(length, 1 << 20));
+        OVERLAPPED ov{};
+        ov.hEvent = event;
+        ResetEvent(event);
+        BOOL ok = write ? WriteFile(handle_, p, chunk, nullptr, &ov)
+                        : ReadFile(handle_, p, chunk, nullptr, &ov);
+        if (!ok) {
+            if (GetLastError() != ERROR_IO_PENDING) return false;
+            HANDLE waits[2] = {event, shutdown_event_};
+            if (WaitForMultipleObjects(2, waits, FALSE, INFINITE) != WAIT_OBJECT_0) {
+                CancelIoEx(handle_, &ov);
+            }
+        }
+        DWORD done = 0;
+        if (!GetOverlappedResult(handle_, &ov, &done, TRUE) || done == 0) return false;
+        p += done;
+        length -= done;
+    }
+    return true;
+}
+
+bool LocalStream::ReadAll(void* data, size_t length) {
+    return Transfer(false, data, length);
+}
+
+bool LocalStream::WriteAll(const void* data, size_t length) {
+    return Transfer(true, const_cast<void*>(data), length);
+}
+
+void LocalStream::Shutdown() {
+    SetEvent(shutdown_event_);
+}
+
+// MARK: - LocalServer (named pipe)
+
+LocalServer::~LocalServer() {
+    Close();
+    if (pending_) CloseHandle(pending_);
+    if (close_event_) CloseHandle(close_event_);
+}
+
+bool LocalServer::Listen(const std::string& endpoint, std::string* error) {
+    HANDLE pipe = CreatePipeInstance(endpoint, true);
+    if (pipe == INVALID_HANDLE_VALUE) {
+        if (error) {
+            *error = GetLastError() == ERROR_ACCESS_DENIED
+                         ? "Endpoint already in use: " + endpoint
+                         : "CreateNamedPipe failed: " + std::to_string(GetLastError());
+        }
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    endpoint_ = endpoint;
+    pending_ = pipe;
+    close_event_ = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    return true;
+}
+
+std::unique_ptr<LocalStream> LocalServer::Accept() {
+    if (!pending_ || !close_event_) return nullptr;
+    HANDLE connected = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    OVERLAPPED ov{};
+    ov.hEvent = connected;
+    bool ok = ConnectNamedPipe(pending_, &ov) != FALSE;
+    if (!ok) {
+        DWORD err = GetLastError();
+        if (err == ERROR_PIPE_CONNECTED) {
+            ok = true;
+        } else if (err == ERROR_IO_PENDING) {
+            HANDLE waits[2] = {connected, close_event_};
+            if (WaitForMultipleObjects(2, waits, FALSE, INFINITE) != WAIT_OBJECT_0) {
+                CancelIoEx(pending_, &ov);
+            }
+            DWORD ignored = 0;
+            ok = GetOverlappedResult(pending_, &ov, &ignored, TRUE) != FALSE;
+        }
+    }
+    CloseHandle(connected);
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!ok || closed_) return nullptr;
+    auto stream = std::make_unique<LocalStream>(pending_);
+    pending_ = CreatePipeInstance(endpoint_, false);
+    if (pending_ == INVALID_HANDLE_VALUE) pending_ = nullptr;
+    return stream;
+}
+
+void LocalServer::Close() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (closed_) return;
+    closed_ = true;
+    if (close_event_) SetEvent(close_event_);
+}
+
+// MARK: - Client (named pipe)
+
+std::unique_ptr<LocalStream> ConnectLocal(const std::string& endpoint, std::string* error) {
+    std::wstring name = Widen(endpoint);
+    for (int attempt = 0; attempt < 5; attempt++) {
+        HANDLE pipe = CreateFileW(name.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                                  OPEN_EXISTING, FILE_FLAG_OVERLAPPED, nullptr);
+        if (pipe != INVALID_HANDLE_VALUE) return std::make_unique<LocalStream>(pipe);
+        if (GetLastError() != ERROR_PIPE_BUSY) break;
+        // Every instance is taken; the broker creates the next one as it accepts
+        WaitNamedPipeW(name.c_str(), 2000);
+    }
+    if (error) *error = "Cannot open " + endpoint + ": " + std::to_string(GetLastError());
+    return nullptr;
+}
+
+#else
+
+namespace {
+
+bool FillAddress(const std::string& endpoint, sockaddr_un& addr, std::string* error) {
+    addr = {};
+    addr.sun_family = AF_UNIX;
+    if (endpoint.empty() || endpoint.size() >= sizeof(addr.sun_path)) {
+        if (error) *error = "Invalid socket path: " + endpoint;
+        return false;
+    }
+    std::memcpy(addr.sun_path, endpoint.c_str(), endpoint.size() + 1);
+    return true;
+}
+
+int OpenSocket() {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    return fd;
+}
+
+std::string Errno(const char* what) {
+    return std::string(what) + ": " + std::strerror(errno);
+}
+
+} // namespace
+
+std::string DefaultBrokerEndpoint() {
+    const char* runtime = std::getenv("XDG_RUNTIME_DIR");
+    std::string dir = runtime && *runtime ? runtime : "/tmp";
+    return dir + "/pod_ble_broker.sock";
+}
+
+// MARK: - LocalStream (Unix domain socket)
+
+LocalStream::LocalStream(int fd) : fd_(fd) {}
+
+LocalStream::~LocalStream() {
+    ::close(fd_);
+}
+
+bool LocalStream::ReadAll(void* data, size_t length) {
+    auto* p = static_cast<uint8_t*>(data);
+    while (length > 0) {
+        ssize_t n = ::recv(fd_, p, length, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool LocalStream::WriteAll(const void* data, size_t length) {
+#ifdef MSG_NOSIGNAL
+    constexpr int kFlags = MSG_NOSIGNAL;
+#else
+    constexpr int kFlags = 0;
+#endif
+    const auto* p = static_cast<const uint8_t*>(data);
+    while (length > 0) {
+        ssize_t n = ::send(fd_, p, length, kFlags);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void LocalStream::Shutdown() {
+    ::shutdown(fd_, SHUT_RDWR);
+}
+
+// MARK: - LocalServer (Unix domain socket)
+
+LocalServer::~LocalServer() {
+    Close();
+    if (fd_ >= 0) ::close(fd_);
+    if (wake_[0] >= 0) ::close(wake_[0]);
+    if (wake_[1] >= 0) ::close(wake_[1]);
+}
+
+bool LocalServer::Listen(const std::string& endpoint, std::string* error) {
+    sockaddr_un addr;
+    if (!FillAddress(endpoint, addr, error)) return false;
+
+    // A socket file nobody answers on is left over from a crashed broker
+    int probe = OpenSocket();
+    if (probe >= 0) {
+        bool live = ::connect(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        ::close(probe);
+        if (live) {
+            if (error) *error = "Endpoint already in use: " + endpoint;
+            return false;
+        }
+    }
+    ::unlink(endpoint.c_str());
+
+    int fd = OpenSocket();
+    if (fd < 0) {
+        if (error) *error = Errno("socket");
+        return false;
+    }
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd, 16) != 0) {
+        if (error) *error = Errno("bind/listen");
+        ::close(fd);
+        return false;
+    }
+    // Same-user clients only
+    ::chmod(endpoint.c_str(), S_IRUSR | S_IWUSR);
+
+    int wake[2];
+    if (::pipe(wake) != 0) {
+        if (error) *error = Errno("pipe");
+        ::close(fd);
+        ::unlink(endpoint.c_str());
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    endpoint_ = endpoint;
+    fd_ = fd;
+    wake_[0] = wake[0];
+    wake_[1] = wake[1];
+    return true;
+}
+
+std::unique_ptr<LocalStream> LocalServer::Accept() {
+    if (fd_ < 0) return nullptr;
+    while (true) {
+        pollfd fds[2] = {{fd_, POLLIN, 0}, {wake_[0], POLLIN, 0}};
+        int ready = ::poll(fds, 2, -1);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready < 0 || fds[1].revents != 0) return nullptr;
+        int client = ::accept(fd_, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            return nullptr;
+        }
+        ::fcntl(client, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+        int one = 1;
+        ::setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+        return std::make_unique<LocalStream>(client);
+    }
+}
+
+void LocalServer::Close() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (closed_ || fd_ < 0) return;
+    closed_ = true;
+    char byte = 0;
+    (void)!::write(wake_[1], &byte, 1);
+    ::unlink(endpoint_.c_str());
+}
+
+// MARK: - Client (Unix domain socket)
+
+std::unique_ptr<LocalStream> ConnectLocal(const std::string& endpoint, std::string* error) {
+    sockaddr_un addr;
+    if (!FillAddress(endpoint, addr, error)) return nullptr;
+    int fd = OpenSocket();
+    if (fd < 0) {
+        if (error) *error = Errno("socket");
+        return nullptr;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        if (error) *error = Errno(("connect " + endpoint).c_str());
+        ::close(fd);
+        return nullptr;
+    }
+    return std::make_unique<LocalStream>(fd);
+}
+
+#endif
+
+} // namespace pod_connector
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace pod_connector {
+
+/// Default broker endpoint: `\\.\pipe\pod_ble_broker` on Windows,
+/// `$XDG_RUNTIME_DIR/pod_ble_broker.sock` (or `/tmp/...`) elsewhere.
+std::string DefaultBrokerEndpoint();
+
+/// One connected byte stream between two local processes: a Unix domain
+/// socket, or an overlapped named-pipe instance on Windows.
+///
+/// One thread may read while another writes. Shutdown() can be called from
+/// any thread and makes pending and later reads and writes fail, which is how
+/// the owner unblocks a reader before joining it.
+class LocalStream {
+public:
+#ifdef _WIN32
+    explicit LocalStream(void* handle);
+#else
+    explicit LocalStream(int fd);
+#endif
+    ~LocalStream();
+
+    LocalStream(const LocalStream&) = delete;
+    LocalStream& operator=(const LocalStream&) = delete;
+
+    /// Blocks until [length] bytes arrived. False on end of stream or error.
+    bool ReadAll(void* data, size_t length);
+
+    /// Blocks until [length] bytes were written. False on error.
+    bool WriteAll(const void* data, size_t length);
+
+    void Shutdown();
+
+private:
+#ifdef _WIN32
+    bool Transfer(bool write, void* data, size_t length);
+
+    void* handle_;
+    void* shutdown_event_;
+    void* read_event_;
+    void* write_event_;
+#else
+    int fd_;
+#endif
+};
+
+/// Listening end of the broker endpoint.
+class LocalServer {
+public:
+    LocalServer() = default;
+    ~LocalServer();
+
+    LocalServer(const LocalServer&) = delete;
+    LocalServer& operator=(const LocalServer&) = delete;
+
+    /// Claims [endpoint]. Fails if another live broker already owns it; a
+    /// stale socket file left by a crashed one is replaced.
+    bool Listen(const std::string& endpoint, std::string* error);
+
+    /// Blocks until a client connects. Returns null once Close() was called.
+    std::unique_ptr<LocalStream> Accept();
+
+    /// Unblocks Accept() and releases the endpoint. Safe from any thread.
+    void Close();
+
+private:
+    std::mutex mtx_;
+    std::string endpoint_;
+    bool closed_ = false;
+#ifdef _WIN32
+    void* close_event_ = nullptr;
+    void* pending_ = nullptr;   // Pipe instance waiting for the next client
+#else
+    int fd_ = -1;
+    int wake_[2] = {-1, -1};    // Self-pipe that interrupts poll() in Accept()
+#endif
+};
+
+/// Connects to a broker listening on [endpoint].
+std::unique_ptr<LocalStream> ConnectLocal(const std::string& endpoint, std::string* error);
+
+} // namespace pod_connector
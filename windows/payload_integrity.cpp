@@ -0,0 +1,299 @@
+#include "payload_integrity.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define POD_CRC32C_X64 1
+#include <nmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(_M_ARM64) && defined(_MSC_VER)
+#define POD_CRC32C_ARM64 1
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <intrin.h>
+#endif
+
+namespace pod_connector {
+
+// MARK: - CRC32C
+
+namespace {
+
+constexpr uint32_t kCastagnoliReflected = 0x82F63B78u;
+
+// Slicing-by-8 tables: kTables[k][b] is the CRC of byte b followed by k zero bytes
+struct Crc32cTables {
+    std::array<std::array<uint32_t, 256>, 8> t{};
+
+    Crc32cTables() {
+        for (uint32_t b = 0; b < 256; b++) {
+            uint32_t crc = b;
+            for (int i = 0; i < 8; i++) crc = (crc >> 1) ^ (kCastagnoliReflected & (0u - (crc & 1u)));
+            t[0][b] = crc;
+        }
+        for (uint32_t b = 0; b < 256; b++) {
+            for (int k = 1; k < 8; k++) t[k][b] = (t[k - 1][b] >> 8) ^ t[0][t[k - 1][b] & 0xFF];
+        }
+    }
+};
+
+const Crc32cTables& Tables() {
+    static const Crc32cTables tables;
+    return tables;
+}
+
+uint32_t Crc32cSoftware(uint32_t crc, const uint8_t* p, size_t len) {
+    const auto& t = Tables().t;
+    while (len >= 8) {
+        uint32_t lo;
+        uint32_t hi;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + 4, 4);
+        lo ^= crc;
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        p += 8;
+        len -= 8;
+    }
+    while (len--) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    return crc;
+}
+
+#if defined(POD_CRC32C_X64)
+#if !defined(_MSC_VER)
+__attribute__((target("sse4.2")))
+#endif
+uint32_t Crc32cHardware(uint32_t crc, const uint8_t* p, size_t len) {
+    uint64_t c = crc;
+    while (len >= 8) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        c = _mm_crc32_u64(c, v);
+        p += 8;
+        len -= 8;
+    }
+    uint32_t c32 = static_cast<uint32_t>(c);
+    while (len--) c32 = _mm_crc32_u8(c32, *p++);
+    return c32;
+}
+
+bool DetectHardwareCrc() {
+#if defined(_MSC_VER)
+    int regs[4] = {};
+    __cpuid(regs, 1);
+    return (regs[2] & (1 << 20)) != 0;  // ECX.SSE4_2
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+    return (ecx & bit_SSE4_2) != 0;
+#endif
+}
+#elif defined(POD_CRC32C_ARM64)
+uint32_t Crc32cHardware(uint32_t crc, const uint8_t* p, size_t len) {
+    while (len >= 8) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        crc = __crc32cd(crc, v);
+        p += 8;
+        len -= 8;
+    }
+    while (len--) crc = __crc32cb(crc, *p++);
+    return crc;
+}
+
+bool DetectHardwareCrc() {
+    return IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE) != 0;
+}
+#else
+uint32_t Crc32cHardware(uint32_t crc, const uint8_t* p, size_t len) {
+    return Crc32cSoftware(crc, p, len);
+}
+
+bool DetectHardwareCrc() { return false; }
+#endif
+
+bool HardwareCrcAvailable() {
+    static const bool available = DetectHardwareCrc();
+    return available;
+}
+
+void PutU32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v >> 16));
+    out.push_back(static_cast<uint8_t>(v >> 24));
+}
+
+}  // namespace
+
+uint32_t Crc32c(uint32_t crc, const uint8_t* data, size_t len) {
+    crc = ~crc;
+    crc = HardwareCrcAvailable() ? Crc32cHardware(crc, data, len) : Crc32cSoftware(crc, data, len);
+    return ~crc;
+}
+
+uint32_t Crc32cPortable(uint32_t crc, const uint8_t* data, size_t len) {
+    return ~Crc32cSoftware(~crc, data, len);
+}
+
+bool Crc32cIsHardwareAccelerated() {
+    return HardwareCrcAvailable();
+}
+
+// MARK: - TransferIntegrity
+
+std::vector<uint8_t> TransferIntegrity::Serialize() const {
+    std::vector<uint8_t> out;
+    out.reserve(31 + validity.size());
+    out.push_back(kMessageType);
+    PutU32(out, crc32c);
+    out.push_back(flags);
+    out.push_back(static_cast<uint8_t>(record_size));
+    PutU32(out, static_cast<uint32_t>(records));
+    PutU32(out, static_cast<uint32_t>(valid_records));
+    PutU32(out, static_cast<uint32_t>(missing_blocks));
+    PutU32(out, static_cast<uint32_t>(duplicate_blocks));
+    PutU32(out, static_cast<uint32_t>(data_bytes));
+    out.insert(out.end(), validity.begin(), validity.end());
+    return out;
+}
+
+// MARK: - PayloadIntegrityTracker
+
+void PayloadIntegrityTracker::Begin(uint32_t firstSequence, size_t dataOffset) {
+    result_ = TransferIntegrity{};
+    data_offset_ = dataOffset;
+    record_size_ = 0;
+    next_record_ = 0;
+    have_first_sequence_ = true;
+    sequence_trusted_ = false;
+    sequence_decided_ = false;
+    expected_sequence_ = firstSequence + 1;
+    gaps_.clear();
+}
+
+void PayloadIntegrityTracker::AppendFirstBlock(std::vector<uint8_t>& buffer, const uint8_t* data, size_t len) {
+    result_.blocks++;
+    if (len == 0) return;
+    buffer.insert(buffer.end(), data, data + len);
+    Hash(data, len);
+    ScanRecords(buffer);
+}
+
+bool PayloadIntegrityTracker::AppendBlock(std::vector<uint8_t>& buffer, uint32_t sequence,
+                                          const uint8_t* data, size_t len, size_t blockPayloadSize) {
+    result_.blocks++;
+
+    if (have_first_sequence_ && !sequence_decided_) {
+        // Only a strictly consecutive second block proves bytes 1-4 are a block counter
+        sequence_decided_ = true;
+        sequence_trusted_ = (sequence == expected_sequence_);
+    }
+
+    if (sequence_trusted_) {
+        if (sequence < expected_sequence_) {
+            // Retransmitted block — already have it
+            result_.duplicate_blocks++;
+            return false;
+        }
+        if (sequence > expected_sequence_) {
+            uint32_t missing = sequence - expected_sequence_;
+            result_.missing_blocks += static_cast<int>(missing);
+            if (missing <= kMaxPadBlocks && blockPayloadSize > 0) {
+                // Zero-fill so every record after the gap stays on its stride
+                size_t begin = buffer.size();
+                buffer.resize(begin + static_cast<size_t>(missing) * blockPayloadSize, 0);
+                gaps_.emplace_back(begin, buffer.size());
+                result_.flags |= TransferIntegrity::kGapsPadded;
+            } else {
+                result_.flags |= TransferIntegrity::kGapsUnpadded;
+            }
+        }
+        expected_sequence_ = sequence + 1;
+    }
+
+    if (len > 0) {
+        buffer.insert(buffer.end(), data, data + len);
+        Hash(data, len);
+    }
+    ScanRecords(buffer);
+    return true;
+}
+
+void PayloadIntegrityTracker::SetRecordSize(int recordSize, const std::vector<uint8_t>& buffer) {
+    if (record_size_ != 0 || recordSize <= 0) return;
+    record_size_ = recordSize;
+    ScanRecords(buffer);
+}
+
+TransferIntegrity PayloadIntegrityTracker::Finish(const std::vector<uint8_t>& buffer,
+                                                  uint32_t previousCrc, size_t previousBytes) {
+    ScanRecords(buffer);
+    result_.record_size = record_size_;
+    if (sequence_trusted_) result_.flags |= TransferIntegrity::kSequenceVerified;
+
+    bool complete = result_.missing_blocks == 0;
+    if (complete && previousBytes > 0 && previousBytes == result_.data_bytes) {
+        result_.flags |= (previousCrc == result_.crc32c)
+            ? TransferIntegrity::kDigestMatched
+            : TransferIntegrity::kDigestMismatch;
+    }
+
+    TransferIntegrity out = std::move(result_);
+    result_ = TransferIntegrity{};
+    have_first_sequence_ = false;
+    gaps_.clear();
+    return out;
+}
+
+bool PayloadIntegrityTracker::IsPlausibleHeader(const uint8_t* record, size_t available) {
+    if (available < 8) return false;
+    int year = record[4] | (record[5] << 8);
+    int month = record[6];
+    int day = record[7];
+    return year >= 2022 && year <= 2030 && month >= 1 && month <= 12 && day >= 1 && day <= 31;
+}
+
+void PayloadIntegrityTracker::Hash(const uint8_t* data, size_t len) {
+    result_.crc32c = Crc32c(result_.crc32c, data, len);
+    result_.data_bytes += len;
+}
+
+void PayloadIntegrityTracker::ScanRecords(const std::vector<uint8_t>& buffer) {
+    if (record_size_ <= 0 || buffer.size() <= data_offset_) return;
+
+    const size_t size = static_cast<size_t>(record_size_);
+    const size_t complete = (buffer.size() - data_offset_) / size;
+    if (complete <= next_record_) return;
+
+    result_.validity.resize((complete + 7) / 8, 0);
+    for (size_t i = next_record_; i < complete; i++) {
+        size_t begin = data_offset_ + i * size;
+        size_t end = begin + size;
+
+        bool valid = IsPlausibleHeader(buffer.data() + begin, size);
+        for (const auto& [gapBegin, gapEnd] : gaps_) {
+            if (begin < gapEnd && gapBegin < end) {
+                valid = false;
+                break;
+            }
+        }
+
+        if (valid) {
+            result_.validity[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+            result_.valid_records++;
+        }
+    }
+    next_record_ = complete;
+    result_.records = static_cast<int>(complete);
+}
+
+} // namespace pod_connector
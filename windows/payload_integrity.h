@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pod_connector {
+
+/// CRC32C (Castagnoli). Uses the SSE4.2 / ARMv8 CRC instructions when the CPU
+/// has them and a slicing-by-8 table otherwise. Pass the previous return value
+/// as [crc] to continue a rolling checksum (start with 0).
+uint32_t Crc32c(uint32_t crc, const uint8_t* data, size_t len);
+
+/// Table-driven path only, regardless of CPU support (benchmark baseline).
+uint32_t Crc32cPortable(uint32_t crc, const uint8_t* data, size_t len);
+
+/// True when Crc32c runs on the hardware path (for diagnostics / benchmarks).
+bool Crc32cIsHardwareAccelerated();
+
+/// Integrity summary of one reassembled file transfer.
+struct TransferIntegrity {
+    /// Synthetic message type delivered on the payload stream immediately
+    /// before the 0x03 payload it describes (alongside 0xDA "skipped").
+    static constexpr uint8_t kMessageType = 0xDB;
+
+    enum Flags : uint8_t {
+        kSequenceVerified = 0x01,   // Block sequence numbers were trusted and checked
+        kDigestMatched = 0x02,      // CRC equals an earlier complete download of the same file
+        kDigestMismatch = 0x04,     // Same file and length as before, different CRC
+        kGapsPadded = 0x08,         // Missing blocks were zero-filled to keep record alignment
+        kGapsUnpadded = 0x10,       // A gap was too long to fill: records after it are off their stride
+    };
+
+    uint32_t crc32c = 0;            // Over every received data byte (padding excluded)
+    uint8_t flags = 0;
+    int record_size = 0;            // 47 / 61 / 64, 0 if unknown
+    int blocks = 0;                 // BLE notifications consumed
+    int missing_blocks = 0;
+    int duplicate_blocks = 0;
+    int records = 0;                // Whole records in the payload
+    int valid_records = 0;
+    size_t data_bytes = 0;          // Bytes hashed
+
+    /// Bit i (LSB first) set = record i has a plausible header and does not
+    /// overlap a missing block. Consumers can parse at a fixed stride and skip
+    /// their own header validation.
+    std::vector<uint8_t> validity;
+
+    /// Wire format (little endian):
+    ///   [0xDB][crc32c u32][flags u8][record_size u8][records u32]
+    ///   [valid_records u32][missing_blocks u32][duplicate_blocks u32]
+    ///   [data_bytes u32][validity bitmap ...]
+    std::vector<uint8_t> Serialize() const;
+};
+
+/// Per-transfer integrity tracking, driven by the packet reassembler.
+///
+/// The pod's BLE framing carries a 32-bit block sequence number at bytes 1-4.
+/// It is only trusted once the first two blocks of a transfer are numbered
+/// consecutively; from then on duplicates are dropped and gaps are zero-filled
+/// (up to kMaxPadBlocks per gap) so records after a gap stay on their stride.
+/// A longer gap is left as is and flagged kGapsUnpadded; losses before the
+/// sequence is trusted cannot be seen at all, so consumers should rely on the
+/// stride only with kSequenceVerified set.
+/// Record validity is evaluated incrementally as records complete, so the
+/// bitmap is ready as soon as the last block arrives.
+///
+/// Not thread-safe: owned by the reassembler, which runs on one thread at a time.
+class PayloadIntegrityTracker {
+public:
+    static constexpr uint32_t kMaxPadBlocks = 64;
+
+    /// Starts a new transfer. [dataOffset] is where record data begins in the
+    /// reassembly buffer (1: after the message type byte).
+    void Begin(uint32_t firstSequence, size_t dataOffset);
+
+    /// Appends one block's data to [buffer], handling duplicates and gaps.
+    /// [blockPayloadSize] is the data length of a full block, used to size the
+    /// padding for missing ones. Returns false if the block was a duplicate and
+    /// was not appended.
+    bool AppendBlock(std::vector<uint8_t>& buffer, uint32_t sequence,
+                     const uint8_t* data, size_t len, size_t blockPayloadSize);
+
+    /// Appends the first block's data (sequence already passed to Begin).
+    void AppendFirstBlock(std::vector<uint8_t>& buffer, const uint8_t* data, size_t len);
+
+    /// Enables record validation. Call once the record size is known; records
+    /// already in the buffer are evaluated immediately.
+    void SetRecordSize(int recordSize, const std::vector<uint8_t>& buffer);
+    int RecordSize() const { return record_size_; }
+
+    /// Blocks known to be missing (counts toward transfer completion).
+    int MissingBlocks() const { return result_.missing_blocks; }
+
+    /// Finalises the summary. [previousCrc]/[previousBytes] describe an earlier
+    /// complete download of the same file (0 bytes = none).
+    TransferIntegrity Finish(const std::vector<uint8_t>& buffer,
+                             uint32_t previousCrc, size_t previousBytes);
+
+    /// Plausible record header: year 2022-2030, month 1-12, day 1-31.
+    static bool IsPlausibleHeader(const uint8_t* record, size_t available);
+
+private:
+    TransferIntegrity result_;
+    size_t data_offset_ = 1;
+    int record_size_ = 0;
+    size_t next_record_ = 0;                        // First record not yet evaluated
+    bool have_first_sequence_ = false;
+    bool sequence_trusted_ = false;
+    bool sequence_decided_ = false;
+    uint32_t expected_sequence_ = 0;
+    std::vector<std::pair<size_t, size_t>> gaps_;   // Zero-filled [begin, end) in buffer
+
+    void Hash(const uint8_t* data, size_t len);
+    void ScanRecords(const std::vector<uint8_t>& buffer);
+};
+
+} // namespace pod_connector
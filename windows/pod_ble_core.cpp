@@ -17,24 +17,79 @@ const winrt::guid PodBLECore::NOTIFY_CHAR_UUID{0x5E0C4072, 0xEE4D, 0x450D,
 const winrt::guid PodBLECore::WRITE_CHAR_UUID{0xFB4A9352, 0x9BCD, 0x4CC6,
     {0x80, 0xE4, 0xAE, 0x37, 0xD1, 0x6F, 0xFB, 0xF1}};
 
-PodBLECore::PodBLECore() {}
+PodBLECore::PodBLECore(std::shared_ptr<CoreScheduler> scheduler)
+    : scheduler_(scheduler ? std::move(scheduler) : std::make_shared<ThreadScheduler>()) {
+    auto send = [this](const std::vector<uint8_t>& command) { SendCommand(command); };
+    auto gate = [this] { return CommandGate(); };
+    settings_verifier_ = std::make_unique<SettingsVerifier>(
+        *scheduler_, reply_matcher_, alive_, send, gate,
+        // Flutter sees every reply, as if it had asked for it itself
+        [this](const PodSettings& settings) {
+            if (on_payload_) on_payload_(EncodeSettingsPayload(settings));
+        });
+    file_deleter_ = std::make_unique<FileDeleter>(*scheduler_, reply_matcher_, alive_, send, gate);
+}
 
 PodBLECore::~PodBLECore() {
+    // Tear down on the strand; tasks still queued after it see alive_ false
+    OnStrand([this] {
+        StopWatchdog();
+        StopLivePlayout();
+        Disconnect();
+        AllowSleep();
+    });
     alive_->store(false);
-    StopWatchdog();
-    Disconnect();
-    AllowSleep();
+    // Waits out a task still running on our own timer thread
+    scheduler_.reset();
+}
+
+// MARK: - Strand
+
+bool PodBLECore::PostToStrand(std::function<void()> call) {
+    if (scheduler_->IsCurrent()) return false;
+    scheduler_->Post([alive = alive_, call = std::move(call)]() {
+        if (alive->load()) call();
+    });
+    return true;
+}
+
+void PodBLECore::StrandAwaiter::await_suspend(std::coroutine_handle<> handle) const {
+    core->scheduler_->Post([alive = core->alive_, handle]() {
+        if (alive->load()) handle.resume();
+    });
 }
 
 void PodBLECore::SetCallbacks(StatusCallback status, ScanCallback scan, PayloadCallback payload) {
-    on_status_ = std::move(status);
-    on_scan_ = std::move(scan);
-    on_payload_ = std::move(payload);
+    OnStrand([&] {
+        // Outputs pass through the session recorder, if one is set
+        on_status_ = [this, status = std::move(status)](const std::string& text) {
+            if (recording_) {
+                auto event = SessionEvent::Of(SessionEvent::Kind::kOutStatus);
+                event.text = text;
+                Record(std::move(event));
+            }
+            if (status) status(text);
+        };
+        on_scan_ = std::move(scan);
+        on_payload_ = [this, payload = std::move(payload)](const std::vector<uint8_t>& data) {
+            if (recording_) Record(SessionEvent::Payload(data));
+            if (payload) payload(data);
+        };
+    });
+}
+
+void PodBLECore::SetHistoryStore(std::shared_ptr<PodHistoryStore> store) {
+    OnStrand([&] { history_ = std::move(store); });
+}
+
+void PodBLECore::SetIdleDowngradeDelay(std::chrono::milliseconds delay) {
+    OnStrand([&] { idle_downgrade_delay_ = delay; });
 }
 
 // MARK: - Scanning
 
 void PodBLECore::StartScan() {
+    if (PostToStrand([this] { StartScan(); })) return;
     // Stop any existing watcher first to prevent overlapping watcher state
     StopScan();
     CheckRadioAndScan();
@@ -44,6 +99,7 @@ winrt::fire_and_forget PodBLECore::CheckRadioAndScan() {
     // Check Bluetooth radio state before scanning (matches iOS/macOS/Android behaviour)
     try {
         auto radios = co_await Windows::Devices::Radios::Radio::GetRadiosAsync();
+        co_await ResumeOnStrand();
 
         Windows::Devices::Radios::Radio btRadio{nullptr};
         for (auto const& radio : radios) {
@@ -65,6 +121,7 @@ winrt::fire_and_forget PodBLECore::CheckRadioAndScan() {
     } catch (...) {
         // Radio API unavailable (older Windows) — proceed optimistically
     }
+    co_await ResumeOnStrand();
 
     // Radio is on — proceed with scan
     // Guard: only create watcher if null (StopScan nullified it)
@@ -73,8 +130,9 @@ winrt::fire_and_forget PodBLECore::CheckRadioAndScan() {
     watcher_ = BluetoothLEAdvertisementWatcher();
     watcher_.ScanningMode(BluetoothLEScanningMode::Active);
 
-    watcher_.Received([this](auto const& watcher, auto const& args) {
-        OnAdvertisementReceived(watcher, args);
+    watcher_.Received([this, alive = alive_](auto const& watcher, auto const& args) {
+        if (!alive->load()) return;
+        PostToStrand([this, watcher, args] { OnAdvertisementReceived(watcher, args); });
     });
 
     try {
@@ -88,13 +146,13 @@ winrt::fire_and_forget PodBLECore::CheckRadioAndScan() {
     if (on_status_) on_status_("Scanning...");
 
     // Auto-stop after 15 seconds
-    std::thread([this, alive = alive_]() {
-        std::this_thread::sleep_for(std::chrono::seconds(15));
+    scheduler_->After(std::chrono::seconds(15), [this, alive = alive_]() {
         if (alive->load()) StopScan();
-    }).detach();
+    });
 }
 
 void PodBLECore::StopScan() {
+    if (PostToStrand([this] { StopScan(); })) return;
     if (watcher_ != nullptr) {
         try {
             watcher_.Stop();
@@ -136,9 +194,18 @@ void PodBLECore::OnAdvertisementReceived(
 // MARK: - Connection
 
 void PodBLECore::Connect(const std::string& deviceAddress) {
+    ConnectAndWaitAsync(deviceAddress);
+}
+
+Windows::Foundation::IAsyncOperation<bool> PodBLECore::ConnectAndWaitAsync(std::string deviceAddress) {
+    co_await ResumeOnStrand();
     StopScan();
     if (on_status_) on_status_("Connecting...");
 
+    device_address_ = deviceAddress;
+    connect_started_ = scheduler_->Now();
+    negotiated_mtu_ = 0;
+
     // Parse address string back to uint64
     uint64_t addr = 0;
     std::istringstream ss(deviceAddress);
@@ -147,47 +214,61 @@ void PodBLECore::Connect(const std::string& deviceAddress) {
         addr = (addr << 8) | std::stoul(byte_str, nullptr, 16);
     }
 
-    ConnectAsync(addr);
+    // Cancelling the returned operation tears down the half-open link
+    auto cancel = co_await winrt::get_cancellation_token();
+    cancel.enable_propagation();
+    cancel.callback([this, alive = alive_]() {
+        if (alive->load()) Disconnect();
+    });
+
+    bool connected = co_await ConnectAsync(addr);
+    co_await ResumeOnStrand();
+    co_return connected;
 }
 
-winrt::fire_and_forget PodBLECore::ConnectAsync(uint64_t address) {
+Windows::Foundation::IAsyncOperation<bool> PodBLECore::ConnectAsync(uint64_t address) {
     try {
-        device_ = co_await BluetoothLEDevice::FromBluetoothAddressAsync(address);
+        auto device = co_await BluetoothLEDevice::FromBluetoothAddressAsync(address);
+        co_await ResumeOnStrand();
+        device_ = device;
         if (device_ == nullptr) {
             if (on_status_) on_status_("Device Not Found");
-            co_return;
+            co_return false;
         }
 
-        // Subscribe to connection status changes to detect unexpected disconnects
+        // Subscribe to connection status changes to detect unexpected disconnects.
+        // Raised on a WinRT thread: only the sender is read there.
         connection_token_ = device_.ConnectionStatusChanged(
-            [this, alive = alive_](BluetoothLEDevice const&, auto const&) {
+            [this, alive = alive_](BluetoothLEDevice const& sender, auto const&) {
                 if (!alive->load()) return;
                 try {
-                    if (device_ != nullptr &&
-                        device_.ConnectionStatus() == BluetoothConnectionStatus::Disconnected) {
-                        Disconnect();
+                    if (sender.ConnectionStatus() == BluetoothConnectionStatus::Disconnected) {
+                        PostToStrand([this, sender] {
+                            if (device_ == sender) Disconnect();
+                        });
                     }
                 } catch (const winrt::hresult_error&) {
                 } catch (const std::exception&) {
                 } catch (...) {}
             });
 
-        PreventSleep();
-
         // Service discovery — wrapped in try-catch so one failing step
         // doesn't crash the entire connection flow
+        const char* discoveryError = nullptr;
         try {
             auto servicesResult = co_await device_.GetGattServicesForUuidAsync(SERVICE_UUID);
+            co_await ResumeOnStrand();
             if (servicesResult.Status() != GattCommunicationStatus::Success ||
                 servicesResult.Services().Size() == 0) {
                 if (on_status_) on_status_("Service Not Found");
-                co_return;
+                co_return false;
             }
 
             auto service = servicesResult.Services().GetAt(0);
 
             // Get Notify Characteristic
             auto notifyResult = co_await service.GetCharacteristicsForUuidAsync(NOTIFY_CHAR_UUID);
+            co_await ResumeOnStrand();
             if (notifyResult.Status() == GattCommunicationStatus::Success &&
                 notifyResult.Characteristics().Size() > 0) {
                 notify_char_ = notifyResult.Characteristics().GetAt(0);
@@ -195,8 +276,10 @@ winrt::fire_and_forget PodBLECore::ConnectAsync(uint64_t address) {
                 // Enable notifications
                 auto status = co_await notify_char_.WriteClientCharacteristicConfigurationDescriptorAsync(
                     GattClientCharacteristicConfigurationDescriptorValue::Notify);
+                co_await ResumeOnStrand();
 
                 if (status == GattCommunicationStatus::Success) {
+                    // Copied out on the WinRT thread, reassembled on the strand
                     notify_token_ = notify_char_.ValueChanged(
                         [this, alive = alive_](auto const&, GattValueChangedEventArgs const& args) {
                         if (!alive->load()) return;
@@ -205,17 +288,7 @@ winrt::fire_and_forget PodBLECore::ConnectAsync(uint64_t address) {
                             reader.ByteOrder(ByteOrder::LittleEndian);
                             std::vector<uint8_t> data(reader.UnconsumedBufferLength());
                             reader.ReadBytes(data);
-
-                            {
-                                std::lock_guard<std::mutex> lock(mtx_);
-                                last_packet_time_ = std::chrono::steady_clock::now();
-                            }
-
-                            if (total_expected_packets_ > 0 || received_packet_count_ == 0) {
-                                ProcessPacket(data);
-                            } else {
-                                if (on_payload_) on_payload_(data);
-                            }
+                            PostToStrand([this, data = std::move(data)] { OnNotification(data); });
                         } catch (const winrt::hresult_error&) {
                         } catch (const std::exception&) {
                         } catch (...) {}
@@ -225,52 +298,89 @@ winrt::fire_and_forget PodBLECore::ConnectAsync(uint64_t address) {
 
             // Get Write Characteristic
             auto writeResult = co_await service.GetCharacteristicsForUuidAsync(WRITE_CHAR_UUID);
+            co_await ResumeOnStrand();
             if (writeResult.Status() == GattCommunicationStatus::Success &&
                 writeResult.Characteristics().Size() > 0) {
                 write_char_ = writeResult.Characteristics().GetAt(0);
             }
         } catch (const winrt::hresult_error&) {
-            if (on_status_) on_status_("Service Discovery Error");
-            co_return;
+            discoveryError = "Service Discovery Error";
         } catch (const std::exception&) {
-            if (on_status_) on_status_("Connection Error");
-            co_return;
+            discoveryError = "Connection Error";
         } catch (...) {
-            if (on_status_) on_status_("Connection Error");
-            co_return;
+            discoveryError = "Connection Error";
+        }
+        // A throwing co_await leaves us on a WinRT thread
+        co_await ResumeOnStrand();
+        if (discoveryError) {
+            if (on_status_) on_status_(discoveryError);
+            co_return false;
         }
 
         // MTU negotiation: establishing a GattSession can trigger MTU negotiation
         // on some Windows adapters. We read the negotiated value for diagnostics.
+        int mtu = 0;
         try {
             auto gattSession = co_await GattSession::FromDeviceIdAsync(device_.BluetoothDeviceId());
             if (gattSession) {
                 // MaxPduSize() returns the negotiated MTU
-                (void)gattSession.MaxPduSize();
+                mtu = static_cast<int>(gattSession.MaxPduSize());
             }
         } catch (...) {
             // MTU query is optional — continue without it
         }
+        co_await ResumeOnStrand();
+        negotiated_mtu_ = mtu;
+
+        is_connected_ = true;
+        is_active_ = false;
+        active_ms_total_ = 0;
+        connected_at_ = scheduler_->Now();
 
         if (on_status_) on_status_("Connected");
+        AttachLiveSegment(true);
+        RecordConnectOutcome();
+        ScheduleIdleDowngrade();
 
-        // Clear leftover buffers on Pod
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-        WriteCommand({0x08});
+        // Clear leftover buffers on Pod. The link is "ready" once the pod has
+        // acknowledged this first write.
+        co_await winrt::resume_after(std::chrono::seconds(1));
+        co_return co_await WriteCommandAsync(pod_command::CancelTransfer().ToVector());
 
-    } catch (const winrt::hresult_error&) {
-        if (on_status_) on_status_("Connection Error");
     } catch (...) {
-        if (on_status_) on_status_("Connection Error");
+        // Reported below, once back on the strand
     }
+    co_await ResumeOnStrand();
+    if (on_status_) on_status_("Connection Error");
+    co_return false;
 }
 
 void PodBLECore::Disconnect() {
-    // Guard against re-entrant calls (ConnectionStatusChanged → Disconnect → ...)
-    if (disconnecting_.exchange(true)) return;
+    if (PostToStrand([this] { Disconnect(); })) return;
+    // Guard against re-entrant calls from the callbacks below
+    if (disconnecting_) return;
+    disconnecting_ = true;
+
+    if (recording_) Record(SessionEvent::Of(SessionEvent::Kind::kDisconnect));
 
     StopWatchdog();
+    ClearBatch();
+    CancelReadyDetection();
+    settings_verifier_->Abandon();
+    file_deleter_->Abandon();
+    reply_matcher_.Reset();
+    EndActivePeriod();
     AllowSleep();
+    idle_generation_++;
+    is_connected_ = false;
+    power_optimized_ = false;
+    AttachLiveSegment(false);
+#ifdef POD_BLE_HAS_CONNECTION_PARAMETERS
+    try {
+        if (conn_params_request_ != nullptr) conn_params_request_.Close();
+    } catch (...) {}
+    conn_params_request_ = nullptr;
+#endif
 
     // Revoke event subscriptions BEFORE nullifying objects to prevent
     // callbacks from firing on a cleaned-up state.
@@ -290,6 +400,7 @@ void PodBLECore::Disconnect() {
 
     notify_char_ = nullptr;
     write_char_ = nullptr;
+    replay_link_ = nullptr;
 
     if (device_ != nullptr) {
         try { device_.Close(); } catch (...) {}
@@ -297,14 +408,49 @@ void PodBLECore::Disconnect() {
     }
 
     ResetDownloadState();
+    SignalPendingDownload(nullptr);
     if (on_status_) on_status_("Disconnected");
-    disconnecting_.store(false);
+    disconnecting_ = false;
 }
 
 // MARK: - Write
 
-winrt::fire_and_forget PodBLECore::WriteCommand(const std::vector<uint8_t>& data) {
-    if (write_char_ == nullptr) co_return;
+void PodBLECore::WriteCommand(const std::vector<uint8_t>& data) {
+    WriteCommandAsync(data);
+}
+
+Windows::Foundation::IAsyncOperation<bool> PodBLECore::WriteCommandAsync(std::vector<uint8_t> data) {
+    co_await ResumeOnStrand();
+    if (recording_) Record(SessionEvent::Of(SessionEvent::Kind::kWrite, data));
+    co_return co_await SendCommandAsync(std::move(data));
+}
+
+// Internal writes: the core's own commands, not recorded as inputs
+void PodBLECore::SendCommand(const std::vector<uint8_t>& data, uint32_t replyTag) {
+    SendCommandAsync(data, replyTag);
+}
+
+Windows::Foundation::IAsyncOperation<bool> PodBLECore::SendCommandAsync(std::vector<uint8_t> data,
+                                                                         uint32_t replyTag) {
+    // Called on the strand; everything after the GATT write resumes there too
+    if (!data.empty()) reply_matcher_.Sent(static_cast<PodOpcode>(data[0]), scheduler_->Now(), replyTag);
+    ReplayLink link = replay_link_;
+    if (link || recording_) {
+        // Prepend 0xAE message header per BLE ICD V3.6 protocol spec.
+        std::vector<uint8_t> framed;
+        framed.reserve(data.size() + 1);
+        framed.push_back(0xAE);
+        framed.insert(framed.end(), data.begin(), data.end());
+        if (recording_) Record(SessionEvent::Of(SessionEvent::Kind::kOutWrite, framed));
+        if (link) {
+            link(framed);
+            co_return true;
+        }
+    }
+
+    // Hold our own reference: Disconnect() may null write_char_ mid-write
+    auto characteristic = write_char_;
+    if (characteristic == nullptr) co_return false;
 
     try {
         DataWriter writer;
@@ -314,19 +460,65 @@ winrt::fire_and_forget PodBLECore::WriteCommand(const std::vector<uint8_t>& data
         writer.WriteBytes(data);
         auto buffer = writer.DetachBuffer();
 
-        co_await write_char_.WriteValueAsync(buffer, GattWriteOption::WriteWithResponse);
-    } catch (const winrt::hresult_error&) {
-        // Write failed — device likely disconnected
-        if (on_status_) on_status_("Write Error");
+        auto result = co_await characteristic.WriteValueWithResultAsync(
+            buffer, GattWriteOption::WriteWithResponse);
+        if (result.Status() == GattCommunicationStatus::Success) co_return true;
     } catch (...) {
-        if (on_status_) on_status_("Write Error");
+        // Write failed — device likely disconnected
     }
+    co_await ResumeOnStrand();
+    if (on_status_) on_status_("Write Error");
+    co_return false;
+}
+
+// MARK: - Recording and Replay
+
+void PodBLECore::SetSessionRecorder(std::shared_ptr<SessionRecorder> recorder) {
+    OnStrand([&] {
+        recording_ = recorder != nullptr;
+        recorder_ = std::move(recorder);
+    });
+}
+
+void PodBLECore::Record(SessionEvent event) {
+    if (recorder_) recorder_->Add(scheduler_->Now(), std::move(event));
+}
+
+void PodBLECore::AttachReplayLink(ReplayLink link) {
+    OnStrand([&] {
+        replay_link_ = std::move(link);
+        device_address_ = "replay";
+        is_connected_ = true;
+        is_active_ = false;
+        active_ms_total_ = 0;
+        connected_at_ = scheduler_->Now();
+    });
+}
+
+void PodBLECore::InjectNotification(const std::vector<uint8_t>& data) {
+    if (PostToStrand([this, data] { OnNotification(data); })) return;
+    OnNotification(data);
 }
 
 // MARK: - Download
 
 void PodBLECore::DownloadFile(const std::string& filename, int64_t start, int64_t end,
                                int totalFiles, int currentIndex) {
+    if (PostToStrand([=, this] { DownloadFile(filename, start, end, totalFiles, currentIndex); })) return;
+    if (recording_) {
+        auto input = SessionEvent::Of(SessionEvent::Kind::kDownloadFile);
+        input.text = filename;
+        input.start = start;
+        input.end = end;
+        input.total = totalFiles;
+        input.index = currentIndex;
+        Record(std::move(input));
+    }
+    BeginDownload(filename, start, end, totalFiles, currentIndex);
+}
+
+void PodBLECore::BeginDownload(const std::string& filename, int64_t start, int64_t end,
+                               int totalFiles, int currentIndex) {
     StopWatchdog();
     ResetDownloadState();
 
@@ -334,41 +526,177 @@ void PodBLECore::DownloadFile(const std::string& filename, int64_t start, int64_
     filter_end_ = end;
     is_filtering_ = (start > 0 || end > 0);
 
-    // Construct command: 0x06 + 0x20 + [32 bytes filename]
-    std::string cleanName = filename;
-    auto parenPos = cleanName.find('(');
-    if (parenPos != std::string::npos) {
-        cleanName = cleanName.substr(0, parenPos);
+    // Re-requesting a file that never completed counts as a retry
+    download_retries_ = (filename == last_incomplete_filename_) ? download_retries_ + 1 : 0;
+    download_filename_ = filename;
+    last_incomplete_filename_ = filename;
+    download_started_ = scheduler_->Now();
+    download_active_ = true;
+    watchdog_triggers_ = 0;
+    // An abort still settling owes its skip marker before this file's data
+    EmitOwedSkips();
+    CancelReadyDetection();
+
+    // Keep the machine awake and the link fast only for the transfer itself
+    PreventSleep();
+    BeginActivePeriod();
+
+    // Tags the payload that follows with its position in a multi-file sync
+    if (totalFiles > 1 && on_status_) {
+        on_status_("Downloading File " + std::to_string(currentIndex) + "/" + std::to_string(totalFiles));
     }
-    // Trim trailing spaces
-    cleanName.erase(cleanName.find_last_not_of(' ') + 1);
 
-    std::vector<uint8_t> command(34, 0);
-    command[0] = 0x06;
-    command[1] = 0x20;
-    size_t copyLen = std::min(cleanName.size(), size_t(32));
-    std::memcpy(command.data() + 2, cleanName.data(), copyLen);
+    SendCommand(pod_command::DownloadFile(filename).ToVector());
 
-    WriteCommand(command);
-
-    last_packet_time_ = std::chrono::steady_clock::now();
+    last_packet_time_ = scheduler_->Now();
     StartWatchdog();
 }
 
+Windows::Foundation::IAsyncOperation<IBuffer> PodBLECore::DownloadFileAsync(
+    std::string filename, int64_t start, int64_t end) {
+    co_await ResumeOnStrand();
+    auto waiter = std::make_shared<DownloadWaiter>();
+    waiter->done.attach(CreateEventW(nullptr, TRUE, FALSE, nullptr));
+    if (pending_download_) SignalPendingDownload(nullptr);
+    pending_download_ = waiter;
+
+    DownloadFile(filename, start, end, 1, 1);
+
+    // Cancelling the operation aborts the transfer on the pod as well
+    auto cancel = co_await winrt::get_cancellation_token();
+    cancel.callback([this, alive = alive_]() {
+        if (alive->load()) CancelDownload();
+    });
+
+    // The strand fills in the payload before it signals, and never touches it after
+    co_await winrt::resume_on_signal(waiter->done.get());
+
+    std::vector<uint8_t> payload = std::move(waiter->payload);
+    co_return Windows::Security::Cryptography::CryptographicBuffer::CreateFromByteArray(payload);
+}
+
+void PodBLECore::SignalPendingDownload(std::vector<uint8_t>* payload) {
+    // A null payload means skipped/cancelled/disconnected.
+    if (!pending_download_) return;
+    if (payload) pending_download_->payload = *payload;
+    SetEvent(pending_download_->done.get());
+    pending_download_.reset();
+}
+
 void PodBLECore::CancelDownload() {
+    if (PostToStrand([this] { CancelDownload(); })) return;
+    if (recording_) Record(SessionEvent::Of(SessionEvent::Kind::kCancel));
+    ClearBatch();
+    AbortTransfer();
+}
+
+void PodBLECore::AbortTransfer() {
     StopWatchdog();
-    WriteCommand({0x08});
+    SendCommand(pod_command::CancelTransfer().ToVector());
     ResetDownloadState();
+    download_active_ = false;
+    EndActivePeriod();
+    AllowSleep();
+    SignalPendingDownload(nullptr);
+
+    // Send the skip signal (0xDA) as soon as the pod has settled after the cancel
+    skips_owed_++;
+    BeginReadyDetection();
+}
+
+// MARK: - Multi-File Pipeline
+
+void PodBLECore::DownloadFiles(const std::vector<std::string>& filenames, int64_t start, int64_t end,
+                               int window) {
+    if (PostToStrand([=, this] { DownloadFiles(filenames, start, end, window); })) return;
+    if (recording_) {
+        auto input = SessionEvent::Of(SessionEvent::Kind::kDownloadFiles);
+        input.files = filenames;
+        input.start = start;
+        input.end = end;
+        input.window = window;
+        Record(std::move(input));
+    }
+    batch_queue_.assign(filenames.begin(), filenames.end());
+    batch_filter_start_ = start;
+    batch_filter_end_ = end;
+    batch_total_ = static_cast<int>(filenames.size());
+    batch_requested_ = 0;
+    batch_acknowledged_ = 0;
+    batch_window_ = std::max(window, 1);
+    batch_active_ = true;
+    batch_paused_ = false;
+    StartNextBatchFile();
+}
 
-    // Send skip signal
-    std::thread([this, alive = alive_]() {
-        std::this_thread::sleep_for(std::chrono::milliseconds(600));
-        if (alive->load() && on_payload_) on_payload_({0xDA});
-    }).detach();
+void PodBLECore::AcknowledgeBatchFile(int index) {
+    if (PostToStrand([this, index] { AcknowledgeBatchFile(index); })) return;
+    if (recording_) {
+        auto input = SessionEvent::Of(SessionEvent::Kind::kAck);
+        input.index = index;
+        Record(std::move(input));
+    }
+    if (!batch_active_) return;
+    batch_acknowledged_ = std::max(batch_acknowledged_, std::min(index, batch_requested_));
+    if (batch_paused_ && batch_requested_ - batch_acknowledged_ < batch_window_) {
+        batch_paused_ = false;
+        StartNextBatchFile();
+    }
+}
+
+void PodBLECore::StartNextBatchFile() {
+    if (!batch_active_) return;
+    if (batch_queue_.empty()) {
+        batch_active_ = false;
+        if (on_status_) on_status_("Batch Complete");
+        return;
+    }
+    if (batch_requested_ - batch_acknowledged_ >= batch_window_) {
+        // Consumer is behind — resume from AcknowledgeBatchFile
+        batch_paused_ = true;
+        return;
+    }
+    std::string filename = std::move(batch_queue_.front());
+    batch_queue_.pop_front();
+    int index = ++batch_requested_;
+    BeginDownload(filename, batch_filter_start_, batch_filter_end_, batch_total_, index);
+}
+
+void PodBLECore::ClearBatch() {
+    batch_queue_.clear();
+    batch_active_ = false;
+    batch_paused_ = false;
 }
 
 // MARK: - Packet Reassembly
 
+void PodBLECore::OnNotification(const std::vector<uint8_t>& data) {
+    if (recording_) Record(SessionEvent::Of(SessionEvent::Kind::kNotify, data));
+
+    last_packet_time_ = scheduler_->Now();
+
+    // Replies are correlated with their request on a message's first block
+    std::optional<ReplyMatcher::Match> reply;
+    if (received_packet_count_ == 0) reply = reply_matcher_.OnReply(data, last_packet_time_);
+
+    // Settings reply to our own readiness probe — consume it. Replies the
+    // app asked for (getDeviceSettings) during the wait go on to Flutter.
+    if (reply && reply->tag == kReadyProbeTag) {
+        OnPodReady(false, reply->latency_ms);
+        return;
+    }
+
+    // Settings reply to a set-and-verify probe: the verifier takes it rather
+    // than reassembly, so the transaction completes on this packet
+    if (reply && settings_verifier_->OnReply(*reply, data)) return;
+
+    if (total_expected_packets_ > 0 || received_packet_count_ == 0) {
+        ProcessPacket(data);
+    } else {
+        if (on_payload_) on_payload_(data);
+    }
+}
+
 void PodBLECore::ProcessPacket(const std::vector<uint8_t>& packet) {
     if (packet.size() < 5) return;
 
@@ -392,6 +720,13 @@ void PodBLECore::ProcessPacket(const std::vector<uint8_t>& packet) {
             return;
         }
 
+        // Live telemetry is a single-block message; it skips reassembly
+        // entirely when Flutter only wants the metric snapshots
+        if (current_message_type_ == 0x01 && total_expected_packets_ == 1 && HandleLivePacket(packet)) {
+            total_expected_packets_ = 0;
+            return;
+        }
+
         int safeSize = std::max(actual_packet_size_, 64);
         int estimatedSize = total_expected_packets_ * (safeSize - 5) + 2048;
         // Cap at 10 MB to prevent OOM from corrupted but in-range packet counts
@@ -407,18 +742,24 @@ void PodBLECore::ProcessPacket(const std::vector<uint8_t>& packet) {
 
         payload_buffer_.push_back(current_message_type_);
 
-        if (packet.size() > 9) {
-            payload_buffer_.insert(payload_buffer_.end(), packet.begin() + 9, packet.end());
-        }
+        integrity_.Begin(ReadSequence(packet), 1);
+        integrity_.AppendFirstBlock(payload_buffer_, packet.data() + 9, packet.size() - 9);
         received_packet_count_ = 1;
 
     } else {
-        if (packet.size() > 5) {
-            payload_buffer_.insert(payload_buffer_.end(), packet.begin() + 5, packet.end());
+        size_t blockPayload = actual_packet_size_ > 5 ? static_cast<size_t>(actual_packet_size_ - 5) : 0;
+        if (!integrity_.AppendBlock(payload_buffer_, ReadSequence(packet),
+                                    packet.data() + 5, packet.size() - 5, blockPayload)) {
+            return;  // Retransmitted block — already in the buffer
         }
         received_packet_count_++;
     }
 
+    // Record validation starts once the firmware's record size is known
+    if (current_message_type_ == 0x03 && integrity_.RecordSize() == 0 && payload_buffer_.size() >= 70) {
+        integrity_.SetRecordSize(DetectRecordSize(payload_buffer_), payload_buffer_);
+    }
+
     // Smart Peek
     if (is_filtering_ && current_message_type_ == 0x03 && !is_smart_peek_done_ &&
         payload_buffer_.size() >= 129) {
@@ -426,15 +767,142 @@ void PodBLECore::ProcessPacket(const std::vector<uint8_t>& packet) {
         is_smart_peek_done_ = true;
     }
 
-    // Completion check
-    if (total_expected_packets_ > 0 && received_packet_count_ >= total_expected_packets_) {
-        std::thread([this, alive = alive_]() {
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    // Completion check — blocks known to be lost will not arrive, so they count as accounted for
+    if (total_expected_packets_ > 0 &&
+        received_packet_count_ + integrity_.MissingBlocks() >= total_expected_packets_) {
+        scheduler_->After(std::chrono::milliseconds(50), [this, alive = alive_]() {
             if (alive->load()) FinishMessage();
-        }).detach();
+        });
+    }
+}
+
+// MARK: - Live Metrics
+
+// Returns true when the packet was consumed here and must not be forwarded.
+bool PodBLECore::HandleLivePacket(const std::vector<uint8_t>& packet) {
+    const uint8_t* telemetry = packet.data() + 9;
+    size_t len = packet.size() - 9;
+    if (live_jitter_enabled_) {
+        // Released in tick order by the playout ticks
+        live_jitter_.Push(telemetry, len, scheduler_->Now());
+        return true;
+    }
+    PublishLiveSample(telemetry, len, false);
+    if (!live_metrics_enabled_) return false;
+    return !UpdateLiveMetrics(telemetry, len);
+}
+
+// Feeds one in-order live sample to the metrics and publishes a snapshot when
+// due. Returns true when raw samples should still reach Flutter.
+bool PodBLECore::UpdateLiveMetrics(const uint8_t* telemetry, size_t len) {
+    if (!live_metrics_enabled_) return true;
+    live_metrics_.Add(telemetry, len);
+    auto now = scheduler_->Now();
+    if (now - live_last_publish_ >= live_publish_interval_) {
+        live_last_publish_ = now;
+        if (on_payload_) on_payload_(live_metrics_.Snapshot().Serialize());
+    }
+    return live_forward_packets_;
+}
+
+void PodBLECore::SetLiveMetrics(bool enabled, std::chrono::milliseconds publishInterval,
+                                bool forwardPackets) {
+    OnStrand([&] {
+        if (enabled && !live_metrics_enabled_) {
+            live_metrics_.Reset();
+            live_last_publish_ = {};
+        }
+        live_metrics_enabled_ = enabled;
+        live_publish_interval_ = std::max(publishInterval, std::chrono::milliseconds(0));
+        // Raw packets always flow while the native metrics are off
+        live_forward_packets_ = forwardPackets || !enabled;
+    });
+}
+
+void PodBLECore::ResetLiveMetrics() {
+    OnStrand([&] {
+        live_metrics_.Reset();
+        live_last_publish_ = {};
+    });
+}
+
+void PodBLECore::SetLiveJitterBuffer(bool enabled, const LiveJitterConfig& config) {
+    OnStrand([&] {
+        StopLivePlayout();
+        live_jitter_.Configure(config);
+        if (enabled && !live_jitter_enabled_) live_jitter_.Reset();
+        live_jitter_enabled_ = enabled;
+        if (enabled) StartLivePlayout();
+    });
+}
+
+LiveJitterStats PodBLECore::GetLiveJitterStats() {
+    return OnStrand([&] { return live_jitter_.Stats(); });
+}
+
+void PodBLECore::SetLiveTelemetrySegment(std::shared_ptr<LiveTelemetrySegment> segment) {
+    // Waits for the strand, so the old segment is released on return
+    OnStrand([&] {
+        AttachLiveSegment(false);
+        live_segment_ = std::move(segment);
+        if (is_connected_) AttachLiveSegment(true);
+    });
+}
+
+// Claims (or gives back) this pod's slot in the shared live segment
+void PodBLECore::AttachLiveSegment(bool connected) {
+    if (!live_segment_) return;
+    if (live_segment_slot_ >= 0) live_segment_->DetachPod(live_segment_slot_);
+    live_segment_slot_ = connected ? live_segment_->AttachPod(device_address_) : -1;
+}
+
+void PodBLECore::PublishLiveSample(const uint8_t* telemetry, size_t len, bool concealed) {
+    if (live_segment_ && live_segment_slot_ >= 0) {
+        live_segment_->Publish(live_segment_slot_, telemetry, len, concealed);
     }
 }
 
+void PodBLECore::StartLivePlayout() {
+    uint64_t generation = ++live_playout_generation_;
+    scheduler_->After(std::chrono::milliseconds(0), [this, alive = alive_, generation]() {
+        if (alive->load()) LivePlayoutTick(generation);
+    });
+}
+
+void PodBLECore::StopLivePlayout() {
+    live_playout_generation_++;
+}
+
+// Releases buffered live samples as they fall due, then re-arms for the next
+// release. Concealed samples carry a trailing flag byte after the 72-byte
+// body so Flutter can tell them apart.
+void PodBLECore::LivePlayoutTick(uint64_t generation) {
+    if (live_playout_generation_ != generation) return;
+
+    constexpr auto kMaxSleep = std::chrono::milliseconds(20);
+    auto now = scheduler_->Now();
+    auto wake = now + kMaxSleep;
+    std::vector<LiveSample> due = live_jitter_.Pop(now);
+    if (auto next = live_jitter_.NextRelease()) wake = std::max(now, std::min(wake, *next));
+
+    for (const auto& sample : due) {
+        PublishLiveSample(sample.data.data(), sample.data.size(), sample.concealed);
+        if (!UpdateLiveMetrics(sample.data.data(), sample.data.size())) continue;
+        std::vector<uint8_t> message;
+        message.reserve(sample.data.size() + 2);
+        message.push_back(0x01);
+        message.insert(message.end(), sample.data.begin(), sample.data.end());
+        message.push_back(sample.concealed ? 0x01 : 0x00);
+        if (on_payload_) on_payload_(message);
+    }
+
+    // At least 1 ms apart so a sample that is already due cannot spin the timer
+    auto delay = std::max<std::chrono::steady_clock::duration>(wake - now, std::chrono::milliseconds(1));
+    scheduler_->After(delay, [this, alive = alive_, generation]() {
+        if (alive->load()) LivePlayoutTick(generation);
+    });
+}
+
 // Detect firmware record size from payload buffer (47, 61, or 64 bytes).
 // Buffer includes the 1-byte type prefix, so the second record header starts at 1+recordSize.
 // Returns 47 for V3.6 (v01), 61 for Proewe, 64 for HTS firmware.
@@ -496,70 +964,225 @@ void PodBLECore::PerformSmartPeek() {
 
     if ((filter_end_ > 0 && startTimeMs > filter_end_) ||
         (filter_start_ > 0 && (startTimeMs + dur) < filter_start_)) {
-        CancelDownload();
+        AbortTransfer();
     }
 }
 
 void PodBLECore::FinishMessage() {
     StopWatchdog();
 
-    std::vector<uint8_t> data;
-    {
-        std::lock_guard<std::mutex> lock(mtx_);
-        data = std::move(payload_buffer_);
+    std::vector<uint8_t> data = std::move(payload_buffer_);
+
+    bool wasDownload = download_active_ && current_message_type_ == 0x03;
+    std::vector<uint8_t> integrityMessage;
+    if (wasDownload) {
+        RecordDownloadOutcome(data.size(), received_packet_count_, total_expected_packets_);
+        if (data.size() >= 70) firmware_record_size_ = DetectRecordSize(data);
+
+        // Compare against the last complete download of the same file, then remember this one
+        auto previous = file_digests_.find(download_filename_);
+        uint32_t previousCrc = previous != file_digests_.end() ? previous->second.first : 0;
+        size_t previousBytes = previous != file_digests_.end() ? previous->second.second : 0;
+        auto integrity = integrity_.Finish(data, previousCrc, previousBytes);
+        if (integrity.missing_blocks == 0 && !download_filename_.empty()) {
+            file_digests_[download_filename_] = {integrity.crc32c, integrity.data_bytes};
+        }
+        integrityMessage = integrity.Serialize();
     }
 
+    // The integrity summary (0xDB) precedes the file it describes on the same stream
+    if (!integrityMessage.empty() && on_payload_) on_payload_(integrityMessage);
     if (on_payload_) on_payload_(data);
+    if (current_message_type_ == static_cast<uint8_t>(PodReplyType::kFileList)) file_deleter_->OnCatalog(data);
+
+    if (wasDownload) SignalPendingDownload(&data);
 
     received_packet_count_ = 0;
     total_expected_packets_ = 0;
     payload_buffer_.clear();
+
+    EndActivePeriod();
+    AllowSleep();
+
+    if (wasDownload) BeginReadyDetection();
 }
 
-// MARK: - Watchdog
+// MARK: - Firmware Ready Detection
+
+// After a transfer ends the firmware still has to close the file pointer
+// before it accepts the next request. Instead of a fixed delay we wait a
+// learned minimum, then probe with Get Settings (0x09) until the pod answers.
+// Probes are tagged in the reply matcher: their replies are consumed here and
+// never reach Flutter, while a settings reply the app asked for does.
+void PodBLECore::BeginReadyDetection() {
+    auto it = ready_latency_ewma_ms_.find(firmware_record_size_);
+    double learned = it != ready_latency_ewma_ms_.end() ? it->second : kReadyFallbackMs;
+    // Probe slightly before the firmware is expected to be ready
+    auto minGap = std::chrono::milliseconds(static_cast<int64_t>(
+        std::clamp(learned * 0.8, 0.0, static_cast<double>(kReadyFallbackMs))));
+    uint64_t generation = ++ready_generation_;
+    ready_wait_started_ = scheduler_->Now();
+    awaiting_ready_ = true;
+
+    scheduler_->After(minGap, [this, alive = alive_, generation]() {
+        if (alive->load()) ProbeReady(generation, 0);
+    });
+}
 
-void PodBLECore::StartWatchdog() {
-    StopWatchdog();
-    watchdog_running_ = true;
+void PodBLECore::ProbeReady(uint64_t generation, int attempt) {
+    if (ready_generation_ != generation) return;
+    if (attempt == kReadyProbeAttempts) {
+        // Firmware never answered — release the caller anyway (legacy behaviour)
+        OnPodReady(true);
+        return;
+    }
+    if (!awaiting_ready_) return;
+    // The firmware drops probes until it is ready; an unanswered one must not
+    // take the reply to a later request
+    reply_matcher_.Withdraw(kReadyProbeTag);
+    ready_probe_attempt_ = attempt;
+    SendCommand(pod_command::GetSettings().ToVector(), kReadyProbeTag);
+    scheduler_->After(std::chrono::milliseconds(kReadyProbeIntervalMs),
+                      [this, alive = alive_, generation, attempt]() {
+        if (alive->load()) ProbeReady(generation, attempt + 1);
+    });
+}
 
-    watchdog_thread_ = std::thread([this, alive = alive_]() {
-        while (watchdog_running_.load() && alive->load()) {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-            if (!alive->load()) return;
+void PodBLECore::CancelReadyDetection() {
+    ready_generation_++;
+    awaiting_ready_ = false;
+    skips_owed_ = 0;
+    reply_matcher_.Withdraw(kReadyProbeTag);
+}
 
-            std::chrono::steady_clock::time_point lpt;
-            {
-                std::lock_guard<std::mutex> lock(mtx_);
-                lpt = last_packet_time_;
-            }
+// One 0xDA per aborted transfer, so Flutter can match each to its own cancel
+void PodBLECore::EmitOwedSkips() {
+    for (; skips_owed_ > 0; skips_owed_--) {
+        if (on_payload_) on_payload_({0xDA});
+    }
+}
 
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - lpt).count();
+void PodBLECore::OnPodReady(bool timedOut, double probeLatencyMs) {
+    if (!awaiting_ready_) return;
+    awaiting_ready_ = false;
+    reply_matcher_.Withdraw(kReadyProbeTag);
+
+    if (!timedOut) {
+        // First probe answered: the pod was ready before the enforced gap ran
+        // out, so only the probe's own round trip is known to have been
+        // needed and the estimate may shrink. A later probe answered: the
+        // earlier ones were dropped, so the wait up to now was needed.
+        double elapsed = ready_probe_attempt_ == 0
+            ? probeLatencyMs
+            : static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                  scheduler_->Now() - ready_wait_started_).count());
+        auto [it, inserted] = ready_latency_ewma_ms_.try_emplace(firmware_record_size_, elapsed);
+        if (!inserted) it->second = 0.7 * it->second + 0.3 * elapsed;
+    }
 
-            // Hard timeout (60s)
-            if (total_expected_packets_ > 0 && elapsed > 60000) {
-                FinishMessage();
-                return;
-            }
+    // Skips first: a caller released by "Pod Ready" must not see them land
+    // on its next request
+    EmitOwedSkips();
+    if (on_status_) on_status_("Pod Ready");
 
-            // Stuck at 99%
-            if (total_expected_packets_ > 0 && elapsed > 2500) {
-                double progress = static_cast<double>(received_packet_count_) /
-                                  static_cast<double>(total_expected_packets_);
-                if (progress > 0.98) {
-                    FinishMessage();
-                    return;
-                }
-            }
-        }
+    // Pipeline: the next queued file goes out without a round trip through Flutter
+    StartNextBatchFile();
+}
+
+// MARK: - Settings (set-and-verify)
+
+void PodBLECore::ApplySettings(const SettingsRequest& request, std::chrono::milliseconds timeout,
+                               SettingsCallback done) {
+    if (PostToStrand([this, request, timeout, done = std::move(done)]() mutable {
+        ApplySettings(request, timeout, std::move(done));
+    })) return;
+    if (recording_) {
+        auto event = SessionEvent::Of(SessionEvent::Kind::kApplySettings);
+        event.player_number = request.player_number.value_or(0);
+        event.log_interval_ms = request.log_interval_ms.value_or(0);
+        event.timeout_ms = static_cast<int>(timeout.count());
+        Record(std::move(event));
+    }
+    settings_verifier_->Apply(request, timeout, std::move(done));
+}
+
+// MARK: - Batch delete
+
+void PodBLECore::DeleteFiles(const std::vector<std::string>& files, std::chrono::milliseconds timeout,
+                             DeleteCallback done) {
+    if (PostToStrand([this, files, timeout, done = std::move(done)]() mutable {
+        DeleteFiles(files, timeout, std::move(done));
+    })) return;
+    if (recording_) {
+        auto event = SessionEvent::Of(SessionEvent::Kind::kDeleteFiles);
+        event.files = files;
+        event.timeout_ms = static_cast<int>(timeout.count());
+        Record(std::move(event));
+    }
+    file_deleter_->Delete(files, timeout, std::move(done));
+}
+
+// Settings and deletes need the link to themselves: a transfer in progress
+// (or the file close after it) would hold their replies back
+SettingsVerifier::Gate PodBLECore::CommandGate() const {
+    if (!is_connected_) return SettingsVerifier::Gate::kOffline;
+    if (download_active_ || awaiting_ready_) return SettingsVerifier::Gate::kBusy;
+    return SettingsVerifier::Gate::kReady;
+}
+
+std::map<uint8_t, CommandLatency> PodBLECore::GetCommandStats() {
+    return OnStrand([this] {
+        reply_matcher_.Expire(scheduler_->Now());
+        return reply_matcher_.Stats();
+    });
+}
+
+uint32_t PodBLECore::ReadSequence(const std::vector<uint8_t>& packet) {
+    // BLE framing: [type][sequence u32 LE]...
+    return static_cast<uint32_t>(packet[1]) | (static_cast<uint32_t>(packet[2]) << 8) |
+           (static_cast<uint32_t>(packet[3]) << 16) | (static_cast<uint32_t>(packet[4]) << 24);
+}
+
+// MARK: - Watchdog
+
+void PodBLECore::StartWatchdog() {
+    uint64_t generation = ++watchdog_generation_;
+    scheduler_->After(std::chrono::seconds(1), [this, alive = alive_, generation]() {
+        if (alive->load()) WatchdogTick(generation);
     });
 }
 
 void PodBLECore::StopWatchdog() {
-    watchdog_running_ = false;
-    if (watchdog_thread_.joinable()) {
-        watchdog_thread_.join();
+    watchdog_generation_++;
+}
+
+void PodBLECore::WatchdogTick(uint64_t generation) {
+    if (watchdog_generation_ != generation) return;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        scheduler_->Now() - last_packet_time_).count();
+
+    // Hard timeout (60s)
+    if (total_expected_packets_ > 0 && elapsed > 60000) {
+        watchdog_triggers_++;
+        FinishMessage();
+        return;
+    }
+
+    // Stuck at 99%
+    if (total_expected_packets_ > 0 && elapsed > 2500) {
+        double progress = static_cast<double>(received_packet_count_ + integrity_.MissingBlocks()) /
+                          static_cast<double>(total_expected_packets_);
+        if (progress > 0.98) {
+            watchdog_triggers_++;
+            FinishMessage();
+            return;
+        }
     }
+
+    scheduler_->After(std::chrono::seconds(1), [this, alive = alive_, generation]() {
+        if (alive->load()) WatchdogTick(generation);
+    });
 }
 
 // MARK: - Helpers
@@ -586,12 +1209,127 @@ int64_t PodBLECore::SnapToStandardInterval(int64_t raw) {
     return closest;
 }
 
+void PodBLECore::RecordConnectOutcome() {
+    if (!history_) return;
+
+    PodHistoryRecord record;
+    record.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.address = device_address_;
+    record.kind = PodHistoryRecord::Kind::kConnect;
+    record.mtu = negotiated_mtu_;
+    record.connect_latency_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        scheduler_->Now() - connect_started_).count();
+    history_->Append(record);
+}
+
+void PodBLECore::RecordDownloadOutcome(size_t payloadBytes, int received, int expected) {
+    download_active_ = false;
+    last_incomplete_filename_.clear();
+    if (!history_) return;
+
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        scheduler_->Now() - download_started_).count();
+
+    PodHistoryRecord record;
+    record.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.address = device_address_;
+    record.kind = PodHistoryRecord::Kind::kDownload;
+    record.mtu = negotiated_mtu_;
+    record.bytes_per_sec = elapsedMs > 0
+        ? static_cast<double>(payloadBytes) * 1000.0 / static_cast<double>(elapsedMs)
+        : 0.0;
+    record.packet_loss_pct = expected > 0
+        ? 100.0 * static_cast<double>(std::max(expected - received, 0)) / static_cast<double>(expected)
+        : 0.0;
+    record.retries = download_retries_;
+    record.watchdog_triggers = watchdog_triggers_;
+    history_->Append(record);
+}
+
+// MARK: - Power
+
 void PodBLECore::PreventSleep() {
-    SetThreadExecutionState(ES_CONTINUOUS | ES_SYSTEM_REQUIRED);
+    power_hold_.Hold();
 }
 
 void PodBLECore::AllowSleep() {
-    SetThreadExecutionState(ES_CONTINUOUS);
+    power_hold_.Drop();
+}
+
+void PodBLECore::BeginActivePeriod() {
+    idle_generation_++; // Cancels any pending idle downgrade
+    if (!is_active_) {
+        is_active_ = true;
+        active_since_ = scheduler_->Now();
+    }
+    bool wasOptimized = power_optimized_;
+    power_optimized_ = false;
+    if (wasOptimized) RequestConnectionProfile(true);
+}
+
+void PodBLECore::EndActivePeriod() {
+    if (!is_active_) return;
+    is_active_ = false;
+    active_ms_total_ += std::chrono::duration_cast<std::chrono::milliseconds>(
+        scheduler_->Now() - active_since_).count();
+    ScheduleIdleDowngrade();
+}
+
+void PodBLECore::ScheduleIdleDowngrade() {
+    if (!is_connected_ || idle_downgrade_delay_.count() <= 0) return;
+
+    uint64_t generation = ++idle_generation_;
+    scheduler_->After(idle_downgrade_delay_, [this, alive = alive_, generation]() {
+        if (!alive->load() || idle_generation_ != generation) return;
+        if (!is_connected_ || is_active_ || power_optimized_) return;
+        power_optimized_ = true;
+        RequestConnectionProfile(false);
+    });
+}
+
+void PodBLECore::RequestConnectionProfile(bool throughput) {
+#ifdef POD_BLE_HAS_CONNECTION_PARAMETERS
+    // Windows 11+: ask the controller for a longer connection interval while
+    // idle (fewer radio/CPU wakeups) and the throughput profile for transfers.
+    // Older builds throw here — the request is advisory, so ignore failures.
+    try {
+        if (device_ == nullptr) return;
+        if (conn_params_request_ != nullptr) {
+            conn_params_request_.Close();
+            conn_params_request_ = nullptr;
+        }
+        auto params = throughput
+            ? BluetoothLEPreferredConnectionParameters::ThroughputOptimized()
+            : BluetoothLEPreferredConnectionParameters::PowerOptimized();
+        conn_params_request_ = device_.RequestPreferredConnectionParameters(params);
+    } catch (...) {
+        conn_params_request_ = nullptr;
+    }
+#else
+    (void)throughput;
+#endif
+}
+
+ConnectionPowerStats PodBLECore::GetPowerStats() {
+    return OnStrand([this] {
+        ConnectionPowerStats stats;
+        if (!is_connected_) return stats;
+
+        auto now = scheduler_->Now();
+        stats.connected_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            now - connected_at_).count();
+        stats.active_ms = active_ms_total_;
+        if (is_active_) {
+            stats.active_ms += std::chrono::duration_cast<std::chrono::milliseconds>(
+                now - active_since_).count();
+        }
+        stats.idle_ms = std::max<int64_t>(stats.connected_ms - stats.active_ms, 0);
+        stats.holding_wake_lock = power_hold_.IsHeld();
+        stats.power_optimized = power_optimized_;
+        return stats;
+    });
 }
 
 } // namespace pod_connector
@@ -16,14 +16,28 @@
 #include <winrt/Windows.Devices.Radios.h>
 #include <winrt/Windows.Storage.Streams.h>
 
+#include <coroutine>
+#include <deque>
 #include <functional>
-#include <mutex>
+#include <map>
 #include <vector>
 #include <string>
 #include <chrono>
-#include <thread>
 #include <atomic>
 #include <cstdint>
+#include <memory>
+
+#include "core_scheduler.h"
+#include "file_deleter.h"
+#include "live_jitter_buffer.h"
+#include "live_metrics.h"
+#include "live_telemetry_segment.h"
+#include "payload_integrity.h"
+#include "pod_commands.h"
+#include "pod_history_store.h"
+#include "power_policy.h"
+#include "session_script.h"
+#include "settings_verifier.h"
 
 namespace pod_connector {
 
@@ -37,30 +51,148 @@ using namespace Windows::Storage::Streams;
 using StatusCallback = std::function<void(const std::string&)>;
 using ScanCallback = std::function<void(const std::string& name, const std::string& id, int rssi)>;
 using PayloadCallback = std::function<void(const std::vector<uint8_t>&)>;
+using ReplayLink = std::function<void(const std::vector<uint8_t>& framed)>;
+
+/// Measured radio duty for the current connection.
+/// "Active" is time spent inside a file transfer; everything else while
+/// connected counts as idle.
+struct ConnectionPowerStats {
+    int64_t connected_ms = 0;
+    int64_t active_ms = 0;
+    int64_t idle_ms = 0;
+    bool holding_wake_lock = false;
+    bool power_optimized = false;   // Idle connection-parameter downgrade in effect
+};
 
 /// Pure C++ class encapsulating WinRT BLE logic for Pod device communication.
+///
+/// Every timer, delay and clock read goes through [scheduler]: the default
+/// runs on real time, a VirtualScheduler makes the core fully deterministic
+/// for replay (see session_replay.h).
+///
+/// The scheduler is also the core's strand, and the strand owns all mutable
+/// state: notifications, connection changes, timers and resumed coroutines
+/// are posted to it, and every public method may be called from any thread.
+/// Commands are posted and return at once; setters and getters run on the
+/// strand and wait for it. Nothing on the packet path takes a lock.
 class PodBLECore {
 public:
-    PodBLECore();
+    explicit PodBLECore(std::shared_ptr<CoreScheduler> scheduler = nullptr);
     ~PodBLECore();
 
+    /// Callbacks run on the strand.
     void SetCallbacks(StatusCallback status, ScanCallback scan, PayloadCallback payload);
 
+    /// Optional persistent history sink. Connect and download outcomes are
+    /// appended to it; passing nullptr disables recording.
+    void SetHistoryStore(std::shared_ptr<PodHistoryStore> store);
+
+    /// Delay after a transfer ends before the link is asked to switch to
+    /// power-optimised connection parameters. 0 disables the downgrade.
+    void SetIdleDowngradeDelay(std::chrono::milliseconds delay);
+
+    ConnectionPowerStats GetPowerStats();
+
+    /// Native live metrics on the 0x01 stream. While enabled every live packet
+    /// updates a LiveMetricsTracker and a 0xDC snapshot is sent on the payload
+    /// stream at most once per [publishInterval]. With [forwardPackets] false
+    /// raw 0x01 packets no longer reach Flutter. Enabling resets the totals.
+    void SetLiveMetrics(bool enabled, std::chrono::milliseconds publishInterval,
+                        bool forwardPackets);
+    void ResetLiveMetrics();
+
+    /// Live jitter buffer. While enabled, 0x01 packets are reordered by kernel
+    /// tick and released (to Flutter and to the live metrics) on the pod's
+    /// cadence, config.latency_ms behind the fastest delivery, with short gaps
+    /// interpolated. Enabling clears the buffer and its statistics.
+    void SetLiveJitterBuffer(bool enabled, const LiveJitterConfig& config);
+    LiveJitterStats GetLiveJitterStats();
+
+    /// Shared-memory export of the live stream. While set, every in-order
+    /// 0x01 sample (after the jitter buffer, if enabled) is decoded into
+    /// [segment] under this pod's address for readers in other processes.
+    /// The pod holds a slot from "Connected" until it disconnects. nullptr
+    /// stops publishing.
+    void SetLiveTelemetrySegment(std::shared_ptr<LiveTelemetrySegment> segment);
+
+    /// Session recording. While set, every input (notification, download,
+    /// ack, cancel, write, disconnect) and output (write, status, payload)
+    /// is added to [recorder] for later replay. nullptr stops recording.
+    void SetSessionRecorder(std::shared_ptr<SessionRecorder> recorder);
+
+    /// Replay mode: the core behaves as connected to a pod that is not
+    /// there. Writes (with the 0xAE header) go to [link] instead of GATT and
+    /// the pod's side arrives through InjectNotification. Disconnect ends it.
+    void AttachReplayLink(ReplayLink link);
+    void InjectNotification(const std::vector<uint8_t>& data);
+
     void StartScan();
     void StopScan();
     void Connect(const std::string& deviceAddress);
     void Disconnect();
-    winrt::fire_and_forget WriteCommand(const std::vector<uint8_t>& data);
+    void WriteCommand(const std::vector<uint8_t>& data);
     void DownloadFile(const std::string& filename, int64_t start, int64_t end,
                       int totalFiles, int currentIndex);
     void CancelDownload();
 
+    /// Downloads [filenames] back to back without returning to Flutter between
+    /// files. Each file goes through Smart Peek with the shared filter range;
+    /// the next request is written as soon as the pod reports ready after the
+    /// previous one. [window] bounds how many delivered files may await
+    /// AcknowledgeBatchFile before the queue pauses (minimum 1).
+    /// Emits "Downloading File i/n" before each file's payload and
+    /// "Batch Complete" when the queue drains. CancelDownload aborts the batch.
+    void DownloadFiles(const std::vector<std::string>& filenames, int64_t start, int64_t end,
+                       int window);
+
+    /// Marks batch files up to and including [index] (1-based) as consumed,
+    /// resuming the queue if it was paused on the window.
+    void AcknowledgeBatchFile(int index);
+
+    /// Set-and-verify (see SettingsVerifier). Every settings reply is also
+    /// sent to the payload callback as a 0x05 message. A transaction that
+    /// finds a transfer in progress completes as busy. [done] runs on the
+    /// strand and may be null.
+    void ApplySettings(const SettingsRequest& request, std::chrono::milliseconds timeout,
+                       SettingsCallback done);
+
+    /// Batch delete (see FileDeleter): every Delete File goes out at once,
+    /// then one file listing confirms them. The listing also reaches the
+    /// payload callback as usual. A transaction that finds a transfer in
+    /// progress completes as busy. [done] runs on the strand and may be null.
+    void DeleteFiles(const std::vector<std::string>& files, std::chrono::milliseconds timeout,
+                     DeleteCallback done);
+
+    /// Round-trip latency per opcode for this core's lifetime. Set commands
+    /// and deletes are timed to the reply that verified them.
+    std::map<uint8_t, CommandLatency> GetCommandStats();
+
+    // Awaitable variants. C++/WinRT async operations start eagerly, so the
+    // fire-and-forget methods above simply discard these. Cancel() on the
+    // returned operation disconnects / aborts the transfer respectively.
+
+    /// Completes with true once services are discovered and the pod has
+    /// acknowledged the initial buffer-clear command.
+    Windows::Foundation::IAsyncOperation<bool> ConnectAndWaitAsync(std::string deviceAddress);
+
+    /// Completes with true when the pod acknowledges the write (WriteWithResponse).
+    Windows::Foundation::IAsyncOperation<bool> WriteCommandAsync(std::vector<uint8_t> data);
+
+    /// Completes with the reassembled payload (also delivered to the payload
+    /// callback as before). An empty buffer means the file was skipped by
+    /// Smart Peek, cancelled, or the link dropped.
+    Windows::Foundation::IAsyncOperation<IBuffer> DownloadFileAsync(
+        std::string filename, int64_t start, int64_t end);
+
 private:
     // UUIDs
     static const winrt::guid SERVICE_UUID;
     static const winrt::guid NOTIFY_CHAR_UUID;
     static const winrt::guid WRITE_CHAR_UUID;
 
+    // Timers, clock (real or virtual) and the strand that owns everything below
+    std::shared_ptr<CoreScheduler> scheduler_;
+
     // Callbacks
     StatusCallback on_status_;
     ScanCallback on_scan_;
@@ -83,41 +215,173 @@ private:
     int actual_packet_size_ = 0;
     uint8_t current_message_type_ = 0;
 
+    // Integrity: rolling CRC32C, block sequence check and record validity bitmap
+    PayloadIntegrityTracker integrity_;
+    std::map<std::string, std::pair<uint32_t, size_t>> file_digests_;  // filename → (crc, bytes) of last complete download
+
     // Smart Peek
     int64_t filter_start_ = 0;
     int64_t filter_end_ = 0;
     bool is_filtering_ = false;
     bool is_smart_peek_done_ = false;
 
-    // Watchdog
-    std::atomic<bool> watchdog_running_{false};
-    std::thread watchdog_thread_;
+    // Watchdog: a 1 s tick on the scheduler, cancelled by bumping the generation
+    uint64_t watchdog_generation_ = 0;
     std::chrono::steady_clock::time_point last_packet_time_;
-    std::mutex mtx_;
 
-    // Lifetime guard: shared flag checked by detached threads before using `this`
+    // Lifetime guard: shared flag checked by scheduled tasks before using `this`
     std::shared_ptr<std::atomic<bool>> alive_ = std::make_shared<std::atomic<bool>>(true);
 
-    // Re-entrancy guard for Disconnect (ConnectionStatusChanged → Disconnect → ...)
-    std::atomic<bool> disconnecting_{false};
+    // Performance history (per connect / per download)
+    std::shared_ptr<PodHistoryStore> history_;
+    std::string device_address_;
+    std::chrono::steady_clock::time_point connect_started_;
+    int negotiated_mtu_ = 0;
+    bool download_active_ = false;
+    std::string download_filename_;
+    std::string last_incomplete_filename_;
+    std::chrono::steady_clock::time_point download_started_;
+    int download_retries_ = 0;
+    int watchdog_triggers_ = 0;
+
+    // Power policy: wake lock is held only while a transfer is in flight
+    PowerHold power_hold_;
+    std::chrono::milliseconds idle_downgrade_delay_{5000};
+    uint64_t idle_generation_ = 0;
+    bool is_connected_ = false;
+    bool power_optimized_ = false;
+    std::chrono::steady_clock::time_point connected_at_;
+    std::chrono::steady_clock::time_point active_since_;
+    bool is_active_ = false;
+    int64_t active_ms_total_ = 0;
+#ifdef POD_BLE_HAS_CONNECTION_PARAMETERS
+    BluetoothLEPreferredConnectionParametersRequest conn_params_request_{nullptr};
+#endif
+
+    // Live metrics
+    LiveMetricsTracker live_metrics_;
+    bool live_metrics_enabled_ = false;
+    bool live_forward_packets_ = true;
+    std::chrono::milliseconds live_publish_interval_{250};
+    std::chrono::steady_clock::time_point live_last_publish_;
+    LiveJitterBuffer live_jitter_;
+    bool live_jitter_enabled_ = false;
+    uint64_t live_playout_generation_ = 0;
+    std::shared_ptr<LiveTelemetrySegment> live_segment_;
+    int live_segment_slot_ = -1;
+
+    // Awaiter for DownloadFileAsync, signalled from FinishMessage/CancelDownload/Disconnect
+    struct DownloadWaiter {
+        winrt::handle done;
+        std::vector<uint8_t> payload;
+    };
+    std::shared_ptr<DownloadWaiter> pending_download_;
+
+    // Firmware-ready detection (replaces fixed handover delays). Dart waits
+    // PodHandover.probedFallback for "Pod Ready", which must cover
+    // kReadyFallbackMs + kReadyProbeAttempts * kReadyProbeIntervalMs.
+    static constexpr int kReadyFallbackMs = 500;
+    static constexpr int kReadyProbeAttempts = 4;
+    static constexpr int kReadyProbeIntervalMs = 150;
+    static constexpr uint32_t kReadyProbeTag = 1;   // ReplyMatcher tag of our own 0x09 probes
+    bool awaiting_ready_ = false;
+    uint64_t ready_generation_ = 0;
+    std::chrono::steady_clock::time_point ready_wait_started_;
+    int ready_probe_attempt_ = 0;                   // Of the probe still outstanding
+    int skips_owed_ = 0;                            // 0xDA markers owed to aborted transfers
+    int firmware_record_size_ = 0;                  // 47/61/64 identifies the firmware family
+    std::map<int, double> ready_latency_ewma_ms_;   // Learned completion→ready latency per family
+
+    // Multi-file pipeline (DownloadFiles). Indices are 1-based.
+    std::deque<std::string> batch_queue_;
+    int64_t batch_filter_start_ = 0;
+    int64_t batch_filter_end_ = 0;
+    int batch_total_ = 0;
+    int batch_requested_ = 0;       // Files written to the pod so far
+    int batch_acknowledged_ = 0;    // Files the consumer has finished with
+    int batch_window_ = 1;
+    bool batch_active_ = false;
+    bool batch_paused_ = false;     // Pod ready, waiting on the window
+
+    // Command correlation, set-and-verify (ApplySettings) and batch delete
+    ReplyMatcher reply_matcher_;
+    std::unique_ptr<SettingsVerifier> settings_verifier_;
+    std::unique_ptr<FileDeleter> file_deleter_;
+
+    // Session recording and replay. recording_ mirrors recorder_ != nullptr so
+    // the hot paths skip building events when nothing is recording.
+    std::shared_ptr<SessionRecorder> recorder_;
+    bool recording_ = false;
+    ReplayLink replay_link_;
+
+    // Re-entrancy guard for Disconnect (a callback may call back into it)
+    bool disconnecting_ = false;
+
+    // Strand. PostToStrand() is how public methods hop over: it returns true
+    // when it posted the call and the caller must return.
+    bool PostToStrand(std::function<void()> call);
+    template <typename Fn>
+    auto OnStrand(Fn fn) { return RunOnStrand(*scheduler_, std::move(fn)); }
+
+    // co_await ResumeOnStrand() continues a coroutine on the strand; WinRT
+    // resumes them on its own thread pool. Skipped when already there. If
+    // the core goes away first the coroutine is never resumed.
+    struct StrandAwaiter {
+        PodBLECore* core;
+        bool await_ready() const { return core->scheduler_->IsCurrent(); }
+        void await_suspend(std::coroutine_handle<> handle) const;
+        void await_resume() const {}
+    };
+    StrandAwaiter ResumeOnStrand() { return {this}; }
 
-    // Sleep prevention
+    // Sleep prevention (download-scoped, reference-counted across pods)
     void PreventSleep();
     void AllowSleep();
+    void BeginActivePeriod();
+    void EndActivePeriod();
+    void ScheduleIdleDowngrade();
+    void RequestConnectionProfile(bool throughput);
 
     // Internal
+    void OnNotification(const std::vector<uint8_t>& data);
     void ProcessPacket(const std::vector<uint8_t>& packet);
+    bool HandleLivePacket(const std::vector<uint8_t>& packet);
+    bool UpdateLiveMetrics(const uint8_t* telemetry, size_t len);
+    void PublishLiveSample(const uint8_t* telemetry, size_t len, bool concealed);
+    void AttachLiveSegment(bool connected);
+    void StartLivePlayout();
+    void StopLivePlayout();
+    void LivePlayoutTick(uint64_t generation);
     int DetectRecordSize(const std::vector<uint8_t>& buffer);
     void PerformSmartPeek();
     void FinishMessage();
+    void AbortTransfer();
+    void BeginDownload(const std::string& filename, int64_t start, int64_t end,
+                       int totalFiles, int currentIndex);
+    void StartNextBatchFile();
+    void ClearBatch();
     void ResetDownloadState();
     void StartWatchdog();
     void StopWatchdog();
+    void WatchdogTick(uint64_t generation);
+    void Record(SessionEvent event);
     int64_t SnapToStandardInterval(int64_t raw);
+    void RecordConnectOutcome();
+    void RecordDownloadOutcome(size_t payloadBytes, int received, int expected);
 
     // Async helpers
     winrt::fire_and_forget CheckRadioAndScan();
-    winrt::fire_and_forget ConnectAsync(uint64_t address);
+    void SendCommand(const std::vector<uint8_t>& data, uint32_t replyTag = 0);
+    Windows::Foundation::IAsyncOperation<bool> SendCommandAsync(std::vector<uint8_t> data, uint32_t replyTag = 0);
+    Windows::Foundation::IAsyncOperation<bool> ConnectAsync(uint64_t address);
+    void SignalPendingDownload(std::vector<uint8_t>* payload);
+    void BeginReadyDetection();
+    void ProbeReady(uint64_t generation, int attempt);
+    void CancelReadyDetection();
+    void EmitOwedSkips();
+    void OnPodReady(bool timedOut, double probeLatencyMs = 0);
+    SettingsVerifier::Gate CommandGate() const;
+    static uint32_t ReadSequence(const std::vector<uint8_t>& packet);
     void OnAdvertisementReceived(BluetoothLEAdvertisementWatcher const& watcher,
                                   BluetoothLEAdvertisementReceivedEventArgs const& args);
 };
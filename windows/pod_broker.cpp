@@ -0,0 +1,534 @@
+#include "pod_broker.h"
+
+#include "payload_integrity.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace pod_connector {
+
+namespace {
+
+// Statuses after which the pod is no longer connected
+bool EndsSession(const std::string& status) {
+    return status == "Disconnected" || status == "Connection Error" ||
+           status == "Device Not Found" || status == "Service Not Found" ||
+           status == "Service Discovery Error";
+}
+
+bool IsFileDelivery(const std::vector<uint8_t>& payload) {
+    return !payload.empty() && (payload[0] == 0x03 || payload[0] == 0xDA);
+}
+
+} // namespace
+
+// MARK: - Lifecycle
+
+PodBroker::PodBroker(BrokerBackend& backend, BrokerConfig config)
+    : backend_(backend), config_(std::move(config)) {
+    if (config_.endpoint.empty()) config_.endpoint = DefaultBrokerEndpoint();
+    if (config_.shared_memory_name.empty()) config_.shared_memory_name = DefaultSharedMemoryName();
+}
+
+PodBroker::~PodBroker() {
+    Stop();
+}
+
+bool PodBroker::Start(std::string* error) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (running_) return true;
+    }
+    if (!ring_.Create(config_.shared_memory_name, config_.shared_memory_size, error)) return false;
+    if (!server_.Listen(config_.endpoint, error)) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        running_ = true;
+    }
+    backend_.SetCallbacks(
+        [this](const std::string& status) { OnStatus(status); },
+        [this](const std::string& name, const std::string& id, int rssi) { OnScan(name, id, rssi); },
+        [this](const std::vector<uint8_t>& payload) { OnPayload(payload); });
+    accept_thread_ = std::thread([this] { AcceptLoop(); });
+    return true;
+}
+
+void PodBroker::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!running_) return;
+        running_ = false;
+    }
+    server_.Close();
+    if (accept_thread_.joinable()) accept_thread_.join();
+    backend_.SetCallbacks(nullptr, nullptr, nullptr);
+
+    std::list<std::unique_ptr<Client>> clients;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (auto& client : clients_) {
+            client->closing = true;
+            client->stream->Shutdown();
+            client->cv.notify_all();
+        }
+        clients.splice(clients.end(), clients_);
+    }
+    // Each reader releases its client's claims on the way out
+    for (auto& client : clients) {
+        if (client->reader.joinable()) client->reader.join();
+        if (client->writer.joinable()) client->writer.join();
+    }
+}
+
+BrokerStats PodBroker::Stats() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    BrokerStats stats = stats_;
+    stats.clients = 0;
+    for (const auto& client : clients_) {
+        if (!client->finished) stats.clients++;
+    }
+    stats.scanning = scanners_ > 0;
+    stats.live_stream = live_on_;
+    stats.device = device_;
+    stats.ring = ring_.Stats();
+    return stats;
+}
+
+// MARK: - Clients
+
+void PodBroker::AcceptLoop() {
+    while (auto stream = server_.Accept()) {
+        ReapFinished();
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!running_) break;
+        auto client = std::make_unique<Client>();
+        client->id = next_client_id_++;
+        client->stream = std::move(stream);
+        Client* raw = client.get();
+        clients_.push_back(std::move(client));
+        stats_.clients_accepted++;
+        raw->reader = std::thread([this, raw] { ReaderLoop(raw); });
+        raw->writer = std::thread([this, raw] { WriterLoop(raw); });
+    }
+}
+
+void PodBroker::ReapFinished() {
+    std::list<std::unique_ptr<Client>> finished;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (auto it = clients_.begin(); it != clients_.end();) {
+            auto next = std::next(it);
+            if ((*it)->finished) finished.splice(finished.end(), clients_, it);
+            it = next;
+        }
+    }
+    for (auto& client : finished) {
+        if (client->reader.joinable()) client->reader.join();
+        if (client->writer.joinable()) client->writer.join();
+    }
+}
+
+void PodBroker::ReaderLoop(Client* client) {
+    BrokerMessage type;
+    std::vector<uint8_t> body;
+    bool ready = false;
+    while (ReadFrame(*client->stream, type, body)) {
+        if (!ready) {
+            if (type != BrokerMessage::kHello || !HandleHello(client, body)) break;
+            ready = true;
+            continue;
+        }
+        if (type == BrokerMessage::kRequest) {
+            HandleRequest(client, body);
+        } else if (type == BrokerMessage::kRelease) {
+            HandleRelease(client, body);
+        } else if (type == BrokerMessage::kSubscribe) {
+            FrameReader reader(body);
+            uint32_t subscriptions;
+            if (!reader.U32(subscriptions)) break;
+            std::lock_guard<std::mutex> lock(mtx_);
+            client->subscriptions = subscriptions;
+        } else {
+            break;  // Protocol error
+        }
+    }
+
+    // Gone (or told to go): give back whatever it held
+    std::vector<Action> actions;
+    {
+        std::lock_guard<std::mutex> command_lock(command_mtx_);
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            ReleaseClaims(client, actions);
+            client->closing = true;
+            client->cv.notify_all();
+        }
+        for (auto& action : actions) action();
+    }
+    client->stream->Shutdown();
+    std::lock_guard<std::mutex> lock(mtx_);
+    client->finished = true;
+}
+
+void PodBroker::WriterLoop(Client* client) {
+    while (true) {
+        Frame frame;
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            client->cv.wait(lock, [&] { return client->closing || !client->backlog.empty(); });
+            if (client->closing) return;
+            frame = std::move(client->backlog.front().first);
+            client->backlog.pop_front();
+            client->backlog_bytes -= frame->size();
+        }
+        if (!client->stream->WriteAll(frame->data(), frame->size())) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            client->closing = true;
+            client->stream->Shutdown();
+            return;
+        }
+    }
+}
+
+bool PodBroker::HandleHello(Client* client, const std::vector<uint8_t>& body) {
+    FrameReader reader(body);
+    uint32_t version = 0;
+    uint32_t subscriptions = 0;
+    std::string name;
+    if (!reader.U32(version) || !reader.U32(subscriptions) || !reader.Str(name)) return false;
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (version != kBrokerProtocolVersion) {
+        // Tell the client which version we speak, then hang up
+        std::vector<uint8_t> welcome = FrameWriter(BrokerMessage::kWelcome)
+                                           .U32(kBrokerProtocolVersion).U32(0)
+                                           .Str("").U64(0).Finish();
+        client->stream->WriteAll(welcome.data(), welcome.size());
+        return false;
+    }
+    client->name = std::move(name);
+    client->subscriptions = subscriptions;
+    client->ready = true;
+    Send(client, std::make_shared<std::vector<uint8_t>>(
+                     FrameWriter(BrokerMessage::kWelcome)
+                         .U32(kBrokerProtocolVersion).U32(client->id)
+                         .Str(ring_.name()).U64(ring_.capacity()).Finish()),
+         false);
+    // Late joiners learn the session state straight away
+    if ((subscriptions & kSubscribeStatus) && !last_status_.empty()) {
+        Send(client, std::make_shared<std::vector<uint8_t>>(
+                         FrameWriter(BrokerMessage::kStatus).Str(last_status_).Finish()),
+             false);
+    }
+    return true;
+}
+
+void PodBroker::HandleRelease(Client* client, const std::vector<uint8_t>& body) {
+    FrameReader reader(body);
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+    if (!reader.U32(slot) || !reader.U32(generation)) return;
+    std::lock_guard<std::mutex> lock(mtx_);
+    // Only slots this client was sent, once each
+    if (client->shared.erase({slot, generation}) != 0) ring_.Release(slot, generation);
+}
+
+// MARK: - Requests
+
+void PodBroker::HandleRequest(Client* client, const std::vector<uint8_t>& body) {
+    FrameReader reader(body);
+    uint32_t request_id = 0;
+    uint8_t command = 0;
+    if (!reader.U32(request_id) || !reader.U8(command)) return;
+
+    std::lock_guard<std::mutex> command_lock(command_mtx_);
+    std::vector<Action> actions;
+    std::string error;
+    bool ok;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stats_.requests++;
+        ok = ExecuteCommand(client, static_cast<BrokerCommand>(command), reader, actions, error);
+        if (!ok) stats_.requests_refused++;
+    }
+    for (auto& action : actions) action();
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    SendReply(client, request_id, ok, error);
+}
+
+bool PodBroker::ExecuteCommand(Client* client, BrokerCommand command, FrameReader& args,
+                               std::vector<Action>& actions, std::string& error) {
+    auto refuse = [&](std::string message) {
+        error = std::move(message);
+        return false;
+    };
+
+    switch (command) {
+        case BrokerCommand::kStartScan:
+            if (!client->scanning) {
+                client->scanning = true;
+                if (scanners_++ == 0) actions.push_back([this] { backend_.StartScan(); });
+            }
+            return true;
+
+        case BrokerCommand::kStopScan:
+            if (client->scanning) {
+                client->scanning = false;
+                if (--scanners_ == 0) actions.push_back([this] { backend_.StopScan(); });
+            }
+            return true;
+
+        case BrokerCommand::kConnect: {
+            std::string id;
+            if (!args.Str(id) || id.empty()) return refuse("Bad arguments");
+            if (device_.empty()) {
+                device_ = id;
+                client->holds_connection = true;
+                actions.push_back([this, id] { backend_.Connect(id); });
+                return true;
+            }
+            if (device_ != id) return refuse("Busy: connected to " + device_);
+            if (!client->holds_connection) {
+                client->holds_connection = true;
+                if ((client->subscriptions & kSubscribeStatus) && !last_status_.empty()) {
+                    Send(client, std::make_shared<std::vector<uint8_t>>(
+                                     FrameWriter(BrokerMessage::kStatus).Str(last_status_).Finish()),
+                         false);
+                }
+            }
+            return true;
+        }
+
+        case BrokerCommand::kDisconnect:
+            ReleaseConnection(client, actions);
+            return true;
+
+        case BrokerCommand::kWriteCommand: {
+            std::vector<uint8_t> data;
+            if (!args.Bytes(data) || data.empty()) return refuse("Bad arguments");
+            if (!client->holds_connection) return refuse("Not connected");
+            if (data[0] == 0x03 && data.size() >= 2) {
+                // Live stream on/off is shared: on while anyone wants it
+                client->wants_live = data[1] != 0;
+                bool wanted = std::any_of(clients_.begin(), clients_.end(),
+                                          [](const auto& c) { return c->wants_live; });
+                if (wanted == live_on_) return true;
+                live_on_ = wanted;
+            } else if ((data[0] == 0x06 || data[0] == 0x08) && download_owner_ != 0 &&
+                       download_owner_ != client->id) {
+                return refuse("Busy: download in progress");
+            }
+            actions.push_back([this, data = std::move(data)] { backend_.WriteCommand(data); });
+            return true;
+        }
+
+        case BrokerCommand::kDownloadFile: {
+            std::string filename;
+            int64_t start = 0;
+            int64_t end = 0;
+            if (!args.Str(filename) || !args.I64(start) || !args.I64(end)) return refuse("Bad arguments");
+            if (!client->holds_connection) return refuse("Not connected");
+            if (download_owner_ != 0) return refuse("Busy: download in progress");
+            download_owner_ = client->id;
+            downloads_left_ = 1;
+            batch_download_ = false;
+            actions.push_back([this, filename, start, end] { backend_.DownloadFile(filename, start, end); });
+            return true;
+        }
+
+        case BrokerCommand::kDownloadFiles: {
+            uint32_t count = 0;
+            if (!args.U32(count) || count == 0) return refuse("Bad arguments");
+            std::vector<std::string> filenames(count);
+            for (auto& filename : filenames) {
+                if (!args.Str(filename)) return refuse("Bad arguments");
+            }
+            int64_t start = 0;
+            int64_t end = 0;
+            uint32_t window = 0;
+            if (!args.I64(start) || !args.I64(end) || !args.U32(window)) return refuse("Bad arguments");
+            if (!client->holds_connection) return refuse("Not connected");
+            if (download_owner_ != 0) return refuse("Busy: download in progress");
+            download_owner_ = client->id;
+            downloads_left_ = static_cast<int>(count);
+            batch_download_ = true;
+            actions.push_back([this, filenames = std::move(filenames), start, end, window] {
+                backend_.DownloadFiles(filenames, start, end, static_cast<int>(window));
+            });
+            return true;
+        }
+
+        case BrokerCommand::kAcknowledgeBatchFile: {
+            uint32_t index = 0;
+            if (!args.U32(index)) return refuse("Bad arguments");
+            if (download_owner_ == 0) return true;  // Late ack after "Batch Complete"
+            if (download_owner_ != client->id) return refuse("Not the download owner");
+            actions.push_back([this, index] { backend_.AcknowledgeBatchFile(static_cast<int>(index)); });
+            return true;
+        }
+
+        case BrokerCommand::kCancelDownload:
+            if (download_owner_ == 0) return true;
+            if (download_owner_ != client->id) return refuse("Not the download owner");
+            download_owner_ = 0;
+            actions.push_back([this] { backend_.CancelDownload(); });
+            return true;
+    }
+    return refuse("Unknown command");
+}
+
+void PodBroker::ReleaseClaims(Client* client, std::vector<Action>& actions) {
+    if (client->scanning) {
+        client->scanning = false;
+        if (--scanners_ == 0) actions.push_back([this] { backend_.StopScan(); });
+    }
+    ReleaseConnection(client, actions);
+    for (const auto& [slot, generation] : client->shared) ring_.Release(slot, generation);
+    client->shared.clear();
+    client->backlog.clear();
+    client->backlog_bytes = 0;
+}
+
+void PodBroker::ReleaseConnection(Client* client, std::vector<Action>& actions) {
+    if (!client->holds_connection) return;
+    if (download_owner_ == client->id) {
+        download_owner_ = 0;
+        actions.push_back([this] { backend_.CancelDownload(); });
+    }
+    client->holds_connection = false;
+    client->wants_live = false;
+    bool shared = std::any_of(clients_.begin(), clients_.end(),
+                              [](const auto& c) { return c->holds_connection; });
+    if (!shared) {
+        // Leave the pod with its stream off for whoever connects next
+        if (live_on_) actions.push_back([this] { backend_.WriteCommand({0x03, 0x00}); });
+        ResetSession();
+        actions.push_back([this] { backend_.Disconnect(); });
+    } else if (live_on_ && std::none_of(clients_.begin(), clients_.end(),
+                                        [](const auto& c) { return c->wants_live; })) {
+        live_on_ = false;
+        actions.push_back([this] { backend_.WriteCommand({0x03, 0x00}); });
+    }
+}
+
+void PodBroker::ResetSession() {
+    device_.clear();
+    download_owner_ = 0;
+    downloads_left_ = 0;
+    batch_download_ = false;
+    live_on_ = false;
+    for (auto& client : clients_) {
+        client->holds_connection = false;
+        client->wants_live = false;
+    }
+}
+
+// MARK: - Events
+
+void PodBroker::OnStatus(const std::string& status) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!running_) return;
+    stats_.events++;
+    last_status_ = status;
+    if (EndsSession(status)) ResetSession();
+    if (status == "Batch Complete" && batch_download_) download_owner_ = 0;
+
+    auto frame = std::make_shared<std::vector<uint8_t>>(FrameWriter(BrokerMessage::kStatus).Str(status).Finish());
+    for (auto& client : clients_) {
+        if (client->ready && (client->subscriptions & kSubscribeStatus)) Send(client.get(), frame, false);
+    }
+}
+
+void PodBroker::OnScan(const std::string& name, const std::string& id, int rssi) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!running_) return;
+    stats_.events++;
+    auto frame = std::make_shared<std::vector<uint8_t>>(
+        FrameWriter(BrokerMessage::kScanResult).Str(name).Str(id).I32(rssi).Finish());
+    for (auto& client : clients_) {
+        if (client->ready && (client->subscriptions & kSubscribeScan)) Send(client.get(), frame, true);
+    }
+}
+
+void PodBroker::OnPayload(const std::vector<uint8_t>& payload) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!running_) return;
+    stats_.events++;
+    if (download_owner_ != 0 && IsFileDelivery(payload) && --downloads_left_ <= 0 && !batch_download_) {
+        download_owner_ = 0;
+    }
+
+    const uint32_t stream = PayloadSubscription(payload.data(), payload.size());
+    const bool live = stream == kSubscribeLive;
+    std::vector<Client*> recipients;
+    for (auto& client : clients_) {
+        if (client->ready && !client->closing && (client->subscriptions & stream)) {
+            recipients.push_back(client.get());
+        }
+    }
+    if (recipients.empty()) return;
+
+    // Large payloads are written once to shared memory; each client gets its location
+    if (payload.size() > config_.inline_limit) {
+        auto slot = ring_.Publish(payload.data(), payload.size(), static_cast<uint32_t>(recipients.size()));
+        if (slot) {
+            stats_.payloads_shared++;
+            auto frame = std::make_shared<std::vector<uint8_t>>(
+                FrameWriter(BrokerMessage::kPayloadRef)
+                    .U32(slot->slot).U32(slot->generation).U64(slot->offset).U32(slot->length)
+                    .U32(Crc32c(0, payload.data(), payload.size()))
+                    .Finish());
+            for (Client* client : recipients) {
+                if (Send(client, frame, live)) {
+                    client->shared.insert({slot->slot, slot->generation});
+                } else {
+                    ring_.Release(slot->slot, slot->generation);
+                }
+            }
+            return;
+        }
+    }
+
+    stats_.payloads_inline++;
+    auto frame = std::make_shared<std::vector<uint8_t>>(FrameWriter(BrokerMessage::kPayload).Bytes(payload).Finish());
+    for (Client* client : recipients) Send(client, frame, live);
+}
+
+bool PodBroker::Send(Client* client, Frame frame, bool droppable) {
+    if (client->closing) return false;
+    if (droppable) {
+        if (client->backlog_bytes + frame->size() > config_.client_backlog) {
+            client->dropped_live++;
+            stats_.live_dropped++;
+            return false;
+        }
+        if (client->dropped_live > 0) {
+            auto notice = std::make_shared<std::vector<uint8_t>>(
+                FrameWriter(BrokerMessage::kDropped).U32(client->dropped_live).Finish());
+            client->dropped_live = 0;
+            client->backlog_bytes += notice->size();
+            client->backlog.emplace_back(std::move(notice), false);
+        }
+    } else if (client->backlog_bytes + frame->size() > config_.client_backlog_limit) {
+        // Not keeping up with events that cannot be dropped: let it reconnect
+        stats_.clients_evicted++;
+        client->closing = true;
+        client->stream->Shutdown();
+        client->cv.notify_all();
+        return false;
+    }
+    client->backlog_bytes += frame->size();
+    client->backlog.emplace_back(std::move(frame), droppable);
+    client->cv.notify_one();
+    return true;
+}
+
+void PodBroker::SendReply(Client* client, uint32_t requestId, bool ok, const std::string& error) {
+    Send(client, std::make_shared<std::vector<uint8_t>>(
+                     FrameWriter(BrokerMessage::kReply).U32(requestId).U8(ok ? 1 : 0).Str(error).Finish()),
+         false);
+}
+
+} // namespace pod_connector
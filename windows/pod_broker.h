@@ -0,0 +1,196 @@
+#pragma once
+
+#include "broker_protocol.h"
+#include "local_channel.h"
+#include "shared_payload_ring.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace pod_connector {
+
+/// The BLE side a PodBroker drives: PodBLECore on Windows, a simulator in
+/// tests. Mirrors the PodBLECore commands the method channel exposes.
+///
+/// Callbacks may fire on any thread, including from inside a command call.
+/// After SetCallbacks returns, the previous callbacks must not be invoked.
+class BrokerBackend {
+public:
+    using StatusFn = std::function<void(const std::string&)>;
+    using ScanFn = std::function<void(const std::string& name, const std::string& id, int rssi)>;
+    using PayloadFn = std::function<void(const std::vector<uint8_t>&)>;
+
+    virtual ~BrokerBackend() = default;
+
+    virtual void SetCallbacks(StatusFn status, ScanFn scan, PayloadFn payload) = 0;
+    virtual void StartScan() = 0;
+    virtual void StopScan() = 0;
+    virtual void Connect(const std::string& deviceId) = 0;
+    virtual void Disconnect() = 0;
+    virtual void WriteCommand(const std::vector<uint8_t>& data) = 0;
+    virtual void DownloadFile(const std::string& filename, int64_t start, int64_t end) = 0;
+    virtual void DownloadFiles(const std::vector<std::string>& filenames, int64_t start, int64_t end,
+                               int window) = 0;
+    virtual void AcknowledgeBatchFile(int index) = 0;
+    virtual void CancelDownload() = 0;
+};
+
+struct BrokerConfig {
+    std::string endpoint;                           // Empty = DefaultBrokerEndpoint()
+    std::string shared_memory_name;                 // Empty = DefaultSharedMemoryName()
+    size_t shared_memory_size = 64 * 1024 * 1024;
+    size_t inline_limit = 4096;                     // Payloads up to this size are sent in the frame
+    size_t client_backlog = 4 * 1024 * 1024;        // Queued bytes past which live events are dropped
+    size_t client_backlog_limit = 64 * 1024 * 1024; // Queued bytes at which a stalled client is dropped
+};
+
+struct BrokerStats {
+    size_t clients = 0;
+    uint64_t clients_accepted = 0;
+    uint64_t clients_evicted = 0;   // Disconnected for not keeping up
+    uint64_t requests = 0;
+    uint64_t requests_refused = 0;  // Busy / not connected / not the download owner
+    uint64_t events = 0;            // Backend callbacks received
+    uint64_t payloads_shared = 0;   // Sent as kPayloadRef
+    uint64_t payloads_inline = 0;   // Sent inside the frame
+    uint64_t live_dropped = 0;      // Live events dropped for clients over their backlog
+    bool scanning = false;
+    bool live_stream = false;
+    std::string device;             // Connected device, empty if none
+    PayloadRingStats ring;
+};
+
+/// Owns one BLE session and shares it with several local processes, so a
+/// coaching dashboard and an archiving service can use the same pod without
+/// each opening the radio. Clients speak the broker protocol
+/// (broker_protocol.h) over a Unix domain socket or named pipe;
+/// PodBrokerClient is the C++ end of it.
+///
+/// Shared resources are reference counted per client:
+///   * Scanning runs while at least one client asked for it.
+///   * The connection is shared by every client that connected to the same
+///     device, and closed when the last one disconnects or goes away. A
+///     connect to a different device is refused while the first is in use.
+///   * The live stream (write command 0x03 0x01 / 0x00) is on while at least
+///     one client asked for it.
+///   * One download (single file or batch) runs at a time; only the client
+///     that started it may acknowledge or cancel it. It is cancelled if that
+///     client goes away.
+///
+/// Status, scan and payload events go to every client subscribed to them.
+/// Payloads larger than inline_limit are copied once into a shared-memory
+/// ring and only their location is sent; each client reads them in place and
+/// releases the slot. Every client has its own send thread and backlog, so a
+/// stalled client loses live events (and is eventually disconnected)
+/// without delaying the others.
+class PodBroker {
+public:
+    PodBroker(BrokerBackend& backend, BrokerConfig config);
+
+    /// Calls Stop().
+    ~PodBroker();
+
+    PodBroker(const PodBroker&) = delete;
+    PodBroker& operator=(const PodBroker&) = delete;
+
+    /// Creates the shared-memory ring and starts accepting clients.
+    bool Start(std::string* error);
+
+    /// Disconnects every client, releases the pod (scan, live stream,
+    /// download, connection) and clears the backend callbacks.
+    void Stop();
+
+    const std::string& endpoint() const { return config_.endpoint; }
+
+    BrokerStats Stats() const;
+
+private:
+    using Frame = std::shared_ptr<const std::vector<uint8_t>>;
+
+    struct Client {
+        uint32_t id = 0;
+        std::string name;
+        std::unique_ptr<LocalStream> stream;
+        std::thread reader;
+        std::thread writer;
+
+        // Guarded by PodBroker::mtx_
+        bool ready = false;         // Hello received
+        bool closing = false;
+        bool finished = false;      // Reader has cleaned up; threads can be joined
+        uint32_t subscriptions = 0;
+        bool scanning = false;
+        bool holds_connection = false;
+        bool wants_live = false;
+        std::deque<std::pair<Frame, bool>> backlog;     // Frame, droppable (live)
+        size_t backlog_bytes = 0;
+        uint32_t dropped_live = 0;  // Not yet reported with kDropped
+        std::set<std::pair<uint32_t, uint32_t>> shared; // Unreleased ring slots
+        std::condition_variable cv;
+    };
+
+    /// Backend commands decided under mtx_, issued after it is released
+    using Action = std::function<void()>;
+
+    void AcceptLoop();
+    void ReaderLoop(Client* client);
+    void WriterLoop(Client* client);
+    void ReapFinished();
+
+    bool HandleHello(Client* client, const std::vector<uint8_t>& body);
+    void HandleRequest(Client* client, const std::vector<uint8_t>& body);
+    bool ExecuteCommand(Client* client, BrokerCommand command, FrameReader& args,
+                        std::vector<Action>& actions, std::string& error);
+    void HandleRelease(Client* client, const std::vector<uint8_t>& body);
+
+    /// Drops [client]'s claims on the shared session. Caller holds mtx_.
+    void ReleaseClaims(Client* client, std::vector<Action>& actions);
+    void ReleaseConnection(Client* client, std::vector<Action>& actions);
+    void ResetSession();
+
+    void OnStatus(const std::string& status);
+    void OnScan(const std::string& name, const std::string& id, int rssi);
+    void OnPayload(const std::vector<uint8_t>& payload);
+
+    /// Queues [frame] for [client]; false if it was dropped or the client is
+    /// going away. Caller holds mtx_.
+    bool Send(Client* client, Frame frame, bool droppable);
+    void SendReply(Client* client, uint32_t requestId, bool ok, const std::string& error);
+
+    BrokerBackend& backend_;
+    BrokerConfig config_;
+    LocalServer server_;
+    SharedPayloadRing ring_;
+    std::thread accept_thread_;
+
+    // Serialises request handling so the decide-then-act of one request
+    // cannot interleave with another's.
+    std::mutex command_mtx_;
+
+    mutable std::mutex mtx_;
+    std::list<std::unique_ptr<Client>> clients_;
+    bool running_ = false;
+    uint32_t next_client_id_ = 1;
+    size_t scanners_ = 0;
+    std::string device_;
+    std::string last_status_;       // Replayed to clients that subscribe late
+    uint32_t download_owner_ = 0;   // Client id, 0 = idle
+    int downloads_left_ = 0;        // Files of the running download not yet delivered
+    bool batch_download_ = false;
+    bool live_on_ = false;
+    BrokerStats stats_;
+};
+
+} // namespace pod_connector
@@ -0,0 +1,256 @@
+#include "pod_broker_client.h"
+
+#include "payload_integrity.h"
+
+#include <utility>
+
+namespace pod_connector {
+
+// MARK: - Connection
+
+PodBrokerClient::~PodBrokerClient() {
+    Close();
+}
+
+bool PodBrokerClient::Open(const std::string& endpoint, const std::string& name, uint32_t subscriptions,
+                           Handlers handlers, std::string* error) {
+    Close();
+    auto stream = ConnectLocal(endpoint, error);
+    if (!stream) return false;
+
+    std::vector<uint8_t> hello = FrameWriter(BrokerMessage::kHello)
+                                     .U32(kBrokerProtocolVersion).U32(subscriptions).Str(name)
+                                     .Finish();
+    BrokerMessage type;
+    std::vector<uint8_t> body;
+    if (!stream->WriteAll(hello.data(), hello.size()) || !ReadFrame(*stream, type, body) ||
+        type != BrokerMessage::kWelcome) {
+        if (error) *error = "Broker handshake failed";
+        return false;
+    }
+    FrameReader reader(body);
+    uint32_t version = 0;
+    uint32_t id = 0;
+    std::string shared_name;
+    uint64_t shared_size = 0;
+    if (!reader.U32(version) || !reader.U32(id) || !reader.Str(shared_name) || !reader.U64(shared_size)) {
+        if (error) *error = "Malformed welcome";
+        return false;
+    }
+    if (version != kBrokerProtocolVersion || id == 0) {
+        if (error) *error = "Broker speaks protocol version " + std::to_string(version);
+        return false;
+    }
+    if (!shared_name.empty() && !shared_.Open(shared_name, static_cast<size_t>(shared_size), error)) {
+        return false;
+    }
+
+    stream_ = std::move(stream);
+    handlers_ = std::move(handlers);
+    client_id_ = id;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        connected_ = true;
+        stats_ = Stats{};
+    }
+    receiver_ = std::thread([this] { ReceiveLoop(); });
+    return true;
+}
+
+void PodBrokerClient::Close() {
+    if (stream_) stream_->Shutdown();
+    if (receiver_.joinable()) receiver_.join();
+    stream_.reset();
+    client_id_ = 0;
+}
+
+PodBrokerClient::Stats PodBrokerClient::stats() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return stats_;
+}
+
+bool PodBrokerClient::Write(const std::vector<uint8_t>& frame) {
+    std::lock_guard<std::mutex> lock(write_mtx_);
+    return stream_ && stream_->WriteAll(frame.data(), frame.size());
+}
+
+// MARK: - Commands
+
+bool PodBrokerClient::Call(BrokerCommand command, const std::function<void(FrameWriter&)>& args,
+                           std::string* error) {
+    uint32_t request_id;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!connected_) {
+            if (error) *error = "Not connected to the broker";
+            return false;
+        }
+        request_id = next_request_++;
+        pending_[request_id] = Pending{};
+    }
+
+    FrameWriter writer(BrokerMessage::kRequest);
+    writer.U32(request_id).U8(static_cast<uint8_t>(command));
+    if (args) args(writer);
+    bool sent = Write(writer.Finish());
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    bool replied = sent && cv_.wait_for(lock, kReplyTimeout, [&] {
+        return pending_[request_id].done || !connected_;
+    });
+    Pending result = std::move(pending_[request_id]);
+    pending_.erase(request_id);
+    if (!replied || !result.done) {
+        if (error) *error = sent ? "No reply from the broker" : "Broker connection lost";
+        return false;
+    }
+    if (!result.ok && error) *error = result.error;
+    return result.ok;
+}
+
+bool PodBrokerClient::StartScan(std::string* error) {
+    return Call(BrokerCommand::kStartScan, nullptr, error);
+}
+
+bool PodBrokerClient::StopScan(std::string* error) {
+    return Call(BrokerCommand::kStopScan, nullptr, error);
+}
+
+bool PodBrokerClient::Connect(const std::string& deviceId, std::string* error) {
+    return Call(BrokerCommand::kConnect, [&](FrameWriter& w) { w.Str(deviceId); }, error);
+}
+
+bool PodBrokerClient::Disconnect(std::string* error) {
+    return Call(BrokerCommand::kDisconnect, nullptr, error);
+}
+
+bool PodBrokerClient::WriteCommand(const std::vector<uint8_t>& data, std::string* error) {
+    return Call(BrokerCommand::kWriteCommand, [&](FrameWriter& w) { w.Bytes(data); }, error);
+}
+
+bool PodBrokerClient::DownloadFile(const std::string& filename, int64_t start, int64_t end, std::string* error) {
+    return Call(BrokerCommand::kDownloadFile, [&](FrameWriter& w) { w.Str(filename).I64(start).I64(end); }, error);
+}
+
+bool PodBrokerClient::DownloadFiles(const std::vector<std::string>& filenames, int64_t start, int64_t end,
+                                    int window, std::string* error) {
+    return Call(BrokerCommand::kDownloadFiles, [&](FrameWriter& w) {
+        w.U32(static_cast<uint32_t>(filenames.size()));
+        for (const auto& filename : filenames) w.Str(filename);
+        w.I64(start).I64(end).U32(static_cast<uint32_t>(window));
+    }, error);
+}
+
+bool PodBrokerClient::AcknowledgeBatchFile(int index, std::string* error) {
+    return Call(BrokerCommand::kAcknowledgeBatchFile,
+                [&](FrameWriter& w) { w.U32(static_cast<uint32_t>(index)); }, error);
+}
+
+bool PodBrokerClient::CancelDownload(std::string* error) {
+    return Call(BrokerCommand::kCancelDownload, nullptr, error);
+}
+
+bool PodBrokerClient::Subscribe(uint32_t subscriptions) {
+    return Write(FrameWriter(BrokerMessage::kSubscribe).U32(subscriptions).Finish());
+}
+
+// MARK: - Events
+
+void PodBrokerClient::ReceiveLoop() {
+    BrokerMessage type;
+    std::vector<uint8_t> body;
+    while (ReadFrame(*stream_, type, body)) {
+        FrameReader reader(body);
+        switch (type) {
+            case BrokerMessage::kReply: {
+                uint32_t request_id = 0;
+                uint8_t ok = 0;
+                std::string message;
+                if (!reader.U32(request_id) || !reader.U8(ok) || !reader.Str(message)) break;
+                std::lock_guard<std::mutex> lock(mtx_);
+                auto it = pending_.find(request_id);
+                if (it != pending_.end()) {
+                    it->second.done = true;
+                    it->second.ok = ok != 0;
+                    it->second.error = std::move(message);
+                    cv_.notify_all();
+                }
+                break;
+            }
+            case BrokerMessage::kStatus: {
+                std::string status;
+                if (reader.Str(status) && handlers_.status) handlers_.status(status);
+                break;
+            }
+            case BrokerMessage::kScanResult: {
+                std::string name;
+                std::string id;
+                int32_t rssi = 0;
+                if (reader.Str(name) && reader.Str(id) && reader.I32(rssi) && handlers_.scan) {
+                    handlers_.scan(name, id, rssi);
+                }
+                break;
+            }
+            case BrokerMessage::kPayload: {
+                std::vector<uint8_t> payload;
+                if (!reader.Bytes(payload)) break;
+                {
+                    std::lock_guard<std::mutex> lock(mtx_);
+                    stats_.payloads_inline++;
+                }
+                if (handlers_.payload) handlers_.payload(payload.data(), payload.size());
+                break;
+            }
+            case BrokerMessage::kPayloadRef:
+                HandlePayloadRef(body);
+                break;
+            case BrokerMessage::kDropped: {
+                uint32_t count = 0;
+                if (!reader.U32(count)) break;
+                {
+                    std::lock_guard<std::mutex> lock(mtx_);
+                    stats_.live_dropped += count;
+                }
+                if (handlers_.dropped) handlers_.dropped(count);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        connected_ = false;
+    }
+    cv_.notify_all();
+    if (handlers_.closed) handlers_.closed();
+}
+
+void PodBrokerClient::HandlePayloadRef(const std::vector<uint8_t>& body) {
+    FrameReader reader(body);
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+    uint64_t offset = 0;
+    uint32_t length = 0;
+    uint32_t crc = 0;
+    if (!reader.U32(slot) || !reader.U32(generation) || !reader.U64(offset) ||
+        !reader.U32(length) || !reader.U32(crc)) {
+        return;
+    }
+
+    const uint8_t* data = shared_.data();
+    bool valid = data && offset <= shared_.size() && length <= shared_.size() - offset &&
+                 Crc32c(0, data + offset, length) == crc;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (valid) stats_.payloads_shared++;
+        else stats_.checksum_errors++;
+    }
+    if (valid && handlers_.payload) handlers_.payload(data + offset, length);
+
+    // The broker reuses the space once every reader has released it
+    Write(FrameWriter(BrokerMessage::kRelease).U32(slot).U32(generation).Finish());
+}
+
+} // namespace pod_connector
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "broker_protocol.h"
+#include "local_channel.h"
+#include "shared_payload_ring.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pod_connector {
+
+/// C++ end of the broker protocol, for local processes that share a
+/// PodBroker's BLE session.
+///
+/// Handlers run on the client's receive thread, in the order the broker
+/// sent the events. Commands block until the broker replies and may be
+/// called from any thread except a handler's.
+class PodBrokerClient {
+public:
+    struct Handlers {
+        std::function<void(const std::string& status)> status;
+        std::function<void(const std::string& name, const std::string& id, int rssi)> scan;
+
+        /// [data] points into the broker's shared memory (or the received
+        /// frame) and is only valid for the duration of the call.
+        std::function<void(const uint8_t* data, size_t length)> payload;
+
+        /// The broker dropped [count] live events because this client fell
+        /// behind.
+        std::function<void(uint32_t count)> dropped;
+
+        /// The connection to the broker ended.
+        std::function<void()> closed;
+    };
+
+    struct Stats {
+        uint64_t payloads_shared = 0;   // Read from shared memory
+        uint64_t payloads_inline = 0;
+        uint64_t checksum_errors = 0;   // Shared payloads whose CRC32C did not match (skipped)
+        uint64_t live_dropped = 0;      // As reported by the broker
+    };
+
+    PodBrokerClient() = default;
+
+    /// Calls Close().
+    ~PodBrokerClient();
+
+    PodBrokerClient(const PodBrokerClient&) = delete;
+    PodBrokerClient& operator=(const PodBrokerClient&) = delete;
+
+    /// Connects to the broker at [endpoint] and subscribes to
+    /// [subscriptions] (BrokerSubscription bits).
+    bool Open(const std::string& endpoint, const std::string& name, uint32_t subscriptions,
+              Handlers handlers, std::string* error);
+
+    void Close();
+
+    bool StartScan(std::string* error = nullptr);
+    bool StopScan(std::string* error = nullptr);
+    bool Connect(const std::string& deviceId, std::string* error = nullptr);
+    bool Disconnect(std::string* error = nullptr);
+    bool WriteCommand(const std::vector<uint8_t>& data, std::string* error = nullptr);
+    bool DownloadFile(const std::string& filename, int64_t start, int64_t end, std::string* error = nullptr);
+    bool DownloadFiles(const std::vector<std::string>& filenames, int64_t start, int64_t end, int window,
+                       std::string* error = nullptr);
+    bool AcknowledgeBatchFile(int index, std::string* error = nullptr);
+    bool CancelDownload(std::string* error = nullptr);
+    bool Subscribe(uint32_t subscriptions);
+
+    uint32_t client_id() const { return client_id_; }
+    Stats stats() const;
+
+    /// How long a command waits for the broker's reply.
+    static constexpr std::chrono::seconds kReplyTimeout{10};
+
+private:
+    struct Pending {
+        bool done = false;
+        bool ok = false;
+        std::string error;
+    };
+
+    bool Call(BrokerCommand command, const std::function<void(FrameWriter&)>& args, std::string* error);
+    bool Write(const std::vector<uint8_t>& frame);
+    void ReceiveLoop();
+    void HandlePayloadRef(const std::vector<uint8_t>& body);
+
+    std::unique_ptr<LocalStream> stream_;
+    SharedMemoryRegion shared_;
+    Handlers handlers_;
+    uint32_t client_id_ = 0;
+    std::thread receiver_;
+
+    std::mutex write_mtx_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::map<uint32_t, Pending> pending_;
+    uint32_t next_request_ = 1;
+    bool connected_ = false;
+    Stats stats_;
+};
+
+} // namespace pod_connector
@@ -0,0 +1,117 @@
+// Standalone broker: owns the radio through PodBLECore and shares the BLE
+// session with local apps over a named pipe (see pod_broker.h).
+//
+//   pod_ble_broker [--endpoint \\.\pipe\name] [--shared-memory-mb N] [--live-export]
+//
+// --live-export also publishes the live stream into the shared-memory live
+// telemetry segment (see live_telemetry_segment.h).
+//
+// Runs until Ctrl+C. Build with -DPOD_BLE_BUILD_BROKER=ON.
+
+#include "pod_ble_core.h"
+#include "pod_broker.h"
+#include "pod_history_store.h"
+
+#include <windows.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+using namespace pod_connector;
+
+namespace {
+
+HANDLE g_stop_event = nullptr;
+
+BOOL WINAPI OnConsoleCtrl(DWORD) {
+    SetEvent(g_stop_event);
+    return TRUE;
+}
+
+/// PodBLECore behind the broker's backend interface.
+class PodBLECoreBackend : public BrokerBackend {
+public:
+    explicit PodBLECoreBackend(std::shared_ptr<PodHistoryStore> history) {
+        core_.SetHistoryStore(std::move(history));
+    }
+
+    void SetCallbacks(StatusFn status, ScanFn scan, PayloadFn payload) override {
+        core_.SetCallbacks(std::move(status), std::move(scan), std::move(payload));
+    }
+    void StartScan() override { core_.StartScan(); }
+    void StopScan() override { core_.StopScan(); }
+    void Connect(const std::string& deviceId) override { core_.Connect(deviceId); }
+    void Disconnect() override { core_.Disconnect(); }
+    void WriteCommand(const std::vector<uint8_t>& data) override { core_.WriteCommand(data); }
+    void DownloadFile(const std::string& filename, int64_t start, int64_t end) override {
+        core_.DownloadFile(filename, start, end, 1, 1);
+    }
+    void DownloadFiles(const std::vector<std::string>& filenames, int64_t start, int64_t end,
+                       int window) override {
+        core_.DownloadFiles(filenames, start, end, window);
+    }
+    void AcknowledgeBatchFile(int index) override { core_.AcknowledgeBatchFile(index); }
+    void CancelDownload() override { core_.CancelDownload(); }
+
+    void ExportLive(std::shared_ptr<LiveTelemetrySegment> segment) {
+        core_.SetLiveTelemetrySegment(std::move(segment));
+    }
+
+private:
+    PodBLECore core_;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BrokerConfig config;
+    bool liveExport = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--endpoint" && i + 1 < argc) {
+            config.endpoint = argv[++i];
+        } else if (arg == "--shared-memory-mb" && i + 1 < argc) {
+            config.shared_memory_size = static_cast<size_t>(std::atoi(argv[++i])) * 1024 * 1024;
+        } else if (arg == "--live-export") {
+            liveExport = true;
+        } else {
+            std::fprintf(stderr,
+                         "Usage: pod_ble_broker [--endpoint <pipe>] [--shared-memory-mb <n>] [--live-export]\n");
+            return 2;
+        }
+    }
+
+    winrt::init_apartment(winrt::apartment_type::multi_threaded);
+    g_stop_event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    SetConsoleCtrlHandler(OnConsoleCtrl, TRUE);
+
+    auto backend = std::make_unique<PodBLECoreBackend>(
+        std::make_shared<PodHistoryStore>(PodHistoryStore::DefaultPath()));
+    PodBroker broker(*backend, config);
+    std::string error;
+    auto liveSegment = std::make_shared<LiveTelemetrySegment>();
+    if (liveExport) {
+        if (!liveSegment->Create(DefaultLiveTelemetrySegmentName(), LiveTelemetrySegment::kDefaultPodSlots,
+                                 LiveTelemetrySegment::kDefaultRingRecords, &error)) {
+            std::fprintf(stderr, "pod_ble_broker: %s\n", error.c_str());
+            return 1;
+        }
+        backend->ExportLive(liveSegment);
+        std::printf("Live telemetry exported to %s\n", liveSegment->name().c_str());
+    }
+    if (!broker.Start(&error)) {
+        std::fprintf(stderr, "pod_ble_broker: %s\n", error.c_str());
+        return 1;
+    }
+    std::printf("pod_ble_broker listening on %s\n", broker.endpoint().c_str());
+
+    WaitForSingleObject(g_stop_event, INFINITE);
+
+    // Releases the pod, then tears the core down before the broker it calls into
+    broker.Stop();
+    backend.reset();
+    CloseHandle(g_stop_event);
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include "pod_commands.h"
+
+#include <algorithm>
+
+namespace pod_connector {
+
+// The encodings are fixed by the ICD; check them where the compiler can
+static_assert(pod_command::SetLogInterval(1000).bytes == std::array<uint8_t, 4>{0x0B, 0x02, 0xE8, 0x03});
+static_assert(pod_command::SetPlayerNumber(23).bytes == std::array<uint8_t, 3>{0x0A, 0x01, 23});
+static_assert(pod_command::SetLiveStream(true).bytes == std::array<uint8_t, 3>{0x03, 0x01, 0x01});
+static_assert(pod_command::SetInternalLogging(false).bytes == std::array<uint8_t, 3>{0x04, 0x01, 0x00});
+static_assert(pod_command::GetSettings().opcode() == PodOpcode::kGetSettings);
+static_assert(pod_command::DownloadFile("LOG1.BIN  (2048 bytes)").bytes[1] == 0x20);
+static_assert(pod_command::DownloadFile("LOG1.BIN  (2048 bytes)").bytes[9] == 'N');
+static_assert(pod_command::DownloadFile("LOG1.BIN  (2048 bytes)").bytes[10] == 0x00);
+static_assert(pod_command::DeleteFile("LOG1.BIN").opcode() == PodOpcode::kDeleteFile);
+static_assert(pod_command::FileNameOf("LOG1.BIN (1.2 KB)") == "LOG1.BIN");
+
+namespace {
+
+// A sequenced block carries its data after [type][seq u32][total u32]
+constexpr size_t kBlockHeader = 9;
+constexpr size_t kSettingsData = 4;     // [len][player][lsb][msb]
+constexpr size_t kCatalogEntry = pod_command::kFilenameBytes + 4;
+
+} // namespace
+
+std::string OpcodeName(uint8_t opcode) {
+    switch (static_cast<PodOpcode>(opcode)) {
+        case PodOpcode::kSetLiveStream: return "setLiveStream";
+        case PodOpcode::kSetInternalLogging: return "setInternalLogging";
+        case PodOpcode::kGetLogFilesInfo: return "getLogFilesInfo";
+        case PodOpcode::kDownloadFile: return "downloadFile";
+        case PodOpcode::kDeleteFile: return "deleteFile";
+        case PodOpcode::kCancelTransfer: return "cancelTransfer";
+        case PodOpcode::kGetSettings: return "getSettings";
+        case PodOpcode::kSetPlayerNumber: return "setPlayerNumber";
+        case PodOpcode::kSetLogInterval: return "setLogInterval";
+    }
+    static const char kHex[] = "0123456789ABCDEF";
+    return std::string("0x") + kHex[opcode >> 4] + kHex[opcode & 0x0F];
+}
+
+std::optional<PodReplyType> ExpectedReply(PodOpcode opcode) {
+    switch (opcode) {
+        case PodOpcode::kGetLogFilesInfo: return PodReplyType::kFileList;
+        case PodOpcode::kDownloadFile: return PodReplyType::kFileData;
+        case PodOpcode::kGetSettings: return PodReplyType::kSettings;
+        default: return std::nullopt;
+    }
+}
+
+std::optional<uint8_t> ReplyTypeOf(const std::vector<uint8_t>& packet) {
+    if (packet.empty()) return std::nullopt;
+    if (packet[0] != 0xAE) return packet[0];
+    if (packet.size() < 2) return std::nullopt;
+    return packet[1];
+}
+
+std::optional<PodSettings> ParseSettingsReply(const std::vector<uint8_t>& packet) {
+    size_t offset = !packet.empty() && packet[0] == 0xAE ? 1 : 0;
+    if (packet.size() <= offset || packet[offset] != static_cast<uint8_t>(PodReplyType::kSettings)) {
+        return std::nullopt;
+    }
+    size_t remaining = packet.size() - offset;
+    size_t data;
+    if (remaining >= kBlockHeader + kSettingsData) {
+        data = offset + kBlockHeader;
+    } else if (remaining >= 1 + kSettingsData) {
+        data = offset + 1;
+    } else {
+        return std::nullopt;
+    }
+    PodSettings settings;
+    settings.player_number = packet[data + 1];
+    settings.log_interval_ms = packet[data + 2] | (packet[data + 3] << 8);
+    return settings;
+}
+
+std::vector<uint8_t> EncodeSettingsPayload(const PodSettings& settings) {
+    return {static_cast<uint8_t>(PodReplyType::kSettings), 0x03,
+            static_cast<uint8_t>(settings.player_number),
+            static_cast<uint8_t>(settings.log_interval_ms & 0xFF),
+            static_cast<uint8_t>((settings.log_interval_ms >> 8) & 0xFF)};
+}
+
+std::optional<std::vector<PodFileEntry>> ParseFileCatalog(const std::vector<uint8_t>& message) {
+    size_t offset = !message.empty() && message[0] == 0xAE ? 1 : 0;
+    if (message.size() < offset + 3 || message[offset] != static_cast<uint8_t>(PodReplyType::kFileList)) {
+        return std::nullopt;
+    }
+    const size_t count = message[offset + 2];
+    const size_t entries = offset + 3;
+    if (message.size() < entries + count * kCatalogEntry) return std::nullopt;
+
+    std::vector<PodFileEntry> files;
+    files.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* entry = message.data() + entries + i * kCatalogEntry;
+        const char* name = reinterpret_cast<const char*>(entry);
+        PodFileEntry file;
+        file.name.assign(name, std::find(name, name + pod_command::kFilenameBytes, '\0'));
+        const uint8_t* size = entry + pod_command::kFilenameBytes;
+        file.size = size[0] | (size[1] << 8) | (size[2] << 16) | (static_cast<uint32_t>(size[3]) << 24);
+        files.push_back(std::move(file));
+    }
+    return files;
+}
+
+std::vector<uint8_t> EncodeFileCatalog(const std::vector<PodFileEntry>& files) {
+    const size_t count = std::min<size_t>(files.size(), 255);
+    std::vector<uint8_t> data;
+    data.reserve(2 + count * kCatalogEntry);
+    // The length byte covers the count and entries, capped at 255
+    data.push_back(static_cast<uint8_t>(std::min<size_t>(1 + count * kCatalogEntry, 255)));
+    data.push_back(static_cast<uint8_t>(count));
+    for (size_t i = 0; i < count; i++) {
+        const auto& file = files[i];
+        for (size_t b = 0; b < static_cast<size_t>(pod_command::kFilenameBytes); b++) {
+            data.push_back(b < file.name.size() ? static_cast<uint8_t>(file.name[b]) : 0);
+        }
+        for (int b = 0; b < 4; b++) data.push_back(static_cast<uint8_t>(file.size >> (b * 8)));
+    }
+    return data;
+}
+
+// MARK: - CommandLatency
+
+void CommandLatency::Add(double ms) {
+    answered++;
+    last_ms = ms;
+    mean_ms += (ms - mean_ms) / static_cast<double>(answered);
+    max_ms = std::max(max_ms, ms);
+}
+
+// MARK: - ReplyMatcher
+
+void ReplyMatcher::Sent(PodOpcode opcode, Clock::time_point now, uint32_t tag) {
+    Expire(now);
+    StatsFor(opcode).sent++;
+    if (auto reply = ExpectedReply(opcode)) pending_.push_back({opcode, *reply, now, tag});
+}
+
+std::optional<ReplyMatcher::Match> ReplyMatcher::OnReply(const std::vector<uint8_t>& packet,
+                                                         Clock::time_point now) {
+    Expire(now);
+    auto type = ReplyTypeOf(packet);
+    if (!type) return std::nullopt;
+    auto it = std::find_if(pending_.begin(), pending_.end(), [&](const Pending& p) {
+        return static_cast<uint8_t>(p.reply) == *type;
+    });
+    if (it == pending_.end()) return std::nullopt;
+    Match match{it->request, std::chrono::duration<double, std::milli>(now - it->sent).count(), it->tag};
+    pending_.erase(it);
+    StatsFor(match.request).Add(match.latency_ms);
+    return match;
+}
+
+void ReplyMatcher::Withdraw(uint32_t tag) {
+    for (auto it = pending_.begin(); it != pending_.end();) {
+        if (it->tag == tag) {
+            StatsFor(it->request).timeouts++;
+            it = pending_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ReplyMatcher::Expire(Clock::time_point now) {
+    while (!pending_.empty() && now - pending_.front().sent > expiry_) {
+        StatsFor(pending_.front().request).timeouts++;
+        pending_.pop_front();
+    }
+}
+
+} // namespace pod_connector
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pod_connector {
+
+/// Host → pod commands of BLE ICD V3.6. Every command is
+/// [opcode][payload length][payload]; PodBLECore prepends the 0xAE message
+/// header on write.
+enum class PodOpcode : uint8_t {
+    kSetLiveStream = 0x03,
+    kSetInternalLogging = 0x04,
+    kGetLogFilesInfo = 0x05,
+    kDownloadFile = 0x06,
+    kDeleteFile = 0x07,
+    kCancelTransfer = 0x08,
+    kGetSettings = 0x09,
+    kSetPlayerNumber = 0x0A,
+    kSetLogInterval = 0x0B,
+};
+
+/// Pod → host message types. Replies arrive as sequenced blocks:
+/// [type][sequence u32][total blocks u32][data].
+enum class PodReplyType : uint8_t {
+    kLiveData = 0x01,
+    kFileList = 0x02,
+    kFileData = 0x03,
+    kSettings = 0x05,
+};
+
+/// An encoded command of [N] bytes (opcode, length, payload).
+template <size_t N>
+struct CommandFrame {
+    std::array<uint8_t, N> bytes{};
+
+    constexpr PodOpcode opcode() const { return static_cast<PodOpcode>(bytes[0]); }
+    std::vector<uint8_t> ToVector() const { return {bytes.begin(), bytes.end()}; }
+};
+
+/// Device settings, as carried by a 0x05 reply.
+struct PodSettings {
+    int player_number = 0;      // 1-99, appended to the advertised name
+    int log_interval_ms = 0;    // 100-1000, SD-card logging period
+
+    bool operator==(const PodSettings&) const = default;
+};
+
+namespace pod_command {
+
+constexpr int kFilenameBytes = 32;
+
+constexpr bool IsValidPlayerNumber(int number) { return number >= 1 && number <= 99; }
+constexpr bool IsValidLogInterval(int intervalMs) { return intervalMs >= 100 && intervalMs <= 1000; }
+
+constexpr CommandFrame<3> SetLiveStream(bool enabled) {
+    return {{0x03, 0x01, static_cast<uint8_t>(enabled ? 0x01 : 0x00)}};
+}
+
+constexpr CommandFrame<3> SetInternalLogging(bool enabled) {
+    return {{0x04, 0x01, static_cast<uint8_t>(enabled ? 0x01 : 0x00)}};
+}
+
+constexpr CommandFrame<2> GetLogFilesInfo() { return {{0x05, 0x00}}; }
+constexpr CommandFrame<2> CancelTransfer() { return {{0x08, 0x00}}; }
+constexpr CommandFrame<2> GetSettings() { return {{0x09, 0x00}}; }
+
+constexpr CommandFrame<3> SetPlayerNumber(uint8_t number) { return {{0x0A, 0x01, number}}; }
+
+constexpr CommandFrame<4> SetLogInterval(uint16_t intervalMs) {
+    return {{0x0B, 0x02, static_cast<uint8_t>(intervalMs & 0xFF), static_cast<uint8_t>(intervalMs >> 8)}};
+}
+
+/// The filename in a file list entry: entries read "NAME.BIN (12345 bytes)",
+/// so the name stops at the parenthesis, trailing spaces trimmed.
+constexpr std::string_view FileNameOf(std::string_view entry) {
+    std::string_view name = entry.substr(0, entry.find('('));
+    while (!name.empty() && name.back() == ' ') name.remove_suffix(1);
+    return name;
+}
+
+namespace detail {
+
+// The entry's filename, NUL-padded to 32 bytes
+constexpr CommandFrame<2 + kFilenameBytes> FileCommand(uint8_t opcode, std::string_view entry) {
+    std::string_view name = FileNameOf(entry);
+    CommandFrame<2 + kFilenameBytes> frame;
+    frame.bytes[0] = opcode;
+    frame.bytes[1] = kFilenameBytes;
+    for (size_t i = 0; i < name.size() && i < static_cast<size_t>(kFilenameBytes); i++) {
+        frame.bytes[2 + i] = static_cast<uint8_t>(name[i]);
+    }
+    return frame;
+}
+
+} // namespace detail
+
+constexpr CommandFrame<2 + kFilenameBytes> DownloadFile(std::string_view entry) {
+    return detail::FileCommand(0x06, entry);
+}
+
+constexpr CommandFrame<2 + kFilenameBytes> DeleteFile(std::string_view entry) {
+    return detail::FileCommand(0x07, entry);
+}
+
+} // namespace pod_command
+
+/// Command name for statistics ("getSettings"), or "0x.." for opcodes
+/// outside the ICD.
+std::string OpcodeName(uint8_t opcode);
+
+/// The reply a command is answered with, if any. Set commands have no reply
+/// of their own; they are verified through Get Settings.
+std::optional<PodReplyType> ExpectedReply(PodOpcode opcode);
+
+/// Message type of a notification, looking past a 0xAE header.
+std::optional<uint8_t> ReplyTypeOf(const std::vector<uint8_t>& packet);
+
+/// Decodes a settings reply: the sequenced block
+/// [0x05][seq u32][total u32][len][player][interval lsb][interval msb], or
+/// the short [0x05][len][player][lsb][msb] form, optionally 0xAE-prefixed.
+std::optional<PodSettings> ParseSettingsReply(const std::vector<uint8_t>& packet);
+
+/// The settings reply as PodBLECore delivers it on the payload stream
+/// (the reassembled form: [0x05][len][player][lsb][msb]).
+std::vector<uint8_t> EncodeSettingsPayload(const PodSettings& settings);
+
+/// One file on the pod's SD card, as listed by Get Log Files Info.
+struct PodFileEntry {
+    std::string name;
+    uint32_t size = 0;
+
+    bool operator==(const PodFileEntry&) const = default;
+};
+
+/// Decodes a reassembled file list message:
+/// [0x02][len][count][count x (name[32] NUL-padded, size u32)].
+std::optional<std::vector<PodFileEntry>> ParseFileCatalog(const std::vector<uint8_t>& message);
+
+/// The data of a file list message ([len][count][entries], without the
+/// type), as the firmware sends it. At most 255 files.
+std::vector<uint8_t> EncodeFileCatalog(const std::vector<PodFileEntry>& files);
+
+/// Round-trip latency of one command kind.
+struct CommandLatency {
+    uint64_t sent = 0;
+    uint64_t answered = 0;
+    uint64_t timeouts = 0;      // No reply (or, for set commands, never verified)
+    uint64_t mismatches = 0;    // Set commands: replies that did not show the change yet
+    double last_ms = 0;
+    double mean_ms = 0;
+    double max_ms = 0;
+
+    void Add(double ms);
+};
+
+/// Correlates replies with the requests that asked for them. The pod answers
+/// in order, so a reply goes to the oldest request waiting for its type;
+/// requests still unanswered after [expiry] count as timeouts.
+class ReplyMatcher {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ReplyMatcher(Clock::duration expiry = std::chrono::seconds(1)) : expiry_(expiry) {}
+
+    /// Records that [opcode] was written at [now]. Commands without a reply
+    /// are only counted. A non-zero [tag] marks requests the host made for
+    /// itself, so their replies can be told apart from the app's.
+    void Sent(PodOpcode opcode, Clock::time_point now, uint32_t tag = 0);
+
+    struct Match {
+        PodOpcode request;
+        double latency_ms;
+        uint32_t tag = 0;
+    };
+
+    /// The request [packet] answers, if any. Its latency is recorded.
+    std::optional<Match> OnReply(const std::vector<uint8_t>& packet, Clock::time_point now);
+
+    /// Counts requests older than the expiry as timed out and drops them.
+    void Expire(Clock::time_point now);
+
+    /// Drops the outstanding requests sent with [tag], counted as timed out:
+    /// the pod ignored them, and a later reply must not be taken for theirs.
+    void Withdraw(uint32_t tag);
+
+    /// Forgets outstanding requests without counting them (link dropped).
+    void Reset() { pending_.clear(); }
+
+    size_t Outstanding() const { return pending_.size(); }
+
+    CommandLatency& StatsFor(PodOpcode opcode) { return stats_[static_cast<uint8_t>(opcode)]; }
+    const std::map<uint8_t, CommandLatency>& Stats() const { return stats_; }
+
+private:
+    struct Pending {
+        PodOpcode request;
+        PodReplyType reply;
+        Clock::time_point sent;
+        uint32_t tag;
+    };
+
+    Clock::duration expiry_;
+    std::deque<Pending> pending_;
+    std::map<uint8_t, CommandLatency> stats_;
+};
+
+} // namespace pod_connector
@@ -5,6 +5,9 @@
 #include <flutter/plugin_registrar_windows.h>
 #include <flutter/standard_method_codec.h>
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -21,33 +24,219 @@ int GetIntFromEncodableValue(const flutter::EncodableValue& value, int fallback)
     if (auto* i64 = std::get_if<int64_t>(&value)) return static_cast<int>(*i64);
     return fallback;
 }
+
+int64_t GetInt64FromEncodableValue(const flutter::EncodableValue& value, int64_t fallback) {
+    if (auto* i32 = std::get_if<int32_t>(&value)) return static_cast<int64_t>(*i32);
+    if (auto* i64 = std::get_if<int64_t>(&value)) return *i64;
+    return fallback;
+}
+
+// Live telemetry and metric snapshots; everything else on the payload
+// channel is file data that must not be dropped.
+bool IsLiveMessage(const std::vector<uint8_t>& data) {
+    return !data.empty() && (data[0] == 0x01 || data[0] == LiveMetricsSnapshot::kMessageType);
+}
+
+// "Downloading File i/n" updates replace each other; other statuses are events.
+std::string StatusCoalesceKey(const std::string& status) {
+    static const std::string kProgressPrefix = "Downloading File ";
+    return status.rfind(kProgressPrefix, 0) == 0 ? "progress" : std::string();
+}
+
+std::filesystem::path PayloadSpillPath() {
+    std::error_code ec;
+    auto dir = std::filesystem::temp_directory_path(ec);
+    if (ec) dir = std::filesystem::current_path(ec);
+    return dir / ("pod_ble_payload_" + std::to_string(GetCurrentProcessId()) + ".spill");
+}
+
+flutter::EncodableMap HistorySummaryToMap(const PodHistorySummary& s) {
+    flutter::EncodableMap map;
+    map[flutter::EncodableValue("id")] = flutter::EncodableValue(s.address);
+    map[flutter::EncodableValue("connectCount")] = flutter::EncodableValue(s.connect_count);
+    map[flutter::EncodableValue("downloadCount")] = flutter::EncodableValue(s.download_count);
+    map[flutter::EncodableValue("lastMtu")] = flutter::EncodableValue(s.last_mtu);
+    map[flutter::EncodableValue("connectLatencyP50Ms")] = flutter::EncodableValue(s.connect_latency_p50_ms);
+    map[flutter::EncodableValue("connectLatencyP90Ms")] = flutter::EncodableValue(s.connect_latency_p90_ms);
+    map[flutter::EncodableValue("throughputP10Bps")] = flutter::EncodableValue(s.throughput_p10_bps);
+    map[flutter::EncodableValue("throughputP50Bps")] = flutter::EncodableValue(s.throughput_p50_bps);
+    map[flutter::EncodableValue("throughputP90Bps")] = flutter::EncodableValue(s.throughput_p90_bps);
+    map[flutter::EncodableValue("packetLossP50Pct")] = flutter::EncodableValue(s.packet_loss_p50_pct);
+    map[flutter::EncodableValue("packetLossP90Pct")] = flutter::EncodableValue(s.packet_loss_p90_pct);
+    map[flutter::EncodableValue("totalRetries")] = flutter::EncodableValue(s.total_retries);
+    map[flutter::EncodableValue("totalWatchdogTriggers")] = flutter::EncodableValue(s.total_watchdog_triggers);
+    map[flutter::EncodableValue("firstSeenMs")] = flutter::EncodableValue(s.first_seen_ms);
+    map[flutter::EncodableValue("lastSeenMs")] = flutter::EncodableValue(s.last_seen_ms);
+    map[flutter::EncodableValue("degrading")] = flutter::EncodableValue(s.degrading);
+    return map;
+}
+
+std::optional<int> OptionalIntFromMap(const flutter::EncodableMap& map, const char* key) {
+    auto it = map.find(flutter::EncodableValue(key));
+    if (it == map.end() || it->second.IsNull()) return std::nullopt;
+    return GetIntFromEncodableValue(it->second, 0);
+}
+
+SettingsRequest SettingsRequestFromMap(const flutter::EncodableMap& map) {
+    return {OptionalIntFromMap(map, "playerNumber"), OptionalIntFromMap(map, "logIntervalMs")};
+}
+
+const char* SettingsRequestError(const SettingsRequest& request) {
+    if (request.Empty()) return "Nothing to set";
+    if (request.player_number && !pod_command::IsValidPlayerNumber(*request.player_number)) {
+        return "Player number must be 1-99";
+    }
+    if (request.log_interval_ms && !pod_command::IsValidLogInterval(*request.log_interval_ms)) {
+        return "Log interval must be 100-1000 ms";
+    }
+    return "Invalid settings";
+}
+
+flutter::EncodableMap SettingsResultToMap(const SettingsResult& outcome) {
+    flutter::EncodableMap map;
+    map[flutter::EncodableValue("verified")] = flutter::EncodableValue(outcome.verified);
+    map[flutter::EncodableValue("timedOut")] = flutter::EncodableValue(outcome.timed_out);
+    map[flutter::EncodableValue("probes")] = flutter::EncodableValue(outcome.probes);
+    map[flutter::EncodableValue("latencyMs")] = flutter::EncodableValue(outcome.latency_ms);
+    if (outcome.has_settings) {
+        map[flutter::EncodableValue("playerNumber")] = flutter::EncodableValue(outcome.settings.player_number);
+        map[flutter::EncodableValue("logIntervalMs")] = flutter::EncodableValue(outcome.settings.log_interval_ms);
+    }
+    return map;
+}
+
+std::vector<std::string> StringListFromMap(const flutter::EncodableMap& map, const char* key) {
+    std::vector<std::string> strings;
+    auto it = map.find(flutter::EncodableValue(key));
+    auto* list = it != map.end() ? std::get_if<flutter::EncodableList>(&it->second) : nullptr;
+    if (list) {
+        for (const auto& value : *list) {
+            if (auto* text = std::get_if<std::string>(&value)) strings.push_back(*text);
+        }
+    }
+    return strings;
+}
+
+flutter::EncodableList StringsToList(const std::vector<std::string>& strings) {
+    flutter::EncodableList list;
+    for (const auto& text : strings) list.emplace_back(text);
+    return list;
+}
+
+flutter::EncodableMap DeleteResultToMap(const DeleteResult& outcome) {
+    flutter::EncodableMap map;
+    map[flutter::EncodableValue("verified")] = flutter::EncodableValue(outcome.verified);
+    map[flutter::EncodableValue("timedOut")] = flutter::EncodableValue(outcome.timed_out);
+    map[flutter::EncodableValue("deleted")] = flutter::EncodableValue(StringsToList(outcome.deleted));
+    map[flutter::EncodableValue("remaining")] = flutter::EncodableValue(StringsToList(outcome.remaining));
+    map[flutter::EncodableValue("catalogReads")] = flutter::EncodableValue(outcome.catalog_reads);
+    map[flutter::EncodableValue("latencyMs")] = flutter::EncodableValue(outcome.latency_ms);
+    if (outcome.has_catalog) {
+        map[flutter::EncodableValue("filesLeft")] = flutter::EncodableValue(outcome.files_left);
+        map[flutter::EncodableValue("bytesLeft")] =
+            flutter::EncodableValue(static_cast<int64_t>(outcome.bytes_left));
+    }
+    return map;
+}
+
+flutter::EncodableMap FleetReportToMap(const FleetReport& report) {
+    flutter::EncodableList pods;
+    for (const auto& pod : report.pods) {
+        auto map = SettingsResultToMap(pod.settings);
+        map[flutter::EncodableValue("id")] = flutter::EncodableValue(pod.address);
+        map[flutter::EncodableValue("connected")] = flutter::EncodableValue(pod.connected);
+        map[flutter::EncodableValue("connectAttempts")] = flutter::EncodableValue(pod.connect_attempts);
+        map[flutter::EncodableValue("connectMs")] = flutter::EncodableValue(pod.connect_ms);
+        map[flutter::EncodableValue("totalMs")] = flutter::EncodableValue(pod.total_ms);
+        map[flutter::EncodableValue("deletion")] = flutter::EncodableValue(DeleteResultToMap(pod.deletion));
+        // The pod's outcome over every step, not just the settings one
+        map[flutter::EncodableValue("verified")] = flutter::EncodableValue(pod.ok());
+        if (!pod.error.empty()) map[flutter::EncodableValue("error")] = flutter::EncodableValue(pod.error);
+        pods.emplace_back(map);
+    }
+    flutter::EncodableMap map;
+    map[flutter::EncodableValue("pods")] = flutter::EncodableValue(pods);
+    map[flutter::EncodableValue("totalMs")] = flutter::EncodableValue(report.total_ms);
+    map[flutter::EncodableValue("verified")] = flutter::EncodableValue(report.verified);
+    map[flutter::EncodableValue("failed")] = flutter::EncodableValue(report.failed);
+    map[flutter::EncodableValue("peakConnections")] = flutter::EncodableValue(report.peak_connections);
+    map[flutter::EncodableValue("filesDeleted")] = flutter::EncodableValue(report.files_deleted);
+    map[flutter::EncodableValue("cancelled")] = flutter::EncodableValue(report.cancelled);
+    return map;
+}
+
+// A fleet pod on a PodBLECore of its own, beside the main connection
+class PodBLECoreFleetLink : public FleetPodLink {
+public:
+    PodBLECoreFleetLink(std::string address, std::shared_ptr<PodHistoryStore> history)
+        : address_(std::move(address)), core_(std::make_unique<PodBLECore>()) {
+        core_->SetHistoryStore(std::move(history));
+    }
+
+    void Connect(ConnectCallback done) override {
+        core_->ConnectAndWaitAsync(address_).Completed(
+            [done = std::move(done)](auto const& op, winrt::Windows::Foundation::AsyncStatus status) {
+            bool ok = false;
+            if (status == winrt::Windows::Foundation::AsyncStatus::Completed) {
+                try { ok = op.GetResults(); } catch (...) {}
+            }
+            done(ok);
+        });
+    }
+
+    void ApplySettings(const SettingsRequest& request, std::chrono::milliseconds timeout,
+                       SettingsCallback done) override {
+        core_->ApplySettings(request, timeout, std::move(done));
+    }
+
+    void DeleteFiles(const std::vector<std::string>& files, std::chrono::milliseconds timeout,
+                     DeleteCallback done) override {
+        core_->DeleteFiles(files, timeout, std::move(done));
+    }
+
+    void Disconnect() override { core_->Disconnect(); }
+
+private:
+    std::string address_;
+    std::unique_ptr<PodBLECore> core_;
+};
 }  // namespace
 
 // static
 void PodConnectorPlugin::RegisterWithRegistrar(
     flutter::PluginRegistrarWindows* registrar,
     FlutterDesktopPluginRegistrarRef raw_registrar) {
-    auto plugin = std::make_unique<PodConnectorPlugin>(registrar, raw_registrar);
+    // Created here, on the platform thread; it does not depend on a view or
+    // the top-level window proc. Without it replies and events would have to
+    // run on some other thread, which Flutter does not allow, so the plugin
+    // stays unregistered and Dart calls fail with MissingPluginException.
+    auto dispatcher = std::make_unique<MessageWindowDispatcher>();
+    if (!dispatcher->IsValid()) return;
+    auto plugin = std::make_unique<PodConnectorPlugin>(registrar, raw_registrar, std::move(dispatcher));
     registrar->AddPlugin(std::move(plugin));
 }
 
 PodConnectorPlugin::PodConnectorPlugin(flutter::PluginRegistrarWindows* registrar,
-                                       FlutterDesktopPluginRegistrarRef raw_registrar)
-    : registrar_(registrar) {
-
-    // Capture HWND for dispatching BLE callbacks back to the platform thread.
-    // BLE events fire on WinRT thread-pool threads, but Flutter requires all
-    // EventSink calls on the platform (UI) thread.
-    // Use C API to get the view ref (Flutter 3.38+ changed the type signature).
-    auto view_ref = FlutterDesktopPluginRegistrarGetView(raw_registrar);
-    if (view_ref) {
-        window_handle_ = FlutterDesktopViewGetHWND(view_ref);
-    }
-
-    // Register a window proc delegate to handle our custom callback message.
-    proc_delegate_id_ = registrar->RegisterTopLevelWindowProcDelegate(
-        [this](HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) {
-            return HandleWindowMessage(hwnd, msg, wparam, lparam);
+                                       FlutterDesktopPluginRegistrarRef /*raw_registrar*/,
+                                       std::unique_ptr<CallbackDispatcher> dispatcher)
+    : dispatcher_(std::move(dispatcher)) {
+    // Per-channel queues, drained by one task on the dispatcher at a time
+    channels_ = std::make_unique<ChannelQueues>([this, alive = alive_]() {
+        return dispatcher_->Post([this, alive]() {
+            if (alive->load()) channels_->Drain();
+        });
+    });
+    live_channel_ = channels_->AddChannel("live", OverflowPolicy::kDropOldest, kLiveQueueCapacity);
+    scan_channel_ = channels_->AddChannel("scan", OverflowPolicy::kDropOldest, kScanQueueCapacity);
+    status_channel_ = channels_->AddChannel("status", OverflowPolicy::kCoalesce, kStatusQueueCapacity);
+    reply_channel_ = channels_->AddChannel("reply", OverflowPolicy::kKeepAll, 0);
+    payload_channel_ = channels_->AddSpillChannel(
+        "payload", kPayloadMemoryBudget, PayloadSpillPath(),
+        [this, alive = alive_](std::vector<uint8_t> data) {
+            if (!alive->load()) return;
+            if (payload_sink_) {
+                payload_sink_->Success(flutter::EncodableValue(std::move(data)));
+            }
         });
 
     // Method Channel
@@ -90,22 +279,27 @@ PodConnectorPlugin::PodConnectorPlugin(flutter::PluginRegistrarWindows* registra
             [this](auto sink) { payload_sink_ = std::move(sink); },
             [this](auto) { payload_sink_.reset(); }));
 
+    // Per-pod performance history (persists across app runs)
+    history_store_ = std::make_shared<PodHistoryStore>(PodHistoryStore::DefaultPath());
+    history_store_->Open();
+
     // Initialize BLE Core
     ble_core_ = std::make_unique<PodBLECore>();
+    ble_core_->SetHistoryStore(history_store_);
     auto plugin_alive = alive_;
     ble_core_->SetCallbacks(
-        // Status callback — dispatched to platform thread
+        // Status callback — progress updates coalesce while the platform thread is behind
         [this, plugin_alive](const std::string& status) {
-            PostToMainThread([this, status, alive = plugin_alive]() {
+            channels_->Push(status_channel_, [this, status, alive = plugin_alive]() {
                 if (!alive->load()) return;
                 if (status_sink_) {
                     status_sink_->Success(flutter::EncodableValue(status));
                 }
-            });
+            }, StatusCoalesceKey(status));
         },
-        // Scan callback — dispatched to platform thread
+        // Scan callback — oldest results dropped while the platform thread is behind
         [this, plugin_alive](const std::string& name, const std::string& id, int rssi) {
-            PostToMainThread([this, name, id, rssi, alive = plugin_alive]() {
+            channels_->Push(scan_channel_, [this, name, id, rssi, alive = plugin_alive]() {
                 if (!alive->load()) return;
                 if (scan_sink_) {
                     flutter::EncodableMap device_map;
@@ -116,9 +310,13 @@ PodConnectorPlugin::PodConnectorPlugin(flutter::PluginRegistrarWindows* registra
                 }
             });
         },
-        // Payload callback — dispatched to platform thread
+        // Payload callback — live telemetry is droppable, file data never is
         [this, plugin_alive](const std::vector<uint8_t>& data) {
-            PostToMainThread([this, data, alive = plugin_alive]() {
+            if (!IsLiveMessage(data)) {
+                channels_->PushPayload(payload_channel_, data);
+                return;
+            }
+            channels_->Push(live_channel_, [this, data, alive = plugin_alive]() {
                 if (!alive->load()) return;
                 if (payload_sink_) {
                     payload_sink_->Success(flutter::EncodableValue(data));
@@ -128,41 +326,44 @@ PodConnectorPlugin::PodConnectorPlugin(flutter::PluginRegistrarWindows* registra
 }
 
 PodConnectorPlugin::~PodConnectorPlugin() {
-    alive_->store(false);
-    if (registrar_ && proc_delegate_id_ >= 0) {
-        registrar_->UnregisterTopLevelWindowProcDelegate(proc_delegate_id_);
+    {
+        // Waits out a WinRT completion handler that is queueing its reply
+        std::lock_guard<std::mutex> lock(*teardown_mtx_);
+        alive_->store(false);
     }
+    // Stop BLE callbacks before the dispatcher they post to goes away
+    fleet_job_.reset();
+    ble_core_.reset();
+    dispatcher_.reset();
+    channels_.reset();
 }
 
 void PodConnectorPlugin::PostToMainThread(std::function<void()> callback) {
-    if (window_handle_ == nullptr) {
-        // No window handle (headless?) — call directly as fallback
-        callback();
-        return;
-    }
-    {
-        std::lock_guard<std::mutex> lock(callback_mutex_);
-        queued_callbacks_.emplace_back(std::move(callback));
-    }
-    PostMessage(window_handle_, kCallbackMessage, 0, 0);
+    channels_->Push(reply_channel_, std::move(callback));
 }
 
-std::optional<LRESULT> PodConnectorPlugin::HandleWindowMessage(
-    HWND /*hwnd*/, UINT message, WPARAM /*wparam*/, LPARAM /*lparam*/) {
-    if (message == kCallbackMessage) {
-        // Swap-under-lock: drain the queue atomically to avoid holding
-        // the mutex while executing callbacks
-        std::list<std::function<void()>> batch;
-        {
-            std::lock_guard<std::mutex> lock(callback_mutex_);
-            std::swap(queued_callbacks_, batch);
-        }
-        for (auto& fn : batch) {
-            try { fn(); } catch (...) {}
+void PodConnectorPlugin::CompleteWhenDone(
+    winrt::Windows::Foundation::IAsyncOperation<bool> operation,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+    // MethodResult must be completed on the platform thread; the WinRT
+    // Completed handler fires on a thread-pool thread.
+    std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>> shared_result(std::move(result));
+    operation.Completed([this, shared_result, alive = alive_, teardown = teardown_mtx_](
+        auto const& op, winrt::Windows::Foundation::AsyncStatus status) {
+        if (!alive->load()) return;
+        bool ok = false;
+        if (status == winrt::Windows::Foundation::AsyncStatus::Completed) {
+            try { ok = op.GetResults(); } catch (...) {}
         }
-        return 0;
-    }
-    return std::nullopt;
+        // Not a strand or fleet thread the destructor joins: keep the plugin
+        // from tearing down channels_ until the reply is queued
+        std::lock_guard<std::mutex> lock(*teardown);
+        if (!alive->load()) return;
+        PostToMainThread([shared_result, ok, alive]() {
+            if (!alive->load()) return;
+            shared_result->Success(flutter::EncodableValue(ok));
+        });
+    });
 }
 
 void PodConnectorPlugin::HandleMethodCall(
@@ -180,8 +381,8 @@ void PodConnectorPlugin::HandleMethodCall(
     } else if (method == "connect") {
         auto* args = std::get_if<std::string>(method_call.arguments());
         if (args) {
-            ble_core_->Connect(*args);
-            result->Success();
+            // Reply once the link is ready (true) or has failed (false)
+            CompleteWhenDone(ble_core_->ConnectAndWaitAsync(*args), std::move(result));
         } else {
             result->Error("INVALID_ARG", "Device ID required");
         }
@@ -191,8 +392,8 @@ void PodConnectorPlugin::HandleMethodCall(
     } else if (method == "writeCommand") {
         auto* bytes = std::get_if<std::vector<uint8_t>>(method_call.arguments());
         if (bytes) {
-            ble_core_->WriteCommand(*bytes);
-            result->Success();
+            // Reply with the pod's write acknowledgement
+            CompleteWhenDone(ble_core_->WriteCommandAsync(*bytes), std::move(result));
         } else {
             result->Error("INVALID_ARG", "Byte array required");
         }
@@ -223,9 +424,387 @@ void PodConnectorPlugin::HandleMethodCall(
         } else {
             result->Error("INVALID_ARG", "Download arguments required");
         }
+    } else if (method == "downloadFiles") {
+        auto* args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+        const flutter::EncodableList* files = nullptr;
+        if (args) {
+            auto files_it = args->find(flutter::EncodableValue("filenames"));
+            if (files_it != args->end()) files = std::get_if<flutter::EncodableList>(&files_it->second);
+        }
+        if (files) {
+            std::vector<std::string> filenames;
+            filenames.reserve(files->size());
+            for (const auto& f : *files) {
+                if (auto* name = std::get_if<std::string>(&f)) filenames.push_back(*name);
+            }
+
+            int64_t start = 0, end = 0;
+            int window = 1;
+            auto start_it = args->find(flutter::EncodableValue("filterStart"));
+            auto end_it = args->find(flutter::EncodableValue("filterEnd"));
+            auto window_it = args->find(flutter::EncodableValue("window"));
+            if (start_it != args->end()) start = GetInt64FromEncodableValue(start_it->second, 0);
+            if (end_it != args->end()) end = GetInt64FromEncodableValue(end_it->second, 0);
+            if (window_it != args->end()) window = GetIntFromEncodableValue(window_it->second, 1);
+
+            ble_core_->DownloadFiles(filenames, start, end, window);
+            result->Success();
+        } else {
+            result->Error("INVALID_ARG", "File list required");
+        }
+    } else if (method == "acknowledgeBatchFile") {
+        if (method_call.arguments()) {
+            ble_core_->AcknowledgeBatchFile(GetIntFromEncodableValue(*method_call.arguments(), 0));
+        }
+        result->Success();
     } else if (method == "cancelDownload") {
         ble_core_->CancelDownload();
         result->Success();
+    } else if (method == "getPodHistory") {
+        // Optional device ID argument — omitted returns every known pod
+        flutter::EncodableList list;
+        if (auto* id = std::get_if<std::string>(method_call.arguments())) {
+            list.emplace_back(HistorySummaryToMap(history_store_->Summarize(*id)));
+        } else {
+            for (const auto& summary : history_store_->SummarizeAll()) {
+                list.emplace_back(HistorySummaryToMap(summary));
+            }
+        }
+        result->Success(flutter::EncodableValue(list));
+    } else if (method == "setPowerPolicy") {
+        auto* args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+        if (args) {
+            auto delay_it = args->find(flutter::EncodableValue("idleDowngradeMs"));
+            if (delay_it != args->end()) {
+                int delayMs = GetIntFromEncodableValue(delay_it->second, 5000);
+                ble_core_->SetIdleDowngradeDelay(std::chrono::milliseconds(std::max(delayMs, 0)));
+            }
+            result->Success();
+        } else {
+            result->Error("INVALID_ARG", "Power policy arguments required");
+        }
+    } else if (method == "getPowerStats") {
+        auto stats = ble_core_->GetPowerStats();
+        flutter::EncodableMap map;
+        map[flutter::EncodableValue("connectedMs")] = flutter::EncodableValue(stats.connected_ms);
+        map[flutter::EncodableValue("activeMs")] = flutter::EncodableValue(stats.active_ms);
+        map[flutter::EncodableValue("idleMs")] = flutter::EncodableValue(stats.idle_ms);
+        map[flutter::EncodableValue("holdingWakeLock")] = flutter::EncodableValue(stats.holding_wake_lock);
+        map[flutter::EncodableValue("powerOptimized")] = flutter::EncodableValue(stats.power_optimized);
+        result->Success(flutter::EncodableValue(map));
+    } else if (method == "setLiveMetrics") {
+        auto* args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+        if (args) {
+            bool enabled = true;
+            bool forwardPackets = true;
+            int intervalMs = 250;
+            auto enabled_it = args->find(flutter::EncodableValue("enabled"));
+            if (enabled_it != args->end()) {
+                if (auto* v = std::get_if<bool>(&enabled_it->second)) enabled = *v;
+            }
+            auto forward_it = args->find(flutter::EncodableValue("forwardPackets"));
+            if (forward_it != args->end()) {
+                if (auto* v = std::get_if<bool>(&forward_it->second)) forwardPackets = *v;
+            }
+            auto interval_it = args->find(flutter::EncodableValue("publishIntervalMs"));
+            if (interval_it != args->end()) intervalMs = GetIntFromEncodableValue(interval_it->second, 250);
+
+            ble_core_->SetLiveMetrics(enabled, std::chrono::milliseconds(std::max(intervalMs, 0)),
+                                      forwardPackets);
+            result->Success();
+        } else {
+            result->Error("INVALID_ARG", "Live metrics arguments required");
+        }
+    } else if (method == "resetLiveMetrics") {
+        ble_core_->ResetLiveMetrics();
+        result->Success();
+    } else if (method == "setLiveJitterBuffer") {
+        auto* args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+        if (args) {
+            bool enabled = true;
+            LiveJitterConfig config;
+            auto enabled_it = args->find(flutter::EncodableValue("enabled"));
+            if (enabled_it != args->end()) {
+                if (auto* v = std::get_if<bool>(&enabled_it->second)) enabled = *v;
+            }
+            auto latency_it = args->find(flutter::EncodableValue("latencyMs"));
+            if (latency_it != args->end()) {
+                config.latency_ms = GetIntFromEncodableValue(latency_it->second, config.latency_ms);
+            }
+            auto conceal_it = args->find(flutter::EncodableValue("maxConcealMs"));
+            if (conceal_it != args->end()) {
+                config.max_conceal_ms = GetIntFromEncodableValue(conceal_it->second, config.max_conceal_ms);
+            }
+            auto interval_it = args->find(flutter::EncodableValue("intervalMs"));
+            if (interval_it != args->end()) {
+                config.interval_ms = GetIntFromEncodableValue(interval_it->second, 0);
+            }
+
+            ble_core_->SetLiveJitterBuffer(enabled, config);
+            result->Success();
+        } else {
+            result->Error("INVALID_ARG", "Jitter buffer arguments required");
+        }
+    } else if (method == "getLiveJitterStats") {
+        auto stats = ble_core_->GetLiveJitterStats();
+        flutter::EncodableMap map;
+        map[flutter::EncodableValue("received")] = flutter::EncodableValue(static_cast<int64_t>(stats.received));
+        map[flutter::EncodableValue("duplicates")] = flutter::EncodableValue(static_cast<int64_t>(stats.duplicates));
+        map[flutter::EncodableValue("reordered")] = flutter::EncodableValue(static_cast<int64_t>(stats.reordered));
+        map[flutter::EncodableValue("late")] = flutter::EncodableValue(static_cast<int64_t>(stats.late));
+        map[flutter::EncodableValue("lost")] = flutter::EncodableValue(static_cast<int64_t>(stats.lost));
+        map[flutter::EncodableValue("concealed")] = flutter::EncodableValue(static_cast<int64_t>(stats.concealed));
+        map[flutter::EncodableValue("underruns")] = flutter::EncodableValue(static_cast<int64_t>(stats.underruns));
+        map[flutter::EncodableValue("jitterMs")] = flutter::EncodableValue(stats.jitter_ms);
+        map[flutter::EncodableValue("meanDelayMs")] = flutter::EncodableValue(stats.mean_delay_ms);
+        map[flutter::EncodableValue("maxDelayMs")] = flutter::EncodableValue(stats.max_delay_ms);
+        map[flutter::EncodableValue("intervalMs")] = flutter::EncodableValue(stats.interval_ms);
+        map[flutter::EncodableValue("buffered")] = flutter::EncodableValue(static_cast<int64_t>(stats.buffered));
+        result->Success(flutter::EncodableValue(map));
+    } else if (method == "setLiveTelemetryExport") {
+        auto* args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+        if (args) {
+            bool enabled = true;
+            std::string name = DefaultLiveTelemetrySegmentName();
+            int podSlots = static_cast<int>(LiveTelemetrySegment::kDefaultPodSlots);
+            int ringRecords = static_cast<int>(LiveTelemetrySegment::kDefaultRingRecords);
+            auto enabled_it = args->find(flutter::EncodableValue("enabled"));
+            if (enabled_it != args->end()) {
+                if (auto* v = std::get_if<bool>(&enabled_it->second)) enabled = *v;
+            }
+            auto name_it = args->find(flutter::EncodableValue("name"));
+            if (name_it != args->end()) {
+                if (auto* v = std::get_if<std::string>(&name_it->second)) name = *v;
+            }
+            auto slots_it = args->find(flutter::EncodableValue("podSlots"));
+            if (slots_it != args->end()) podSlots = GetIntFromEncodableValue(slots_it->second, podSlots);
+            auto records_it = args->find(flutter::EncodableValue("ringRecords"));
+            if (records_it != args->end()) ringRecords = GetIntFromEncodableValue(records_it->second, ringRecords);
+
+            // The old segment goes away (and its name is freed) before a new one is made
+            ble_core_->SetLiveTelemetrySegment(nullptr);
+            live_segment_.reset();
+            auto segment = std::make_shared<LiveTelemetrySegment>();
+            std::string error;
+            if (!enabled) {
+                result->Success();
+            } else if (!segment->Create(name, static_cast<uint32_t>(std::max(podSlots, 1)),
+                                        static_cast<uint32_t>(std::max(ringRecords, 1)), &error)) {
+                result->Error("SHARED_MEMORY_ERROR", error);
+            } else {
+                live_segment_ = segment;
+                ble_core_->SetLiveTelemetrySegment(segment);
+                flutter::EncodableMap map;
+                map[flutter::EncodableValue("name")] = flutter::EncodableValue(segment->name());
+                map[flutter::EncodableValue("bytes")] = flutter::EncodableValue(static_cast<int64_t>(segment->size()));
+                result->Success(flutter::EncodableValue(map));
+            }
+        } else {
+            result->Error("INVALID_ARG", "Live telemetry export arguments required");
+        }
+    } else if (method == "setSessionRecording") {
+        auto* args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+        if (args) {
+            bool enabled = true;
+            std::filesystem::path path;
+            auto enabled_it = args->find(flutter::EncodableValue("enabled"));
+            if (enabled_it != args->end()) {
+                if (auto* v = std::get_if<bool>(&enabled_it->second)) enabled = *v;
+            }
+            auto path_it = args->find(flutter::EncodableValue("path"));
+            if (path_it != args->end()) {
+                if (auto* v = std::get_if<std::string>(&path_it->second)) path = *v;
+            }
+
+            // Stopping (or restarting) writes out the recording in progress
+            ble_core_->SetSessionRecorder(nullptr);
+            auto finished = std::move(session_recorder_);
+            auto finishedPath = session_recording_path_;
+            std::string error;
+            bool saved = !finished || SaveSessionScript(finishedPath, finished->Events(), &error);
+
+            if (!saved) {
+                result->Error("RECORDING_ERROR", error);
+            } else if (enabled) {
+                session_recording_path_ = path.empty() ? DefaultSessionRecordingPath() : path;
+                session_recorder_ = std::make_shared<SessionRecorder>();
+                ble_core_->SetSessionRecorder(session_recorder_);
+                flutter::EncodableMap map;
+                map[flutter::EncodableValue("path")] = flutter::EncodableValue(session_recording_path_.string());
+                result->Success(flutter::EncodableValue(map));
+            } else if (finished) {
+                flutter::EncodableMap map;
+                map[flutter::EncodableValue("path")] = flutter::EncodableValue(finishedPath.string());
+                map[flutter::EncodableValue("events")] = flutter::EncodableValue(static_cast<int64_t>(finished->Size()));
+                result->Success(flutter::EncodableValue(map));
+            } else {
+                result->Success();
+            }
+        } else {
+            result->Error("INVALID_ARG", "Session recording arguments required");
+        }
+    } else if (method == "getDispatcherStats") {
+        auto stats = dispatcher_->Stats();
+        flutter::EncodableMap map;
+        map[flutter::EncodableValue("pending")] = flutter::EncodableValue(static_cast<int64_t>(stats.pending));
+        map[flutter::EncodableValue("highWater")] = flutter::EncodableValue(static_cast<int64_t>(stats.high_water));
+        map[flutter::EncodableValue("capacity")] = flutter::EncodableValue(static_cast<int64_t>(dispatcher_->Capacity()));
+        map[flutter::EncodableValue("dispatched")] = flutter::EncodableValue(static_cast<int64_t>(stats.dispatched));
+        map[flutter::EncodableValue("waited")] = flutter::EncodableValue(static_cast<int64_t>(stats.waited));
+        map[flutter::EncodableValue("rejected")] = flutter::EncodableValue(static_cast<int64_t>(stats.rejected));
+        flutter::EncodableMap channels;
+        for (const auto& c : channels_->Stats()) {
+            flutter::EncodableMap channel;
+            channel[flutter::EncodableValue("policy")] = flutter::EncodableValue(OverflowPolicyName(c.policy));
+            channel[flutter::EncodableValue("capacity")] = flutter::EncodableValue(static_cast<int64_t>(c.capacity));
+            channel[flutter::EncodableValue("memoryBudget")] = flutter::EncodableValue(static_cast<int64_t>(c.memory_budget));
+            channel[flutter::EncodableValue("pending")] = flutter::EncodableValue(static_cast<int64_t>(c.pending));
+            channel[flutter::EncodableValue("highWater")] = flutter::EncodableValue(static_cast<int64_t>(c.high_water));
+            channel[flutter::EncodableValue("accepted")] = flutter::EncodableValue(static_cast<int64_t>(c.accepted));
+            channel[flutter::EncodableValue("delivered")] = flutter::EncodableValue(static_cast<int64_t>(c.delivered));
+            channel[flutter::EncodableValue("dropped")] = flutter::EncodableValue(static_cast<int64_t>(c.dropped));
+            channel[flutter::EncodableValue("coalesced")] = flutter::EncodableValue(static_cast<int64_t>(c.coalesced));
+            channel[flutter::EncodableValue("spilled")] = flutter::EncodableValue(static_cast<int64_t>(c.spilled));
+            channel[flutter::EncodableValue("spillErrors")] = flutter::EncodableValue(static_cast<int64_t>(c.spill_errors));
+            channel[flutter::EncodableValue("memoryBytes")] = flutter::EncodableValue(static_cast<int64_t>(c.memory_bytes));
+            channel[flutter::EncodableValue("spillBytes")] = flutter::EncodableValue(static_cast<int64_t>(c.spill_bytes));
+            channels[flutter::EncodableValue(c.name)] = flutter::EncodableValue(channel);
+        }
+        map[flutter::EncodableValue("channels")] = flutter::EncodableValue(channels);
+        result->Success(flutter::EncodableValue(map));
+    } else if (method == "applyPodSettings") {
+        auto* args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+        if (!args) {
+            result->Error("INVALID_ARG", "Settings arguments required");
+        } else if (auto request = SettingsRequestFromMap(*args); !request.Valid()) {
+            result->Error("INVALID_ARG", SettingsRequestError(request));
+        } else {
+            int timeoutMs = 3000;
+            auto timeout_it = args->find(flutter::EncodableValue("timeoutMs"));
+            if (timeout_it != args->end()) timeoutMs = GetIntFromEncodableValue(timeout_it->second, 3000);
+
+            // Completed from the strand once the pod has answered (or not)
+            std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>> shared_result(std::move(result));
+            ble_core_->ApplySettings(request, std::chrono::milliseconds(std::max(timeoutMs, 0)),
+                                     [this, shared_result, alive = alive_](const SettingsResult& outcome) {
+                if (!alive->load()) return;
+                PostToMainThread([shared_result, outcome, alive]() {
+                    if (!alive->load()) return;
+                    if (outcome.busy) {
+                        shared_result->Error("BUSY", "A file transfer is in progress");
+                        return;
+                    }
+                    shared_result->Success(flutter::EncodableValue(SettingsResultToMap(outcome)));
+                });
+            });
+        }
+    } else if (method == "deletePodFiles") {
+        auto* args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+        if (!args || !args->count(flutter::EncodableValue("filenames"))) {
+            result->Error("INVALID_ARG", "File names required");
+        } else {
+            int timeoutMs = 15000;
+            auto timeout_it = args->find(flutter::EncodableValue("timeoutMs"));
+            if (timeout_it != args->end()) timeoutMs = GetIntFromEncodableValue(timeout_it->second, 15000);
+
+            // Completed from the strand once a listing settles the batch (or not)
+            std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>> shared_result(std::move(result));
+            ble_core_->DeleteFiles(StringListFromMap(*args, "filenames"),
+                                   std::chrono::milliseconds(std::max(timeoutMs, 0)),
+                                   [this, shared_result, alive = alive_](const DeleteResult& outcome) {
+                if (!alive->load()) return;
+                PostToMainThread([shared_result, outcome, alive]() {
+                    if (!alive->load()) return;
+                    if (outcome.busy) {
+                        shared_result->Error("BUSY", "A file transfer is in progress");
+                        return;
+                    }
+                    shared_result->Success(flutter::EncodableValue(DeleteResultToMap(outcome)));
+                });
+            });
+        }
+    } else if (method == "configureFleet") {
+        auto* args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+        const flutter::EncodableList* pods = nullptr;
+        FleetConfigOptions options;
+        if (args) {
+            auto pods_it = args->find(flutter::EncodableValue("pods"));
+            if (pods_it != args->end()) pods = std::get_if<flutter::EncodableList>(&pods_it->second);
+            auto max_it = args->find(flutter::EncodableValue("maxConnections"));
+            if (max_it != args->end()) {
+                options.max_connections = GetIntFromEncodableValue(max_it->second, options.max_connections);
+            }
+            auto timeout_it = args->find(flutter::EncodableValue("timeoutMs"));
+            if (timeout_it != args->end()) {
+                options.apply_timeout = std::chrono::milliseconds(
+                    std::max(GetIntFromEncodableValue(timeout_it->second, 3000), 0));
+            }
+            auto connect_it = args->find(flutter::EncodableValue("connectTimeoutMs"));
+            if (connect_it != args->end()) {
+                options.connect_timeout = std::chrono::milliseconds(
+                    std::max(GetIntFromEncodableValue(connect_it->second, 10000), 0));
+            }
+            auto delete_it = args->find(flutter::EncodableValue("deleteTimeoutMs"));
+            if (delete_it != args->end()) {
+                options.delete_timeout = std::chrono::milliseconds(
+                    std::max(GetIntFromEncodableValue(delete_it->second, 15000), 0));
+            }
+        }
+
+        std::vector<FleetTarget> targets;
+        if (pods) {
+            for (const auto& pod : *pods) {
+                auto* entry = std::get_if<flutter::EncodableMap>(&pod);
+                if (!entry) continue;
+                auto id_it = entry->find(flutter::EncodableValue("id"));
+                auto* id = id_it != entry->end() ? std::get_if<std::string>(&id_it->second) : nullptr;
+                if (id) {
+                    targets.push_back({*id, SettingsRequestFromMap(*entry), StringListFromMap(*entry, "deleteFiles")});
+                }
+            }
+        }
+
+        if (!pods) {
+            result->Error("INVALID_ARG", "Pod list required");
+        } else {
+            // One job at a time; it keeps its own strand so a slow pod never
+            // holds up the main connection
+            if (!fleet_job_) {
+                auto history = history_store_;
+                fleet_job_ = std::make_unique<FleetConfigJob>(
+                    std::make_shared<ThreadScheduler>(),
+                    [history](const std::string& address) -> std::unique_ptr<FleetPodLink> {
+                        return std::make_unique<PodBLECoreFleetLink>(address, history);
+                    });
+            }
+            std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>> shared_result(std::move(result));
+            bool started = fleet_job_->Start(std::move(targets), options,
+                                             [this, shared_result, alive = alive_](const FleetReport& report) {
+                if (!alive->load()) return;
+                PostToMainThread([shared_result, report, alive]() {
+                    if (!alive->load()) return;
+                    shared_result->Success(flutter::EncodableValue(FleetReportToMap(report)));
+                });
+            });
+            if (!started) shared_result->Error("BUSY", "A fleet configuration is already running");
+        }
+    } else if (method == "cancelFleetConfig") {
+        if (fleet_job_) fleet_job_->Cancel();
+        result->Success();
+    } else if (method == "getCommandStats") {
+        flutter::EncodableMap map;
+        for (const auto& [opcode, stats] : ble_core_->GetCommandStats()) {
+            flutter::EncodableMap command;
+            command[flutter::EncodableValue("sent")] = flutter::EncodableValue(static_cast<int64_t>(stats.sent));
+            command[flutter::EncodableValue("answered")] = flutter::EncodableValue(static_cast<int64_t>(stats.answered));
+            command[flutter::EncodableValue("timeouts")] = flutter::EncodableValue(static_cast<int64_t>(stats.timeouts));
+            command[flutter::EncodableValue("mismatches")] = flutter::EncodableValue(static_cast<int64_t>(stats.mismatches));
+            command[flutter::EncodableValue("lastMs")] = flutter::EncodableValue(stats.last_ms);
+            command[flutter::EncodableValue("meanMs")] = flutter::EncodableValue(stats.mean_ms);
+            command[flutter::EncodableValue("maxMs")] = flutter::EncodableValue(stats.max_ms);
+            map[flutter::EncodableValue(OpcodeName(opcode))] = flutter::EncodableValue(command);
+        }
+        result->Success(flutter::EncodableValue(map));
     } else if (method == "requestBatteryExemption") {
         // No-op on Windows
         result->Success();
@@ -6,8 +6,12 @@
 #include <flutter/standard_method_codec.h>
 #include <flutter/encodable_value.h>
 
+#include "callback_dispatcher.h"
+#include "channel_queues.h"
+#include "fleet_config.h"
 #include "pod_ble_core.h"
 
+#include <filesystem>
 #include <functional>
 #include <list>
 #include <memory>
@@ -22,8 +26,10 @@ public:
     static void RegisterWithRegistrar(flutter::PluginRegistrarWindows* registrar,
                                       FlutterDesktopPluginRegistrarRef raw_registrar);
 
+    /// [dispatcher] must drain on the platform thread.
     PodConnectorPlugin(flutter::PluginRegistrarWindows* registrar,
-                       FlutterDesktopPluginRegistrarRef raw_registrar);
+                       FlutterDesktopPluginRegistrarRef raw_registrar,
+                       std::unique_ptr<CallbackDispatcher> dispatcher);
     virtual ~PodConnectorPlugin();
 
     // Disallow copy and assign
@@ -35,10 +41,24 @@ private:
         const flutter::MethodCall<flutter::EncodableValue>& method_call,
         std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
+    // Replies to a method call when an awaitable core operation finishes.
+    void CompleteWhenDone(
+        winrt::Windows::Foundation::IAsyncOperation<bool> operation,
+        std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
     std::unique_ptr<PodBLECore> ble_core_;
+    std::shared_ptr<PodHistoryStore> history_store_;
+    std::shared_ptr<LiveTelemetrySegment> live_segment_;     // Set while the live export is on
+    std::shared_ptr<SessionRecorder> session_recorder_;      // Set while a session is being recorded
+    std::filesystem::path session_recording_path_;
+    std::unique_ptr<FleetConfigJob> fleet_job_;              // Created by the first configureFleet
 
     // Lifetime guard: checked by BLE callbacks before using sinks
     std::shared_ptr<std::atomic<bool>> alive_ = std::make_shared<std::atomic<bool>>(true);
+    // Held by the destructor while clearing alive_, and by WinRT completion
+    // handlers from their alive_ check until their reply is queued, so
+    // channels_ cannot be freed in between.
+    std::shared_ptr<std::mutex> teardown_mtx_ = std::make_shared<std::mutex>();
 
     // Event sinks
     std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> status_sink_;
@@ -46,20 +66,32 @@ private:
     std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> payload_sink_;
 
     // Platform thread dispatch: BLE callbacks fire on WinRT background threads,
-    // but Flutter requires EventSink calls on the platform (UI) thread.
-    HWND window_handle_ = nullptr;
-    int proc_delegate_id_ = -1;
-    flutter::PluginRegistrarWindows* registrar_ = nullptr;
-    static constexpr UINT kCallbackMessage = WM_APP + 0x504F; // "PO" for Pod
-
-    // Mutex-protected callback queue (swap-under-lock pattern).
-    // Eliminates heap-allocated std::function* passed via WPARAM.
-    std::mutex callback_mutex_;
-    std::list<std::function<void()>> queued_callbacks_;
-
+    // but Flutter requires EventSink calls on the platform (UI) thread. A
+    // message-only window owned by the platform thread works with any number
+    // of views (or none). There is no fallback: without the window the
+    // plugin does not register.
+    std::unique_ptr<CallbackDispatcher> dispatcher_;
+
+    // Completes a method call on the platform thread. Replies are never
+    // dropped: they wait on the unbounded reply channel.
     void PostToMainThread(std::function<void()> callback);
-    std::optional<LRESULT> HandleWindowMessage(
-        HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam);
+
+    // Event channel traffic is queued per channel in front of the dispatcher,
+    // so a stalled platform thread never blocks the BLE threads: live
+    // telemetry and scan results drop their oldest entries, progress statuses
+    // coalesce, and payloads spill to a temp file past the memory budget.
+    // Method replies are kept however many are pending.
+    std::unique_ptr<ChannelQueues> channels_;
+    size_t live_channel_ = 0;
+    size_t scan_channel_ = 0;
+    size_t status_channel_ = 0;
+    size_t payload_channel_ = 0;
+    size_t reply_channel_ = 0;
+
+    static constexpr size_t kLiveQueueCapacity = 512;
+    static constexpr size_t kScanQueueCapacity = 256;
+    static constexpr size_t kStatusQueueCapacity = 64;
+    static constexpr size_t kPayloadMemoryBudget = 32 * 1024 * 1024;
 };
 
 // Stream handler template
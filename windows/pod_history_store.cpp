@@ -0,0 +1,282 @@
+#include "pod_history_store.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace pod_connector {
+
+namespace {
+// Line format (comma separated, one record per line):
+//   v1,timestamp_ms,address,kind,mtu,connect_latency_ms,bytes_per_sec,
+//   packet_loss_pct,retries,watchdog_triggers
+constexpr const char* kLineVersion = "v1";
+constexpr size_t kFieldCount = 10;
+}  // namespace
+
+PodHistoryStore::PodHistoryStore(std::filesystem::path path) : path_(std::move(path)) {}
+
+std::filesystem::path PodHistoryStore::DefaultPath() {
+    std::filesystem::path base;
+    if (const char* local = std::getenv("LOCALAPPDATA")) {
+        base = local;
+    } else {
+        base = std::filesystem::temp_directory_path();
+    }
+    return base / "metric_athlete_pod_ble" / "pod_history.log";
+}
+
+void PodHistoryStore::Open() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (opened_) return;
+    opened_ = true;
+
+    try {
+        std::filesystem::create_directories(path_.parent_path());
+    } catch (...) {
+        // Directory creation failure surfaces as a failed append later — history is best-effort
+    }
+
+    LoadLocked();
+    if (NeedsCompactLocked()) CompactLocked();
+}
+
+void PodHistoryStore::Append(const PodHistoryRecord& record) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (record.address.empty()) return;
+
+    by_address_[record.address].push_back(record);
+
+    try {
+        std::ofstream out(path_, std::ios::app | std::ios::binary);
+        out << Serialize(record) << '\n';
+    } catch (...) {
+        // History is diagnostic only — never let a disk error reach the BLE path
+    }
+
+    ++line_count_;
+    if (NeedsCompactLocked()) CompactLocked();
+}
+
+PodHistorySummary PodHistoryStore::Summarize(const std::string& address) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = by_address_.find(address);
+    if (it == by_address_.end()) {
+        PodHistorySummary empty;
+        empty.address = address;
+        return empty;
+    }
+    return SummarizeLocked(address, it->second);
+}
+
+std::vector<PodHistorySummary> PodHistoryStore::SummarizeAll() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::vector<PodHistorySummary> result;
+    result.reserve(by_address_.size());
+    for (const auto& [address, records] : by_address_) {
+        result.push_back(SummarizeLocked(address, records));
+    }
+    std::sort(result.begin(), result.end(),
+        [](const auto& a, const auto& b) { return a.address < b.address; });
+    return result;
+}
+
+std::vector<PodHistoryRecord> PodHistoryStore::Records(const std::string& address, size_t limit) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = by_address_.find(address);
+    if (it == by_address_.end()) return {};
+    const auto& records = it->second;
+    size_t first = records.size() > limit ? records.size() - limit : 0;
+    return std::vector<PodHistoryRecord>(records.begin() + first, records.end());
+}
+
+void PodHistoryStore::Compact() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    CompactLocked();
+}
+
+// MARK: - Persistence
+
+void PodHistoryStore::LoadLocked() {
+    by_address_.clear();
+    line_count_ = 0;
+
+    std::ifstream in(path_, std::ios::binary);
+    if (!in) return;
+
+    std::string line;
+    PodHistoryRecord record;
+    while (std::getline(in, line)) {
+        ++line_count_;
+        if (Parse(line, record)) {
+            by_address_[record.address].push_back(record);
+        }
+    }
+
+    // Appends from concurrent processes can interleave slightly out of order
+    for (auto& [address, records] : by_address_) {
+        std::stable_sort(records.begin(), records.end(),
+            [](const auto& a, const auto& b) { return a.timestamp_ms < b.timestamp_ms; });
+    }
+}
+
+bool PodHistoryStore::NeedsCompactLocked() const {
+    return line_count_ > std::max(kCompactThreshold, 2 * compacted_lines_);
+}
+
+void PodHistoryStore::CompactLocked() {
+    const int64_t cutoff = NowMs() - kRetentionMs;
+    // Even a failed rewrite waits for the log to double before the next try
+    compacted_lines_ = line_count_;
+
+    size_t kept = 0;
+    for (auto it = by_address_.begin(); it != by_address_.end();) {
+        auto& records = it->second;
+        records.erase(std::remove_if(records.begin(), records.end(),
+            [cutoff](const auto& r) { return r.timestamp_ms < cutoff; }), records.end());
+        if (records.empty()) {
+            it = by_address_.erase(it);
+        } else {
+            kept += records.size();
+            ++it;
+        }
+    }
+
+    // Write-then-rename so a crash mid-compaction leaves the old log intact
+    auto tmp = path_;
+    tmp += ".tmp";
+    try {
+        {
+            std::ofstream out(tmp, std::ios::trunc | std::ios::binary);
+            if (!out) return;
+            for (const auto& [address, records] : by_address_) {
+                for (const auto& r : records) out << Serialize(r) << '\n';
+            }
+        }
+        std::filesystem::rename(tmp, path_);
+        line_count_ = kept;
+        compacted_lines_ = kept;
+    } catch (...) {
+        std::error_code ec;
+        std::filesystem::remove(tmp, ec);
+    }
+}
+
+std::string PodHistoryStore::Serialize(const PodHistoryRecord& r) {
+    std::ostringstream ss;
+    ss << kLineVersion << ','
+       << r.timestamp_ms << ','
+       << r.address << ','
+       << static_cast<int>(r.kind) << ','
+       << r.mtu << ','
+       << r.connect_latency_ms << ','
+       << r.bytes_per_sec << ','
+       << r.packet_loss_pct << ','
+       << r.retries << ','
+       << r.watchdog_triggers;
+    return ss.str();
+}
+
+bool PodHistoryStore::Parse(const std::string& line, PodHistoryRecord& out) {
+    std::vector<std::string> fields;
+    fields.reserve(kFieldCount);
+    std::istringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, ',')) fields.push_back(field);
+
+    // Torn or foreign lines are skipped (and dropped at the next compaction)
+    if (fields.size() != kFieldCount || fields[0] != kLineVersion) return false;
+
+    try {
+        out.timestamp_ms = std::stoll(fields[1]);
+        out.address = fields[2];
+        int kind = std::stoi(fields[3]);
+        if (kind != 0 && kind != 1) return false;
+        out.kind = static_cast<PodHistoryRecord::Kind>(kind);
+        out.mtu = std::stoi(fields[4]);
+        out.connect_latency_ms = std::stoll(fields[5]);
+        out.bytes_per_sec = std::stod(fields[6]);
+        out.packet_loss_pct = std::stod(fields[7]);
+        out.retries = std::stoi(fields[8]);
+        out.watchdog_triggers = std::stoi(fields[9]);
+    } catch (...) {
+        return false;
+    }
+    return !out.address.empty();
+}
+
+// MARK: - Aggregation
+
+PodHistorySummary PodHistoryStore::SummarizeLocked(
+    const std::string& address, const std::vector<PodHistoryRecord>& records) const {
+    PodHistorySummary s;
+    s.address = address;
+    if (records.empty()) return s;
+
+    std::vector<double> latencies;
+    std::vector<double> throughput;
+    std::vector<double> loss;
+
+    for (const auto& r : records) {
+        if (r.mtu > 0) s.last_mtu = r.mtu;
+        if (r.kind == PodHistoryRecord::Kind::kConnect) {
+            s.connect_count++;
+            latencies.push_back(static_cast<double>(r.connect_latency_ms));
+        } else {
+            s.download_count++;
+            throughput.push_back(r.bytes_per_sec);
+            loss.push_back(r.packet_loss_pct);
+            s.total_retries += r.retries;
+            s.total_watchdog_triggers += r.watchdog_triggers;
+        }
+    }
+
+    s.first_seen_ms = records.front().timestamp_ms;
+    s.last_seen_ms = records.back().timestamp_ms;
+    s.connect_latency_p50_ms = Percentile(latencies, 0.5);
+    s.connect_latency_p90_ms = Percentile(latencies, 0.9);
+    s.throughput_p10_bps = Percentile(throughput, 0.1);
+    s.throughput_p50_bps = Percentile(throughput, 0.5);
+    s.throughput_p90_bps = Percentile(throughput, 0.9);
+    s.packet_loss_p50_pct = Percentile(loss, 0.5);
+    s.packet_loss_p90_pct = Percentile(loss, 0.9);
+
+    // Degradation: compare the last kRecentWindow downloads against the
+    // baseline built from everything before them. Needs enough baseline
+    // history to be meaningful, otherwise a new pod would always look "bad".
+    if (throughput.size() >= kRecentWindow * 2) {
+        auto split = throughput.size() - kRecentWindow;
+        std::vector<double> baseTp(throughput.begin(), throughput.begin() + split);
+        std::vector<double> recentTp(throughput.begin() + split, throughput.end());
+        std::vector<double> baseLoss(loss.begin(), loss.begin() + split);
+        std::vector<double> recentLoss(loss.begin() + split, loss.end());
+
+        double baseTpMedian = Percentile(baseTp, 0.5);
+        double recentTpMedian = Percentile(recentTp, 0.5);
+        double baseLossP90 = Percentile(baseLoss, 0.9);
+        double recentLossMedian = Percentile(recentLoss, 0.5);
+
+        bool throughputDrop = baseTpMedian > 0 && recentTpMedian < baseTpMedian * 0.7;
+        bool lossIncrease = recentLossMedian > std::max(baseLossP90, 1.0);
+        s.degrading = throughputDrop || lossIncrease;
+    }
+
+    return s;
+}
+
+double PodHistoryStore::Percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    size_t idx = static_cast<size_t>(p * static_cast<double>(values.size() - 1) + 0.5);
+    idx = std::min(idx, values.size() - 1);
+    std::nth_element(values.begin(), values.begin() + idx, values.end());
+    return values[idx];
+}
+
+int64_t PodHistoryStore::NowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace pod_connector
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pod_connector {
+
+/// One connect or download outcome for a single pod.
+struct PodHistoryRecord {
+    enum class Kind : uint8_t { kConnect = 0, kDownload = 1 };
+
+    int64_t timestamp_ms = 0;       // Wall-clock time the operation finished (epoch ms)
+    std::string address;            // "aa:bb:cc:dd:ee:ff"
+    Kind kind = Kind::kConnect;
+    int mtu = 0;                    // Negotiated PDU size (0 = unknown)
+    int64_t connect_latency_ms = 0; // Connect: request → "Connected"
+    double bytes_per_sec = 0.0;     // Download: payload bytes / transfer time
+    double packet_loss_pct = 0.0;   // Download: 100 × (expected − received) / expected
+    int retries = 0;                // Download: re-requests of the same file
+    int watchdog_triggers = 0;      // Download: watchdog forced completion
+};
+
+/// Aggregated view of a pod's history, returned by PodHistoryStore::Summarize.
+struct PodHistorySummary {
+    std::string address;
+    int connect_count = 0;
+    int download_count = 0;
+    int last_mtu = 0;
+    double connect_latency_p50_ms = 0.0;
+    double connect_latency_p90_ms = 0.0;
+    double throughput_p10_bps = 0.0;
+    double throughput_p50_bps = 0.0;
+    double throughput_p90_bps = 0.0;
+    double packet_loss_p50_pct = 0.0;
+    double packet_loss_p90_pct = 0.0;
+    int total_retries = 0;
+    int total_watchdog_triggers = 0;
+    int64_t first_seen_ms = 0;
+    int64_t last_seen_ms = 0;
+
+    /// True when the most recent downloads are markedly worse than the pod's
+    /// own long-term baseline (throughput drop or loss increase).
+    bool degrading = false;
+};
+
+/// Persistent per-pod performance history.
+///
+/// Records are appended as single text lines to an append-only log so a crash
+/// can lose at most the line being written. The whole log is indexed in memory
+/// per address on Open(), which keeps aggregate queries independent of disk
+/// I/O. When the log grows past kCompactThreshold lines, and to twice what
+/// the last compaction kept, it is rewritten (temp file + rename) dropping
+/// torn lines and records older than the retention window. The doubling keeps
+/// a large retained history from being rewritten on every append.
+///
+/// Thread-safe: all public methods take the internal mutex.
+class PodHistoryStore {
+public:
+    static constexpr size_t kCompactThreshold = 50000;
+    static constexpr int64_t kRetentionMs = 400LL * 24 * 60 * 60 * 1000; // ~13 months
+
+    /// Recent-window size used for the degradation check.
+    static constexpr size_t kRecentWindow = 10;
+
+    explicit PodHistoryStore(std::filesystem::path path);
+
+    /// Default location: %LOCALAPPDATA%\metric_athlete_pod_ble\pod_history.log
+    static std::filesystem::path DefaultPath();
+
+    /// Loads the log into memory, compacting first if it has grown too large.
+    /// Safe to call more than once; later calls are no-ops.
+    void Open();
+
+    void Append(const PodHistoryRecord& record);
+
+    PodHistorySummary Summarize(const std::string& address);
+    std::vector<PodHistorySummary> SummarizeAll();
+
+    /// Raw records for one pod, oldest first, limited to the last [limit] entries.
+    std::vector<PodHistoryRecord> Records(const std::string& address, size_t limit);
+
+    /// Forces a compaction pass regardless of log size.
+    void Compact();
+
+private:
+    std::filesystem::path path_;
+    std::mutex mtx_;
+    bool opened_ = false;
+    size_t line_count_ = 0;
+    size_t compacted_lines_ = 0;    // Lines the last compaction left behind
+
+    // Per-address index, each vector kept in append (time) order
+    std::unordered_map<std::string, std::vector<PodHistoryRecord>> by_address_;
+
+    void LoadLocked();
+    void CompactLocked();
+    bool NeedsCompactLocked() const;
+    PodHistorySummary SummarizeLocked(const std::string& address,
+                                      const std::vector<PodHistoryRecord>& records) const;
+
+    static std::string Serialize(const PodHistoryRecord& record);
+    static bool Parse(const std::string& line, PodHistoryRecord& out);
+    static double Percentile(std::vector<double> values, double p);
+    static int64_t NowMs();
+};
+
+} // namespace pod_connector
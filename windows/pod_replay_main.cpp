@@ -0,0 +1,147 @@
+// Deterministic session replay: runs PodBLECore on a virtual clock against a
+// recorded session or a simulated pod (see session_replay.h).
+//
+//   pod_ble_replay <session.txt> [options]      replays a recording
+//   pod_ble_replay --synthetic [options]        syncs files from a ScriptedPod
+//
+//   --files N          synthetic: number of files (default 8)
+//   --window N         synthetic: batch window (default 2)
+//   --loss PCT         synthetic: percentage of blocks the pod drops
+//   --seed N           synthetic: seed for file contents and loss
+//   --simulate-pod     recording: answer writes with a ScriptedPod instead
+//                      of the recorded notifications
+//   --ack-ms N         acknowledge each batch file N ms after delivery
+//   --runs N           replay N times and fail unless every trace is identical
+//   --trace <path>     write the output trace
+//   --expect <path>    fail unless the outputs match this trace or recording
+//
+// A recording replayed on its own is also checked against the outputs it
+// recorded. Exits non-zero on any mismatch. Build with -DPOD_BLE_BUILD_REPLAY=ON.
+
+#include "session_replay.h"
+#include "session_script.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace pod_connector;
+
+namespace {
+
+int Usage() {
+    std::fprintf(stderr,
+                 "usage: pod_ble_replay (<session.txt> | --synthetic) [--files N] [--window N]\n"
+                 "                      [--loss PCT] [--seed N] [--simulate-pod] [--ack-ms N]\n"
+                 "                      [--runs N] [--trace <path>] [--expect <path>]\n");
+    return 2;
+}
+
+bool CheckOutputs(const char* label, const std::vector<SessionEvent>& expected,
+                  const std::vector<SessionEvent>& actual) {
+    int64_t mismatch = FirstOutputMismatch(expected, actual);
+    if (mismatch < 0) {
+        std::printf("outputs match %s\n", label);
+        return true;
+    }
+    std::fprintf(stderr, "outputs differ from %s at output %lld\n", label,
+                 static_cast<long long>(mismatch));
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string scriptPath, tracePath, expectPath;
+    bool synthetic = false;
+    int files = 8;
+    int window = 2;
+    int runs = 1;
+    ReplayOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* value = nullptr;
+        if (arg == "--synthetic") {
+            synthetic = true;
+        } else if (arg == "--simulate-pod") {
+            options.simulate_pod = true;
+        } else if (arg == "--files" && (value = next())) {
+            files = std::atoi(value);
+        } else if (arg == "--window" && (value = next())) {
+            window = std::atoi(value);
+        } else if (arg == "--loss" && (value = next())) {
+            options.pod.loss = std::atof(value) / 100.0;
+        } else if (arg == "--seed" && (value = next())) {
+            options.pod.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (arg == "--ack-ms" && (value = next())) {
+            options.auto_ack_delay = std::chrono::milliseconds(std::atoi(value));
+        } else if (arg == "--runs" && (value = next())) {
+            runs = std::max(std::atoi(value), 1);
+        } else if (arg == "--trace" && (value = next())) {
+            tracePath = value;
+        } else if (arg == "--expect" && (value = next())) {
+            expectPath = value;
+        } else if (!arg.empty() && arg[0] != '-' && scriptPath.empty()) {
+            scriptPath = arg;
+        } else {
+            return Usage();
+        }
+    }
+    if (synthetic == !scriptPath.empty()) return Usage();
+
+    std::vector<SessionEvent> script;
+    std::string error;
+    if (synthetic) {
+        std::vector<std::string> names;
+        for (int i = 1; i <= std::max(files, 1); i++) names.push_back("LOG" + std::to_string(1000 + i) + ".BIN");
+        script = SyntheticSyncScript(names, window);
+        options.simulate_pod = true;
+        if (options.auto_ack_delay.count() < 0) options.auto_ack_delay = std::chrono::milliseconds(30);
+    } else {
+        auto loaded = LoadSessionScript(scriptPath, &error);
+        if (!loaded) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        script = std::move(*loaded);
+    }
+
+    bool ok = true;
+    ReplayResult first;
+    for (int run = 0; run < runs; run++) {
+        ReplayResult result = RunSessionReplay(script, options);
+        std::printf("run %d: %zu outputs, %llu tasks, %.1f s virtual in %.1f ms (%.0fx), digest %016llx\n",
+                    run + 1, result.trace.size(), static_cast<unsigned long long>(result.tasks),
+                    static_cast<double>(result.virtual_ms) / 1000.0, result.wall_ms,
+                    result.wall_ms > 0 ? static_cast<double>(result.virtual_ms) / result.wall_ms : 0.0,
+                    static_cast<unsigned long long>(result.digest));
+        if (run == 0) {
+            first = std::move(result);
+        } else if (result.digest != first.digest) {
+            std::fprintf(stderr, "run %d diverged from run 1 at output %lld\n", run + 1,
+                         static_cast<long long>(FirstOutputMismatch(first.trace, result.trace)));
+            ok = false;
+        }
+    }
+
+    if (!synthetic && !options.simulate_pod && expectPath.empty()) {
+        ok = CheckOutputs("the recording", script, first.trace) && ok;
+    }
+    if (!expectPath.empty()) {
+        auto expected = LoadSessionScript(expectPath, &error);
+        if (!expected) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        ok = CheckOutputs(expectPath.c_str(), *expected, first.trace) && ok;
+    }
+    if (!tracePath.empty() && !SaveSessionScript(tracePath, first.trace, &error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+#include "power_policy.h"
+
+namespace pod_connector {
+
+std::mutex PowerPolicy::mtx_;
+int PowerPolicy::ref_count_ = 0;
+HANDLE PowerPolicy::request_ = nullptr;
+
+void PowerPolicy::Acquire() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (ref_count_++ > 0) return;
+
+    if (request_ == nullptr) {
+        REASON_CONTEXT reason = {};
+        reason.Version = POWER_REQUEST_CONTEXT_VERSION;
+        reason.Flags = POWER_REQUEST_CONTEXT_SIMPLE_STRING;
+        reason.Reason.SimpleReasonString = const_cast<LPWSTR>(L"Downloading pod session data over Bluetooth");
+        request_ = PowerCreateRequest(&reason);
+        if (request_ == INVALID_HANDLE_VALUE) request_ = nullptr;
+    }
+
+    // No SetThreadExecutionState fallback: it is per thread, and Acquire and
+    // Release run on whichever thread is current, so a release elsewhere
+    // would leave the system pinned awake. Without a request the download
+    // just runs without the wake lock; the next Acquire tries again.
+    if (request_ != nullptr) PowerSetRequest(request_, PowerRequestSystemRequired);
+}
+
+void PowerPolicy::Release() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (ref_count_ == 0) return;
+    if (--ref_count_ > 0) return;
+
+    if (request_ != nullptr) {
+        PowerClearRequest(request_, PowerRequestSystemRequired);
+    }
+}
+
+int PowerPolicy::ActiveCount() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return ref_count_;
+}
+
+void PowerHold::Hold() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (held_) return;
+    held_ = true;
+    PowerPolicy::Acquire();
+}
+
+void PowerHold::Drop() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!held_) return;
+    held_ = false;
+    PowerPolicy::Release();
+}
+
+bool PowerHold::IsHeld() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return held_;
+}
+
+} // namespace pod_connector
@@ -0,0 +1,53 @@
+#pragma once
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+
+#include <mutex>
+
+namespace pod_connector {
+
+/// Process-wide, reference-counted "keep the system awake" request.
+///
+/// Each active download acquires one reference; the system is allowed to
+/// sleep again only when the last concurrent download releases. Uses a
+/// PowerCreateRequest handle (process scoped) rather than
+/// SetThreadExecutionState, whose state is tied to the calling thread and is
+/// silently dropped when a WinRT thread-pool thread finishes. Where power
+/// requests are unavailable the system is not kept awake at all.
+class PowerPolicy {
+public:
+    static void Acquire();
+    static void Release();
+
+    /// Number of outstanding references (for diagnostics).
+    static int ActiveCount();
+
+private:
+    static std::mutex mtx_;
+    static int ref_count_;
+    static HANDLE request_;
+};
+
+/// Per-owner guard around PowerPolicy. Idempotent: Hold() and Drop() may be
+/// called repeatedly and only the first transition touches the global count.
+class PowerHold {
+public:
+    PowerHold() = default;
+    ~PowerHold() { Drop(); }
+
+    PowerHold(const PowerHold&) = delete;
+    PowerHold& operator=(const PowerHold&) = delete;
+
+    void Hold();
+    void Drop();
+    bool IsHeld() const;
+
+private:
+    mutable std::mutex mtx_;
+    bool held_ = false;
+};
+
+} // namespace pod_connector
@@ -0,0 +1,218 @@
+#include "scripted_pod.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pod_connector {
+
+namespace {
+
+constexpr uint8_t kFileMessageType = 0x03;
+
+uint32_t HashName(const std::string& name, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+uint32_t XorShift(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+void PutU32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<uint8_t>(v >> (i * 8)));
+}
+
+// [0xAE][opcode][0x20][32-byte NUL-padded filename]
+std::string FilenameOf(const std::vector<uint8_t>& framed) {
+    size_t len = std::min<size_t>(framed.size() - 3, 32);
+    std::string filename(reinterpret_cast<const char*>(framed.data() + 3), len);
+    filename.erase(std::find(filename.begin(), filename.end(), '\0'), filename.end());
+    return filename;
+}
+
+} // namespace
+
+ScriptedPod::ScriptedPod(std::shared_ptr<CoreScheduler> scheduler, ScriptedPodConfig config,
+                         NotifyCallback notify)
+    : scheduler_(std::move(scheduler)), config_(config), notify_(std::move(notify)),
+      rng_(config.seed ? config.seed : 1) {
+    config_.block_size = std::max(config_.block_size, 20);
+    config_.record_size = std::max(config_.record_size, 12);
+    settings_ = {config_.player_number, config_.log_interval_ms};
+    files_ = config_.files;
+}
+
+void ScriptedPod::OnWrite(const std::vector<uint8_t>& framed) {
+    if (framed.size() < 2 || framed[0] != 0xAE) return;
+    const uint8_t command = framed[1];
+
+    if (command == 0x06 && framed.size() >= 4) {
+        StartTransfer(FilenameOf(framed));
+    } else if (command == 0x07 && framed.size() >= 4) {
+        // Erased one after another; whatever comes next waits its turn
+        auto now = scheduler_->Now();
+        erased_at_ = std::max(erased_at_, now) + config_.delete_latency;
+        scheduler_->After(erased_at_ - now, [this, filename = FilenameOf(framed)] {
+            files_.erase(std::remove(files_.begin(), files_.end(), filename), files_.end());
+        });
+    } else if (command == 0x05) {
+        auto now = scheduler_->Now();
+        scheduler_->After(std::max(erased_at_, now) - now + config_.reply_latency, [this] { SendCatalog(); });
+    } else if (command == 0x08) {
+        transfer_++;
+        if (sending_) {
+            sending_ = false;
+            ready_at_ = scheduler_->Now() + config_.ready_latency;
+        }
+    } else if (command == 0x09) {
+        // Probes are ignored until the firmware has closed the last file
+        if (sending_ || scheduler_->Now() < ready_at_) return;
+        scheduler_->After(config_.reply_latency, [this] {
+            // Single-block settings message, reporting the values at send time
+            std::vector<uint8_t> reply{static_cast<uint8_t>(PodReplyType::kSettings)};
+            PutU32(reply, 0);
+            PutU32(reply, 1);
+            auto data = EncodeSettingsPayload(settings_);
+            reply.insert(reply.end(), data.begin() + 1, data.end());
+            notify_(reply);
+        });
+    } else if ((command == 0x0A && framed.size() >= 4) || (command == 0x0B && framed.size() >= 5)) {
+        // Committed to flash after apply_latency; probes before then see the old value
+        int value = command == 0x0A ? framed[3] : framed[3] | (framed[4] << 8);
+        scheduler_->After(config_.apply_latency, [this, command, value] {
+            if (command == 0x0A) {
+                if (pod_command::IsValidPlayerNumber(value)) settings_.player_number = value;
+            } else if (pod_command::IsValidLogInterval(value)) {
+                settings_.log_interval_ms = value;
+            }
+        });
+    }
+}
+
+void ScriptedPod::StartTransfer(const std::string& filename) {
+    uint64_t transfer = ++transfer_;
+    file_ = FileContents(filename);
+    sending_ = true;
+    files_started_++;
+
+    auto now = scheduler_->Now();
+    auto delay = std::max(ready_at_, now) - now + config_.first_block_latency;
+    scheduler_->After(delay, [this, transfer] { SendBlock(transfer, 0); });
+}
+
+// The listing as it stands when sent, in sequenced 0x02 blocks
+void ScriptedPod::SendCatalog() {
+    std::vector<PodFileEntry> entries;
+    for (const auto& name : files_) {
+        entries.push_back({name, static_cast<uint32_t>(FileContents(name).size())});
+    }
+    auto data = EncodeFileCatalog(entries);
+
+    const size_t firstData = static_cast<size_t>(config_.block_size - 9);
+    const size_t blockData = static_cast<size_t>(config_.block_size - 5);
+    const int total = BlockCount(data.size());
+    size_t offset = 0;
+    for (int block = 0; block < total; block++) {
+        std::vector<uint8_t> packet{static_cast<uint8_t>(PodReplyType::kFileList)};
+        PutU32(packet, static_cast<uint32_t>(block));
+        if (block == 0) PutU32(packet, static_cast<uint32_t>(total));
+        size_t len = std::min(block == 0 ? firstData : blockData, data.size() - offset);
+        packet.insert(packet.end(), data.begin() + offset, data.begin() + offset + len);
+        offset += len;
+        notify_(packet);
+    }
+}
+
+void ScriptedPod::SendBlock(uint64_t transfer, int block) {
+    if (transfer != transfer_ || !sending_) return;
+
+    const size_t firstData = static_cast<size_t>(config_.block_size - 9);
+    const size_t blockData = static_cast<size_t>(config_.block_size - 5);
+    const int total = BlockCount(file_.size());
+
+    std::vector<uint8_t> packet;
+    packet.reserve(static_cast<size_t>(config_.block_size));
+    packet.push_back(kFileMessageType);
+    PutU32(packet, static_cast<uint32_t>(block));
+    size_t offset, len;
+    if (block == 0) {
+        PutU32(packet, static_cast<uint32_t>(total));
+        offset = 0;
+        len = std::min(firstData, file_.size());
+    } else {
+        offset = firstData + static_cast<size_t>(block - 1) * blockData;
+        len = std::min(blockData, file_.size() - offset);
+    }
+    packet.insert(packet.end(), file_.begin() + offset, file_.begin() + offset + len);
+
+    if (DropNext()) {
+        blocks_dropped_++;
+    } else {
+        blocks_sent_++;
+        notify_(packet);
+    }
+
+    if (block + 1 < total) {
+        scheduler_->After(config_.block_interval, [this, transfer, block] { SendBlock(transfer, block + 1); });
+    } else {
+        sending_ = false;
+        ready_at_ = scheduler_->Now() + config_.ready_latency;
+    }
+}
+
+bool ScriptedPod::DropNext() {
+    if (config_.loss <= 0.0) return false;
+    return static_cast<double>(XorShift(rng_)) / 4294967296.0 < config_.loss;
+}
+
+int ScriptedPod::BlockCount(size_t bytes) const {
+    const size_t firstData = static_cast<size_t>(config_.block_size - 9);
+    const size_t blockData = static_cast<size_t>(config_.block_size - 5);
+    if (bytes <= firstData) return 1;
+    return 1 + static_cast<int>((bytes - firstData + blockData - 1) / blockData);
+}
+
+std::vector<uint8_t> ScriptedPod::FileContents(const std::string& filename) const {
+    uint32_t state = HashName(filename, config_.seed) | 1;
+    const int spread = std::max(config_.records_spread, 0);
+    const int records = std::max(config_.records_per_file, 2) +
+                        static_cast<int>(XorShift(state) % static_cast<uint32_t>(spread + 1));
+    const int size = config_.record_size;
+    const uint8_t day = static_cast<uint8_t>(1 + XorShift(state) % 28);
+
+    std::vector<uint8_t> file(static_cast<size_t>(records) * static_cast<size_t>(size));
+    for (int i = 0; i < records; i++) {
+        uint8_t* record = file.data() + static_cast<size_t>(i) * static_cast<size_t>(size);
+        // [tick u32][year u16][month][day][hour][minute][second], 10 Hz
+        uint32_t tick = static_cast<uint32_t>(i) * 100;
+        uint32_t seconds = 8 * 3600 + tick / 1000;
+        std::memcpy(record, &tick, 4);
+        record[4] = static_cast<uint8_t>(2024 & 0xFF);
+        record[5] = static_cast<uint8_t>(2024 >> 8);
+        record[6] = 5;
+        record[7] = day;
+        record[8] = static_cast<uint8_t>(seconds / 3600 % 24);
+        record[9] = static_cast<uint8_t>(seconds / 60 % 60);
+        record[10] = static_cast<uint8_t>(seconds % 60);
+        // Sensor bytes stay below 0x40 so no offset inside a record reads as a plausible date
+        for (int b = 11; b < size; b++) record[b] = static_cast<uint8_t>(XorShift(state) & 0x3F);
+    }
+    return file;
+}
+
+std::vector<SessionEvent> SyntheticSyncScript(const std::vector<std::string>& files, int window) {
+    SessionEvent event;
+    event.kind = SessionEvent::Kind::kDownloadFiles;
+    event.files = files;
+    event.window = std::max(window, 1);
+    return {event};
+}
+
+} // namespace pod_connector
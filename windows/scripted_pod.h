@@ -0,0 +1,98 @@
+#pragma once
+
+#include "core_scheduler.h"
+#include "pod_commands.h"
+#include "session_script.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pod_connector {
+
+/// Timing and content of a ScriptedPod. Defaults approximate a 61-byte
+/// (Proewe) pod on a 244-byte ATT payload.
+struct ScriptedPodConfig {
+    int record_size = 61;
+    int block_size = 244;                   // Whole notification, header included
+    int records_per_file = 600;             // Each file gets this plus up to records_spread more
+    int records_spread = 400;
+    std::chrono::microseconds block_interval{2500};
+    std::chrono::milliseconds first_block_latency{40};  // 0x06 request → first block
+    std::chrono::milliseconds ready_latency{350};       // Last block → file closed, probes answered
+    std::chrono::milliseconds reply_latency{20};        // 0x09 probe → settings reply
+    std::chrono::milliseconds apply_latency{60};        // 0x0A/0x0B write → reported by 0x09
+    std::chrono::milliseconds delete_latency{80};       // 0x07 → file erased; commands queue behind it
+    int player_number = 10;
+    int log_interval_ms = 100;
+    std::vector<std::string> files;         // SD card contents, listed by 0x05
+    double loss = 0.0;                      // Fraction of blocks never delivered
+    uint32_t seed = 1;                      // For loss and record contents
+};
+
+/// Simulated pod firmware on a CoreScheduler, for synthetic sessions.
+///
+/// Answers the host's writes the way the firmware does: a 0x06 download
+/// request streams the file as sequenced 0x03 blocks, 0x08 cancels, 0x0A and
+/// 0x0B change the settings after apply_latency, and a 0x09 settings probe
+/// gets a 0x05 reply once the previous file has been closed. 0x07 erases a
+/// file in delete_latency, one at a time; a 0x05 file list request waits
+/// for the erases ahead of it and is answered with 0x02 blocks. Everything it
+/// sends goes through [notify] from a scheduler task, so the host never sees
+/// a reply inline with its own write. File contents are derived from the
+/// filename and seed: valid records, so Smart Peek and the record validity
+/// checks see real data.
+class ScriptedPod {
+public:
+    using NotifyCallback = std::function<void(const std::vector<uint8_t>&)>;
+
+    ScriptedPod(std::shared_ptr<CoreScheduler> scheduler, ScriptedPodConfig config,
+                NotifyCallback notify);
+
+    /// Host → pod, as written (with the 0xAE header).
+    void OnWrite(const std::vector<uint8_t>& framed);
+
+    /// The file the pod serves for [filename] (without the message type byte).
+    std::vector<uint8_t> FileContents(const std::string& filename) const;
+
+    /// Blocks a transfer of [bytes] of file data takes.
+    int BlockCount(size_t bytes) const;
+
+    PodSettings settings() const { return settings_; }
+    const std::vector<std::string>& files() const { return files_; }
+    uint64_t files_started() const { return files_started_; }
+    uint64_t blocks_sent() const { return blocks_sent_; }
+    uint64_t blocks_dropped() const { return blocks_dropped_; }
+
+private:
+    void StartTransfer(const std::string& filename);
+    void SendCatalog();
+    void SendBlock(uint64_t transfer, int block);
+    bool DropNext();
+
+    std::shared_ptr<CoreScheduler> scheduler_;
+    ScriptedPodConfig config_;
+    NotifyCallback notify_;
+    uint32_t rng_;
+
+    // Only touched from scheduler tasks and OnWrite, which the replay runs on one thread
+    uint64_t transfer_ = 0;                 // Bumped to cancel the blocks in flight
+    bool sending_ = false;
+    std::vector<uint8_t> file_;
+    CoreScheduler::Clock::time_point ready_at_{};
+    PodSettings settings_;
+    std::vector<std::string> files_;
+    CoreScheduler::Clock::time_point erased_at_{};  // When the queued erases are done
+    uint64_t files_started_ = 0;
+    uint64_t blocks_sent_ = 0;
+    uint64_t blocks_dropped_ = 0;
+};
+
+/// Input events for a synthetic multi-file sync: one DownloadFiles call for
+/// [files] at t=0. Acks come from the replay's simulated consumer.
+std::vector<SessionEvent> SyntheticSyncScript(const std::vector<std::string>& files, int window);
+
+} // namespace pod_connector
@@ -0,0 +1,138 @@
+#include "session_replay.h"
+
+#include "pod_ble_core.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+
+namespace pod_connector {
+
+namespace {
+
+void ApplyInput(PodBLECore& core, const SessionEvent& event) {
+    switch (event.kind) {
+        case SessionEvent::Kind::kNotify:
+            core.InjectNotification(event.bytes);
+            break;
+        case SessionEvent::Kind::kWrite:
+            core.WriteCommand(event.bytes);
+            break;
+        case SessionEvent::Kind::kDownloadFile:
+            core.DownloadFile(event.text, event.start, event.end, event.total, event.index);
+            break;
+        case SessionEvent::Kind::kDownloadFiles:
+            core.DownloadFiles(event.files, event.start, event.end, event.window);
+            break;
+        case SessionEvent::Kind::kAck:
+            core.AcknowledgeBatchFile(event.index);
+            break;
+        case SessionEvent::Kind::kCancel:
+            core.CancelDownload();
+            break;
+        case SessionEvent::Kind::kDisconnect:
+            core.Disconnect();
+            break;
+        case SessionEvent::Kind::kApplySettings: {
+            SettingsRequest request;
+            if (event.player_number > 0) request.player_number = event.player_number;
+            if (event.log_interval_ms > 0) request.log_interval_ms = event.log_interval_ms;
+            core.ApplySettings(request, std::chrono::milliseconds(event.timeout_ms), nullptr);
+            break;
+        }
+        case SessionEvent::Kind::kDeleteFiles:
+            core.DeleteFiles(event.files, std::chrono::milliseconds(event.timeout_ms), nullptr);
+            break;
+        default:
+            break;  // Outputs are what the replay produces, not what it feeds in
+    }
+}
+
+// "Downloading File i/n" → i, 0 for anything else
+int BatchIndexFromStatus(const std::string& status) {
+    static const std::string kPrefix = "Downloading File ";
+    if (status.rfind(kPrefix, 0) != 0) return 0;
+    return std::atoi(status.c_str() + kPrefix.size());
+}
+
+} // namespace
+
+ReplayResult RunSessionReplay(const std::vector<SessionEvent>& script, const ReplayOptions& options) {
+    const auto wallStart = std::chrono::steady_clock::now();
+
+    auto scheduler = std::make_shared<VirtualScheduler>();
+    const auto origin = scheduler->Now();
+    ReplayResult result;
+    auto lastOutput = origin;
+
+    auto core = std::make_unique<PodBLECore>(scheduler);
+    std::unique_ptr<ScriptedPod> pod;
+    if (options.simulate_pod) {
+        pod = std::make_unique<ScriptedPod>(scheduler, options.pod, [&core](const std::vector<uint8_t>& data) {
+            core->InjectNotification(data);
+        });
+    }
+
+    auto emit = [&](SessionEvent event) {
+        auto now = scheduler->Now();
+        event.at_us = std::chrono::duration_cast<std::chrono::microseconds>(now - origin).count();
+        result.trace.push_back(std::move(event));
+        lastOutput = now;
+    };
+
+    int batchIndex = 0;
+    core->SetCallbacks(
+        [&](const std::string& status) {
+            auto event = SessionEvent::Of(SessionEvent::Kind::kOutStatus);
+            event.text = status;
+            emit(std::move(event));
+            if (int index = BatchIndexFromStatus(status)) batchIndex = index;
+        },
+        nullptr,
+        [&](const std::vector<uint8_t>& payload) {
+            emit(SessionEvent::Payload(payload));
+            bool delivered = !payload.empty() && (payload[0] == 0x03 || payload[0] == 0xDA);
+            if (delivered && options.auto_ack_delay.count() >= 0) {
+                int index = std::max(batchIndex, 1);
+                scheduler->After(options.auto_ack_delay, [&core, index] {
+                    core->AcknowledgeBatchFile(index);
+                });
+            }
+        });
+
+    core->AttachReplayLink([&](const std::vector<uint8_t>& framed) {
+        emit(SessionEvent::Of(SessionEvent::Kind::kOutWrite, framed));
+        if (pod) pod->OnWrite(framed);
+    });
+
+    // Inputs go in at their recorded offsets; same-time events keep script order
+    auto lastInput = origin;
+    for (const auto& event : script) {
+        if (event.IsOutput()) continue;
+        if (pod && event.kind == SessionEvent::Kind::kNotify) continue;
+        auto at = origin + std::chrono::microseconds(std::max<int64_t>(event.at_us, 0));
+        lastInput = std::max(lastInput, at);
+        scheduler->After(at - origin, [&core, event] { ApplyInput(*core, event); });
+    }
+
+    // The watchdog keeps ticking while a requested file never starts, so
+    // "idle" means no output for options.settle rather than an empty queue
+    constexpr auto kStep = std::chrono::seconds(1);
+    while (true) {
+        scheduler->RunUntil(scheduler->Now() + kStep);
+        auto now = scheduler->Now();
+        if (now < lastInput) continue;
+        if (scheduler->Pending() == 0 || now - lastOutput >= options.settle) break;
+    }
+
+    result.tasks = scheduler->Executed();
+    result.virtual_ms = std::chrono::duration_cast<std::chrono::milliseconds>(lastOutput - origin).count();
+    core->SetCallbacks(nullptr, nullptr, nullptr);
+    core.reset();  // Pending tasks see the core gone and do nothing
+    pod.reset();
+    result.digest = SessionDigest(result.trace);
+    result.wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+    return result;
+}
+
+} // namespace pod_connector
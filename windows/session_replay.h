@@ -0,0 +1,42 @@
+#pragma once
+
+#include "scripted_pod.h"
+#include "session_script.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace pod_connector {
+
+struct ReplayOptions {
+    /// Answer the core's writes with a ScriptedPod instead of replaying the
+    /// script's recorded notifications (which are then ignored).
+    bool simulate_pod = false;
+    ScriptedPodConfig pod;
+
+    /// Simulated consumer: acknowledge each batch file this long after its
+    /// payload is delivered. Negative leaves acks to the script.
+    std::chrono::milliseconds auto_ack_delay{-1};
+
+    /// The replay ends once the last input has been applied and the core
+    /// has produced no output for this long (virtual time).
+    std::chrono::seconds settle{90};
+};
+
+struct ReplayResult {
+    std::vector<SessionEvent> trace;    // Outputs, timestamped in virtual time
+    uint64_t digest = 0;                // SessionDigest(trace)
+    uint64_t tasks = 0;                 // Scheduler tasks run
+    int64_t virtual_ms = 0;
+    double wall_ms = 0;
+};
+
+/// Runs a PodBLECore on a VirtualScheduler and feeds it [script]'s inputs at
+/// their recorded times. Nothing touches the radio or a real clock, so the
+/// same script and options always give the same trace, bit for bit, however
+/// long the session spans. The core starts out connected (replay link); the
+/// connect flow itself is not replayed.
+ReplayResult RunSessionReplay(const std::vector<SessionEvent>& script, const ReplayOptions& options);
+
+} // namespace pod_connector
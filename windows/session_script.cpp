@@ -0,0 +1,359 @@
+#include "session_script.h"
+
+#include "payload_integrity.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace pod_connector {
+
+namespace {
+
+struct KindName {
+    SessionEvent::Kind kind;
+    const char* name;
+};
+
+constexpr KindName kKindNames[] = {
+    {SessionEvent::Kind::kNotify, "notify"},
+    {SessionEvent::Kind::kWrite, "write"},
+    {SessionEvent::Kind::kDownloadFile, "download_file"},
+    {SessionEvent::Kind::kDownloadFiles, "download_files"},
+    {SessionEvent::Kind::kAck, "ack"},
+    {SessionEvent::Kind::kCancel, "cancel"},
+    {SessionEvent::Kind::kDisconnect, "disconnect"},
+    {SessionEvent::Kind::kApplySettings, "apply_settings"},
+    {SessionEvent::Kind::kDeleteFiles, "delete_files"},
+    {SessionEvent::Kind::kOutWrite, "out_write"},
+    {SessionEvent::Kind::kOutStatus, "out_status"},
+    {SessionEvent::Kind::kOutPayload, "out_payload"},
+};
+
+const char* KindToName(SessionEvent::Kind kind) {
+    for (const auto& k : kKindNames) {
+        if (k.kind == kind) return k.name;
+    }
+    return "?";
+}
+
+std::optional<SessionEvent::Kind> KindFromName(const std::string& name) {
+    for (const auto& k : kKindNames) {
+        if (name == k.name) return k.kind;
+    }
+    return std::nullopt;
+}
+
+std::string ToHex(const std::vector<uint8_t>& bytes) {
+    static const char kDigits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(bytes.size() * 2);
+    for (uint8_t b : bytes) {
+        out.push_back(kDigits[b >> 4]);
+        out.push_back(kDigits[b & 0x0F]);
+    }
+    return out;
+}
+
+bool FromHex(const std::string& hex, std::vector<uint8_t>& out) {
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+    if (hex.size() % 2 != 0) return false;
+    out.clear();
+    out.reserve(hex.size() / 2);
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        int hi = nibble(hex[i]);
+        int lo = nibble(hex[i + 1]);
+        if (hi < 0 || lo < 0) return false;
+        out.push_back(static_cast<uint8_t>((hi << 4) | lo));
+    }
+    return true;
+}
+
+// Rest of the stream after one separating space, for free-text fields
+std::string Rest(std::istringstream& in) {
+    std::string rest;
+    if (in.peek() == ' ') in.get();
+    std::getline(in, rest);
+    return rest;
+}
+
+// Filename lists are '|'-separated: names may contain spaces but not '|'
+std::vector<std::string> SplitNames(const std::string& text) {
+    std::vector<std::string> files;
+    std::istringstream names(text);
+    std::string name;
+    while (std::getline(names, name, '|')) {
+        if (!name.empty()) files.push_back(name);
+    }
+    return files;
+}
+
+std::string JoinNames(const std::vector<std::string>& files) {
+    std::string joined;
+    for (size_t i = 0; i < files.size(); i++) {
+        if (i > 0) joined += '|';
+        joined += files[i];
+    }
+    return joined;
+}
+
+bool ParseEvent(const std::string& line, SessionEvent& event, std::string& error) {
+    std::istringstream in(line);
+    std::string verb;
+    if (!(in >> event.at_us >> verb)) {
+        error = "expected <at_us> <event>";
+        return false;
+    }
+    auto kind = KindFromName(verb);
+    if (!kind) {
+        error = "unknown event '" + verb + "'";
+        return false;
+    }
+    event.kind = *kind;
+
+    std::string word;
+    switch (event.kind) {
+        case SessionEvent::Kind::kNotify:
+        case SessionEvent::Kind::kWrite:
+        case SessionEvent::Kind::kOutWrite:
+            if (!(in >> word) || !FromHex(word, event.bytes)) {
+                error = "expected hex bytes";
+                return false;
+            }
+            break;
+        case SessionEvent::Kind::kDownloadFile:
+            if (!(in >> event.start >> event.end >> event.total >> event.index)) {
+                error = "expected <start> <end> <total> <index> <filename>";
+                return false;
+            }
+            event.text = Rest(in);
+            break;
+        case SessionEvent::Kind::kDownloadFiles: {
+            if (!(in >> event.start >> event.end >> event.window)) {
+                error = "expected <start> <end> <window> <filenames>";
+                return false;
+            }
+            event.files = SplitNames(Rest(in));
+            break;
+        }
+        case SessionEvent::Kind::kAck:
+            if (!(in >> event.index)) {
+                error = "expected <index>";
+                return false;
+            }
+            break;
+        case SessionEvent::Kind::kCancel:
+        case SessionEvent::Kind::kDisconnect:
+            break;
+        case SessionEvent::Kind::kApplySettings:
+            if (!(in >> event.player_number >> event.log_interval_ms >> event.timeout_ms)) {
+                error = "expected <player> <interval_ms> <timeout_ms>";
+                return false;
+            }
+            break;
+        case SessionEvent::Kind::kDeleteFiles:
+            if (!(in >> event.timeout_ms)) {
+                error = "expected <timeout_ms> <filenames>";
+                return false;
+            }
+            event.files = SplitNames(Rest(in));
+            break;
+        case SessionEvent::Kind::kOutStatus:
+            event.text = Rest(in);
+            break;
+        case SessionEvent::Kind::kOutPayload:
+            if (!(in >> event.length >> std::hex >> event.crc)) {
+                error = "expected <length> <crc32c>";
+                return false;
+            }
+            break;
+    }
+    return true;
+}
+
+bool SameContent(const SessionEvent& a, const SessionEvent& b) {
+    return a.kind == b.kind && a.bytes == b.bytes && a.text == b.text &&
+           a.length == b.length && a.crc == b.crc;
+}
+
+} // namespace
+
+std::string SessionEvent::Describe() const {
+    std::ostringstream out;
+    out << KindToName(kind);
+    switch (kind) {
+        case Kind::kNotify:
+        case Kind::kWrite:
+        case Kind::kOutWrite:
+            out << ' ' << ToHex(bytes);
+            break;
+        case Kind::kDownloadFile:
+            out << ' ' << start << ' ' << end << ' ' << total << ' ' << index << ' ' << text;
+            break;
+        case Kind::kDownloadFiles:
+            out << ' ' << start << ' ' << end << ' ' << window << ' ' << JoinNames(files);
+            break;
+        case Kind::kAck:
+            out << ' ' << index;
+            break;
+        case Kind::kCancel:
+        case Kind::kDisconnect:
+            break;
+        case Kind::kApplySettings:
+            out << ' ' << player_number << ' ' << log_interval_ms << ' ' << timeout_ms;
+            break;
+        case Kind::kDeleteFiles:
+            out << ' ' << timeout_ms << ' ' << JoinNames(files);
+            break;
+        case Kind::kOutStatus:
+            out << ' ' << text;
+            break;
+        case Kind::kOutPayload:
+            out << ' ' << length << ' ' << std::hex << crc;
+            break;
+    }
+    return out.str();
+}
+
+SessionEvent SessionEvent::Of(Kind kind, std::vector<uint8_t> bytes) {
+    SessionEvent event;
+    event.kind = kind;
+    event.bytes = std::move(bytes);
+    return event;
+}
+
+SessionEvent SessionEvent::Payload(const std::vector<uint8_t>& payload) {
+    SessionEvent event;
+    event.kind = Kind::kOutPayload;
+    event.length = payload.size();
+    event.crc = Crc32c(0, payload.data(), payload.size());
+    return event;
+}
+
+// MARK: - Script Files
+
+std::optional<std::vector<SessionEvent>> ParseSessionScript(const std::string& text,
+                                                            std::string* error) {
+    std::vector<SessionEvent> events;
+    std::istringstream in(text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        auto first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line[first] == '#') continue;
+
+        SessionEvent event;
+        std::string message;
+        if (!ParseEvent(line.substr(first), event, message)) {
+            if (error) *error = "line " + std::to_string(lineNumber) + ": " + message;
+            return std::nullopt;
+        }
+        events.push_back(std::move(event));
+    }
+    return events;
+}
+
+std::optional<std::vector<SessionEvent>> LoadSessionScript(const std::filesystem::path& path,
+                                                           std::string* error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        if (error) *error = "cannot open " + path.string();
+        return std::nullopt;
+    }
+    std::ostringstream text;
+    text << file.rdbuf();
+    return ParseSessionScript(text.str(), error);
+}
+
+std::string FormatSessionScript(const std::vector<SessionEvent>& events) {
+    std::string out = "# pod_ble session v1\n";
+    for (const auto& event : events) {
+        out += std::to_string(event.at_us);
+        out += ' ';
+        out += event.Describe();
+        out += '\n';
+    }
+    return out;
+}
+
+bool SaveSessionScript(const std::filesystem::path& path, const std::vector<SessionEvent>& events,
+                       std::string* error) {
+    try {
+        if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path());
+    } catch (...) {
+        // Reported by the open below
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (file) file << FormatSessionScript(events);
+    if (!file) {
+        if (error) *error = "cannot write " + path.string();
+        return false;
+    }
+    return true;
+}
+
+uint64_t SessionDigest(const std::vector<SessionEvent>& events) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : FormatSessionScript(events)) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+int64_t FirstOutputMismatch(const std::vector<SessionEvent>& expected,
+                            const std::vector<SessionEvent>& actual) {
+    size_t i = 0, j = 0;
+    int64_t output = 0;
+    while (true) {
+        while (i < expected.size() && !expected[i].IsOutput()) i++;
+        while (j < actual.size() && !actual[j].IsOutput()) j++;
+        bool expectedDone = i == expected.size();
+        bool actualDone = j == actual.size();
+        if (expectedDone && actualDone) return -1;
+        if (expectedDone || actualDone || !SameContent(expected[i], actual[j])) return output;
+        i++;
+        j++;
+        output++;
+    }
+}
+
+std::filesystem::path DefaultSessionRecordingPath() {
+    std::filesystem::path base;
+    if (const char* local = std::getenv("LOCALAPPDATA")) {
+        base = local;
+    } else {
+        base = std::filesystem::temp_directory_path();
+    }
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return base / "metric_athlete_pod_ble" / "sessions" / ("session-" + std::to_string(ms) + ".txt");
+}
+
+// MARK: - SessionRecorder
+
+void SessionRecorder::Add(CoreScheduler::Clock::time_point at, SessionEvent event) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!origin_) origin_ = at;
+    event.at_us = std::chrono::duration_cast<std::chrono::microseconds>(at - *origin_).count();
+    events_.push_back(std::move(event));
+}
+
+size_t SessionRecorder::Size() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return events_.size();
+}
+
+std::vector<SessionEvent> SessionRecorder::Events() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return events_;
+}
+
+} // namespace pod_connector
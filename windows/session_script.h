@@ -0,0 +1,121 @@
+#pragma once
+
+#include "core_scheduler.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace pod_connector {
+
+// Session scripts: what happened to a PodBLECore and what it did in return,
+// with timestamps, for deterministic replay (see session_replay.h).
+//
+// Inputs are everything that drives the core from outside: notifications
+// from the pod and calls made by Flutter. Outputs are what the core sends
+// back: writes to the pod, statuses and payloads. Replaying the inputs on a
+// virtual clock reproduces the outputs; a recording carries both so a replay
+// can be checked against what was seen live.
+//
+// Text format, one event per line, '#' starts a comment:
+//
+//   <at_us> notify <hex>
+//   <at_us> write <hex>                                       (before the 0xAE header)
+//   <at_us> download_file <start> <end> <total> <index> <filename>
+//   <at_us> download_files <start> <end> <window> <filename>|<filename>|...
+//   <at_us> ack <index>
+//   <at_us> cancel
+//   <at_us> disconnect
+//   <at_us> apply_settings <player> <interval_ms> <timeout_ms>      (0 = leave unchanged)
+//   <at_us> delete_files <timeout_ms> <filename>|<filename>|...
+//   <at_us> out_write <hex>                                   (as sent, with 0xAE)
+//   <at_us> out_status <text>
+//   <at_us> out_payload <length> <crc32c hex>
+//
+// at_us is microseconds since the first event. Filenames run to the end of
+// the line and may contain spaces.
+
+struct SessionEvent {
+    enum class Kind {
+        kNotify,
+        kWrite,
+        kDownloadFile,
+        kDownloadFiles,
+        kAck,
+        kCancel,
+        kDisconnect,
+        kApplySettings,
+        kDeleteFiles,
+        kOutWrite,
+        kOutStatus,
+        kOutPayload,
+    };
+
+    int64_t at_us = 0;
+    Kind kind = Kind::kNotify;
+    std::vector<uint8_t> bytes;         // notify, write, out_write
+    std::string text;                   // download_file filename, out_status
+    std::vector<std::string> files;     // download_files, delete_files
+    int64_t start = 0;                  // Smart Peek filter range
+    int64_t end = 0;
+    int total = 0;                      // download_file
+    int index = 0;                      // download_file, ack
+    int window = 0;                     // download_files
+    uint64_t length = 0;                // out_payload
+    uint32_t crc = 0;                   // out_payload, CRC32C of the payload
+    int player_number = 0;              // apply_settings, 0 = unchanged
+    int log_interval_ms = 0;            // apply_settings, 0 = unchanged
+    int timeout_ms = 0;                 // apply_settings, delete_files
+
+    bool IsOutput() const { return kind >= Kind::kOutWrite; }
+
+    /// The event's line without the timestamp, e.g. "ack 3".
+    std::string Describe() const;
+
+    static SessionEvent Of(Kind kind, std::vector<uint8_t> bytes = {});
+    static SessionEvent Payload(const std::vector<uint8_t>& payload);
+};
+
+/// Parses a script. Returns nullopt and sets [error] ("line N: ...") on the
+/// first malformed line.
+std::optional<std::vector<SessionEvent>> ParseSessionScript(const std::string& text,
+                                                            std::string* error);
+std::optional<std::vector<SessionEvent>> LoadSessionScript(const std::filesystem::path& path,
+                                                           std::string* error);
+
+std::string FormatSessionScript(const std::vector<SessionEvent>& events);
+bool SaveSessionScript(const std::filesystem::path& path, const std::vector<SessionEvent>& events,
+                       std::string* error);
+
+/// FNV-1a over the formatted events. Equal digests mean equal traces,
+/// timestamps included.
+uint64_t SessionDigest(const std::vector<SessionEvent>& events);
+
+/// Index of the first output that differs between two traces, comparing
+/// content only (a live recording and its replay differ in timing), or -1
+/// when they match. Inputs in either list are ignored.
+int64_t FirstOutputMismatch(const std::vector<SessionEvent>& expected,
+                            const std::vector<SessionEvent>& actual);
+
+/// A new file under %LOCALAPPDATA%/metric_athlete_pod_ble/sessions.
+std::filesystem::path DefaultSessionRecordingPath();
+
+/// Collects events from a live core. Thread-safe; timestamps are taken
+/// relative to the first event added.
+class SessionRecorder {
+public:
+    void Add(CoreScheduler::Clock::time_point at, SessionEvent event);
+
+    size_t Size();
+    std::vector<SessionEvent> Events();
+
+private:
+    std::mutex mtx_;
+    std::optional<CoreScheduler::Clock::time_point> origin_;
+    std::vector<SessionEvent> events_;
+};
+
+} // namespace pod_connector
@@ -0,0 +1,134 @@
+#include "settings_verifier.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace pod_connector {
+
+SettingsVerifier::SettingsVerifier(CoreScheduler& scheduler, ReplyMatcher& matcher,
+                                   std::shared_ptr<std::atomic<bool>> alive, SendFn send, GateFn gate,
+                                   ReplyFn onReply)
+    : scheduler_(scheduler), matcher_(matcher), alive_(std::move(alive)), send_(std::move(send)),
+      gate_(std::move(gate)), on_reply_(std::move(onReply)) {}
+
+void SettingsVerifier::Apply(const SettingsRequest& request, std::chrono::milliseconds timeout,
+                             SettingsCallback done) {
+    queue_.push_back({request, timeout, std::move(done)});
+    StartNext();
+}
+
+void SettingsVerifier::StartNext() {
+    if (active_ || queue_.empty()) return;
+    current_ = std::move(queue_.front());
+    queue_.pop_front();
+    result_ = {};
+
+    Gate gate = gate_ ? gate_() : Gate::kReady;
+    if (gate != Gate::kReady) {
+        // Offline fails at once. A transfer owns the link: the pod would not
+        // answer until it ends, so report busy rather than wait.
+        result_.busy = gate == Gate::kBusy;
+        auto done = std::move(current_.done);
+        current_ = {};
+        if (done) done(result_);
+        StartNext();
+        return;
+    }
+
+    active_ = true;
+    started_ = scheduler_.Now();
+    deadline_ = started_ + current_.timeout;
+    const auto& request = current_.request;
+    if (request.player_number) {
+        send_(pod_command::SetPlayerNumber(static_cast<uint8_t>(*request.player_number)).ToVector());
+    }
+    if (request.log_interval_ms) {
+        send_(pod_command::SetLogInterval(static_cast<uint16_t>(*request.log_interval_ms)).ToVector());
+    }
+    Probe(generation_);
+}
+
+void SettingsVerifier::Probe(uint64_t generation) {
+    if (!active_ || generation != generation_) return;
+    auto now = scheduler_.Now();
+    if (now >= deadline_) {
+        Finish(true);
+        return;
+    }
+    send_(pod_command::GetSettings().ToVector());
+    result_.probes++;
+
+    uint64_t next = ++generation_;
+    auto wait = std::min<CoreScheduler::Clock::duration>(std::chrono::milliseconds(kReprobeMs), deadline_ - now);
+    scheduler_.After(wait, [this, alive = alive_, next]() {
+        if (alive->load()) Probe(next);
+    });
+}
+
+bool SettingsVerifier::OnReply(const ReplyMatcher::Match& match, const std::vector<uint8_t>& packet) {
+    if (!active_ || match.request != PodOpcode::kGetSettings) return false;
+    auto settings = ParseSettingsReply(packet);
+    if (!settings) return false;
+
+    result_.has_settings = true;
+    result_.settings = *settings;
+    if (on_reply_) on_reply_(*settings);
+
+    const auto& request = current_.request;
+    bool applied = (!request.player_number || *request.player_number == settings->player_number) &&
+                   (!request.log_interval_ms || *request.log_interval_ms == settings->log_interval_ms);
+    if (applied) {
+        Finish(false);
+        return true;
+    }
+
+    if (request.player_number) matcher_.StatsFor(PodOpcode::kSetPlayerNumber).mismatches++;
+    if (request.log_interval_ms) matcher_.StatsFor(PodOpcode::kSetLogInterval).mismatches++;
+    uint64_t next = ++generation_;
+    scheduler_.After(std::chrono::milliseconds(kStaleRetryMs), [this, alive = alive_, next]() {
+        if (alive->load()) Probe(next);
+    });
+    return true;
+}
+
+void SettingsVerifier::Finish(bool timedOut) {
+    active_ = false;
+    generation_++;
+
+    result_.timed_out = timedOut;
+    result_.verified = !timedOut;
+    result_.latency_ms = std::chrono::duration<double, std::milli>(scheduler_.Now() - started_).count();
+    // Set commands have no reply of their own; they are timed to the one that verified them
+    auto record = [&](PodOpcode opcode) {
+        auto& stats = matcher_.StatsFor(opcode);
+        if (timedOut) {
+            stats.timeouts++;
+        } else {
+            stats.Add(result_.latency_ms);
+        }
+    };
+    if (current_.request.player_number) record(PodOpcode::kSetPlayerNumber);
+    if (current_.request.log_interval_ms) record(PodOpcode::kSetLogInterval);
+
+    auto done = std::move(current_.done);
+    current_ = {};
+    if (done) done(result_);
+    StartNext();
+}
+
+void SettingsVerifier::Abandon() {
+    if (active_) {
+        active_ = false;
+        generation_++;
+        auto done = std::move(current_.done);
+        current_ = {};
+        if (done) done(result_);
+    }
+    auto queued = std::move(queue_);
+    queue_.clear();
+    for (auto& transaction : queued) {
+        if (transaction.done) transaction.done(SettingsResult{});
+    }
+}
+
+} // namespace pod_connector
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "core_scheduler.h"
+#include "pod_commands.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace pod_connector {
+
+/// Settings to write; unset values are left as they are.
+struct SettingsRequest {
+    std::optional<int> player_number;
+    std::optional<int> log_interval_ms;
+
+    bool Valid() const {
+        return (!player_number || pod_command::IsValidPlayerNumber(*player_number)) &&
+               (!log_interval_ms || pod_command::IsValidLogInterval(*log_interval_ms));
+    }
+
+    bool Empty() const { return !player_number && !log_interval_ms; }
+};
+
+/// Outcome of a set-and-verify transaction.
+struct SettingsResult {
+    bool verified = false;      // The pod reported the requested values
+    bool timed_out = false;
+    bool busy = false;          // A transfer held the link; nothing was written
+    bool has_settings = false;  // [settings] holds the pod's last reply
+    PodSettings settings;
+    int probes = 0;             // Get Settings requests written
+    double latency_ms = 0;      // First write → verifying reply
+};
+using SettingsCallback = std::function<void(const SettingsResult&)>;
+
+/// Set-and-verify against one pod: writes the set commands back to back,
+/// then repeats Get Settings (0x09) until a reply shows the new values.
+/// A stale reply (firmware still committing) is retried after
+/// kStaleRetryMs, silence after kReprobeMs, until the transaction's timeout.
+/// With nothing to set it is a correlated Get Settings.
+///
+/// Transactions run one at a time in arrival order. Not thread-safe: every
+/// call, the send function and the scheduler's tasks must run on the
+/// owner's strand. Timers check [alive] so the owner can go away first.
+class SettingsVerifier {
+public:
+    static constexpr int kReprobeMs = 250;
+    static constexpr int kStaleRetryMs = 40;
+
+    /// Whether a transaction may start now.
+    enum class Gate { kReady, kBusy, kOffline };
+
+    using SendFn = std::function<void(const std::vector<uint8_t>& command)>;
+    using GateFn = std::function<Gate()>;
+    using ReplyFn = std::function<void(const PodSettings& settings)>;
+
+    /// [send] writes a command (without the 0xAE header) and reports it to
+    /// [matcher]. [onReply] sees every settings reply a probe brings back.
+    SettingsVerifier(CoreScheduler& scheduler, ReplyMatcher& matcher,
+                     std::shared_ptr<std::atomic<bool>> alive, SendFn send, GateFn gate,
+                     ReplyFn onReply = nullptr);
+
+    void Apply(const SettingsRequest& request, std::chrono::milliseconds timeout, SettingsCallback done);
+
+    /// Offers a correlated reply. True if it answered one of our probes and
+    /// was consumed.
+    bool OnReply(const ReplyMatcher::Match& match, const std::vector<uint8_t>& packet);
+
+    /// Link gone: the active transaction and everything queued complete
+    /// unverified.
+    void Abandon();
+
+    bool Active() const { return active_; }
+
+private:
+    struct Transaction {
+        SettingsRequest request;
+        std::chrono::milliseconds timeout{0};
+        SettingsCallback done;
+    };
+
+    void StartNext();
+    void Probe(uint64_t generation);
+    void Finish(bool timedOut);
+
+    CoreScheduler& scheduler_;
+    ReplyMatcher& matcher_;
+    std::shared_ptr<std::atomic<bool>> alive_;
+    SendFn send_;
+    GateFn gate_;
+    ReplyFn on_reply_;
+
+    std::deque<Transaction> queue_;
+    Transaction current_;
+    SettingsResult result_;
+    bool active_ = false;
+    uint64_t generation_ = 0;       // Retires the pending probe timer
+    CoreScheduler::Clock::time_point started_;
+    CoreScheduler::Clock::time_point deadline_;
+};
+
+} // namespace pod_connector
@@ -0,0 +1,163 @@
+#include "shared_memory_region.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pod_connector {
+
+// MARK: - SharedMemoryRegion
+
+#ifdef _WIN32
+
+namespace {
+
+std::wstring Widen(const std::string& s) {
+    int n = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), static_cast<int>(s.size()), nullptr, 0);
+    std::wstring w(n, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), static_cast<int>(s.size()), w.data(), n);
+    return w;
+}
+
+} // namespace
+
+bool SharedMemoryRegion::Create(const std::string& name, size_t size, std::string* error) {
+    Unmap();
+    uint64_t size64 = size;
+    HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64),
+                                        Widen(name).c_str());
+    if (!mapping || GetLastError() == ERROR_ALREADY_EXISTS) {
+        if (error) *error = "CreateFileMapping " + name + " failed: " + std::to_string(GetLastError());
+        if (mapping) CloseHandle(mapping);
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!view) {
+        if (error) *error = "MapViewOfFile failed: " + std::to_string(GetLastError());
+        CloseHandle(mapping);
+        return false;
+    }
+    name_ = name;
+    mapping_ = mapping;
+    data_ = static_cast<uint8_t*>(view);
+    size_ = size;
+    owner_ = true;
+    return true;
+}
+
+bool SharedMemoryRegion::Open(const std::string& name, size_t size, std::string* error) {
+    Unmap();
+    HANDLE mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, Widen(name).c_str());
+    if (!mapping) {
+        if (error) *error = "OpenFileMapping " + name + " failed: " + std::to_string(GetLastError());
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+    if (!view) {
+        if (error) *error = "MapViewOfFile failed: " + std::to_string(GetLastError());
+        CloseHandle(mapping);
+        return false;
+    }
+    name_ = name;
+    mapping_ = mapping;
+    data_ = static_cast<uint8_t*>(view);
+    size_ = size;
+    owner_ = false;
+    return true;
+}
+
+void SharedMemoryRegion::Unmap() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    data_ = nullptr;
+    mapping_ = nullptr;
+    size_ = 0;
+}
+
+#else
+
+bool SharedMemoryRegion::Create(const std::string& name, size_t size, std::string* error) {
+    Unmap();
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0 && errno == EEXIST) {
+        // Left behind by a crashed owner
+        ::shm_unlink(name.c_str());
+        fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    }
+    if (fd < 0) {
+        if (error) *error = "shm_open " + name + ": " + std::strerror(errno);
+        return false;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        if (error) *error = std::string("ftruncate: ") + std::strerror(errno);
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        return false;
+    }
+    void* view = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        if (error) *error = std::string("mmap: ") + std::strerror(errno);
+        ::shm_unlink(name.c_str());
+        return false;
+    }
+    name_ = name;
+    data_ = static_cast<uint8_t*>(view);
+    size_ = size;
+    owner_ = true;
+    return true;
+}
+
+bool SharedMemoryRegion::Open(const std::string& name, size_t size, std::string* error) {
+    Unmap();
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        if (error) *error = "shm_open " + name + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < size) {
+        if (error) *error = "Shared memory " + name + " is smaller than announced";
+        ::close(fd);
+        return false;
+    }
+    void* view = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        if (error) *error = std::string("mmap: ") + std::strerror(errno);
+        return false;
+    }
+    name_ = name;
+    data_ = static_cast<uint8_t*>(view);
+    size_ = size;
+    owner_ = false;
+    return true;
+}
+
+void SharedMemoryRegion::Unmap() {
+    if (data_) ::munmap(data_, size_);
+    if (owner_ && !name_.empty()) ::shm_unlink(name_.c_str());
+    data_ = nullptr;
+    size_ = 0;
+    owner_ = false;
+}
+
+#endif
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+    Unmap();
+}
+
+} // namespace pod_connector
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pod_connector {
+
+/// A named shared-memory mapping: a POSIX shm object or a pagefile-backed
+/// file mapping on Windows. The creator maps it read-write and removes the
+/// name when destroyed; other processes open it read-only.
+class SharedMemoryRegion {
+public:
+    SharedMemoryRegion() = default;
+    ~SharedMemoryRegion();
+
+    SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+    SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+    bool Create(const std::string& name, size_t size, std::string* error);
+    bool Open(const std::string& name, size_t size, std::string* error);
+
+    uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    void Unmap();
+
+    std::string name_;
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool owner_ = false;
+#ifdef _WIN32
+    void* mapping_ = nullptr;
+#endif
+};
+
+} // namespace pod_connector
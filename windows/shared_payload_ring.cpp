@@ -0,0 +1,123 @@
+#include "shared_payload_ring.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace pod_connector {
+
+#ifdef _WIN32
+
+std::string DefaultSharedMemoryName() {
+    return "Local\\pod_ble_broker_" + std::to_string(GetCurrentProcessId());
+}
+
+#else
+
+std::string DefaultSharedMemoryName() {
+    return "/pod_ble_broker_" + std::to_string(::getpid());
+}
+
+#endif
+
+// MARK: - SharedPayloadRing
+
+bool SharedPayloadRing::Create(const std::string& name, size_t capacity, std::string* error) {
+    if (!region_.Create(name, capacity, error)) return false;
+    std::lock_guard<std::mutex> lock(mtx_);
+    name_ = name;
+    slots_.assign(kMaxSlots, Slot{});
+    free_slots_.clear();
+    for (size_t i = kMaxSlots; i > 0; i--) free_slots_.push_back(static_cast<uint32_t>(i - 1));
+    order_.clear();
+    head_ = 0;
+    stats_ = PayloadRingStats{};
+    stats_.capacity = capacity;
+    return true;
+}
+
+std::optional<PayloadSlot> SharedPayloadRing::Publish(const uint8_t* data, size_t length, uint32_t readers) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    const uint64_t capacity = region_.size();
+    if (readers == 0 || length == 0 || length > capacity || free_slots_.empty()) {
+        stats_.rejected++;
+        return std::nullopt;
+    }
+
+    // Contiguous FIFO allocation between head_ and the oldest live payload
+    std::optional<uint64_t> start;
+    if (order_.empty()) {
+        start = 0;
+    } else {
+        uint64_t tail = slots_[order_.front()].offset;
+        if (head_ > tail) {
+            if (capacity - head_ >= length) start = head_;
+            else if (tail >= length) start = 0;     // Wrap; the end of the region stays unused this lap
+        } else if (tail - head_ >= length) {
+            start = head_;
+        }
+    }
+    if (!start) {
+        stats_.rejected++;
+        return std::nullopt;
+    }
+
+    uint32_t index = free_slots_.back();
+    free_slots_.pop_back();
+    Slot& slot = slots_[index];
+    slot.generation++;
+    slot.readers = readers;
+    slot.offset = *start;
+    slot.end = *start + length;
+    order_.push_back(index);
+    head_ = slot.end;
+    std::memcpy(region_.data() + *start, data, length);
+
+    stats_.published++;
+    stats_.outstanding++;
+    size_t used = static_cast<size_t>(head_ > slots_[order_.front()].offset
+                                          ? head_ - slots_[order_.front()].offset
+                                          : capacity - slots_[order_.front()].offset + head_);
+    stats_.high_water = std::max(stats_.high_water, used);
+    return PayloadSlot{index, slot.generation, *start, static_cast<uint32_t>(length)};
+}
+
+bool SharedPayloadRing::Release(uint32_t slot, uint32_t generation) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (slot >= slots_.size()) return false;
+    Slot& s = slots_[slot];
+    if (s.readers == 0 || s.generation != generation) return false;
+    if (--s.readers == 0) {
+        stats_.outstanding--;
+        Reclaim();
+    }
+    return true;
+}
+
+void SharedPayloadRing::Reclaim() {
+    while (!order_.empty() && slots_[order_.front()].readers == 0) {
+        free_slots_.push_back(order_.front());
+        order_.pop_front();
+    }
+    if (order_.empty()) head_ = 0;
+}
+
+PayloadRingStats SharedPayloadRing::Stats() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    PayloadRingStats stats = stats_;
+    if (!order_.empty()) {
+        uint64_t tail = slots_[order_.front()].offset;
+        stats.used = static_cast<size_t>(head_ > tail ? head_ - tail : region_.size() - tail + head_);
+    }
+    return stats;
+}
+
+} // namespace pod_connector
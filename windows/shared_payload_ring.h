@@ -0,0 +1,80 @@
+#pragma once
+
+#include "shared_memory_region.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace pod_connector {
+
+/// Default name for a broker's payload ring (unique per broker process).
+std::string DefaultSharedMemoryName();
+
+/// Where one published payload lives in the ring.
+struct PayloadSlot {
+    uint32_t slot = 0;
+    uint32_t generation = 0;    // Guards against releasing a reused slot twice
+    uint64_t offset = 0;
+    uint32_t length = 0;
+};
+
+struct PayloadRingStats {
+    size_t capacity = 0;
+    size_t used = 0;            // Bytes held by unreleased payloads (and skipped tail space)
+    size_t high_water = 0;
+    size_t outstanding = 0;     // Payloads not yet released by every reader
+    uint64_t published = 0;
+    uint64_t rejected = 0;      // Did not fit; the caller sends those inline
+};
+
+/// Broker side of the shared payload transfer. A payload is copied into the
+/// region once and its PayloadSlot sent to every reader, which read it in
+/// place and release it. Space is handed out in FIFO order and reclaimed
+/// once the oldest payload has been released by all of its readers, so a
+/// reader that never releases eventually makes Publish() fail rather than
+/// having its data overwritten. Thread-safe.
+class SharedPayloadRing {
+public:
+    /// Payloads that may be outstanding at once.
+    static constexpr size_t kMaxSlots = 1024;
+
+    bool Create(const std::string& name, size_t capacity, std::string* error);
+
+    const std::string& name() const { return name_; }
+    size_t capacity() const { return region_.size(); }
+
+    /// Copies [data] into the ring for [readers] readers. Returns nullopt if
+    /// there is no room right now (or [readers] is 0).
+    std::optional<PayloadSlot> Publish(const uint8_t* data, size_t length, uint32_t readers);
+
+    /// One reader is done with [slot]. False for an unknown or stale slot.
+    bool Release(uint32_t slot, uint32_t generation);
+
+    PayloadRingStats Stats() const;
+
+private:
+    struct Slot {
+        uint32_t generation = 0;
+        uint32_t readers = 0;   // 0 = free
+        uint64_t offset = 0;
+        uint64_t end = 0;       // Where the next payload may start after this one
+    };
+
+    void Reclaim();
+
+    SharedMemoryRegion region_;
+    std::string name_;
+    mutable std::mutex mtx_;
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> free_slots_;
+    std::deque<uint32_t> order_;    // Live slots, oldest first
+    uint64_t head_ = 0;             // Next write offset
+    PayloadRingStats stats_;
+};
+
+} // namespace pod_connector
@@ -0,0 +1,274 @@
+#include "simulated_pod_backend.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace pod_connector {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kLivePacketSize = 73;  // Type byte + 72 bytes of telemetry
+
+void PutU32(std::vector<uint8_t>& out, size_t at, uint32_t v) {
+    for (size_t i = 0; i < 4; i++) out[at + i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+} // namespace
+
+// MARK: - Lifecycle
+
+SimulatedPodBackend::SimulatedPodBackend(SimulatedPodConfig config)
+    : config_(std::move(config)), worker_([this] { Run(); }) {}
+
+SimulatedPodBackend::~SimulatedPodBackend() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+}
+
+void SimulatedPodBackend::SetCallbacks(StatusFn status, ScanFn scan, PayloadFn payload) {
+    std::lock_guard<std::mutex> lock(callback_mtx_);
+    on_status_ = std::move(status);
+    on_scan_ = std::move(scan);
+    on_payload_ = std::move(payload);
+}
+
+SimulatedPodBackend::Counters SimulatedPodBackend::counters() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return counters_;
+}
+
+std::vector<uint8_t> SimulatedPodBackend::FileData(const std::string& filename, size_t size) {
+    uint32_t state = 2166136261u;   // FNV-1a of the name seeds an xorshift stream
+    for (char c : filename) state = (state ^ static_cast<uint8_t>(c)) * 16777619u;
+    if (state == 0) state = 1;
+    std::vector<uint8_t> data(size);
+    for (auto& byte : data) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        byte = static_cast<uint8_t>(state);
+    }
+    return data;
+}
+
+// MARK: - Commands (queued to the worker)
+
+void SimulatedPodBackend::Post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_all();
+}
+
+void SimulatedPodBackend::StartScan() {
+    Post([this] {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            counters_.start_scan++;
+        }
+        scanning_ = true;
+        next_scan_ = Clock::now();
+        EmitStatus("Scanning...");
+    });
+}
+
+void SimulatedPodBackend::StopScan() {
+    Post([this] {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            counters_.stop_scan++;
+        }
+        scanning_ = false;
+    });
+}
+
+void SimulatedPodBackend::Connect(const std::string& deviceId) {
+    Post([this, deviceId] {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            counters_.connect++;
+        }
+        EmitStatus("Connecting...");
+        bool known = false;
+        for (size_t i = 0; i < config_.devices.size(); i++) {
+            if (deviceId == "SIM:" + std::to_string(i)) known = true;
+        }
+        if (!known) {
+            EmitStatus("Device Not Found");
+            return;
+        }
+        device_ = deviceId;
+        EmitStatus("Connected");
+    });
+}
+
+void SimulatedPodBackend::Disconnect() {
+    Post([this] {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            counters_.disconnect++;
+        }
+        device_.clear();
+        live_ = false;
+        batch_.clear();
+        EmitStatus("Disconnected");
+    });
+}
+
+void SimulatedPodBackend::WriteCommand(const std::vector<uint8_t>& data) {
+    Post([this, data] {
+        if (device_.empty()) {
+            EmitStatus("Write Error");
+            return;
+        }
+        if (data.size() >= 2 && data[0] == 0x03) {
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if (data[1] != 0) counters_.live_on++;
+                else counters_.live_off++;
+            }
+            live_ = data[1] != 0;
+            next_live_ = Clock::now();
+        }
+    });
+}
+
+void SimulatedPodBackend::DownloadFile(const std::string& filename, int64_t, int64_t) {
+    Post([this, filename] {
+        if (device_.empty()) return;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            counters_.downloads++;
+        }
+        std::vector<uint8_t> payload = {0x03};
+        auto data = FileData(filename, config_.file_size);
+        payload.insert(payload.end(), data.begin(), data.end());
+        EmitPayload(payload);
+        EmitStatus("Pod Ready");
+    });
+}
+
+void SimulatedPodBackend::DownloadFiles(const std::vector<std::string>& filenames, int64_t, int64_t,
+                                        int window) {
+    Post([this, filenames, window] {
+        if (device_.empty()) return;
+        batch_ = filenames;
+        batch_next_ = 0;
+        batch_acked_ = 0;
+        batch_window_ = std::max(window, 1);
+        StartNextBatchFile();
+    });
+}
+
+void SimulatedPodBackend::AcknowledgeBatchFile(int index) {
+    Post([this, index] {
+        batch_acked_ = std::max(batch_acked_, index);
+        StartNextBatchFile();
+    });
+}
+
+void SimulatedPodBackend::CancelDownload() {
+    Post([this] {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            counters_.cancels++;
+        }
+        batch_.clear();
+        EmitStatus("Pod Ready");
+    });
+}
+
+// MARK: - Worker
+
+void SimulatedPodBackend::StartNextBatchFile() {
+    // Sends files until the acknowledgement window is full
+    while (batch_next_ < batch_.size() &&
+           static_cast<int>(batch_next_) - batch_acked_ < batch_window_) {
+        const std::string filename = batch_[batch_next_++];
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            counters_.downloads++;
+        }
+        EmitStatus("Downloading File " + std::to_string(batch_next_) + "/" + std::to_string(batch_.size()));
+        std::vector<uint8_t> payload = {0x03};
+        auto data = FileData(filename, config_.file_size);
+        payload.insert(payload.end(), data.begin(), data.end());
+        EmitPayload(payload);
+        if (batch_next_ == batch_.size()) {
+            batch_.clear();
+            EmitStatus("Batch Complete");
+            return;
+        }
+    }
+}
+
+void SimulatedPodBackend::Run() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (!stopping_) {
+        if (!tasks_.empty()) {
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+            continue;
+        }
+
+        auto now = Clock::now();
+        if (scanning_ && now >= next_scan_) {
+            next_scan_ = now + config_.scan_interval;
+            lock.unlock();
+            {
+                std::lock_guard<std::mutex> callback_lock(callback_mtx_);
+                for (size_t i = 0; i < config_.devices.size() && on_scan_; i++) {
+                    on_scan_(config_.devices[i], "SIM:" + std::to_string(i), -40 - static_cast<int>(i) * 7);
+                }
+            }
+            lock.lock();
+            continue;
+        }
+        if (live_ && now >= next_live_) {
+            // Keep the cadence, but do not burst to catch up after a stall
+            next_live_ = std::max(next_live_ + config_.live_interval, now - 10 * config_.live_interval);
+            uint32_t tick = live_tick_;
+            live_tick_ += static_cast<uint32_t>(config_.live_interval.count());
+            counters_.live_packets++;
+            lock.unlock();
+            std::vector<uint8_t> packet(kLivePacketSize, 0);
+            packet[0] = 0x01;
+            PutU32(packet, 1, tick);
+            for (size_t i = 5; i < packet.size(); i++) packet[i] = static_cast<uint8_t>(tick + i);
+            EmitPayload(packet);
+            lock.lock();
+            continue;
+        }
+
+        auto deadline = Clock::time_point::max();
+        if (scanning_) deadline = std::min(deadline, next_scan_);
+        if (live_) deadline = std::min(deadline, next_live_);
+        if (deadline == Clock::time_point::max()) {
+            cv_.wait(lock, [&] { return stopping_ || !tasks_.empty(); });
+        } else {
+            cv_.wait_until(lock, deadline, [&] { return stopping_ || !tasks_.empty(); });
+        }
+    }
+}
+
+void SimulatedPodBackend::EmitStatus(const std::string& status) {
+    std::lock_guard<std::mutex> lock(callback_mtx_);
+    if (on_status_) on_status_(status);
+}
+
+void SimulatedPodBackend::EmitPayload(const std::vector<uint8_t>& payload) {
+    std::lock_guard<std::mutex> lock(callback_mtx_);
+    if (on_payload_) on_payload_(payload);
+}
+
+} // namespace pod_connector
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "pod_broker.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pod_connector {
+
+struct SimulatedPodConfig {
+    /// Advertised pods; ids are "SIM:<index>".
+    std::vector<std::string> devices = {"MA Pod 1", "MA Pod 2", "MA Pod 3"};
+    std::chrono::milliseconds scan_interval{20};
+    std::chrono::milliseconds live_interval{10};    // 100 Hz, like the pod
+    size_t file_size = 256 * 1024;                  // Data bytes per downloaded file
+};
+
+/// Portable stand-in for PodBLECore, so the broker and its clients can be
+/// exercised on machines without a radio (the Linux harness).
+///
+/// Emits the status strings PodBLECore does ("Connecting...", "Connected",
+/// "Downloading File i/n", "Pod Ready", "Batch Complete", "Disconnected"),
+/// advertises [devices] while scanning, streams 0x01 live packets (73 bytes,
+/// tick in ms at bytes 1-4) while the live stream is on, and answers
+/// downloads with a 0x03 payload whose content is FileData(filename).
+/// Everything is emitted from one worker thread, in order.
+class SimulatedPodBackend : public BrokerBackend {
+public:
+    explicit SimulatedPodBackend(SimulatedPodConfig config = {});
+    ~SimulatedPodBackend() override;
+
+    SimulatedPodBackend(const SimulatedPodBackend&) = delete;
+    SimulatedPodBackend& operator=(const SimulatedPodBackend&) = delete;
+
+    void SetCallbacks(StatusFn status, ScanFn scan, PayloadFn payload) override;
+    void StartScan() override;
+    void StopScan() override;
+    void Connect(const std::string& deviceId) override;
+    void Disconnect() override;
+    void WriteCommand(const std::vector<uint8_t>& data) override;
+    void DownloadFile(const std::string& filename, int64_t start, int64_t end) override;
+    void DownloadFiles(const std::vector<std::string>& filenames, int64_t start, int64_t end,
+                       int window) override;
+    void AcknowledgeBatchFile(int index) override;
+    void CancelDownload() override;
+
+    /// Deterministic content of [filename] (without the 0x03 type byte).
+    static std::vector<uint8_t> FileData(const std::string& filename, size_t size);
+
+    /// Commands received, for assertions on the broker's reference counting.
+    struct Counters {
+        uint64_t start_scan = 0;
+        uint64_t stop_scan = 0;
+        uint64_t connect = 0;
+        uint64_t disconnect = 0;
+        uint64_t live_on = 0;
+        uint64_t live_off = 0;
+        uint64_t downloads = 0;     // Files requested (single or batch)
+        uint64_t cancels = 0;
+        uint64_t live_packets = 0;
+    };
+    Counters counters() const;
+
+private:
+    void Run();
+    void Post(std::function<void()> task);
+    void EmitStatus(const std::string& status);
+    void EmitPayload(const std::vector<uint8_t>& payload);
+    void StartNextBatchFile();
+
+    SimulatedPodConfig config_;
+
+    // Held while a callback runs, so SetCallbacks can guarantee the old
+    // ones have returned
+    std::mutex callback_mtx_;
+    StatusFn on_status_;
+    ScanFn on_scan_;
+    PayloadFn on_payload_;
+
+    // Worker state, guarded by mtx_ (tasks run with it released)
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopping_ = false;
+    bool scanning_ = false;
+    std::string device_;
+    bool live_ = false;
+    uint32_t live_tick_ = 0;
+    std::chrono::steady_clock::time_point next_scan_;
+    std::chrono::steady_clock::time_point next_live_;
+    std::vector<std::string> batch_;
+    size_t batch_next_ = 0;         // Index of the next batch file to send
+    int batch_acked_ = 0;
+    int batch_window_ = 1;
+    Counters counters_;
+    std::thread worker_;
+};
+
+} // namespace pod_connector